@@ -704,9 +704,11 @@ void ClientManager::onFrameAvailable() {
 
     // Drain all available frames from this session (typically 1, occasionally 2-3).
     while ( instance->sessionManager && instance->sessionManager->hasScreenImage() ) {
-        QImage image = instance->sessionManager->dequeueScreenImage();
+        qint64 captureTimestamp = 0;
+        QImage image = instance->sessionManager->dequeueScreenImage(&captureTimestamp);
         if ( !image.isNull() ) {
             instance->remoteDesktopWindow->updateRemoteScreen(image);
+            instance->sessionManager->recordFramePresented(captureTimestamp);
         }
     }
 
@@ -725,9 +727,11 @@ void ClientManager::updateScreens() {
         }
 
         if ( instance->sessionManager->hasScreenImage() ) {
-            QImage image = instance->sessionManager->dequeueScreenImage();
+            qint64 captureTimestamp = 0;
+            QImage image = instance->sessionManager->dequeueScreenImage(&captureTimestamp);
             if ( !image.isNull() ) {
                 instance->remoteDesktopWindow->updateRemoteScreen(image);
+                instance->sessionManager->recordFramePresented(captureTimestamp);
             }
             // Reset notification flag in case it was stuck
             instance->sessionManager->resetFrameNotification();
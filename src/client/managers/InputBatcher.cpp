@@ -0,0 +1,95 @@
+#include "InputBatcher.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+static_assert(NetworkConstants::INPUT_BATCH_MAX_EVENTS <= InputBatch::MAX_EVENTS);
+
+InputBatcher::InputBatcher(Sink sink)
+    : m_sink(std::move(sink))
+    , m_coalescedMoves(0) {
+}
+
+void InputBatcher::addMouseMove(qint16 x, qint16 y, quint64 timestampMs) {
+    // 只与紧邻的移动事件合并，避免越过按键事件改变其发生位置
+    if ( !m_batch.events.isEmpty() ) {
+        InputBatchEvent& last = m_batch.events.last();
+        if ( last.kind == InputBatchEvent::Kind::MOUSE && last.mouse.eventType == MouseEventType::MOVE ) {
+            last.mouse.x = x;
+            last.mouse.y = y;
+            last.timeOffsetMs = offsetFrom(m_batch.baseTimestamp, timestampMs);
+            ++m_coalescedMoves;
+            return;
+        }
+    }
+
+    InputBatchEvent event;
+    event.kind = InputBatchEvent::Kind::MOUSE;
+    event.mouse.eventType = MouseEventType::MOVE;
+    event.mouse.x = x;
+    event.mouse.y = y;
+    event.mouse.wheelDelta = 0;
+    append(std::move(event), timestampMs);
+}
+
+void InputBatcher::addMouseEvent(const MouseEvent& mouse, quint64 timestampMs) {
+    if ( mouse.eventType == MouseEventType::MOVE ) {
+        addMouseMove(mouse.x, mouse.y, timestampMs);
+        return;
+    }
+
+    InputBatchEvent event;
+    event.kind = InputBatchEvent::Kind::MOUSE;
+    event.mouse = mouse;
+    append(std::move(event), timestampMs);
+}
+
+void InputBatcher::addKeyboardEvent(const KeyboardEvent& keyboard, quint64 timestampMs) {
+    InputBatchEvent event;
+    event.kind = InputBatchEvent::Kind::KEYBOARD;
+    event.keyboard = keyboard;
+    append(std::move(event), timestampMs);
+}
+
+bool InputBatcher::hasOnlyMoves() const {
+    return std::all_of(m_batch.events.cbegin(), m_batch.events.cend(), [](const InputBatchEvent& event) {
+        return event.kind == InputBatchEvent::Kind::MOUSE && event.mouse.eventType == MouseEventType::MOVE;
+    });
+}
+
+void InputBatcher::flush() {
+    if ( m_batch.events.isEmpty() ) {
+        return;
+    }
+
+    InputBatch batch = std::move(m_batch);
+    m_batch = InputBatch();
+    if ( m_sink ) {
+        m_sink(batch);
+    }
+}
+
+void InputBatcher::clear() {
+    m_batch = InputBatch();
+}
+
+void InputBatcher::append(InputBatchEvent event, quint64 timestampMs) {
+    if ( m_batch.events.isEmpty() ) {
+        m_batch.baseTimestamp = timestampMs;
+    }
+    event.timeOffsetMs = offsetFrom(m_batch.baseTimestamp, timestampMs);
+    m_batch.events.append(std::move(event));
+
+    if ( m_batch.events.size() >= NetworkConstants::INPUT_BATCH_MAX_EVENTS ) {
+        flush();
+    }
+}
+
+quint16 InputBatcher::offsetFrom(quint64 baseTimestamp, quint64 timestampMs) {
+    if ( timestampMs <= baseTimestamp ) {
+        return 0;
+    }
+    return static_cast<quint16>(std::min<quint64>(timestampMs - baseTimestamp,
+                                                  std::numeric_limits<quint16>::max()));
+}
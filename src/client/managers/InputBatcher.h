@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../../common/core/network/Protocol.h"
+#include <QtCore/qglobal.h>
+#include <functional>
+
+/**
+ * @brief 客户端输入事件合并与批量发送
+ *
+ * 高回报率鼠标每秒产生 500-1000 个移动事件，逐个发送时每个事件都要单独的
+ * 消息头、校验和、TLS 记录以及服务端的一次注入调用。这里在短窗口内合并移动事件：
+ * - 相邻的移动事件只保留最后位置（中间轨迹点对远端无意义）
+ * - 按键、滚轮、键盘事件从不与移动事件交换顺序：它们追加在已有移动之后，
+ *   之后的移动也不会越过它们合并，使按下/释放发生在正确的位置上
+ * - 事件数达到 INPUT_BATCH_MAX_EVENTS 时立即发送
+ *
+ * 发送时机由所有者负责：只有移动事件待发时等待合并窗口，出现其他事件后应在
+ * 下一次事件循环中调用 flush()，同一轮中到达的事件因此合并为一个批次。
+ * 由所属线程独占使用（非线程安全）。
+ */
+class InputBatcher {
+public:
+    /// 发送函数：收到的批次至少包含一个事件，事件按产生顺序排列
+    using Sink = std::function<void(const InputBatch& batch)>;
+
+    explicit InputBatcher(Sink sink);
+
+    /**
+     * @brief 添加鼠标移动事件（与上一个待发移动事件合并）
+     * @param timestampMs 事件时间（本地时钟，毫秒）
+     */
+    void addMouseMove(qint16 x, qint16 y, quint64 timestampMs);
+
+    /// 添加鼠标事件；移动事件按 addMouseMove() 合并，其他事件原样追加
+    void addMouseEvent(const MouseEvent& event, quint64 timestampMs);
+
+    /// 添加键盘事件
+    void addKeyboardEvent(const KeyboardEvent& event, quint64 timestampMs);
+
+    /// 待发事件是否全部为可继续合并的移动事件
+    bool hasOnlyMoves() const;
+
+    /// 发送所有待发事件
+    void flush();
+
+    /// 丢弃待发事件（断开连接时调用）
+    void clear();
+
+    bool isEmpty() const { return m_batch.events.isEmpty(); }
+    qsizetype pendingEvents() const { return m_batch.events.size(); }
+
+    /// 累计被合并掉的移动事件数
+    quint64 coalescedMoves() const { return m_coalescedMoves; }
+
+private:
+    void append(InputBatchEvent event, quint64 timestampMs);
+    static quint16 offsetFrom(quint64 baseTimestamp, quint64 timestampMs);
+
+    Sink m_sink;
+    InputBatch m_batch;
+    quint64 m_coalescedMoves;
+};
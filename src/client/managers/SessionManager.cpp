@@ -2,26 +2,63 @@
 #include "../network/ConnectionManager.h"
 #include "../../common/core/logging/LoggingCategories.h"
 #include "../../common/core/network/Protocol.h"
+#include "../../common/core/memory/FrameBufferPool.h"
+#include "../../common/core/config/Config.h"
 #include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
 #include <QtCore/QTimer>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+#include <QtGui/QImageReader>
+#include <QtGui/QPainter>
+#include <algorithm>
+#include <cmath>
 #include <zstd.h>
 
+namespace {
+
+/**
+ * @brief 图块缓存的磁盘溢出上限（字节）
+ *
+ * 默认关闭（返回 0，只使用内存层）；Performance/tileCacheDiskSpill 开启后
+ * 按 Performance/tileCacheDiskSpillMaxMB 限制临时目录大小。
+ */
+qsizetype tileCacheSpillBytes() {
+    if ( !Config::instance()->getBool(QStringLiteral("tileCacheDiskSpill"), false, Config::Performance) ) {
+        return 0;
+    }
+    const int megabytes = Config::instance()->getInt(QStringLiteral("tileCacheDiskSpillMaxMB"),
+        NetworkConstants::TILE_CACHE_SPILL_DEFAULT_MB, Config::Performance);
+    return qsizetype(std::max(0, megabytes)) * 1024 * 1024;
+}
+
+} // namespace
+
 SessionManager::SessionManager(const QString& connectionId, QObject* parent)
     : QObject(parent)
     , m_connectionId(connectionId)
     , m_connectionManager(new ConnectionManager(this))
     , m_statsTimer(new QTimer(this))
+    , m_inputBatcher([this](const InputBatch& batch) { sendInputBatch(batch); })
+    , m_inputFlushTimer(new QTimer(this))
+    , m_tileCache(NetworkConstants::TILE_CACHE_MEMORY_ENTRIES, tileCacheSpillBytes())
     , m_frameRate(30) {
 
     // SessionManager 拥有并管理 ConnectionManager
     setupConnections();
+    // 只声明缓存实际能容纳的条目数，协商容量才与服务端镜像一致
+    m_connectionManager->setTileCacheCapacity(static_cast<quint32>(
+        std::min<qsizetype>(m_tileCache.maxCapacity(), NetworkConstants::TILE_CACHE_SIZE)));
 
     // 设置性能统计定时器
     m_statsTimer->setInterval(UIConstants::STATS_UPDATE_INTERVAL);
     connect(m_statsTimer, &QTimer::timeout, this, &SessionManager::updatePerformanceStats);
 
+    // 鼠标移动合并窗口
+    m_inputFlushTimer->setSingleShot(true);
+    m_inputFlushTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_inputFlushTimer, &QTimer::timeout, this, [this]() { m_inputBatcher.flush(); });
+
     // 初始化统计数据
     resetStats();
 }
@@ -67,6 +104,11 @@ void SessionManager::resumeSession() {
 
 void SessionManager::terminateSession() {
     m_statsTimer->stop();
+    m_inputFlushTimer->stop();
+    m_inputBatcher.clear();
+    m_cursorShapeCache.clear();
+    resetTileCache();
+    resetMonitorLayout();
 
     // 注意：会话终止不发送断开请求，避免重复发送
     // 断开请求统一由 ConnectionManager/TcpClient 在 disconnectFromHost() 时发送
@@ -75,6 +117,7 @@ void SessionManager::terminateSession() {
     // 清理会话数据
     m_remoteScreenSize = QSize();
     m_frameTimes.clear();
+    m_clockSyncValid.store(false);
 }
 
 bool SessionManager::isActive() const {
@@ -96,7 +139,9 @@ void SessionManager::sendMouseEvent(int x, int y, int eventType) {
     mouseEvent.eventType = static_cast<MouseEventType>(eventType);
     mouseEvent.wheelDelta = 0;
 
-    m_connectionManager->sendMessage(MessageType::MOUSE_EVENT, mouseEvent);
+    const quint64 now = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch());
+    m_inputBatcher.addMouseEvent(mouseEvent, now);
+    scheduleInputFlush();
 }
 
 void SessionManager::sendKeyboardEvent(int key, int modifiers, bool pressed, const QString& text) {
@@ -111,7 +156,8 @@ void SessionManager::sendKeyboardEvent(int key, int modifiers, bool pressed, con
 
     keyEvent.text = text;
 
-    m_connectionManager->sendMessage(MessageType::KEYBOARD_EVENT, keyEvent);
+    m_inputBatcher.addKeyboardEvent(keyEvent, static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()));
+    scheduleInputFlush();
 }
 
 void SessionManager::sendWheelEvent(int x, int y, int delta, int orientation) {
@@ -127,7 +173,42 @@ void SessionManager::sendWheelEvent(int x, int y, int delta, int orientation) {
     wheelEvent.eventType = delta > 0 ? MouseEventType::WHEEL_UP : MouseEventType::WHEEL_DOWN;
     wheelEvent.wheelDelta = delta;
 
-    m_connectionManager->sendMessage(MessageType::MOUSE_EVENT, wheelEvent);
+    m_inputBatcher.addMouseEvent(wheelEvent, static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()));
+    scheduleInputFlush();
+}
+
+void SessionManager::scheduleInputFlush() {
+    if ( m_inputBatcher.isEmpty() ) {
+        m_inputFlushTimer->stop();
+    } else if ( !m_inputBatcher.hasOnlyMoves() ) {
+        // 按键/键盘事件不等待合并窗口：本轮事件循环中已排队的事件处理完后立即发送
+        if ( !m_inputFlushTimer->isActive() || m_inputFlushTimer->interval() != 0 ) {
+            m_inputFlushTimer->start(0);
+        }
+    } else if ( !m_inputFlushTimer->isActive() ) {
+        // 只有移动事件：在合并窗口结束时发送最后位置
+        m_inputFlushTimer->start(NetworkConstants::INPUT_COALESCE_INTERVAL_MS);
+    }
+}
+
+void SessionManager::sendInputBatch(const InputBatch& batch) {
+    if ( !m_connectionManager || !m_connectionManager->isAuthenticated() ) {
+        return;
+    }
+
+    // 旧版本服务端不认识 INPUT_BATCH：逐个发送（移动事件仍已合并）
+    if ( batch.events.size() > 1 && m_connectionManager->serverCapabilities().has(Capability::INPUT_BATCH) ) {
+        m_connectionManager->sendMessage(MessageType::INPUT_BATCH, batch);
+        return;
+    }
+
+    for ( const InputBatchEvent& event : batch.events ) {
+        if ( event.kind == InputBatchEvent::Kind::KEYBOARD ) {
+            m_connectionManager->sendMessage(MessageType::KEYBOARD_EVENT, event.keyboard);
+        } else {
+            m_connectionManager->sendMessage(MessageType::MOUSE_EVENT, event.mouse);
+        }
+    }
 }
 
 SessionManager::PerformanceStats SessionManager::performanceStats() const {
@@ -138,7 +219,10 @@ void SessionManager::resetStats() {
     m_stats.currentFPS = 0.0;
     m_stats.sessionStartTime = QDateTime();
     m_stats.frameCount = 0;
+    m_stats.endToEndLatency = LatencyStats::Summary();
+    m_stats.roundTripMs = -1.0;
     m_frameTimes.clear();
+    m_endToEndLatency.reset();
 }
 
 QString SessionManager::getFormattedPerformanceInfo() const {
@@ -151,6 +235,15 @@ QString SessionManager::getFormattedPerformanceInfo() const {
         info << QString("Duration: %1s").arg(sessionDuration);
     }
 
+    // 捕获到显示的端到端延迟（依赖心跳时钟同步）
+    LatencyStats::Summary latency = m_endToEndLatency.summary();
+    if ( latency.count > 0 ) {
+        info << QString("E2E p50/p95/p99: %1").arg(latency.toString());
+    }
+    if ( m_clockSyncValid.load() ) {
+        info << QString("RTT: %1ms").arg(m_clockRttMs.load(), 0, 'f', 1);
+    }
+
     return info.join(" | ");
 }
 
@@ -181,10 +274,28 @@ void SessionManager::onMessageReceived(MessageType type, const QByteArray& data)
                 handleScreenData(data);
             }
             break;
+        case MessageType::TILE_UPDATE:
+            if ( m_connectionManager && m_connectionManager->isConnected() ) {
+                // 处理图块更新（缓存引用或新图块）
+                handleTileUpdate(data);
+            }
+            break;
+        case MessageType::MONITOR_LAYOUT:
+            // 显示器布局：与屏幕数据同序到达，之后的帧按新布局显示
+            handleMonitorLayout(data);
+            break;
         case MessageType::CURSOR_POSITION:
             // 处理光标位置数据
             handleCursorPosition(data);
             break;
+        case MessageType::CURSOR_STATE:
+            // 处理光标坐标与类型
+            handleCursorState(data);
+            break;
+        case MessageType::CURSOR_SHAPE:
+            // 处理光标图像（或缓存引用）
+            handleCursorShape(data);
+            break;
         case MessageType::CLIPBOARD_DATA:
             // 处理剪贴板数据（文本或图片）
             handleClipboardData(data);
@@ -196,8 +307,29 @@ void SessionManager::onMessageReceived(MessageType type, const QByteArray& data)
     }
 }
 
+void SessionManager::onClockSyncUpdated(double offsetMs, double rttMs) {
+    m_clockOffsetMs.store(offsetMs);
+    m_clockRttMs.store(rttMs);
+    m_clockSyncValid.store(true);
+}
+
+void SessionManager::recordFramePresented(qint64 captureTimestamp) {
+    if ( captureTimestamp <= 0 || !m_clockSyncValid.load() ) {
+        return;
+    }
+
+    // 服务端捕获时间换算到本地时钟：local = remote - offset
+    const double localCaptureMs = static_cast<double>(captureTimestamp) - m_clockOffsetMs.load();
+    const double latencyMs = static_cast<double>(QDateTime::currentMSecsSinceEpoch()) - localCaptureMs;
+
+    // 偏移估计误差最多约半个RTT，轻微负值钳制为0
+    m_endToEndLatency.record(std::max(0.0, latencyMs));
+}
+
 void SessionManager::updatePerformanceStats() {
-    // 只更新FPS相关的统计信息，网络统计信息已移除
+    // 刷新FPS之外的延迟统计
+    m_stats.endToEndLatency = m_endToEndLatency.summary();
+    m_stats.roundTripMs = m_clockSyncValid.load() ? m_clockRttMs.load() : -1.0;
     emit performanceStatsUpdated(m_stats);
 }
 
@@ -206,9 +338,23 @@ void SessionManager::setupConnections() {
     connect(m_connectionManager, &ConnectionManager::connectionStateChanged,
         this, &SessionManager::connectionStateChanged);
 
+    // 新连接对应新的服务端镜像索引，光标缓存从空开始
+    connect(m_connectionManager, &ConnectionManager::connectionStateChanged,
+        this, [this](ConnectionManager::ConnectionState state) {
+        if ( state == ConnectionManager::Connected || state == ConnectionManager::Disconnected ) {
+            m_cursorShapeCache.clear();
+            resetTileCache();
+            resetMonitorLayout();
+        }
+    });
+
     // m_connectionManager 在构造函数中创建，永远不为空
     connect(m_connectionManager, &ConnectionManager::messageReceived,
         this, &SessionManager::onMessageReceived);
+
+    // 心跳时钟同步，用于端到端延迟统计
+    connect(m_connectionManager, &ConnectionManager::clockSyncUpdated,
+        this, &SessionManager::onClockSyncUpdated);
 }
 
 void SessionManager::calculateFPS() {
@@ -229,32 +375,35 @@ void SessionManager::calculateFPS() {
 }
 
 void SessionManager::handleScreenData(const QByteArray& data) {
-    // 使用正确的ScreenData结构体解码数据
+    // 零拷贝解码：imageView 直接指向 data 中的图像字节，data 在本函数内始终存活
     ScreenData screenData{};
-    if ( !screenData.decode(data) ) {
+    if ( !screenData.decodeView(data) ) {
         qCWarning(lcClient) << "SessionManager::handleScreenData() - Failed to decode ScreenData from received data, size:" << data.size();
         return;
     }
 
     // 验证数据完整性
-    if ( screenData.imageData.isEmpty() || screenData.dataSize == 0 ) {
+    if ( screenData.imageView.isEmpty() || screenData.dataSize == 0 ) {
         qCWarning(lcClient) << "SessionManager::handleScreenData() - ScreenData contains empty image data";
         return;
     }
 
-    if ( static_cast<quint32>(screenData.imageData.size()) != screenData.dataSize ) {
-        qCWarning(lcClient) << "SessionManager::handleScreenData() - ScreenData size mismatch, expected:" << screenData.dataSize << "actual:" << screenData.imageData.size();
+    if ( static_cast<quint32>(screenData.imageView.size()) != screenData.dataSize ) {
+        qCWarning(lcClient) << "SessionManager::handleScreenData() - ScreenData size mismatch, expected:" << screenData.dataSize << "actual:" << screenData.imageView.size();
         return;
     }
 
     // 检查是否需要zstd解压
-    QByteArray jpegData;
+    // 解压缓冲取自缓冲池，解码完成后立即交回
+    FrameBufferPool& pool = FrameBufferPool::instance();
+    QByteArray uncompressedData;
+    QByteArrayView jpegData;
     if ( screenData.flags & static_cast<quint8>(ScreenDataFlags::ZSTD_COMPRESSED) ) {
         // 数据经过zstd压缩，需要解压
         // 获取原始大小（zstd在压缩帧中存储了原始大小）
         unsigned long long decompressedSize = ZSTD_getFrameContentSize(
-            screenData.imageData.constData(),
-            static_cast<size_t>(screenData.imageData.size())
+            screenData.imageView.constData(),
+            static_cast<size_t>(screenData.imageView.size())
         );
         
         if ( decompressedSize == ZSTD_CONTENTSIZE_UNKNOWN ) {
@@ -265,25 +414,27 @@ void SessionManager::handleScreenData(const QByteArray& data) {
             return;
         }
         
-        QByteArray uncompressedData(static_cast<int>(decompressedSize), '\0');
+        uncompressedData = pool.acquireBytes(static_cast<qsizetype>(decompressedSize));
+        uncompressedData.resize(static_cast<qsizetype>(decompressedSize));
         
         size_t result = ZSTD_decompress(
             uncompressedData.data(),
             static_cast<size_t>(decompressedSize),
-            screenData.imageData.constData(),
-            static_cast<size_t>(screenData.imageData.size())
+            screenData.imageView.constData(),
+            static_cast<size_t>(screenData.imageView.size())
         );
         
         if ( ZSTD_isError(result) ) {
             qCWarning(lcClient) << "SessionManager::handleScreenData() - Failed to decompress zstd data, error:" << ZSTD_getErrorName(result);
+            pool.recycle(std::move(uncompressedData));
             return;
         }
         
-        uncompressedData.resize(static_cast<int>(result));
+        uncompressedData.resize(static_cast<qsizetype>(result));
         jpegData = uncompressedData;
     } else {
-        // 数据未经zstd压缩，直接使用
-        jpegData = screenData.imageData;
+        // 数据未经zstd压缩，直接使用载荷中的字节
+        jpegData = screenData.imageView;
     }
 
     // 验证JPEG格式头部（JPEG文件以0xFF 0xD8开头）
@@ -298,65 +449,106 @@ void SessionManager::handleScreenData(const QByteArray& data) {
         }
     }
 
-    QByteArray frameData;
-    {
-        QMutexLocker locker(&m_frameDataMutex);
-        // 使用解压后的JPEG数据
-        frameData = jpegData;
-        m_previousFrameData = jpegData;
-    }
-
     // 从JPEG格式数据加载QImage
+    // 先读出尺寸，解码到缓冲池中尺寸与格式相同的图像上，JPEG 插件直接写入而不另行分配
+    QByteArray encoded = QByteArray::fromRawData(jpegData.constData(), jpegData.size());
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer, "JPEG");
     QImage image;
-    bool loaded = image.loadFromData(frameData, "JPEG");
+    const QSize decodedSize = reader.size();
+    if ( decodedSize.isValid() ) {
+        image = pool.acquireImage(decodedSize, QImage::Format_RGB32);
+    }
+    bool loaded = reader.read(&image);
 
     if ( loaded && !image.isNull() ) {
-        // Record the logical remote screen size for layout/aspect ratio.
-        // If the server downscaled the frame, use the original dimensions
-        // so that RenderManager::fitInView() computes the correct aspect ratio.
-        // The actual upscale is NOT performed here — it was a redundant
-        // SmoothTransformation that cost 5-10ms per frame without recovering
-        // any lost detail. RenderManager's fitInView() handles display scaling.
-        if ( screenData.flags & static_cast<quint8>(ScreenDataFlags::SCALED) ) {
-            if ( screenData.originalWidth > 0 && screenData.originalHeight > 0 ) {
-                m_remoteScreenSize = QSize(screenData.originalWidth, screenData.originalHeight);
-            } else {
-                m_remoteScreenSize = image.size();
-            }
-        } else {
-            m_remoteScreenSize = image.size();
-        }
-
-        // 更新性能统计
-        m_frameTimes.enqueue(QDateTime::currentDateTime());
-        if ( m_frameTimes.size() > 100 ) {
-            m_frameTimes.dequeue();
+        pool.recycle(std::move(uncompressedData));
+        // 查看多个显示器：拼合到画布上再发布
+        if ( !m_monitorCanvas.isNull() ) {
+            composeMonitorFrame(image, screenData);
+            return;
         }
-        m_stats.frameCount++;
-        calculateFPS();
-
-        // 将图片放入队列，替代信号槽机制
-        {
-            QMutexLocker locker(&m_screenImageQueueMutex);
-            // 如果队列已满，移除最旧的图片
-            while ( m_screenImageQueue.size() >= MAX_QUEUE_SIZE ) {
-                m_screenImageQueue.dequeue();
-                qCDebug(lcClient) << "SessionManager: Queue full, dropped oldest frame";
-            }
-            m_screenImageQueue.enqueue(image);
+        // 图块更新在整帧之上合成，STORE 记录从整帧中截取图块
+        if ( m_connectionManager->serverCapabilities().has(Capability::TILE_CACHE) ) {
+            m_tileCanvas = image.format() == QImage::Format_RGB32 ? image : image.convertToFormat(QImage::Format_RGB32);
         }
+        publishFrame(image, screenData.flags, screenData.originalWidth, screenData.originalHeight,
+            screenData.captureTimestamp);
+    } else {
+        qCWarning(lcClient) << "SessionManager::handleScreenData() - Failed to load JPEG image from frame data, size:" << jpegData.size()
+            << "first 16 bytes:" << jpegData.first(std::min<qsizetype>(16, jpegData.size())).toByteArray().toHex();
+        pool.recycle(std::move(uncompressedData));
+    }
+}
 
-        // Notify consumer via coalesced signal: only emit when the flag
-        // transitions false→true, so rapid enqueues produce at most one
-        // pending signal in the consumer's event queue.
-        bool expected = false;
-        if ( m_frameNotificationPending.compare_exchange_strong(expected, true) ) {
-            emit frameAvailable();
-        }
+void SessionManager::handleTileUpdate(const QByteArray& data) {
+    TileUpdate update;
+    if ( !update.decode(data) ) {
+        qCWarning(lcClient) << "Failed to decode tile update message, size:" << data.size();
+        return;
+    }
+
+    // 与服务端按相同容量、相同顺序操作，淘汰结果才一致
+    m_tileCache.setCapacity(m_connectionManager->serverCapabilities().uint32Param(Capability::TILE_CACHE));
+    if ( m_tileCache.capacity() == 0 ) {
+        return;
+    }
+
+    if ( m_tileCache.apply(update, m_tileCanvas) ) {
+        publishFrame(m_tileCanvas, update.flags, update.originalWidth, update.originalHeight, update.captureTimestamp);
+    }
+}
+
+void SessionManager::publishFrame(const QImage& image, quint8 flags, quint16 originalWidth, quint16 originalHeight,
+                                  quint64 captureTimestamp) {
+    // Record the logical remote screen size for layout/aspect ratio.
+    // If the server downscaled the frame, use the original dimensions
+    // so that RenderManager::fitInView() computes the correct aspect ratio.
+    // The actual upscale is NOT performed here — it was a redundant
+    // SmoothTransformation that cost 5-10ms per frame without recovering
+    // any lost detail. RenderManager's fitInView() handles display scaling.
+    if ( (flags & static_cast<quint8>(ScreenDataFlags::SCALED)) && originalWidth > 0 && originalHeight > 0 ) {
+        m_remoteScreenSize = QSize(originalWidth, originalHeight);
     } else {
-        qCWarning(lcClient) << "SessionManager::handleScreenData() - Failed to load JPEG image from frame data, size:" << frameData.size()
-            << "first 16 bytes:" << frameData.left(16).toHex();
+        m_remoteScreenSize = image.size();
+    }
+
+    // 更新性能统计
+    m_frameTimes.enqueue(QDateTime::currentDateTime());
+    if ( m_frameTimes.size() > 100 ) {
+        m_frameTimes.dequeue();
+    }
+    m_stats.frameCount++;
+    calculateFPS();
+
+    // 将图片放入队列，替代信号槽机制
+    {
+        QMutexLocker locker(&m_screenImageQueueMutex);
+        // 如果队列已满，移除最旧的图片
+        while ( m_screenImageQueue.size() >= MAX_QUEUE_SIZE ) {
+            m_screenImageQueue.dequeue();
+            qCDebug(lcClient) << "SessionManager: Queue full, dropped oldest frame";
+        }
+        m_screenImageQueue.enqueue({ image, static_cast<qint64>(captureTimestamp) });
     }
+
+    // Notify consumer via coalesced signal: only emit when the flag
+    // transitions false→true, so rapid enqueues produce at most one
+    // pending signal in the consumer's event queue.
+    bool expected = false;
+    if ( m_frameNotificationPending.compare_exchange_strong(expected, true) ) {
+        emit frameAvailable();
+    }
+}
+
+void SessionManager::resetTileCache() {
+    // 新连接对应新的服务端镜像索引，缓存从空开始
+    if ( m_tileCache.misses() > 0 ) {
+        qCWarning(lcClient) << "Tile cache misses during session:" << m_tileCache.misses();
+    }
+    m_tileCache.setCapacity(0);
+    m_tileCanvas = QImage();
 }
 
 void SessionManager::handleCursorPosition(const QByteArray& data) {
@@ -371,6 +563,55 @@ void SessionManager::handleCursorPosition(const QByteArray& data) {
     emit remoteCursorTypeUpdated(message.cursorType);
 }
 
+void SessionManager::handleCursorState(const QByteArray& data) {
+    CursorState state;
+    if ( !state.decode(data) ) {
+        qCWarning(lcClient) << "Failed to decode cursor state message";
+        return;
+    }
+
+    emit remoteCursorTypeUpdated(state.cursorType);
+    emit remoteCursorPositionUpdated(QPoint(state.x, state.y), state.isVisible());
+}
+
+void SessionManager::handleCursorShape(const QByteArray& data) {
+    CursorShapeMessage message;
+    if ( !message.decode(data) ) {
+        qCWarning(lcClient) << "Failed to decode cursor shape message";
+        return;
+    }
+
+    // 与服务端按相同容量、相同顺序操作，淘汰结果才一致
+    const quint32 capacity = m_connectionManager->serverCapabilities().uint32Param(Capability::CURSOR_SHAPE);
+    m_cursorShapeCache.setCapacity(capacity);
+
+    if ( !message.hasBitmap() ) {
+        const CachedCursor* cached = m_cursorShapeCache.find(message.cacheId);
+        if ( !cached ) {
+            qCWarning(lcClient) << "Cursor shape cache miss, id:" << message.cacheId;
+            return;
+        }
+        emit remoteCursorImageUpdated(cached->image, cached->hotspot);
+        return;
+    }
+
+    QImage image(message.width, message.height, QImage::Format_ARGB32_Premultiplied);
+    if ( image.isNull() ) {
+        return;
+    }
+    const char* in = message.pixels.constData();
+    for ( int y = 0; y < image.height(); ++y ) {
+        quint32* line = reinterpret_cast<quint32*>(image.scanLine(y));
+        for ( int x = 0; x < image.width(); ++x, in += 4 ) {
+            line[x] = qFromLittleEndian<quint32>(in);
+        }
+    }
+
+    CachedCursor cursor{ image, QPoint(message.hotspotX, message.hotspotY) };
+    m_cursorShapeCache.insert(message.cacheId, cursor);
+    emit remoteCursorImageUpdated(cursor.image, cursor.hotspot);
+}
+
 QString SessionManager::currentHost() const {
     return m_connectionManager ? m_connectionManager->currentHost() : QString();
 }
@@ -399,6 +640,102 @@ void SessionManager::disconnectFromHost() {
     }
 }
 
+// ==================== 多显示器 ====================
+
+void SessionManager::handleMonitorLayout(const QByteArray& data) {
+    MonitorLayout layout;
+    if ( !layout.decode(data) ) {
+        qCWarning(lcClient) << "SessionManager::handleMonitorLayout() - Failed to decode monitor layout, size:" << data.size();
+        return;
+    }
+    m_monitorLayout = layout;
+    m_viewedBounds = layout.viewedBounds();
+    const qsizetype viewedCount = std::count_if(layout.monitors.cbegin(), layout.monitors.cend(),
+        [](const MonitorInfo& monitor) { return monitor.isViewed(); });
+
+    // 只查看一个显示器时帧就是完整画面；查看多个时分配外接矩形大小的画布
+    m_monitorCanvas = QImage();
+    m_monitorCanvasScale = 1.0;
+    if ( viewedCount > 1 && !m_viewedBounds.isEmpty() ) {
+        const qint64 pixels = qint64(m_viewedBounds.width()) * m_viewedBounds.height();
+        if ( pixels > MAX_MONITOR_CANVAS_PIXELS ) {
+            m_monitorCanvasScale = std::sqrt(double(MAX_MONITOR_CANVAS_PIXELS) / double(pixels));
+        }
+        m_monitorCanvas = QImage(qRound(m_viewedBounds.width() * m_monitorCanvasScale),
+            qRound(m_viewedBounds.height() * m_monitorCanvasScale), QImage::Format_RGB32);
+        m_monitorCanvas.fill(Qt::black);
+    }
+    qCInfo(lcClient) << "SessionManager::handleMonitorLayout() - Monitors:" << layout.monitors.size()
+        << "viewing:" << viewedCount << "bounds:" << m_viewedBounds;
+    emit monitorLayoutChanged(static_cast<int>(layout.monitors.size()));
+}
+
+void SessionManager::composeMonitorFrame(const QImage& image, const ScreenData& screenData) {
+    // 帧的 x,y 与原始尺寸是其区域相对外接矩形左上角的逻辑位置和大小（可能只是显示器的一部分），
+    // 区域必须落在某个查看中的显示器内，否则是旧布局的帧
+    const QRect area(screenData.x, screenData.y, screenData.originalWidth, screenData.originalHeight);
+    const bool inViewedMonitor = std::any_of(m_monitorLayout.monitors.cbegin(), m_monitorLayout.monitors.cend(),
+        [&](const MonitorInfo& monitor) {
+        return monitor.isViewed() && monitor.geometry().translated(-m_viewedBounds.topLeft()).contains(area);
+    });
+    if ( area.isEmpty() || !inViewedMonitor ) {
+        qCDebug(lcClient) << "SessionManager::composeMonitorFrame() - Frame outside viewed monitors:" << area;
+        return;
+    }
+
+    // 帧可能被服务端缩小，按区域的逻辑尺寸画到画布上
+    const QRect target(qRound(area.x() * m_monitorCanvasScale), qRound(area.y() * m_monitorCanvasScale),
+        qRound(area.width() * m_monitorCanvasScale), qRound(area.height() * m_monitorCanvasScale));
+    {
+        QPainter painter(&m_monitorCanvas);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, image.size() != target.size());
+        painter.drawImage(target, image);
+    }
+    // 画布尺寸与外接矩形不同时按缩放帧发布，输入坐标换算到服务端逻辑坐标
+    publishFrame(m_monitorCanvas, static_cast<quint8>(ScreenDataFlags::SCALED),
+        static_cast<quint16>(m_viewedBounds.width()), static_cast<quint16>(m_viewedBounds.height()),
+        screenData.captureTimestamp);
+}
+
+void SessionManager::viewAllMonitors() {
+    QList<quint8> monitorIds;
+    for ( const MonitorInfo& monitor : std::as_const(m_monitorLayout.monitors) ) {
+        monitorIds.append(monitor.id);
+    }
+    selectMonitors(monitorIds);
+}
+
+void SessionManager::viewMonitor(int index) {
+    if ( index < 0 || index >= m_monitorLayout.monitors.size() ) {
+        qCDebug(lcClient) << "SessionManager::viewMonitor() - No monitor at index" << index;
+        return;
+    }
+    selectMonitors({ m_monitorLayout.monitors.at(index).id });
+}
+
+void SessionManager::selectMonitors(const QList<quint8>& monitorIds) {
+    if ( monitorIds.isEmpty() || !m_connectionManager || !m_connectionManager->isAuthenticated()
+         || !m_connectionManager->serverCapabilities().has(Capability::MULTI_MONITOR) ) {
+        return;
+    }
+    // 服务端确认后以新的 MONITOR_LAYOUT 回复，本地在收到布局时才切换显示
+    MonitorSelect select;
+    select.monitorIds = monitorIds;
+    m_connectionManager->sendMessage(MessageType::MONITOR_SELECT, select);
+    qCDebug(lcClient) << "SessionManager::selectMonitors() - Requested monitors:" << monitorIds;
+}
+
+void SessionManager::resetMonitorLayout() {
+    const bool hadLayout = !m_monitorLayout.monitors.isEmpty();
+    m_monitorLayout = MonitorLayout();
+    m_viewedBounds = QRect();
+    m_monitorCanvas = QImage();
+    m_monitorCanvasScale = 1.0;
+    if ( hadLayout ) {
+        emit monitorLayoutChanged(0);
+    }
+}
+
 // ==================== 剪贴板同步实现 ====================
 
 void SessionManager::sendClipboardText(const QString& text) {
@@ -416,6 +753,11 @@ void SessionManager::sendClipboardImage(const QByteArray& imageData, quint32 wid
     if ( !m_connectionManager || !isConnected() ) {
         return;
     }
+    // 服务端未协商图片剪贴板时只同步文本
+    if ( !m_connectionManager->serverCapabilities().has(Capability::CLIPBOARD_IMAGE) ) {
+        qCDebug(lcClient) << "SessionManager::sendClipboardImage() - Server does not accept clipboard images";
+        return;
+    }
 
     ClipboardMessage message(imageData, width, height);
     m_connectionManager->sendMessage(MessageType::CLIPBOARD_DATA, message);
@@ -446,14 +788,17 @@ bool SessionManager::hasScreenImage() const {
     return !m_screenImageQueue.isEmpty();
 }
 
-QImage SessionManager::dequeueScreenImage() {
+QImage SessionManager::dequeueScreenImage(qint64* captureTimestamp) {
     QMutexLocker locker(&m_screenImageQueueMutex);
     if ( m_screenImageQueue.isEmpty() ) {
         return QImage();
     }
-    QImage image = m_screenImageQueue.dequeue();
+    QueuedFrame frame = m_screenImageQueue.dequeue();
+    if ( captureTimestamp ) {
+        *captureTimestamp = frame.captureTimestamp;
+    }
     qCDebug(lcClient) << "SessionManager: Image dequeued, remaining:" << m_screenImageQueue.size();
-    return image;
+    return frame.image;
 }
 
 void SessionManager::resetFrameNotification() {
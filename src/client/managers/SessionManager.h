@@ -7,9 +7,14 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <QtCore/QSize>
+#include <QtCore/QPoint>
 #include "../../common/core/network/Protocol.h"
 #include "../../common/core/config/UiConstants.h"
+#include "../../common/core/metrics/LatencyStats.h"
 #include "../network/ConnectionManager.h"
+#include "InputBatcher.h"
+#include "../../common/core/cache/LruCache.h"
+#include "TileCache.h"
 #include <atomic>
 
 class QTimer;
@@ -22,6 +27,8 @@ public:
         double currentFPS;
         QDateTime sessionStartTime;
         int frameCount;
+        LatencyStats::Summary endToEndLatency;  ///< 捕获到显示的端到端延迟分位数（毫秒）
+        double roundTripMs;                     ///< 心跳估计的网络往返时延（毫秒，<0 表示未知）
     };
 
     explicit SessionManager(const QString& connectionId, QObject* parent = nullptr);
@@ -57,6 +64,10 @@ public slots:
     // 配置（跨线程调用需要使用 slots）
     void setFrameRate(int fps);
 
+    // 多显示器（跨线程调用需要使用 slots；服务端未发送布局时忽略）
+    void viewAllMonitors();
+    void viewMonitor(int index);   ///< index 为布局中的序号，0 为主显示器
+
 public:
     // 性能统计
     PerformanceStats performanceStats() const;
@@ -76,7 +87,21 @@ public:
 
     // 图片队列操作（线程安全）
     bool hasScreenImage() const;
-    QImage dequeueScreenImage();
+
+    /**
+     * @brief 取出一帧待显示图片
+     * @param captureTimestamp 可选输出：服务端捕获时间（服务端时钟，毫秒；0表示未知）
+     */
+    QImage dequeueScreenImage(qint64* captureTimestamp = nullptr);
+
+    /**
+     * @brief 记录一帧已交给窗口显示，用于统计端到端延迟（线程安全）
+     *
+     * 使用心跳估计的时钟偏移把服务端捕获时间换算到本地时钟，
+     * 尚无时钟估计或捕获时间未知时忽略。
+     * @param captureTimestamp 服务端捕获时间（由 dequeueScreenImage 给出）
+     */
+    void recordFramePresented(qint64 captureTimestamp);
 
     /**
      * @brief Reset the frame notification coalescing flag.
@@ -105,10 +130,19 @@ signals:
     // 远程光标类型更新信号
     void remoteCursorTypeUpdated(Qt::CursorShape type);
 
+    // 远程光标位置更新信号（服务端屏幕坐标）
+    void remoteCursorPositionUpdated(const QPoint& position, bool visible);
+
+    // 远程光标图像更新信号（预乘 ARGB32 图像与热点）
+    void remoteCursorImageUpdated(const QImage& image, const QPoint& hotspot);
+
     // 剪贴板数据接收信号
     void clipboardTextReceived(const QString& text);
     void clipboardImageReceived(const QByteArray& imageData);
 
+    // 服务端显示器布局变化信号（显示器数；未协商多显示器或断开后为 0）
+    void monitorLayoutChanged(int monitorCount);
+
     /**
      * @brief Lightweight notification that a new frame is available in the queue.
      *
@@ -120,14 +154,27 @@ signals:
 
 private slots:
     void onMessageReceived(MessageType type, const QByteArray& data);
+    void onClockSyncUpdated(double offsetMs, double rttMs);
     void updatePerformanceStats();
 
 private:
     void setupConnections();
     void calculateFPS();
     void handleScreenData(const QByteArray& data);
+    void handleTileUpdate(const QByteArray& data);
+    void publishFrame(const QImage& image, quint8 flags, quint16 originalWidth, quint16 originalHeight,
+                      quint64 captureTimestamp);
+    void resetTileCache();
+    void handleMonitorLayout(const QByteArray& data);
+    void composeMonitorFrame(const QImage& image, const ScreenData& screenData);
+    void selectMonitors(const QList<quint8>& monitorIds);
+    void resetMonitorLayout();
     void handleCursorPosition(const QByteArray& data);
+    void handleCursorState(const QByteArray& data);
+    void handleCursorShape(const QByteArray& data);
     void handleClipboardData(const QByteArray& data);
+    void sendInputBatch(const InputBatch& batch);
+    void scheduleInputFlush();
 
     // 连接信息
     QString m_connectionId;
@@ -136,12 +183,12 @@ private:
     // 远程桌面数据
     QSize m_remoteScreenSize;
 
-    // 帧数据缓存和线程安全
-    QByteArray m_previousFrameData;
-    mutable QMutex m_frameDataMutex;
-
     // 图片队列（用于替代信号槽机制）
-    QQueue<QImage> m_screenImageQueue;
+    struct QueuedFrame {
+        QImage image;
+        qint64 captureTimestamp;   ///< 服务端捕获时间（服务端时钟，毫秒）
+    };
+    QQueue<QueuedFrame> m_screenImageQueue;
     mutable QMutex m_screenImageQueueMutex;
     static constexpr int MAX_QUEUE_SIZE = 5;  // Queue capacity (absorb network jitter)
 
@@ -154,6 +201,36 @@ private:
     PerformanceStats m_stats;
     QQueue<QDateTime> m_frameTimes;
 
+    // 端到端延迟（显示线程写入，统计时读取，均为线程安全）
+    LatencyStats m_endToEndLatency;
+    std::atomic<bool> m_clockSyncValid{false};
+    std::atomic<double> m_clockOffsetMs{0.0};   ///< 服务端时钟 - 本地时钟
+    std::atomic<double> m_clockRttMs{0.0};
+
+    // 输入事件合并：只有移动事件时等待合并窗口，出现其他事件后在下一轮事件循环发送
+    InputBatcher m_inputBatcher;
+    QTimer* m_inputFlushTimer;
+
+    // 光标图像缓存：缓存ID -> 图像，容量与服务端镜像索引一致（握手协商）
+    struct CachedCursor {
+        QImage image;
+        QPoint hotspot;
+    };
+    LruCache<quint32, CachedCursor> m_cursorShapeCache;
+
+    // 图块缓存：缓存ID -> 图块（内存 + 磁盘溢出），容量与服务端镜像索引一致；
+    // m_tileCanvas 为最近一帧完整画面，图块更新在其上合成
+    TileCache m_tileCache;
+    QImage m_tileCanvas;
+
+    // 多显示器：服务端显示器布局（MONITOR_LAYOUT）。查看多个显示器时各帧按其 x,y 在
+    // m_monitorCanvas 上拼合为外接矩形的画面；画布超过 MAX_MONITOR_CANVAS_PIXELS 时整体缩小
+    MonitorLayout m_monitorLayout;
+    QRect m_viewedBounds;             ///< 查看中的显示器外接矩形（服务端逻辑坐标）
+    QImage m_monitorCanvas;           ///< 拼合画布（只查看一个显示器时为空）
+    qreal m_monitorCanvasScale = 1.0; ///< 画布像素 / 服务端逻辑像素
+    static constexpr qint64 MAX_MONITOR_CANVAS_PIXELS = 7680LL * 2160;
+
     // 配置
     int m_frameRate;
 };
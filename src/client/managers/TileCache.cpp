@@ -0,0 +1,240 @@
+#include "TileCache.h"
+#include "../../common/core/logging/LoggingCategories.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <algorithm>
+#include <cstring>
+
+// 磁盘文件格式：quint16 width | quint16 height | width*height 个 RGB32 像素（行间无填充）
+static constexpr qsizetype TILE_FILE_HEADER_SIZE = 2 * sizeof(quint16);
+
+TileCache::TileCache(qsizetype memoryCapacity, qsizetype maxSpillBytes)
+    : m_capacity(0)
+    , m_memoryCapacity(std::max<qsizetype>(1, memoryCapacity))
+    , m_maxSpillEntries(std::max<qsizetype>(0, maxSpillBytes) / SPILL_FILE_BYTES)
+    , m_misses(0) {
+}
+
+TileCache::~TileCache() = default;
+
+void TileCache::setCapacity(qsizetype capacity) {
+    if ( capacity > maxCapacity() ) {
+        // 超出声明值的部分无处存放，与服务端镜像的淘汰顺序会不一致
+        qCWarning(lcClient) << "TileCache: negotiated capacity" << capacity << "exceeds" << maxCapacity();
+    }
+    capacity = std::clamp<qsizetype>(capacity, 0, maxCapacity());
+    if ( capacity == m_capacity ) {
+        return;
+    }
+    clear();
+    m_capacity = capacity;
+    const qsizetype memoryCapacity = std::min(capacity, m_memoryCapacity);
+    m_memory.setCapacity(memoryCapacity);
+    m_disk.setCapacity(capacity - memoryCapacity);
+}
+
+void TileCache::insert(quint32 id, const QImage& tile) {
+    if ( m_disk.contains(id) ) {
+        removeFile(id);
+        m_disk.remove(id);
+    }
+    const QImage image = tile.format() == QImage::Format_RGB32 ? tile : tile.convertToFormat(QImage::Format_RGB32);
+    demote(m_memory.insert(id, image));
+}
+
+QImage TileCache::find(quint32 id) {
+    if ( const QImage* cached = m_memory.find(id) ) {
+        return *cached;
+    }
+
+    const QImage* spilled = m_disk.find(id);
+    if ( !spilled ) {
+        return QImage();
+    }
+    QImage image = spilled->isNull() ? load(id) : *spilled;
+    removeFile(id);
+    m_disk.remove(id);
+    if ( image.isNull() ) {
+        qCWarning(lcClient) << "TileCache: failed to read spilled tile" << id;
+        return image;
+    }
+
+    // 读回内存层最近使用端，内存层淘汰的条目进入磁盘层最近使用端
+    demote(m_memory.insert(id, image));
+    return image;
+}
+
+bool TileCache::apply(const TileUpdate& update, QImage& canvas) {
+    const QSize frameSize(update.width, update.height);
+    if ( canvas.size() != frameSize || canvas.format() != QImage::Format_RGB32 ) {
+        canvas = QImage(frameSize, QImage::Format_RGB32);
+        canvas.fill(Qt::black);
+    }
+
+    bool painted = false;
+    for ( const CopyRect& copy : update.copies ) {
+        copyWithin(canvas, copy);
+        painted = true;
+    }
+    for ( const TileRecord& record : update.records ) {
+        switch ( record.kind ) {
+            case TileRecordKind::CACHED: {
+                const QImage tile = find(record.cacheId);
+                if ( tile.isNull() ) {
+                    ++m_misses;
+                    qCWarning(lcClient) << "TileCache miss, id:" << record.cacheId << "at" << record.rect();
+                    break;
+                }
+                blit(canvas, tile, record.x, record.y);
+                painted = true;
+                break;
+            }
+            case TileRecordKind::ENCODED: {
+                QImage tile;
+                if ( !tile.loadFromData(record.data, "JPEG") ) {
+                    // 仍然占用该ID，保持与服务端镜像的插入顺序一致
+                    qCWarning(lcClient) << "TileCache: failed to decode tile" << record.cacheId;
+                    tile = QImage(record.width, record.height, QImage::Format_RGB32);
+                    tile.fill(Qt::black);
+                }
+                tile = tile.convertToFormat(QImage::Format_RGB32);
+                insert(record.cacheId, tile);
+                blit(canvas, tile, record.x, record.y);
+                painted = true;
+                break;
+            }
+            case TileRecordKind::STORE:
+                insert(record.cacheId, canvas.copy(record.rect()));
+                break;
+            case TileRecordKind::VIDEO: {
+                // 视频区域可能缩小传输：放大到记录矩形；不入缓存，解码失败时保留旧画面
+                QImage tile;
+                if ( !tile.loadFromData(record.data, "JPEG") ) {
+                    qCWarning(lcClient) << "TileCache: failed to decode video region" << record.rect();
+                    break;
+                }
+                if ( tile.size() != record.rect().size() ) {
+                    tile = tile.scaled(record.rect().size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                }
+                blit(canvas, tile.convertToFormat(QImage::Format_RGB32), record.x, record.y);
+                painted = true;
+                break;
+            }
+        }
+    }
+    return painted;
+}
+
+void TileCache::clear() {
+    m_memory.clear();
+    m_disk.clear();
+    m_misses = 0;
+    // 删除临时目录及其中的图块文件，下次溢出时重新创建
+    m_spillDir.reset();
+}
+
+void TileCache::demote(std::optional<std::pair<quint32, QImage>> entry) {
+    if ( !entry || m_disk.capacity() == 0 ) {
+        return;
+    }
+    QImage image = entry->second;
+    if ( spill(entry->first, image) ) {
+        image = QImage();
+    }
+    const auto evicted = m_disk.insert(entry->first, image);
+    if ( evicted && evicted->second.isNull() ) {
+        removeFile(evicted->first);
+    }
+}
+
+bool TileCache::spill(quint32 id, const QImage& tile) {
+    if ( !m_spillDir ) {
+        m_spillDir = std::make_unique<QTemporaryDir>(QDir::tempPath() + QStringLiteral("/qtremotedesktop-tiles-XXXXXX"));
+        if ( !m_spillDir->isValid() ) {
+            qCWarning(lcClient) << "TileCache: cannot create spill directory:" << m_spillDir->errorString();
+        }
+    }
+    if ( !m_spillDir->isValid() ) {
+        return false;
+    }
+
+    QFile file(filePath(id));
+    if ( !file.open(QIODevice::WriteOnly | QIODevice::Truncate) ) {
+        return false;
+    }
+    char header[TILE_FILE_HEADER_SIZE];
+    qToLittleEndian<quint16>(static_cast<quint16>(tile.width()), header);
+    qToLittleEndian<quint16>(static_cast<quint16>(tile.height()), header + sizeof(quint16));
+    bool ok = file.write(header, TILE_FILE_HEADER_SIZE) == TILE_FILE_HEADER_SIZE;
+    const qsizetype lineBytes = qsizetype(tile.width()) * 4;
+    for ( int y = 0; ok && y < tile.height(); ++y ) {
+        ok = file.write(reinterpret_cast<const char*>(tile.constScanLine(y)), lineBytes) == lineBytes;
+    }
+    if ( !ok ) {
+        file.remove();
+    }
+    return ok;
+}
+
+QImage TileCache::load(quint32 id) const {
+    QFile file(filePath(id));
+    if ( !file.open(QIODevice::ReadOnly) ) {
+        return QImage();
+    }
+    char header[TILE_FILE_HEADER_SIZE];
+    if ( file.read(header, TILE_FILE_HEADER_SIZE) != TILE_FILE_HEADER_SIZE ) {
+        return QImage();
+    }
+    const int width = qFromLittleEndian<quint16>(header);
+    const int height = qFromLittleEndian<quint16>(header + sizeof(quint16));
+    QImage image(width, height, QImage::Format_RGB32);
+    if ( image.isNull() ) {
+        return QImage();
+    }
+    const qsizetype lineBytes = qsizetype(width) * 4;
+    for ( int y = 0; y < height; ++y ) {
+        if ( file.read(reinterpret_cast<char*>(image.scanLine(y)), lineBytes) != lineBytes ) {
+            return QImage();
+        }
+    }
+    return image;
+}
+
+void TileCache::removeFile(quint32 id) const {
+    if ( m_spillDir && m_spillDir->isValid() ) {
+        QFile::remove(filePath(id));
+    }
+}
+
+QString TileCache::filePath(quint32 id) const {
+    return m_spillDir->filePath(QString::number(id));
+}
+
+void TileCache::blit(QImage& canvas, const QImage& tile, int x, int y) {
+    const QRect target = QRect(x, y, tile.width(), tile.height()).intersected(canvas.rect());
+    if ( tile.isNull() || target.isEmpty() ) {
+        return;
+    }
+    const qsizetype lineBytes = qsizetype(target.width()) * 4;
+    for ( int row = 0; row < target.height(); ++row ) {
+        std::memcpy(canvas.scanLine(target.y() + row) + qsizetype(target.x()) * 4, tile.constScanLine(row), lineBytes);
+    }
+}
+
+void TileCache::copyWithin(QImage& canvas, const CopyRect& copy) {
+    if ( !canvas.rect().contains(copy.sourceRect()) || !canvas.rect().contains(copy.targetRect()) ) {
+        return;
+    }
+    // 源与目标重叠：向下移动时从最后一行开始复制，行内重叠由 memmove 处理
+    uchar* bits = canvas.bits();
+    const qsizetype stride = canvas.bytesPerLine();
+    const qsizetype lineBytes = qsizetype(copy.width) * 4;
+    const bool bottomUp = copy.y > copy.srcY;
+    for ( int i = 0; i < copy.height; ++i ) {
+        const int row = bottomUp ? copy.height - 1 - i : i;
+        std::memmove(bits + (copy.y + row) * stride + qsizetype(copy.x) * 4,
+            bits + (copy.srcY + row) * stride + qsizetype(copy.srcX) * 4, lineBytes);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../../common/core/cache/LruCache.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include "../../common/core/network/Protocol.h"
+#include <QtCore/QString>
+#include <QtGui/QImage>
+#include <memory>
+#include <optional>
+#include <utility>
+
+class QTemporaryDir;
+
+/**
+ * @brief 客户端图块缓存（内存 + 可选磁盘溢出）
+ *
+ * 以服务端分配的缓存ID索引图块。逻辑上是一个容量为 capacity() 的 LRU，
+ * 与服务端 TileCacheMirror 同容量、按相同顺序操作；实现上分为两层：
+ * - 最近使用的 memoryCapacity 个条目保留在内存
+ * - 启用磁盘溢出（maxSpillBytes > 0）时，其余条目写入临时目录，再次访问时读回内存层；
+ *   磁盘层条目数按 maxSpillBytes / SPILL_FILE_BYTES 限制
+ * 容量不会超过 maxCapacity()，握手时应声明该值，协商容量才不超出缓存实际能容纳的条目数。
+ * 内存层淘汰的条目进入磁盘层的最近使用端，磁盘层读回的条目进入内存层的最近使用端，
+ * 两层合起来的淘汰顺序与单个同容量 LRU 相同。写盘失败的条目仍占磁盘层位置但保存在内存中，
+ * 不影响与服务端的一致性。临时目录随缓存销毁删除，不跨会话保留。
+ *
+ * 由所属线程独占使用（非线程安全）。
+ */
+class TileCache {
+public:
+    /// 单个溢出文件的最大字节数（文件头 + TILE_SIZE x TILE_SIZE 个 RGB32 像素）
+    static constexpr qsizetype SPILL_FILE_BYTES =
+        2 * sizeof(quint16) + qsizetype(NetworkConstants::TILE_SIZE) * NetworkConstants::TILE_SIZE * 4;
+
+    /**
+     * @brief 构造函数
+     * @param memoryCapacity 内存层条目数
+     * @param maxSpillBytes 磁盘溢出上限（字节），0 表示不落盘
+     */
+    explicit TileCache(qsizetype memoryCapacity, qsizetype maxSpillBytes = 0);
+    ~TileCache();
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    /// 设置总容量（握手协商值，不超过 maxCapacity()）；容量变化时清空
+    void setCapacity(qsizetype capacity);
+    qsizetype capacity() const { return m_capacity; }
+    qsizetype maxCapacity() const { return m_memoryCapacity + m_maxSpillEntries; }
+    qsizetype size() const { return m_memory.size() + m_disk.size(); }
+    qsizetype spilledCount() const { return m_disk.size(); }
+
+    /// 插入或替换图块（转换为 RGB32）并标记为最近使用
+    void insert(quint32 id, const QImage& tile);
+
+    /// 查找并标记为最近使用；未命中返回空图像
+    QImage find(quint32 id);
+
+    /**
+     * @brief 按顺序应用区域复制与图块记录
+     * @param canvas 当前画面：先在其中复制区域，再绘制 CACHED/ENCODED/VIDEO，STORE 从中截取；尺寸或格式不符时重建
+     * @return 画面是否有变化（只有 STORE 记录时为 false）
+     */
+    bool apply(const TileUpdate& update, QImage& canvas);
+
+    /// 自上次清空以来的未命中次数（正常情况下应为 0）
+    quint64 misses() const { return m_misses; }
+
+    void clear();
+
+private:
+    void demote(std::optional<std::pair<quint32, QImage>> entry);
+    bool spill(quint32 id, const QImage& tile);
+    QImage load(quint32 id) const;
+    void removeFile(quint32 id) const;
+    QString filePath(quint32 id) const;
+    static void blit(QImage& canvas, const QImage& tile, int x, int y);
+    static void copyWithin(QImage& canvas, const CopyRect& copy);
+
+    qsizetype m_capacity;
+    qsizetype m_memoryCapacity;
+    qsizetype m_maxSpillEntries;             ///< 磁盘层条目数上限（未启用溢出时为 0）
+    LruCache<quint32, QImage> m_memory;
+    LruCache<quint32, QImage> m_disk;        ///< 值为空表示已写入磁盘，否则为写盘失败时保留的图像
+    std::unique_ptr<QTemporaryDir> m_spillDir;
+    quint64 m_misses;
+};
@@ -12,6 +12,7 @@ ConnectionManager::ConnectionManager(QObject* parent)
     , m_connectionState(Disconnected)
     , m_currentPort(0)
     , m_connectionTimer(new QTimer(this))
+    , m_tileCacheCapacity(static_cast<quint32>(NetworkConstants::TILE_CACHE_SIZE))
     , m_reconnectTimer(new QTimer(this))
     , m_autoReconnect(false)
     , m_reconnectInterval(DEFAULT_RECONNECT_INTERVAL)
@@ -118,6 +119,14 @@ int ConnectionManager::currentPort() const {
     return m_currentPort;
 }
 
+CapabilitySet ConnectionManager::serverCapabilities() const {
+    return m_serverCapabilities;
+}
+
+void ConnectionManager::setTileCacheCapacity(quint32 entries) {
+    m_tileCacheCapacity = entries;
+}
+
 // 业务逻辑接口实现
 void ConnectionManager::authenticate(const QString& username, const QString& password) {
     if ( !isConnected() ) {
@@ -192,6 +201,7 @@ void ConnectionManager::onTcpConnected() {
     m_connectionTimer->stop();
     stopAutoReconnect();
     m_currentReconnectAttempts = 0; // 重置重连计数
+    m_serverCapabilities = CapabilitySet();
     setConnectionState(Connected);
 
     // 连接成功后发送握手请求
@@ -262,6 +272,7 @@ void ConnectionManager::setupTcpClient() {
     connect(m_tcpClient, &TcpClient::disconnected, this, &ConnectionManager::onTcpDisconnected);
     connect(m_tcpClient, &TcpClient::errorOccurred, this, &ConnectionManager::onTcpError);
     connect(m_tcpClient, &TcpClient::messageReceived, this, &ConnectionManager::onTcpMessageReceived);
+    connect(m_tcpClient, &TcpClient::clockSyncUpdated, this, &ConnectionManager::clockSyncUpdated);
 }
 
 void ConnectionManager::cleanupConnection() {
@@ -271,6 +282,7 @@ void ConnectionManager::cleanupConnection() {
 
     m_currentHost.clear();
     m_currentPort = 0;
+    m_serverCapabilities = CapabilitySet();
 }
 
 // 设置连接超时
@@ -315,6 +327,14 @@ void ConnectionManager::handleHandshakeResponse(const QByteArray& data) {
         qCDebug(lcClient)
             << "Screen resolution:" << response.screenWidth << "x" << response.screenHeight;
 
+        // 服务端回复的是共同能力；再与本端取交集以防服务端回复了本端不认识的ID
+        m_serverCapabilities = response.capabilities.intersected(CapabilitySet::local());
+        qCDebug(lcClient)
+            << "Negotiated capabilities:" << m_serverCapabilities.entries.keys();
+
+        // 校验算法已由 TcpClient 在解析到握手响应时切换（同一批数据中的后续消息按新算法解析）
+        m_tcpClient->setFragmentationEnabled(m_serverCapabilities.has(Capability::FRAGMENTATION));
+
         // 发送认证请求
         sendAuthenticationRequest(m_username.isEmpty() ? "guest" : m_username,
             m_password.isEmpty() ? "" : m_password);
@@ -392,6 +412,9 @@ void ConnectionManager::sendHandshakeRequest() {
     request.colorDepth = 32;
     request.clientName = QStringLiteral("QtRemoteDesktop Client");
     request.clientOS = getClientOS();
+    request.capabilities = CapabilitySet::local();
+    request.capabilities.setUInt32(Capability::CHECKSUM, Checksum::supportedMask(m_tcpClient->isEncrypted()));
+    request.capabilities.setUInt32(Capability::TILE_CACHE, m_tileCacheCapacity);
 
     m_tcpClient->sendMessage(MessageType::HANDSHAKE_REQUEST, request);
 
@@ -57,6 +57,12 @@ public:
     QString currentHost() const;
     int currentPort() const;
 
+    // 握手协商得到的共同能力（参数为服务端取值；旧版本服务端为空）
+    CapabilitySet serverCapabilities() const;
+
+    // 握手时声明的图块缓存容量（客户端缓存实际能容纳的条目数），下次握手生效
+    void setTileCacheCapacity(quint32 entries);
+
     // 认证接口
     void authenticate(const QString& username, const QString& password);
 
@@ -83,6 +89,9 @@ signals:
     // 通用消息转发信号 - 供上层业务处理
     void messageReceived(MessageType type, const QByteArray& payload);
 
+    // 时钟同步估计更新（offset = 服务端时钟 - 本地时钟）
+    void clockSyncUpdated(double offsetMs, double rttMs);
+
 private slots:
     void onTcpConnected();
     void onTcpDisconnected();
@@ -118,6 +127,10 @@ private:
     QString m_username;
     QString m_password;
 
+    // 协商能力
+    CapabilitySet m_serverCapabilities;
+    quint32 m_tileCacheCapacity;
+
     // 自动重连相关
     QTimer* m_reconnectTimer;
     bool m_autoReconnect;
@@ -11,6 +11,7 @@
 TcpClient::TcpClient(QObject* parent)
     : QObject(parent)
     , m_socket(new QSslSocket(this))
+    , m_sendQueue([this](const char* data, qint64 length) { return m_socket->write(data, length); })
     , m_heartbeatCheckTimer(new QTimer(this))
     , m_disconnectTimeoutTimer(new QTimer(this)) {
 
@@ -22,6 +23,9 @@ TcpClient::TcpClient(QObject* parent)
     // 连接 socket 信号到本类槽函数
     connect(m_socket, &QSslSocket::disconnected, this, &TcpClient::onDisconnected);
     connect(m_socket, &QSslSocket::readyRead, this, &TcpClient::onReadyRead);
+    // 套接字写缓冲区排空时继续写出批量通道
+    connect(m_socket, &QSslSocket::bytesWritten, this, [this](qint64) { flushSendQueue(); });
+    connect(m_socket, &QSslSocket::encryptedBytesWritten, this, [this](qint64) { flushSendQueue(); });
     connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QSslSocket::errorOccurred),
         this, &TcpClient::onError);
     connect(m_socket, &QSslSocket::encrypted, this, &TcpClient::onEncrypted);
@@ -75,6 +79,7 @@ void TcpClient::connectToHost(const QString& hostName, quint16 port) {
 
     m_hostName = hostName;
     m_port = port;
+    resetSendState();
 
     // 使用TLS加密连接
     m_socket->connectToHostEncrypted(hostName, port);
@@ -89,6 +94,7 @@ void TcpClient::disconnectFromHost() {
 
     // 清理接收缓冲区
     m_receiveBuffer.clear();
+    m_fragmentAssembler.clear();
 
     // 如果仍处于连接状态，优雅断开连接
     if ( m_socket->state() == QAbstractSocket::ConnectedState ) {
@@ -109,8 +115,9 @@ void TcpClient::disconnectFromHost() {
 void TcpClient::abort() {
     m_heartbeatCheckTimer->stop();
 
-    // 清理接收缓冲区
+    // 清理接收缓冲区与未发送数据
     m_receiveBuffer.clear();
+    resetSendState();
 
     m_socket->abort();
 }
@@ -119,6 +126,48 @@ bool TcpClient::isConnected() const {
     return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
 }
 
+bool TcpClient::isEncrypted() const {
+    return m_socket && m_socket->isEncrypted();
+}
+
+void TcpClient::setChecksumAlgorithm(ChecksumAlgorithm algorithm) {
+    m_checksumAlgorithm = algorithm;
+    m_sendQueue.setChecksumAlgorithm(algorithm);
+    qCInfo(lcClient) << "TcpClient: checksum algorithm set to" << Checksum::algorithmName(algorithm);
+}
+
+void TcpClient::applyNegotiatedChecksum(const QByteArray& handshakeResponse) {
+    HandshakeResponse response;
+    if ( !response.decode(handshakeResponse) || !response.capabilities.has(Capability::CHECKSUM) ) {
+        return;
+    }
+    const quint32 chosen = response.capabilities.uint32Param(Capability::CHECKSUM,
+        static_cast<quint32>(ChecksumAlgorithm::CRC32));
+    const quint32 offered = Checksum::supportedMask(isEncrypted());
+    if ( chosen <= static_cast<quint32>(ChecksumAlgorithm::NONE)
+        && (offered & Checksum::maskOf(static_cast<ChecksumAlgorithm>(chosen))) ) {
+        setChecksumAlgorithm(static_cast<ChecksumAlgorithm>(chosen));
+    } else {
+        qCWarning(lcClient) << "TcpClient: server chose unsupported checksum algorithm:" << chosen;
+    }
+}
+
+ChecksumAlgorithm TcpClient::checksumAlgorithm() const {
+    return m_checksumAlgorithm;
+}
+
+void TcpClient::setFragmentationEnabled(bool enabled) {
+    m_sendQueue.setFragmentSize(enabled ? NetworkConstants::FRAGMENT_SIZE : 0);
+}
+
+void TcpClient::resetSendState() {
+    m_checksumAlgorithm = ChecksumAlgorithm::CRC32;
+    m_sendQueue.clear();
+    m_sendQueue.setChecksumAlgorithm(ChecksumAlgorithm::CRC32);
+    m_sendQueue.setFragmentSize(0);
+    m_fragmentAssembler.clear();
+}
+
 QString TcpClient::serverAddress() const {
     return m_hostName;
 }
@@ -133,10 +182,21 @@ void TcpClient::sendMessage(MessageType type, const IMessageCodec& message) {
         return;
     }
 
-    // 使用编解码器创建帧
-    QByteArray messageData = Protocol::createMessage(type, message);
+    // 使用编解码器创建帧，按通道排队后立即尝试写出
+    m_sendQueue.enqueue(Protocol::createMessageSegments(type, message, m_checksumAlgorithm));
+    flushSendQueue();
+}
 
-    m_socket->write(messageData);
+void TcpClient::flushSendQueue() {
+    if ( !isConnected() || m_sendQueue.isEmpty() ) {
+        return;
+    }
+
+    const qint64 pending = m_socket->bytesToWrite() + m_socket->encryptedBytesToWrite();
+    if ( m_sendQueue.flush(pending) < 0 ) {
+        qCWarning(lcClient) << "TcpClient: write failed:" << m_socket->errorString();
+        m_sendQueue.clear();
+    }
 }
 
 void TcpClient::onConnected() {
@@ -153,6 +213,9 @@ void TcpClient::onEncrypted() {
     m_socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, NetworkConstants::SOCKET_SEND_BUFFER_SIZE);
     m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, NetworkConstants::SOCKET_RECEIVE_BUFFER_SIZE);
 
+    // 新连接重新开始时钟同步
+    m_clockSync.reset();
+
     // 启动心跳超时检查定时器（用于检测服务端心跳）
     m_lastHeartbeat = QDateTime::currentDateTime();
     m_heartbeatCheckTimer->start();
@@ -183,8 +246,9 @@ void TcpClient::onDisconnected() {
     // 停止心跳检查定时器
     m_heartbeatCheckTimer->stop();
 
-    // 清理接收缓冲区
+    // 清理接收缓冲区与未发送数据
     m_receiveBuffer.clear();
+    resetSendState();
 
     // Guard: do not emit signals during destruction — parent objects may
     // already be partially destroyed, causing use-after-free / abort()
@@ -245,42 +309,58 @@ void TcpClient::onReadyRead() {
         return;
     }
 
-    // 一次性读取所有可用数据
-    QByteArray newData = m_socket->readAll();
-    if ( newData.isEmpty() ) {
+    // 检查缓冲区大小，防止无限增长
+    const qint64 available = m_socket->bytesAvailable();
+    if ( available <= 0 ) {
         return;
     }
-
-    // 检查缓冲区大小，防止无限增长
-    if ( m_receiveBuffer.size() + newData.size() > NetworkConstants::MAX_PACKET_SIZE ) {
+    if ( m_receiveBuffer.size() + available > NetworkConstants::MAX_PACKET_SIZE ) {
         qCCritical(lcClient) << "接收缓冲区超过最大限制:" << NetworkConstants::MAX_PACKET_SIZE
             << "当前大小:" << m_receiveBuffer.size()
-            << "新增数据:" << newData.size();
+            << "新增数据:" << available;
         abort();
         return;
     }
 
-    // 预留空间以减少内存分配次数
-    m_receiveBuffer.reserve(m_receiveBuffer.size() + newData.size());
-    m_receiveBuffer.append(newData);
+    // 直接读入接收缓冲区的预分配空间（无临时拷贝）
+    const qint64 bytesRead = m_receiveBuffer.readFrom(m_socket);
+    if ( bytesRead <= 0 ) {
+        return;
+    }
 
     // 更新心跳时间
     m_lastHeartbeat = QDateTime::currentDateTime();
 
+    // 记录数据到达时间（用于心跳时钟同步，避免计入排队处理时间）
+    const qint64 receivedAtMs = QDateTime::currentMSecsSinceEpoch();
+
     // 处理缓冲区中的完整消息
     while ( !m_receiveBuffer.isEmpty() ) {
         // 步骤1：先验证数据完整性，同时获取MessageHeader
         MessageHeader header;
-        QByteArray payload;
-        qsizetype result = Protocol::parseMessage(m_receiveBuffer, header, payload);
-        if ( result > 0 ) {
-            // 步骤3：移除已处理的数据
-            m_receiveBuffer.remove(0, result);
+        QByteArrayView payloadView;
+        qsizetype result = Protocol::parseMessage(m_receiveBuffer.view(), header, payloadView, m_checksumAlgorithm);
+        if ( result > 0 && header.type == MessageType::FRAGMENT ) {
+            // 分片直接在接收缓冲区上重组，完整后再按普通消息分发
+            handleFragment(payloadView, receivedAtMs);
+            m_receiveBuffer.consume(result);
+        } else if ( result > 0 ) {
+            // 步骤2：消息异步处理且接收缓冲区会被复用，这里做唯一一次载荷拷贝
+            QByteArray payload = payloadView.toByteArray();
+
+            // 步骤3：前移读游标（不搬移剩余数据）
+            m_receiveBuffer.consume(result);
+
+            // 服务端发出握手响应后即切换校验算法：同一批数据中紧随其后的消息必须按新算法解析，
+            // 因此在解析循环中同步切换，而不是等排队的 processMessage
+            if ( header.type == MessageType::HANDSHAKE_RESPONSE ) {
+                applyNegotiatedChecksum(payload);
+            }
 
             // 步骤4：异步处理消息，使用 QMetaObject::invokeMethod 调度到主线程
             // 这样可以避免跨线程访问 QTcpSocket 的问题
-            QMetaObject::invokeMethod(this, [this, header, payload]() {
-                processMessage(header, payload);
+            QMetaObject::invokeMethod(this, [this, header, payload, receivedAtMs]() {
+                processMessage(header, payload, receivedAtMs);
             }, Qt::QueuedConnection);
         } else if ( result == 0 ) {
             // 消息无效，清空缓冲区
@@ -293,10 +373,42 @@ void TcpClient::onReadyRead() {
     }
 }
 
-void TcpClient::processMessage(const MessageHeader& header, const QByteArray& payload) {
+void TcpClient::handleFragment(QByteArrayView payload, qint64 receivedAtMs) {
+    MessageFragment fragment;
+    QByteArray message;
+    if ( !fragment.decodeView(payload) ) {
+        qCWarning(lcClient) << "TcpClient: invalid fragment";
+        return;
+    }
+
+    switch ( m_fragmentAssembler.addFragment(fragment, message) ) {
+        case FragmentAssembler::Result::Incomplete:
+            return;
+        case FragmentAssembler::Result::Invalid:
+            qCWarning(lcClient) << "TcpClient: dropping fragmented message" << fragment.messageId;
+            return;
+        case FragmentAssembler::Result::Complete:
+            break;
+    }
+
+    MessageHeader header;
+    QByteArrayView innerPayload;
+    const qsizetype result = Protocol::parseMessage(message, header, innerPayload, m_checksumAlgorithm);
+    if ( result != message.size() || header.type == MessageType::FRAGMENT ) {
+        qCWarning(lcClient) << "TcpClient: reassembled message is invalid" << fragment.messageId;
+        return;
+    }
+
+    QByteArray innerData = innerPayload.toByteArray();
+    QMetaObject::invokeMethod(this, [this, header, innerData, receivedAtMs]() {
+        processMessage(header, innerData, receivedAtMs);
+    }, Qt::QueuedConnection);
+}
+
+void TcpClient::processMessage(const MessageHeader& header, const QByteArray& payload, qint64 receivedAtMs) {
     // 心跳消息特殊处理（底层网络层直接处理）
     if (header.type == MessageType::HEARTBEAT) {
-        handleHeartbeat();
+        handleHeartbeat(payload, receivedAtMs);
         return;
     }
     
@@ -304,12 +416,28 @@ void TcpClient::processMessage(const MessageHeader& header, const QByteArray& pa
     emit messageReceived(header.type, payload);
 }
 
-void TcpClient::handleHeartbeat() {
+void TcpClient::handleHeartbeat(const QByteArray& payload, qint64 receivedAtMs) {
     // 收到服务端的心跳请求，更新最后心跳时间并发送响应
     m_lastHeartbeat = QDateTime::currentDateTime();
 
-    // 发送心跳响应
-    sendMessage(MessageType::HEARTBEAT_RESPONSE, BaseMessage());
+    // 旧版本服务端的心跳不带时间戳，只回复空响应
+    HeartbeatMessage heartbeat;
+    if ( !heartbeat.decode(payload) ) {
+        sendMessage(MessageType::HEARTBEAT_RESPONSE, BaseMessage());
+        qCDebug(lcClient) << "收到服务端心跳请求（无时间戳），已发送响应";
+        return;
+    }
+
+    if ( m_clockSync.processIncoming(heartbeat, static_cast<quint64>(receivedAtMs)) ) {
+        ClockSyncEstimate estimate = m_clockSync.estimate();
+        qCDebug(lcClient) << "时钟同步更新: offset=" << estimate.offsetMs << "ms, rtt=" << estimate.rttMs
+            << "ms, 样本数:" << estimate.sampleCount;
+        emit clockSyncUpdated(estimate.offsetMs, estimate.rttMs);
+    }
+
+    // 回显服务端发送时间并附带本端收发时间
+    HeartbeatMessage response = m_clockSync.prepareOutgoing(static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()));
+    sendMessage(MessageType::HEARTBEAT_RESPONSE, response);
 
     qCDebug(lcClient) << "收到服务端心跳请求，已发送响应";
 }
@@ -5,6 +5,10 @@
 #include <QtNetwork/QAbstractSocket>
 #include <QtNetwork/QSslError>
 #include "../common/core/network/Protocol.h"
+#include "../common/core/network/ClockSynchronizer.h"
+#include "../common/core/network/ReceiveBuffer.h"
+#include "../common/core/network/PrioritySendQueue.h"
+#include "../common/core/network/FragmentAssembler.h"
 #include "../common/core/config/NetworkConstants.h"
 
 class QSslSocket;
@@ -34,6 +38,7 @@ public:
 
     // 连接状态
     bool isConnected() const;
+    bool isEncrypted() const;
 
     // 服务器信息
     QString serverAddress() const;
@@ -42,11 +47,20 @@ public:
     // 消息发送 - 底层接口
     void sendMessage(MessageType type, const IMessageCodec& message);
 
+    // 握手协商的校验算法，收发双向同时生效（断开连接后恢复为 CRC32）
+    ChecksumAlgorithm checksumAlgorithm() const;
+
+    // 服务端声明 FRAGMENTATION 后启用：大消息分片发送，交互消息可插在分片之间
+    void setFragmentationEnabled(bool enabled);
+
 signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString& error);
 
+    // 时钟同步估计更新（offset = 服务端时钟 - 本地时钟）
+    void clockSyncUpdated(double offsetMs, double rttMs);
+
     // 通用消息接收信号 - 由 ConnectionManager 处理具体业务逻辑
     void messageReceived(MessageType type, const QByteArray& payload);
 
@@ -59,14 +73,22 @@ private slots:
     void onEncrypted();
 
 private:
-    void processMessage(const MessageHeader& header, const QByteArray& payload);
-    void handleHeartbeat();
+    void processMessage(const MessageHeader& header, const QByteArray& payload, qint64 receivedAtMs);
+    void applyNegotiatedChecksum(const QByteArray& handshakeResponse);
+    void setChecksumAlgorithm(ChecksumAlgorithm algorithm);
+    void handleHeartbeat(const QByteArray& payload, qint64 receivedAtMs);
     void checkHeartbeat();
     void configureSsl();
+    void flushSendQueue();
+    void handleFragment(QByteArrayView payload, qint64 receivedAtMs);
+    void resetSendState();
 
     // 网络
     QSslSocket* m_socket;
-    QByteArray m_receiveBuffer;
+    ReceiveBuffer m_receiveBuffer;
+    ChecksumAlgorithm m_checksumAlgorithm = ChecksumAlgorithm::CRC32;
+    PrioritySendQueue m_sendQueue;
+    FragmentAssembler m_fragmentAssembler;
 
     // 连接信息
     QString m_hostName;
@@ -76,6 +98,9 @@ private:
     QTimer* m_heartbeatCheckTimer;
     QDateTime m_lastHeartbeat;
 
+    // 基于心跳时间戳的时钟偏移/RTT估计
+    ClockSynchronizer m_clockSync;
+
     // Disconnect timeout timer (replaces anonymous QTimer::singleShot to ensure
     // safe cleanup during moveToThread and object destruction)
     QTimer* m_disconnectTimeoutTimer;
@@ -56,6 +56,8 @@ ClientRemoteWindow::ClientRemoteWindow(SessionManager* sessionManager, QWidget*
     , m_hostName()  // 初始化为空,将由外部通过 updateWindowTitle 设置
     , m_inputEnabled(true)
     , m_lastMousePos(-1, -1)
+    , m_swallowedKey(0)
+    , m_remoteMonitorCount(0)
     , m_fileTransferManager(nullptr)
     , m_renderManager(nullptr)
     , m_cursorManager(nullptr)
@@ -220,6 +222,10 @@ void ClientRemoteWindow::setupManagerConnections() {
         // 连接状态变化信号,同步更新 UI 显示
         connect(m_sessionManager, &SessionManager::connectionStateChanged,
             this, &ClientRemoteWindow::setConnectionState);
+
+        // 缓存服务端显示器数，决定 Ctrl+Alt+数字 是本地快捷键还是转发给远端
+        connect(m_sessionManager, &SessionManager::monitorLayoutChanged,
+            this, [this](int monitorCount) { m_remoteMonitorCount = monitorCount; });
     }
 
     // Connect cursor manager signals
@@ -227,6 +233,19 @@ void ClientRemoteWindow::setupManagerConnections() {
         // 连接远程光标类型更新信号
         connect(m_sessionManager, &SessionManager::remoteCursorTypeUpdated,
             m_cursorManager, &CursorManager::setRemoteCursorType);
+
+        // 远程光标位置更新只重绘光标覆盖的区域
+        connect(m_sessionManager, &SessionManager::remoteCursorPositionUpdated,
+            m_cursorManager, &CursorManager::setRemoteCursorPosition);
+        connect(m_sessionManager, &SessionManager::remoteCursorImageUpdated,
+            m_cursorManager, &CursorManager::setRemoteCursorImage);
+        connect(m_cursorManager, &CursorManager::overlayChanged,
+            this, [this](const QPoint& oldPosition, const QPoint& newPosition) {
+            viewport()->update(m_cursorManager->overlayRect(mapFromRemote(oldPosition)));
+            if ( newPosition != oldPosition ) {
+                viewport()->update(m_cursorManager->overlayRect(mapFromRemote(newPosition)));
+            }
+        });
     }
 
     // Connect file transfer manager signals  
@@ -421,6 +440,11 @@ void ClientRemoteWindow::paintEvent(QPaintEvent* event) {
 
     QPainter painter(viewport());
 
+    // 远程光标叠加层（本地指针不在窗口内时）
+    if ( m_cursorManager && m_cursorManager->isOverlayVisible() ) {
+        m_cursorManager->drawRemoteCursor(painter, mapFromRemote(m_cursorManager->remoteCursorPosition()));
+    }
+
     // Draw performance info if enabled
     if ( m_showPerformanceInfo ) {
         drawPerformanceInfo(painter);
@@ -557,6 +581,10 @@ void ClientRemoteWindow::wheelEvent(QWheelEvent* event) {
 }
 
 void ClientRemoteWindow::keyPressEvent(QKeyEvent* event) {
+    if ( handleMonitorShortcut(event) ) {
+        event->accept();
+        return;
+    }
     if ( m_inputEnabled && m_sessionManager ) {
         QMetaObject::invokeMethod(m_sessionManager, "sendKeyboardEvent",
             Qt::QueuedConnection,
@@ -569,6 +597,13 @@ void ClientRemoteWindow::keyPressEvent(QKeyEvent* event) {
 }
 
 void ClientRemoteWindow::keyReleaseEvent(QKeyEvent* event) {
+    if ( m_swallowedKey != 0 && event->key() == m_swallowedKey ) {
+        if ( !event->isAutoRepeat() ) {
+            m_swallowedKey = 0;
+        }
+        event->accept();
+        return;
+    }
     if ( m_inputEnabled && m_sessionManager ) {
         QMetaObject::invokeMethod(m_sessionManager, "sendKeyboardEvent",
             Qt::QueuedConnection,
@@ -580,6 +615,32 @@ void ClientRemoteWindow::keyReleaseEvent(QKeyEvent* event) {
     QGraphicsView::keyReleaseEvent(event);
 }
 
+bool ClientRemoteWindow::handleMonitorShortcut(QKeyEvent* event) {
+    const Qt::KeyboardModifiers modifiers = event->modifiers() & ~Qt::KeypadModifier;
+    if ( !m_sessionManager || modifiers != (Qt::ControlModifier | Qt::AltModifier)
+         || event->key() < Qt::Key_0 || event->key() > Qt::Key_9 ) {
+        return false;
+    }
+    // 只有服务端发送过布局（协商了多显示器）且请求的显示器存在时才作为本地快捷键，
+    // 否则照常转发，不吞掉远端桌面上的组合键
+    const int monitor = event->key() - Qt::Key_0;
+    const bool available = monitor == 0 ? m_remoteMonitorCount > 1 : monitor <= m_remoteMonitorCount;
+    if ( !available ) {
+        return false;
+    }
+    m_swallowedKey = event->key();
+    if ( event->isAutoRepeat() ) {
+        return true;
+    }
+    if ( event->key() == Qt::Key_0 ) {
+        QMetaObject::invokeMethod(m_sessionManager, "viewAllMonitors", Qt::QueuedConnection);
+    } else {
+        QMetaObject::invokeMethod(m_sessionManager, "viewMonitor", Qt::QueuedConnection,
+            Q_ARG(int, event->key() - Qt::Key_1));
+    }
+    return true;
+}
+
 void ClientRemoteWindow::resizeEvent(QResizeEvent* event) {
     QGraphicsView::resizeEvent(event);
 
@@ -606,6 +667,7 @@ void ClientRemoteWindow::enterEvent(QEnterEvent* event) {
 
     // 应用本地光标状态（隐藏或显示）
     if ( m_cursorManager ) {
+        m_cursorManager->setLocalPointerInside(true);
         m_cursorManager->applyLocalCursorState();
     }
 }
@@ -616,6 +678,7 @@ void ClientRemoteWindow::leaveEvent(QEvent* event) {
 
     // 恢复本地光标
     if ( m_cursorManager ) {
+        m_cursorManager->setLocalPointerInside(false);
         m_cursorManager->restoreLocalCursor();
     }
 }
@@ -141,6 +141,9 @@ private:
     // 显示断开连接对话框
     void showDisconnectionDialog();
 
+    // Ctrl+Alt+0 查看全部显示器，Ctrl+Alt+1..9 只查看第 N 个；返回是否已处理（不转发给远端）
+    bool handleMonitorShortcut(QKeyEvent* event);
+
 private:
     QString m_connectionId;
     SessionManager* m_sessionManager;
@@ -155,6 +158,8 @@ private:
 
     bool m_inputEnabled;
     QPoint m_lastMousePos;
+    int m_swallowedKey;                    ///< 已作为本地快捷键处理的按键，其释放也不转发（0 表示无）
+    int m_remoteMonitorCount;              ///< 服务端最近布局中的显示器数（未协商多显示器时为 0）
 
     FileTransferManager* m_fileTransferManager;
     RenderManager* m_renderManager;
@@ -2,11 +2,15 @@
 #include <QtWidgets/QWidget>
 #include <QtGui/QPainter>
 #include <QtGui/QPen>
+#include <QtGui/QPixmap>
 
 CursorManager::CursorManager(QWidget* targetWidget, QObject* parent)
     : QObject(parent)
     , m_targetWidget(targetWidget)
-    , m_remoteCursorType(Qt::ArrowCursor) {  // 默认箭头光标
+    , m_remoteCursorType(Qt::ArrowCursor)  // 默认箭头光标
+    , m_hasRemotePosition(false)
+    , m_remoteCursorVisible(true)
+    , m_localPointerInside(false) {
 }
 
 CursorManager::~CursorManager() {
@@ -25,12 +29,13 @@ void CursorManager::applyLocalCursorState() {
     }
 
     // 根据远程光标类型设置本地光标
-    m_targetWidget->setCursor(QCursor(m_remoteCursorType));
+    const QCursor cursor = remoteCursor();
+    m_targetWidget->setCursor(cursor);
 
     // 如果有viewport（QGraphicsView的子类），也设置它的光标
     QWidget* viewport = m_targetWidget->findChild<QWidget*>("qt_scrollarea_viewport");
     if ( viewport ) {
-        viewport->setCursor(QCursor(m_remoteCursorType));
+        viewport->setCursor(cursor);
     }
 }
 
@@ -67,20 +72,156 @@ void CursorManager::setRemoteCursorType(Qt::CursorShape type) {
         return;
     }
 
+    // 形状改变前后各重绘一次，覆盖新旧两种光标的区域
+    if ( isOverlayVisible() ) {
+        emit overlayChanged(m_remoteCursorPosition, m_remoteCursorPosition);
+    }
+
     m_remoteCursorType = type;
 
     // 更新本地光标显示
     applyLocalCursorState();
+
+    if ( isOverlayVisible() ) {
+        emit overlayChanged(m_remoteCursorPosition, m_remoteCursorPosition);
+    }
+}
+
+void CursorManager::setRemoteCursorImage(const QImage& image, const QPoint& hotspot) {
+    const bool affectsDisplay = m_remoteCursorType == Qt::BitmapCursor;
+    if ( affectsDisplay && isOverlayVisible() ) {
+        emit overlayChanged(m_remoteCursorPosition, m_remoteCursorPosition);
+    }
+
+    m_remoteCursorImage = image;
+    m_remoteCursorHotspot = hotspot;
+    m_remoteBitmapCursor = image.isNull()
+        ? QCursor(Qt::ArrowCursor)
+        : QCursor(QPixmap::fromImage(image), hotspot.x(), hotspot.y());
+
+    if ( affectsDisplay ) {
+        applyLocalCursorState();
+        if ( isOverlayVisible() ) {
+            emit overlayChanged(m_remoteCursorPosition, m_remoteCursorPosition);
+        }
+    }
+}
+
+QCursor CursorManager::remoteCursor() const {
+    if ( m_remoteCursorType == Qt::BitmapCursor ) {
+        return usesRemoteImage() ? m_remoteBitmapCursor : QCursor(Qt::ArrowCursor);
+    }
+    return QCursor(m_remoteCursorType);
+}
+
+bool CursorManager::usesRemoteImage() const {
+    return m_remoteCursorType == Qt::BitmapCursor && !m_remoteCursorImage.isNull();
 }
 
 Qt::CursorShape CursorManager::remoteCursorType() const {
     return m_remoteCursorType;
 }
 
+void CursorManager::setRemoteCursorPosition(const QPoint& position, bool visible) {
+    if ( m_hasRemotePosition && m_remoteCursorPosition == position && m_remoteCursorVisible == visible ) {
+        return;
+    }
+
+    const bool wasVisible = isOverlayVisible();
+    const QPoint oldPosition = m_hasRemotePosition ? m_remoteCursorPosition : position;
+    m_remoteCursorPosition = position;
+    m_remoteCursorVisible = visible;
+    m_hasRemotePosition = true;
+
+    if ( wasVisible || isOverlayVisible() ) {
+        emit overlayChanged(oldPosition, position);
+    }
+}
+
+void CursorManager::setLocalPointerInside(bool inside) {
+    if ( m_localPointerInside == inside ) {
+        return;
+    }
+
+    const bool wasVisible = isOverlayVisible();
+    m_localPointerInside = inside;
+    if ( wasVisible != isOverlayVisible() ) {
+        emit overlayChanged(m_remoteCursorPosition, m_remoteCursorPosition);
+    }
+}
+
+// ==================== 远程光标叠加层 ====================
+
+bool CursorManager::isOverlayVisible() const {
+    return m_hasRemotePosition && m_remoteCursorVisible && !m_localPointerInside;
+}
+
+QRect CursorManager::overlayRect(const QPoint& viewPosition) const {
+    if ( usesRemoteImage() ) {
+        return QRect(viewPosition - m_remoteCursorHotspot, m_remoteCursorImage.size()).adjusted(-1, -1, 1, 1);
+    }
+
+    // 覆盖箭头（12x19）与以热点为中心的 I 形/十字光标，外加描边余量
+    return QRect(viewPosition - QPoint(10, 10), QSize(24, 32));
+}
+
+void CursorManager::drawRemoteCursor(QPainter& painter, const QPoint& viewPosition) const {
+    if ( usesRemoteImage() ) {
+        painter.drawImage(viewPosition - m_remoteCursorHotspot, m_remoteCursorImage);
+        return;
+    }
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.translate(viewPosition);
+
+    QPen outline(Qt::black);
+    outline.setWidthF(1.0);
+
+    switch ( m_remoteCursorType ) {
+        case Qt::IBeamCursor: {
+            // 白底黑线的 I 形光标，热点在中心
+            const QLine lines[] = {
+                QLine(0, -8, 0, 8), QLine(-3, -8, 3, -8), QLine(-3, 8, 3, 8)
+            };
+            painter.setPen(QPen(Qt::white, 3.0));
+            painter.drawLines(lines, 3);
+            painter.setPen(outline);
+            painter.drawLines(lines, 3);
+            break;
+        }
+        case Qt::CrossCursor: {
+            const QLine lines[] = { QLine(-8, 0, 8, 0), QLine(0, -8, 0, 8) };
+            painter.setPen(QPen(Qt::white, 3.0));
+            painter.drawLines(lines, 2);
+            painter.setPen(outline);
+            painter.drawLines(lines, 2);
+            break;
+        }
+        default: {
+            // 其余形状统一绘制箭头，热点在尖端
+            static const QPointF arrow[] = {
+                QPointF(0, 0), QPointF(0, 16), QPointF(4, 12.5), QPointF(7, 19),
+                QPointF(9.5, 18), QPointF(6.5, 11.5), QPointF(11.5, 11.5)
+            };
+            painter.setPen(outline);
+            painter.setBrush(Qt::white);
+            painter.drawPolygon(arrow, 7);
+            break;
+        }
+    }
+
+    painter.restore();
+}
+
 // ==================== 便捷方法 ====================
 
 void CursorManager::reset() {
     m_remoteCursorType = Qt::ArrowCursor;
+    m_hasRemotePosition = false;
+    m_remoteCursorVisible = true;
+    m_remoteCursorImage = QImage();
+    m_remoteBitmapCursor = QCursor(Qt::ArrowCursor);
 
     restoreLocalCursor();
 
@@ -2,7 +2,10 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
+#include <QtCore/QRect>
 #include <QtCore/Qt>
+#include <QtGui/QCursor>
+#include <QtGui/QImage>
 #include <QtGui/QPainter>
 
 class QWidget;
@@ -12,6 +15,10 @@ class QWidget;
  *
  * 统一管理本地光标的显示/隐藏和远程光标的显示
  * 提供简洁的接口用于远程桌面应用中的光标控制
+ *
+ * 远程光标叠加层：服务端推送 CURSOR_STATE 后，本地指针不在窗口内时
+ * 由窗口在 paintEvent 中按远程坐标绘制光标，移动只重绘光标所在的小区域，
+ * 与屏幕帧的解码和刷新无关。本地指针在窗口内时本地光标即代表远程光标，不再叠加。
  */
 class CursorManager : public QObject {
     Q_OBJECT
@@ -60,6 +67,50 @@ public:
      */
     Qt::CursorShape remoteCursorType() const;
 
+    /**
+     * @brief 设置远程光标图像（远程类型为 Qt::BitmapCursor 时使用）
+     * @param image 预乘 ARGB32 光标图像
+     * @param hotspot 热点（图像坐标）
+     */
+    void setRemoteCursorImage(const QImage& image, const QPoint& hotspot);
+
+    /**
+     * @brief 设置远程光标位置
+     * @param position 服务端屏幕坐标
+     * @param visible 远程光标是否可见
+     */
+    void setRemoteCursorPosition(const QPoint& position, bool visible);
+
+    /**
+     * @brief 获取远程光标位置（服务端屏幕坐标）
+     */
+    QPoint remoteCursorPosition() const { return m_remoteCursorPosition; }
+
+    /**
+     * @brief 记录本地指针是否位于目标窗口内（在 enter/leave 事件中调用）
+     */
+    void setLocalPointerInside(bool inside);
+
+    // ==================== 远程光标叠加层 ====================
+
+    /**
+     * @brief 当前是否需要绘制远程光标叠加层
+     */
+    bool isOverlayVisible() const;
+
+    /**
+     * @brief 叠加层在视图中占用的区域（用于局部重绘）
+     * @param viewPosition 远程光标热点映射到视图后的坐标
+     */
+    QRect overlayRect(const QPoint& viewPosition) const;
+
+    /**
+     * @brief 在视图中绘制远程光标
+     * @param painter 视图绘制器
+     * @param viewPosition 远程光标热点映射到视图后的坐标
+     */
+    void drawRemoteCursor(QPainter& painter, const QPoint& viewPosition) const;
+
     // ==================== 便捷方法 ====================
 
     /**
@@ -67,10 +118,35 @@ public:
      */
     void reset();
 
+signals:
+    /**
+     * @brief 叠加层需要重绘（位置、形状或可见性变化）
+     * @param oldPosition 变化前的远程坐标
+     * @param newPosition 变化后的远程坐标
+     */
+    void overlayChanged(const QPoint& oldPosition, const QPoint& newPosition);
+
 private:
+    /**
+     * @brief 当前远程光标对应的本地 QCursor
+     */
+    QCursor remoteCursor() const;
+
+    /**
+     * @brief 是否使用远程光标图像（而非标准形状）
+     */
+    bool usesRemoteImage() const;
+
     QWidget* m_targetWidget;          ///< 目标窗口部件
 
     // 远程光标状态
     Qt::CursorShape m_remoteCursorType; ///< 远程光标类型
+    QPoint m_remoteCursorPosition;      ///< 远程光标位置（服务端屏幕坐标）
+    QImage m_remoteCursorImage;         ///< 远程光标图像
+    QPoint m_remoteCursorHotspot;       ///< 远程光标图像热点
+    QCursor m_remoteBitmapCursor;       ///< 由远程光标图像构造的本地光标
+    bool m_hasRemotePosition;           ///< 是否已收到过远程光标位置
+    bool m_remoteCursorVisible;         ///< 远程光标是否可见
+    bool m_localPointerInside;          ///< 本地指针是否在目标窗口内
 };
 
@@ -0,0 +1,32 @@
+#include "ContentHash.h"
+#include <QtCore/QtEndian>
+
+ContentHash ContentHash::of(QByteArrayView data) {
+    return fromDigest(QCryptographicHash::hash(data, QCryptographicHash::Blake2b_160));
+}
+
+ContentHash ContentHash::fromDigest(QByteArrayView digest) {
+    ContentHash hash;
+    if ( digest.size() < static_cast<qsizetype>(2 * sizeof(quint64)) ) {
+        return hash;
+    }
+    hash.high = qFromLittleEndian<quint64>(digest.constData());
+    hash.low = qFromLittleEndian<quint64>(digest.constData() + sizeof(quint64));
+    return hash;
+}
+
+ContentHasher::ContentHasher()
+    : m_hash(QCryptographicHash::Blake2b_160) {
+}
+
+void ContentHasher::addData(QByteArrayView data) {
+    m_hash.addData(data);
+}
+
+ContentHash ContentHasher::result() const {
+    return ContentHash::fromDigest(m_hash.resultView());
+}
+
+void ContentHasher::reset() {
+    m_hash.reset();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QHashFunctions>
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief 128 位内容哈希（BLAKE2b 截断）
+ *
+ * 用作缓存键：两端按内容识别同一份数据（光标图像、图块），
+ * 命中时只传输缓存ID而不重复传输数据。128 位对缓存场景的碰撞概率可忽略。
+ * 所有函数线程安全。
+ */
+struct ContentHash {
+    quint64 high = 0;
+    quint64 low = 0;
+
+    /// 计算 data 的内容哈希
+    static ContentHash of(QByteArrayView data);
+
+    /// 由 BLAKE2b 摘要构造（取前 128 位）
+    static ContentHash fromDigest(QByteArrayView digest);
+
+    bool isNull() const { return high == 0 && low == 0; }
+
+    friend bool operator==(const ContentHash& a, const ContentHash& b) {
+        return a.high == b.high && a.low == b.low;
+    }
+    friend bool operator!=(const ContentHash& a, const ContentHash& b) {
+        return !(a == b);
+    }
+};
+
+inline size_t qHash(const ContentHash& hash, size_t seed = 0) noexcept {
+    // 内容哈希本身已均匀分布，取低 64 位即可
+    return qHash(hash.low, seed);
+}
+
+/**
+ * @brief 增量计算 ContentHash
+ *
+ * 数据不连续时使用（如图像中的一个矩形区域逐行加入），
+ * 结果与把同样的字节拼接后调用 ContentHash::of() 相同。可 reset() 后复用。
+ */
+class ContentHasher {
+public:
+    ContentHasher();
+
+    void addData(QByteArrayView data);
+    ContentHash result() const;
+    void reset();
+
+private:
+    QCryptographicHash m_hash;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/qglobal.h>
+#include <algorithm>
+#include <list>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief 固定容量的 LRU 缓存
+ *
+ * 淘汰顺序只由 insert()/find() 的调用顺序决定，因此两端用相同容量、
+ * 按相同顺序操作时（发送端镜像索引与接收端缓存），淘汰结果完全一致，
+ * 发送端据此判断接收端是否仍持有某个条目。
+ *
+ * 非线程安全，由所属线程独占使用。
+ */
+template <typename Key, typename Value>
+class LruCache {
+public:
+    explicit LruCache(qsizetype capacity = 0)
+        : m_capacity(std::max<qsizetype>(0, capacity)) {
+    }
+
+    /// 调整容量，超出部分按最久未使用顺序淘汰
+    void setCapacity(qsizetype capacity) {
+        m_capacity = std::max<qsizetype>(0, capacity);
+        while ( size() > m_capacity ) {
+            evictOldest();
+        }
+    }
+
+    qsizetype capacity() const { return m_capacity; }
+    qsizetype size() const { return m_index.size(); }
+    bool isEmpty() const { return m_index.isEmpty(); }
+
+    /// 是否包含 key（不改变使用顺序）
+    bool contains(const Key& key) const { return m_index.contains(key); }
+
+    /**
+     * @brief 查找并标记为最近使用
+     * @return 未命中返回 nullptr；指针在下一次 insert()/clear() 前有效
+     */
+    Value* find(const Key& key) {
+        const auto it = m_index.constFind(key);
+        if ( it == m_index.constEnd() ) {
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it.value());
+        return &m_entries.front().second;
+    }
+
+    /**
+     * @brief 插入或替换条目并标记为最近使用
+     * @return 因容量不足被淘汰的条目（如有）
+     */
+    std::optional<std::pair<Key, Value>> insert(const Key& key, Value value) {
+        if ( m_capacity == 0 ) {
+            return std::nullopt;
+        }
+
+        const auto it = m_index.constFind(key);
+        if ( it != m_index.constEnd() ) {
+            it.value()->second = std::move(value);
+            m_entries.splice(m_entries.begin(), m_entries, it.value());
+            return std::nullopt;
+        }
+
+        std::optional<std::pair<Key, Value>> evicted;
+        if ( size() >= m_capacity ) {
+            m_index.remove(m_entries.back().first);
+            evicted = std::move(m_entries.back());
+            m_entries.pop_back();
+        }
+        m_entries.emplace_front(key, std::move(value));
+        m_index.insert(key, m_entries.begin());
+        return evicted;
+    }
+
+    /// 移除条目，返回是否存在
+    bool remove(const Key& key) {
+        const auto it = m_index.constFind(key);
+        if ( it == m_index.constEnd() ) {
+            return false;
+        }
+        m_entries.erase(it.value());
+        m_index.erase(it);
+        return true;
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+private:
+    using EntryList = std::list<std::pair<Key, Value>>;
+
+    void evictOldest() {
+        m_index.remove(m_entries.back().first);
+        m_entries.pop_back();
+    }
+
+    qsizetype m_capacity;
+    EntryList m_entries;                                    ///< 头部为最近使用
+    QHash<Key, typename EntryList::iterator> m_index;
+};
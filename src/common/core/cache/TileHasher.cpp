@@ -0,0 +1,44 @@
+#include "TileHasher.h"
+#include "../config/NetworkConstants.h"
+#include <QtCore/QtEndian>
+#include <algorithm>
+
+QList<ContentHash> TileHasher::hashTiles(const QImage& image) {
+    QList<ContentHash> hashes;
+    if ( image.isNull() || image.depth() % 8 != 0 ) {
+        return hashes;
+    }
+
+    const int tileSize = NetworkConstants::TILE_SIZE;
+    const int columns = (image.width() + tileSize - 1) / tileSize;
+    const int rows = (image.height() + tileSize - 1) / tileSize;
+    hashes.reserve(qsizetype(columns) * rows);
+
+    ContentHasher hasher;
+    for ( int tileY = 0; tileY < image.height(); tileY += tileSize ) {
+        const int height = std::min(tileSize, image.height() - tileY);
+        for ( int tileX = 0; tileX < image.width(); tileX += tileSize ) {
+            const int width = std::min(tileSize, image.width() - tileX);
+            hashTile(image, QRect(tileX, tileY, width, height), hasher);
+            hashes.append(hasher.result());
+        }
+    }
+    return hashes;
+}
+
+void TileHasher::hashTile(const QImage& image, const QRect& rect, ContentHasher& hasher) {
+    const int bytesPerPixel = image.depth() / 8;
+
+    // 尺寸与像素宽度计入哈希：边缘图块字节数相同但形状不同时不会混淆
+    char shape[5];
+    qToLittleEndian<quint16>(static_cast<quint16>(rect.width()), shape);
+    qToLittleEndian<quint16>(static_cast<quint16>(rect.height()), shape + 2);
+    shape[4] = static_cast<char>(bytesPerPixel);
+
+    hasher.reset();
+    hasher.addData(QByteArrayView(shape, sizeof(shape)));
+    for ( int y = rect.top(); y <= rect.bottom(); ++y ) {
+        const char* line = reinterpret_cast<const char*>(image.constScanLine(y)) + qsizetype(rect.x()) * bytesPerPixel;
+        hasher.addData(QByteArrayView(line, qsizetype(rect.width()) * bytesPerPixel));
+    }
+}
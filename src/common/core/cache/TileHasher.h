@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ContentHash.h"
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+
+/**
+ * @brief 图块内容哈希
+ *
+ * 帧按 NetworkConstants::TILE_SIZE 对齐切分为图块，逐块计算 ContentHash。
+ * 处理线程为订阅图块缓存的会话计算，会话线程（TileCacheMirror）据此比较与查找缓存。
+ * 所有函数线程安全。
+ */
+class TileHasher {
+public:
+    /**
+     * @brief 按 TILE_SIZE 切分并计算每个图块的内容哈希（行优先）
+     * @return 像素格式不是整字节时返回空列表
+     */
+    static QList<ContentHash> hashTiles(const QImage& image);
+
+    /**
+     * @brief 计算 image 中一个图块的哈希
+     * @param image 图像（像素格式为整字节）
+     * @param rect 图块矩形（位于 image 内）
+     * @param hasher 复用的哈希器，结果通过 hasher.result() 取得
+     */
+    static void hashTile(const QImage& image, const QRect& rect, ContentHasher& hasher);
+};
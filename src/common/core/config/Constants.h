@@ -74,6 +74,10 @@ public:
         static constexpr bool ENABLE_ADAPTIVE_QUALITY = true;           ///< 启用自适应质量调整
         static constexpr int QUEUE_HIGH_WATERMARK = 60;                 ///< 队列高水位（触发质量降低）
         static constexpr int QUEUE_LOW_WATERMARK = 20;                  ///< 队列低水位（恢复质量）
+        // 同播层：层 0 为自适应质量，其余层在其基础上限制质量与缩放（只在有会话订阅时编码）
+        static constexpr int SIMULCAST_LAYERS = 3;                      ///< 同播层数
+        static constexpr int SIMULCAST_LAYER_QUALITY[SIMULCAST_LAYERS] = { 100, JPEG_QUALITY_LOW, JPEG_QUALITY_MIN };      ///< 各层质量上限
+        static constexpr double SIMULCAST_LAYER_SCALE[SIMULCAST_LAYERS] = { 1.0, SCALE_FACTOR_MEDIUM, SCALE_FACTOR_LOW };  ///< 各层缩放上限
     };
 
     /**
@@ -14,6 +14,7 @@ namespace NetworkConstants {
     const int DEFAULT_CONNECTION_TIMEOUT = 15000;  // 15秒 - 连接建立超时时间
     const int HEARTBEAT_TIMEOUT = 25000;           // 25秒 - 心跳超时（无心跳后断开）
     const int HEARTBEAT_INTERVAL = 15000;          // 15秒 - 心跳发送间隔
+    const int CLOCK_SYNC_WARMUP_EXCHANGES = 4;     // 认证后快速心跳交换次数，用于尽快收敛时钟偏移估计
     const int DEFAULT_RECONNECT_INTERVAL = 3000;   // 3秒 - 重连间隔
     const int ADAPTIVE_HEARTBEAT_MIN = 5000;       // 5秒 - 自适应心跳最小间隔
     const int ADAPTIVE_HEARTBEAT_MAX = 30000;      // 30秒 - 自适应心跳最大间隔
@@ -35,6 +36,43 @@ namespace NetworkConstants {
     const int KEEP_ALIVE_COUNT = 9;                // Keep-Alive探测次数
     const int MAX_FRAMES_PER_CYCLE = 2;            // 每个周期最多发送的帧数
 
+    // ==================== 分片与优先级发送 ====================
+    const int FRAGMENT_SIZE = 32 * 1024;           // 32KB - 大消息分片大小（对端支持分片时）
+    const int SEND_LOW_WATERMARK = 64 * 1024;      // 64KB - 套接字待发字节低于该值才写入下一个批量分片
+    const int MAX_PENDING_BULK_MESSAGES = 2;       // 发送队列中最多积压的批量消息（屏幕帧）数
+    const int MAX_PARTIAL_FRAGMENTED_MESSAGES = 4; // 接收端同时重组中的分片消息上限
+
+    // ==================== 输入批量发送 ====================
+    const int INPUT_COALESCE_INTERVAL_MS = 8;      // 鼠标移动合并窗口（毫秒），窗口内只保留最后位置
+    const int INPUT_BATCH_MAX_EVENTS = 64;         // 单个 INPUT_BATCH 的事件数上限，达到即发送
+
+    // ==================== 光标同步 ====================
+    const int CURSOR_POLL_INTERVAL_MS = 8;         // 服务端轮询指针的间隔（毫秒），仅在变化时发送
+    const int CURSOR_SHAPE_CACHE_SIZE = 32;        // 光标图像 LRU 缓存条目数（双方取小）
+
+    // ==================== 图块缓存 ====================
+    const int TILE_SIZE = 64;                      // 图块边长（像素），按帧左上角对齐切分
+    const int TILE_CACHE_SIZE = 8192;              // 图块 LRU 缓存条目数（双方取小；64x64 约 16KB/块）
+    const int TILE_CACHE_MEMORY_ENTRIES = 2048;    // 客户端内存中保留的条目数；未启用磁盘溢出时即客户端声明的缓存容量
+    const int TILE_CACHE_SPILL_DEFAULT_MB = 128;   // 启用磁盘溢出（Performance/tileCacheDiskSpill）时临时目录的默认上限（MB）
+    const int TILE_FULL_FRAME_MISS_PERCENT = 50;   // 未命中图块超过总块数的该比例时改为发送整帧
+    const int SCROLL_MIN_CHANGED_TILES = 4;        // 变化图块不少于该数时才检测滚动（区域复制）
+    const int SCROLL_MIN_MATCH_LINES = 16;         // 判定位移所需的最少匹配行（列）数
+
+    // ==================== 视频区域 ====================
+    const int VIDEO_HOT_CHANGES = 12;              // 图块最近16帧中变化次数达到该值视为视频
+    const int VIDEO_COOL_CHANGES = 4;              // 变化次数降到该值以下不再视为视频
+    const int VIDEO_MIN_TILES = 4;                 // 构成视频区域的最少图块数
+    const int VIDEO_MIN_FILL_PERCENT = 50;         // 热图块占外接矩形的最低比例，分散的变化不算视频
+    const int VIDEO_FRAME_RATE = 15;               // 视频区域的帧率上限，超出的帧延后合并发送
+    const int VIDEO_JPEG_QUALITY = 50;             // 视频区域 JPEG 质量上限
+    const int VIDEO_SCALE_PERCENT = 50;            // 视频区域编码前的缩放比例，客户端放大显示
+    const int VIDEO_DESKTOP_MIN_QUALITY = 85;      // 存在视频区域时其余图块的最低 JPEG 质量（不随整体降质）
+
+    // ==================== 同播层选择 ====================
+    const int SIMULCAST_DOWN_SKIPS = 3;            // 最近 16 帧中有这么多帧发生跳帧时降一层
+    const int SIMULCAST_UP_CLEAN_FRAMES = 150;     // 连续这么多帧未跳帧时升一层
+
     // ==================== 重试设置 ====================
     const int MAX_RETRY_COUNT = 3;                 // 最大重试次数
     const int MAX_RECONNECT_ATTEMPTS = 5;          // 最大重连尝试次数
@@ -48,5 +86,7 @@ namespace NetworkConstants {
 
     // ==================== 连接数限制 ====================
     const int MAX_CONNECTIONS = 100;               // 最大同时连接数
+    const int MAX_VIEWER_SESSIONS = 64;            // 最大同时观看会话数（共享同一份编码帧）
+    const int MAX_IO_THREADS = 8;                  // 会话共享的I/O线程数上限（默认按CPU核心数）
 }
 
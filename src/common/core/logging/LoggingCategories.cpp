@@ -38,6 +38,9 @@ Q_LOGGING_CATEGORY(lcScreenCaptureManager, "server.capture.manager", QtDebugMsg)
 /// 屏幕捕获Worker日志
 Q_LOGGING_CATEGORY(lcScreenCaptureWorker, "server.capture.worker", QtDebugMsg)
 
+/// 屏幕捕获后端日志
+Q_LOGGING_CATEGORY(lcCaptureBackend, "server.capture.backend", QtDebugMsg)
+
 /// 数据流日志
 Q_LOGGING_CATEGORY(lcDataFlow, "dataflow", QtDebugMsg)
 
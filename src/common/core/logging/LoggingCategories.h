@@ -41,6 +41,9 @@ Q_DECLARE_LOGGING_CATEGORY(lcScreenCaptureManager)
 /// 屏幕捕获Worker日志
 Q_DECLARE_LOGGING_CATEGORY(lcScreenCaptureWorker)
 
+/// 屏幕捕获后端日志
+Q_DECLARE_LOGGING_CATEGORY(lcCaptureBackend)
+
 /// 数据流日志
 Q_DECLARE_LOGGING_CATEGORY(lcDataFlow)
 
@@ -0,0 +1,211 @@
+#include "FrameBufferPool.h"
+#include <QtCore/QList>
+#include <QtCore/QMutexLocker>
+#include <QtGui/QPixelFormat>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+namespace {
+
+constexpr qsizetype PAGE_SIZE = 4096;   // 内存块大小按页取整，尺寸相近的帧可以复用同一块
+
+constexpr qsizetype roundUp(qsizetype value, qsizetype multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+uchar* allocateBlock(qsizetype bytes) {
+    return static_cast<uchar*>(::operator new(static_cast<size_t>(bytes),
+        std::align_val_t(FrameBufferPool::ALIGNMENT), std::nothrow));
+}
+
+void freeBlock(uchar* data) {
+    ::operator delete(data, std::align_val_t(FrameBufferPool::ALIGNMENT));
+}
+
+} // namespace
+
+struct FrameBufferPool::Private {
+    struct Block {
+        uchar* data = nullptr;
+        qsizetype size = 0;
+    };
+
+    explicit Private(qsizetype maxIdle)
+        : maxIdleBytes(maxIdle) {
+    }
+
+    ~Private() {
+        for ( const Block& block : idleBlocks ) {
+            freeBlock(block.data);
+        }
+    }
+
+    mutable QMutex mutex;
+    const qsizetype maxIdleBytes;
+    std::vector<Block> idleBlocks;
+    qsizetype idleBytes = 0;
+    QList<QByteArray> byteArrays;   // 交回的数组，可能仍被下游共享
+    Stats stats;
+};
+
+/**
+ * @brief 借出的内存块
+ *
+ * 作为 QImage 清理函数的参数，持有池的 shared_ptr，池先于图像销毁时内存块直接释放。
+ */
+struct FrameBufferPool::Lease {
+    std::shared_ptr<Private> pool;
+    Private::Block block;
+};
+
+FrameBufferPool& FrameBufferPool::instance() {
+    static FrameBufferPool pool;
+    return pool;
+}
+
+FrameBufferPool::FrameBufferPool(qsizetype maxIdleBytes)
+    : d(std::make_shared<Private>(std::max<qsizetype>(0, maxIdleBytes))) {
+}
+
+FrameBufferPool::~FrameBufferPool() = default;
+
+qsizetype FrameBufferPool::alignedBytesPerLine(int width, QImage::Format format) {
+    // 调色板格式需要颜色表，不适合池化
+    if ( width <= 0 || format == QImage::Format_Invalid || format == QImage::Format_Mono ||
+         format == QImage::Format_MonoLSB || format == QImage::Format_Indexed8 ) {
+        return 0;
+    }
+    const qsizetype bitsPerPixel = QImage::toPixelFormat(format).bitsPerPixel();
+    if ( bitsPerPixel <= 0 ) {
+        return 0;
+    }
+    return roundUp((static_cast<qsizetype>(width) * bitsPerPixel + 7) / 8, ALIGNMENT);
+}
+
+QImage FrameBufferPool::acquireImage(const QSize& size, QImage::Format format) {
+    if ( size.isEmpty() ) {
+        return QImage();
+    }
+    const qsizetype bytesPerLine = alignedBytesPerLine(size.width(), format);
+    if ( bytesPerLine <= 0 ) {
+        return QImage();
+    }
+    const qsizetype needed = roundUp(bytesPerLine * size.height(), PAGE_SIZE);
+
+    Private::Block block;
+    {
+        QMutexLocker locker(&d->mutex);
+        // 最佳适配：大小不超过所需两倍的最小空闲块，避免小图长期占用整屏大小的块
+        auto best = d->idleBlocks.end();
+        for ( auto it = d->idleBlocks.begin(); it != d->idleBlocks.end(); ++it ) {
+            if ( it->size >= needed && it->size <= needed * 2 &&
+                 (best == d->idleBlocks.end() || it->size < best->size) ) {
+                best = it;
+            }
+        }
+        if ( best != d->idleBlocks.end() ) {
+            block = *best;
+            *best = d->idleBlocks.back();
+            d->idleBlocks.pop_back();
+            d->idleBytes -= block.size;
+            ++d->stats.imageHits;
+        } else {
+            ++d->stats.imageMisses;
+        }
+    }
+
+    if ( !block.data ) {
+        block.data = allocateBlock(needed);
+        if ( !block.data ) {
+            return QImage();
+        }
+        block.size = needed;
+    }
+
+    auto* lease = new Lease{ d, block };
+    QImage image(block.data, size.width(), size.height(), bytesPerLine, format, &FrameBufferPool::releaseImage, lease);
+    if ( image.isNull() ) {
+        releaseImage(lease);
+        return QImage();
+    }
+    return image;
+}
+
+void FrameBufferPool::releaseImage(void* info) {
+    const std::unique_ptr<Lease> lease(static_cast<Lease*>(info));
+    Private& pool = *lease->pool;
+    {
+        QMutexLocker locker(&pool.mutex);
+        if ( pool.idleBytes + lease->block.size <= pool.maxIdleBytes ) {
+            pool.idleBlocks.push_back(lease->block);
+            pool.idleBytes += lease->block.size;
+            return;
+        }
+    }
+    freeBlock(lease->block.data);
+}
+
+QByteArray FrameBufferPool::acquireBytes(qsizetype capacity) {
+    {
+        QMutexLocker locker(&d->mutex);
+        // 只借出下游已全部释放的数组：此后写入不会触发分离拷贝，也不会改动别人仍在读的数据
+        qsizetype best = -1;
+        for ( qsizetype i = 0; i < d->byteArrays.size(); ++i ) {
+            const QByteArray& candidate = d->byteArrays.at(i);
+            if ( candidate.isDetached() && candidate.capacity() >= capacity &&
+                 (best < 0 || candidate.capacity() < d->byteArrays.at(best).capacity()) ) {
+                best = i;
+            }
+        }
+        if ( best >= 0 ) {
+            QByteArray bytes = d->byteArrays.takeAt(best);
+            ++d->stats.bytesHits;
+            locker.unlock();
+            bytes.resize(0);   // 保留容量（clear() 会释放内存）
+            return bytes;
+        }
+        ++d->stats.bytesMisses;
+    }
+
+    QByteArray bytes;
+    bytes.reserve(capacity);
+    return bytes;
+}
+
+void FrameBufferPool::recycle(QByteArray&& bytes) {
+    if ( bytes.capacity() <= 0 ) {
+        return;
+    }
+    QByteArray dropped;
+    {
+        QMutexLocker locker(&d->mutex);
+        if ( d->byteArrays.size() >= MAX_POOLED_BYTE_ARRAYS ) {
+            dropped = d->byteArrays.takeFirst();
+        }
+        d->byteArrays.append(std::move(bytes));
+    }
+    // dropped 在锁外析构
+}
+
+void FrameBufferPool::trim() {
+    std::vector<Private::Block> blocks;
+    QList<QByteArray> byteArrays;
+    {
+        QMutexLocker locker(&d->mutex);
+        blocks.swap(d->idleBlocks);
+        byteArrays.swap(d->byteArrays);
+        d->idleBytes = 0;
+    }
+    for ( const Private::Block& block : blocks ) {
+        freeBlock(block.data);
+    }
+}
+
+FrameBufferPool::Stats FrameBufferPool::stats() const {
+    QMutexLocker locker(&d->mutex);
+    Stats result = d->stats;
+    result.idleBytes = d->idleBytes;
+    result.idleBlocks = static_cast<int>(d->idleBlocks.size());
+    return result;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSize>
+#include <QtGui/QImage>
+#include <memory>
+
+/**
+ * @brief 帧缓冲池：复用像素缓冲与字节缓冲
+ *
+ * 捕获、编码和解码每帧都要分配整屏大小的缓冲，4K@60fps 时每秒约 2GB 的分配与缺页。
+ * 缓冲池让这些缓冲在帧之间循环使用：
+ * - acquireImage() 返回包装池内存块的 QImage，起始地址与每行字节数都按 ALIGNMENT（64 字节）对齐，
+ *   便于 SIMD 按行处理；最后一个 QImage 副本释放时内存块自动归还（引用计数语义）。
+ * - acquireBytes()/recycle() 复用 QByteArray：recycle() 交回的数组可能仍被下游（网络队列等）共享，
+ *   池只持有一份引用，等下游全部释放后（isDetached()）才再次借出，不会覆盖仍在使用的数据。
+ *
+ * 空闲内存块总量不超过 maxIdleBytes，超出时直接释放；借出的缓冲不受限制，也可以比池本身存活更久。
+ * 所有函数线程安全。
+ */
+class FrameBufferPool {
+public:
+    static constexpr qsizetype ALIGNMENT = 64;                              ///< 起始地址与行跨度的对齐字节数
+    static constexpr qsizetype DEFAULT_MAX_IDLE_BYTES = 256 * 1024 * 1024;  ///< 默认空闲像素内存上限
+    static constexpr int MAX_POOLED_BYTE_ARRAYS = 16;                       ///< 池中最多保留的字节数组数
+
+    /**
+     * @brief 命中统计
+     */
+    struct Stats {
+        quint64 imageHits = 0;      ///< 复用内存块的 acquireImage() 次数
+        quint64 imageMisses = 0;    ///< 新分配内存块的 acquireImage() 次数
+        quint64 bytesHits = 0;      ///< 复用数组的 acquireBytes() 次数
+        quint64 bytesMisses = 0;    ///< 新分配数组的 acquireBytes() 次数
+        qsizetype idleBytes = 0;    ///< 当前空闲内存块总字节数
+        int idleBlocks = 0;         ///< 当前空闲内存块数
+    };
+
+    /**
+     * @brief 进程共享的缓冲池
+     */
+    static FrameBufferPool& instance();
+
+    /**
+     * @brief 构造函数
+     * @param maxIdleBytes 空闲像素内存上限
+     */
+    explicit FrameBufferPool(qsizetype maxIdleBytes = DEFAULT_MAX_IDLE_BYTES);
+    ~FrameBufferPool();
+
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /**
+     * @brief 借出一张图像
+     *
+     * 像素内容未初始化，调用方负责整张写入。复用大小不超过所需两倍的空闲块，否则新分配。
+     * @param size 图像尺寸
+     * @param format 像素格式（不支持调色板格式）
+     * @return 图像；尺寸无效或分配失败时返回空图像
+     */
+    QImage acquireImage(const QSize& size, QImage::Format format);
+
+    /**
+     * @brief 借出一个字节数组
+     * @param capacity 所需容量
+     * @return 空数组（size() 为 0），capacity() 不小于 capacity；在容量内 resize() 不会重新分配
+     */
+    QByteArray acquireBytes(qsizetype capacity);
+
+    /**
+     * @brief 交回字节数组
+     *
+     * bytes 可以仍被下游共享；池中数组已满时丢弃最早交回的一个。
+     */
+    void recycle(QByteArray&& bytes);
+
+    /**
+     * @brief 释放所有空闲缓冲；已借出的缓冲不受影响
+     */
+    void trim();
+
+    /**
+     * @brief 当前统计
+     */
+    Stats stats() const;
+
+    /**
+     * @brief 池中图像的每行字节数（按 ALIGNMENT 对齐）
+     */
+    static qsizetype alignedBytesPerLine(int width, QImage::Format format);
+
+private:
+    struct Private;
+    struct Lease;
+
+    static void releaseImage(void* info);
+
+    std::shared_ptr<Private> d;
+};
@@ -0,0 +1,63 @@
+#include "LatencyStats.h"
+#include <QtCore/QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+QString LatencyStats::Summary::toString(const QString& unit) const {
+    return QString("%1/%2/%3%4")
+        .arg(p50, 0, 'f', 1)
+        .arg(p95, 0, 'f', 1)
+        .arg(p99, 0, 'f', 1)
+        .arg(unit);
+}
+
+LatencyStats::LatencyStats(int windowSize)
+    : m_windowSize(std::max(1, windowSize))
+    , m_nextIndex(0) {
+    m_samples.reserve(m_windowSize);
+}
+
+void LatencyStats::record(double value) {
+    QMutexLocker locker(&m_mutex);
+    if ( m_samples.size() < m_windowSize ) {
+        m_samples.append(value);
+    } else {
+        m_samples[m_nextIndex] = value;
+    }
+    m_nextIndex = (m_nextIndex + 1) % m_windowSize;
+}
+
+LatencyStats::Summary LatencyStats::summary() const {
+    QList<double> sorted;
+    {
+        QMutexLocker locker(&m_mutex);
+        sorted = m_samples;
+    }
+
+    Summary result;
+    result.count = static_cast<int>(sorted.size());
+    if ( sorted.isEmpty() ) {
+        return result;
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    // 最近秩法（nearest-rank）
+    auto percentile = [&sorted](double p) {
+        qsizetype rank = static_cast<qsizetype>(std::ceil(p * static_cast<double>(sorted.size()) / 100.0));
+        rank = std::clamp<qsizetype>(rank, 1, sorted.size());
+        return sorted[rank - 1];
+    };
+
+    result.p50 = percentile(50.0);
+    result.p95 = percentile(95.0);
+    result.p99 = percentile(99.0);
+    result.max = sorted.last();
+    return result;
+}
+
+void LatencyStats::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_samples.clear();
+    m_nextIndex = 0;
+}
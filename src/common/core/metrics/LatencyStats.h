@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QtCore/QMutex>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+/**
+ * @brief 滑动窗口延迟统计
+ *
+ * 保留最近 windowSize 个延迟样本，按需计算 p50/p95/p99 等分位数。
+ * 样本写入为 O(1)，分位数在查询时对窗口副本排序计算，适合每秒刷新一次的统计显示。
+ * 线程安全：记录与查询可以位于不同线程。
+ */
+class LatencyStats {
+public:
+    /**
+     * @brief 分位数摘要
+     */
+    struct Summary {
+        int count = 0;       ///< 窗口内样本数
+        double p50 = 0.0;    ///< 中位数
+        double p95 = 0.0;    ///< 95分位
+        double p99 = 0.0;    ///< 99分位
+        double max = 0.0;    ///< 窗口内最大值
+
+        /**
+         * @brief 格式化为 "p50/p95/p99" 形式的字符串
+         * @param unit 单位后缀
+         */
+        QString toString(const QString& unit = QStringLiteral("ms")) const;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param windowSize 滑动窗口大小
+     */
+    explicit LatencyStats(int windowSize = DEFAULT_WINDOW_SIZE);
+
+    LatencyStats(const LatencyStats&) = delete;
+    LatencyStats& operator=(const LatencyStats&) = delete;
+
+    /**
+     * @brief 记录一个延迟样本
+     * @param value 延迟值
+     */
+    void record(double value);
+
+    /**
+     * @brief 计算当前窗口的分位数摘要
+     */
+    Summary summary() const;
+
+    /**
+     * @brief 清空所有样本
+     */
+    void reset();
+
+    static constexpr int DEFAULT_WINDOW_SIZE = 512;  ///< 默认窗口大小
+
+private:
+    mutable QMutex m_mutex;
+    QList<double> m_samples;  ///< 环形样本窗口
+    int m_windowSize;
+    int m_nextIndex;
+};
@@ -0,0 +1,311 @@
+#include "Checksum.h"
+#include <QtCore/QtEndian>
+#include <array>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define RDP_CHECKSUM_X86 1
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define RDP_CHECKSUM_ARM_CRC 1
+#endif
+
+namespace {
+
+using CrcTables = std::array<std::array<quint32, 256>, 8>;
+
+// slice-by-8 查表：tables[0] 为普通逐字节表，tables[k] 为前移 k 个字节后的余数
+template <quint32 Poly>
+constexpr CrcTables generateSliceBy8Tables() {
+    CrcTables tables{};
+    for ( quint32 i = 0; i < 256; ++i ) {
+        quint32 crc = i;
+        for ( int j = 0; j < 8; ++j ) {
+            crc = (crc >> 1) ^ ((crc & 1) ? Poly : 0u);
+        }
+        tables[0][i] = crc;
+    }
+    for ( quint32 i = 0; i < 256; ++i ) {
+        for ( int t = 1; t < 8; ++t ) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+// 编译期生成，零运行时开销
+constexpr CrcTables kCrc32Tables = generateSliceBy8Tables<0xEDB88320u>();    // IEEE 802.3
+constexpr CrcTables kCrc32cTables = generateSliceBy8Tables<0x82F63B78u>();   // Castagnoli
+
+quint32 updateBytewise(const CrcTables& t, quint32 crc, const quint8* p, size_t n) {
+    for ( size_t i = 0; i < n; ++i ) {
+        crc = t[0][(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+quint32 updateSliceBy8(const CrcTables& t, quint32 crc, const quint8* p, size_t n) {
+    while ( n >= 8 ) {
+        const quint32 lo = qFromLittleEndian<quint32>(p) ^ crc;
+        const quint32 hi = qFromLittleEndian<quint32>(p + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    return updateBytewise(t, crc, p, n);
+}
+
+#ifdef RDP_CHECKSUM_X86
+// PCLMULQDQ 折叠（Intel 白皮书 "Fast CRC Computation Using PCLMULQDQ"，位反射域常量）
+// 要求 len >= 64 且为16的倍数；crc 为内部状态（已取反）
+__attribute__((target("pclmul,sse4.1")))
+quint32 crc32FoldPclmul(quint32 crc, const quint8* buf, size_t len) {
+    alignas(16) static const quint64 k1k2[] = { 0x0154442bd4ULL, 0x01c6e41596ULL };
+    alignas(16) static const quint64 k3k4[] = { 0x01751997d0ULL, 0x00ccaa009eULL };
+    alignas(16) static const quint64 k5k0[] = { 0x0163cd6124ULL, 0x0000000000ULL };
+    alignas(16) static const quint64 poly[] = { 0x01db710641ULL, 0x01f7011641ULL };
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64; len -= 64;
+    while ( len >= 64 ) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        buf += 64; len -= 64;
+    }
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    while ( len >= 16 ) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16; len -= 16;
+    }
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<quint32>(_mm_extract_epi32(x1, 1));
+}
+
+__attribute__((target("sse4.2")))
+quint32 crc32cSse42(quint32 crc, const quint8* p, size_t n) {
+    quint64 c = crc;
+    while ( n >= 8 ) {
+        quint64 v;
+        std::memcpy(&v, p, sizeof(v));
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        n -= 8;
+    }
+    crc = static_cast<quint32>(c);
+    while ( n-- ) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+bool cpuHasPclmul() {
+    static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+
+bool cpuHasSse42() {
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#endif
+
+#ifdef RDP_CHECKSUM_ARM_CRC
+quint32 crc32Arm(quint32 crc, const quint8* p, size_t n) {
+    while ( n >= 8 ) {
+        quint64 v;
+        std::memcpy(&v, p, sizeof(v));
+        crc = __crc32d(crc, v);
+        p += 8;
+        n -= 8;
+    }
+    while ( n-- ) {
+        crc = __crc32b(crc, *p++);
+    }
+    return crc;
+}
+
+quint32 crc32cArm(quint32 crc, const quint8* p, size_t n) {
+    while ( n >= 8 ) {
+        quint64 v;
+        std::memcpy(&v, p, sizeof(v));
+        crc = __crc32cd(crc, v);
+        p += 8;
+        n -= 8;
+    }
+    while ( n-- ) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+const quint8* bytesOf(QByteArrayView data) {
+    return reinterpret_cast<const quint8*>(data.constData());
+}
+
+} // namespace
+
+quint32 Checksum::compute(ChecksumAlgorithm algorithm, QByteArrayView data, quint32 previous) {
+    switch ( algorithm ) {
+        case ChecksumAlgorithm::CRC32C:
+            return crc32c(data, previous);
+        case ChecksumAlgorithm::NONE:
+            return 0;
+        case ChecksumAlgorithm::CRC32:
+        default:
+            return crc32(data, previous);
+    }
+}
+
+quint32 Checksum::crc32(QByteArrayView data, quint32 previous) {
+    const quint8* p = bytesOf(data);
+    size_t n = static_cast<size_t>(data.size());
+    quint32 crc = ~previous;
+
+#if defined(RDP_CHECKSUM_ARM_CRC)
+    return crc32Arm(crc, p, n) ^ 0xFFFFFFFFu;
+#else
+#ifdef RDP_CHECKSUM_X86
+    if ( n >= 64 && cpuHasPclmul() ) {
+        const size_t folded = n & ~static_cast<size_t>(15);
+        crc = crc32FoldPclmul(crc, p, folded);
+        p += folded;
+        n -= folded;
+    }
+#endif
+    return updateSliceBy8(kCrc32Tables, crc, p, n) ^ 0xFFFFFFFFu;
+#endif
+}
+
+quint32 Checksum::crc32c(QByteArrayView data, quint32 previous) {
+    const quint8* p = bytesOf(data);
+    const size_t n = static_cast<size_t>(data.size());
+    const quint32 crc = ~previous;
+
+#if defined(RDP_CHECKSUM_ARM_CRC)
+    return crc32cArm(crc, p, n) ^ 0xFFFFFFFFu;
+#else
+#ifdef RDP_CHECKSUM_X86
+    if ( cpuHasSse42() ) {
+        return crc32cSse42(crc, p, n) ^ 0xFFFFFFFFu;
+    }
+#endif
+    return updateSliceBy8(kCrc32cTables, crc, p, n) ^ 0xFFFFFFFFu;
+#endif
+}
+
+quint32 Checksum::crc32Bytewise(QByteArrayView data) {
+    return updateBytewise(kCrc32Tables, 0xFFFFFFFFu, bytesOf(data), static_cast<size_t>(data.size())) ^ 0xFFFFFFFFu;
+}
+
+quint32 Checksum::crc32SliceBy8(QByteArrayView data) {
+    return updateSliceBy8(kCrc32Tables, 0xFFFFFFFFu, bytesOf(data), static_cast<size_t>(data.size())) ^ 0xFFFFFFFFu;
+}
+
+quint32 Checksum::crc32cSliceBy8(QByteArrayView data) {
+    return updateSliceBy8(kCrc32cTables, 0xFFFFFFFFu, bytesOf(data), static_cast<size_t>(data.size())) ^ 0xFFFFFFFFu;
+}
+
+bool Checksum::hasHardwareCrc32() {
+#if defined(RDP_CHECKSUM_ARM_CRC)
+    return true;
+#elif defined(RDP_CHECKSUM_X86)
+    return cpuHasPclmul();
+#else
+    return false;
+#endif
+}
+
+bool Checksum::hasHardwareCrc32c() {
+#if defined(RDP_CHECKSUM_ARM_CRC)
+    return true;
+#elif defined(RDP_CHECKSUM_X86)
+    return cpuHasSse42();
+#else
+    return false;
+#endif
+}
+
+quint32 Checksum::supportedMask(bool tlsActive) {
+    quint32 mask = maskOf(ChecksumAlgorithm::CRC32) | maskOf(ChecksumAlgorithm::CRC32C);
+    if ( tlsActive ) {
+        mask |= maskOf(ChecksumAlgorithm::NONE);
+    }
+    return mask;
+}
+
+ChecksumAlgorithm Checksum::choose(quint32 localMask, quint32 peerMask) {
+    const quint32 common = localMask & peerMask;
+
+    // TLS 记录层已有 AEAD 完整性校验，双方都在 TLS 下时不再重复计算
+    if ( common & maskOf(ChecksumAlgorithm::NONE) ) {
+        return ChecksumAlgorithm::NONE;
+    }
+
+    // PCLMUL 折叠的 CRC32 快于单流 CRC32C 指令，其次才选硬件 CRC32C
+    if ( (common & maskOf(ChecksumAlgorithm::CRC32C)) && hasHardwareCrc32c() && !hasHardwareCrc32() ) {
+        return ChecksumAlgorithm::CRC32C;
+    }
+    return ChecksumAlgorithm::CRC32;
+}
+
+const char* Checksum::algorithmName(ChecksumAlgorithm algorithm) {
+    switch ( algorithm ) {
+        case ChecksumAlgorithm::CRC32:
+            return "CRC32";
+        case ChecksumAlgorithm::CRC32C:
+            return "CRC32C";
+        case ChecksumAlgorithm::NONE:
+            return "NONE";
+    }
+    return "UNKNOWN";
+}
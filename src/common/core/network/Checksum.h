@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/qglobal.h>
+
+// 消息校验算法（握手时通过 Capability::CHECKSUM 协商）
+enum class ChecksumAlgorithm : quint8 {
+    CRC32 = 0,    ///< IEEE CRC-32（默认；旧版本对端及握手阶段使用）
+    CRC32C = 1,   ///< Castagnoli CRC-32C（可使用 SSE4.2 / ARMv8 CRC 指令）
+    NONE = 2      ///< 不校验，校验和字段为0（仅在 TLS 已提供完整性保护时协商）
+};
+
+/**
+ * @brief 消息载荷校验和计算
+ *
+ * - CRC32：PCLMULQDQ 折叠（x86）或 ARMv8 CRC 指令，不支持时退回 slice-by-8 查表
+ * - CRC32C：SSE4.2 / ARMv8 CRC 指令，不支持时退回 slice-by-8 查表
+ *
+ * 硬件路径在运行时检测 CPU 特性后选择，结果与查表实现逐位一致。
+ * 所有函数线程安全。
+ */
+class Checksum {
+public:
+    /**
+     * @brief 按指定算法计算校验和（NONE 返回0）
+     * @param previous 前一段数据的校验和，用于分段增量计算（首段为0）
+     */
+    static quint32 compute(ChecksumAlgorithm algorithm, QByteArrayView data, quint32 previous = 0);
+
+    // 自动选择最快实现；compute(a, x + y) == compute(a, y, compute(a, x))
+    static quint32 crc32(QByteArrayView data, quint32 previous = 0);
+    static quint32 crc32c(QByteArrayView data, quint32 previous = 0);
+
+    // 固定实现（用于测试和基准对比）
+    static quint32 crc32Bytewise(QByteArrayView data);
+    static quint32 crc32SliceBy8(QByteArrayView data);
+    static quint32 crc32cSliceBy8(QByteArrayView data);
+
+    // CPU 特性
+    static bool hasHardwareCrc32();    ///< CRC32 可走 PCLMUL 折叠或 ARMv8 CRC 指令
+    static bool hasHardwareCrc32c();   ///< CRC32C 可走 SSE4.2 或 ARMv8 CRC 指令
+
+    /**
+     * @brief 本端支持的算法位掩码（bit = 1 << 算法值）
+     * @param tlsActive 链路是否已由 TLS 保护，决定是否声明 NONE
+     */
+    static quint32 supportedMask(bool tlsActive);
+
+    /**
+     * @brief 从双方共同支持的算法中选择最优者
+     *
+     * 优先级：NONE（双方都在 TLS 下）> 本机有硬件加速的 CRC > CRC32。
+     * @return 无交集时返回 CRC32（所有版本都支持）
+     */
+    static ChecksumAlgorithm choose(quint32 localMask, quint32 peerMask);
+
+    static const char* algorithmName(ChecksumAlgorithm algorithm);
+
+    static constexpr quint32 maskOf(ChecksumAlgorithm algorithm) {
+        return 1u << static_cast<quint32>(algorithm);
+    }
+};
@@ -0,0 +1,99 @@
+#include "ClockSynchronizer.h"
+#include <QtCore/QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+ClockSynchronizer::ClockSynchronizer(int windowSize)
+    : m_windowSize(std::max(1, windowSize))
+    , m_nextIndex(0)
+    , m_lastTransmit(0)
+    , m_peerTransmit(0)
+    , m_peerReceivedAt(0) {
+    m_samples.reserve(m_windowSize);
+}
+
+HeartbeatMessage ClockSynchronizer::prepareOutgoing(quint64 nowMs) {
+    QMutexLocker locker(&m_mutex);
+
+    HeartbeatMessage message;
+    message.originTimestamp = m_peerTransmit;
+    message.receiveTimestamp = m_peerReceivedAt;
+    message.transmitTimestamp = nowMs;
+    m_lastTransmit = nowMs;
+    return message;
+}
+
+bool ClockSynchronizer::processIncoming(const HeartbeatMessage& message, quint64 receivedAtMs) {
+    quint64 lastTransmit = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        lastTransmit = m_lastTransmit;
+        m_peerTransmit = message.transmitTimestamp;
+        m_peerReceivedAt = receivedAtMs;
+    }
+
+    // 只接受回显了本端最近一次发送时间的样本，过期或重复的回显直接忽略
+    if ( message.originTimestamp == 0 || message.originTimestamp != lastTransmit ) {
+        return false;
+    }
+
+    return addSample(static_cast<qint64>(message.originTimestamp),
+        static_cast<qint64>(message.receiveTimestamp),
+        static_cast<qint64>(message.transmitTimestamp),
+        static_cast<qint64>(receivedAtMs));
+}
+
+bool ClockSynchronizer::addSample(qint64 t1, qint64 t2, qint64 t3, qint64 t4) {
+    if ( t1 <= 0 || t2 <= 0 || t3 <= 0 || t4 < t1 || t3 < t2 ) {
+        return false;
+    }
+
+    Sample sample;
+    sample.offsetMs = (static_cast<double>(t2 - t1) + static_cast<double>(t3 - t4)) / 2.0;
+    // 毫秒精度下局域网往返可能被量化为负数，钳制为0
+    sample.delayMs = std::max(0.0, static_cast<double>((t4 - t1) - (t3 - t2)));
+
+    QMutexLocker locker(&m_mutex);
+    if ( m_samples.size() < m_windowSize ) {
+        m_samples.append(sample);
+    } else {
+        m_samples[m_nextIndex] = sample;
+    }
+    m_nextIndex = (m_nextIndex + 1) % m_windowSize;
+    return true;
+}
+
+ClockSyncEstimate ClockSynchronizer::estimate() const {
+    QMutexLocker locker(&m_mutex);
+
+    ClockSyncEstimate result;
+    result.sampleCount = static_cast<int>(m_samples.size());
+    if ( m_samples.isEmpty() ) {
+        return result;
+    }
+
+    // 最小RTT滤波：往返时延最小的样本受排队影响最小，偏移最可信
+    auto best = std::min_element(m_samples.cbegin(), m_samples.cend(),
+        [](const Sample& a, const Sample& b) { return a.delayMs < b.delayMs; });
+    result.valid = true;
+    result.offsetMs = best->offsetMs;
+    result.rttMs = best->delayMs;
+    return result;
+}
+
+qint64 ClockSynchronizer::toLocalTime(qint64 remoteMs) const {
+    ClockSyncEstimate current = estimate();
+    if ( !current.valid ) {
+        return remoteMs;
+    }
+    return remoteMs - static_cast<qint64>(std::llround(current.offsetMs));
+}
+
+void ClockSynchronizer::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_samples.clear();
+    m_nextIndex = 0;
+    m_lastTransmit = 0;
+    m_peerTransmit = 0;
+    m_peerReceivedAt = 0;
+}
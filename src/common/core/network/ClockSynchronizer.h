@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Protocol.h"
+#include <QtCore/QMutex>
+#include <QtCore/QList>
+
+/**
+ * @brief 时钟同步估计结果
+ */
+struct ClockSyncEstimate {
+    bool valid = false;       ///< 是否已有有效估计
+    double offsetMs = 0.0;    ///< 时钟偏移（对端时钟 - 本地时钟，毫秒）
+    double rttMs = 0.0;       ///< 往返时延（毫秒，已扣除对端处理时间）
+    int sampleCount = 0;      ///< 窗口内样本数
+};
+
+/**
+ * @brief NTP风格的时钟偏移/RTT估计器
+ *
+ * 基于 HEARTBEAT/HEARTBEAT_RESPONSE 的对称模式时间戳交换：
+ * 每条心跳携带 {origin, receive, transmit}，收到后与本地接收时间组成 T1..T4：
+ * - offset = ((T2 - T1) + (T3 - T4)) / 2
+ * - delay  = (T4 - T1) - (T3 - T2)
+ *
+ * 保留最近若干样本，取往返时延最小的样本作为估计（最小RTT滤波），
+ * 排队和调度抖动造成的非对称延迟因此被过滤掉。
+ * 服务端与客户端使用同一实现，线程安全。
+ */
+class ClockSynchronizer {
+public:
+    /**
+     * @brief 构造函数
+     * @param windowSize 样本窗口大小
+     */
+    explicit ClockSynchronizer(int windowSize = DEFAULT_WINDOW_SIZE);
+
+    ClockSynchronizer(const ClockSynchronizer&) = delete;
+    ClockSynchronizer& operator=(const ClockSynchronizer&) = delete;
+
+    /**
+     * @brief 生成待发送的心跳时间戳，并记录本次发送时间
+     * @param nowMs 当前本地时间（毫秒）
+     * @return 心跳消息
+     */
+    HeartbeatMessage prepareOutgoing(quint64 nowMs);
+
+    /**
+     * @brief 处理收到的心跳时间戳
+     * @param message 对端心跳
+     * @param receivedAtMs 本地接收时间（毫秒）
+     * @return 是否产生了新的有效样本
+     */
+    bool processIncoming(const HeartbeatMessage& message, quint64 receivedAtMs);
+
+    /**
+     * @brief 直接添加一组 T1..T4 样本
+     * @param t1 本端发送时间（本地时钟）
+     * @param t2 对端接收时间（对端时钟）
+     * @param t3 对端发送时间（对端时钟）
+     * @param t4 本端接收时间（本地时钟）
+     * @return 样本是否有效
+     */
+    bool addSample(qint64 t1, qint64 t2, qint64 t3, qint64 t4);
+
+    /**
+     * @brief 获取当前估计
+     */
+    ClockSyncEstimate estimate() const;
+
+    /**
+     * @brief 将对端时钟时间换算为本地时钟时间
+     * @param remoteMs 对端时间（毫秒）
+     * @return 本地时间（毫秒）；无有效估计时原样返回
+     */
+    qint64 toLocalTime(qint64 remoteMs) const;
+
+    /**
+     * @brief 清空样本和交换状态（重新连接时调用）
+     */
+    void reset();
+
+    static constexpr int DEFAULT_WINDOW_SIZE = 8;  ///< 默认样本窗口
+
+private:
+    struct Sample {
+        double offsetMs;
+        double delayMs;
+    };
+
+    mutable QMutex m_mutex;
+    QList<Sample> m_samples;       ///< 环形样本窗口
+    int m_windowSize;
+    int m_nextIndex;
+
+    quint64 m_lastTransmit;        ///< 本端最近一次发送时间（用于匹配对端回显）
+    quint64 m_peerTransmit;        ///< 对端最近一次发送时间（下次发送时回显）
+    quint64 m_peerReceivedAt;      ///< 收到对端最近一次心跳的本地时间
+};
@@ -0,0 +1,48 @@
+#include "FragmentAssembler.h"
+#include "../config/NetworkConstants.h"
+#include "../logging/LoggingCategories.h"
+
+FragmentAssembler::Result FragmentAssembler::addFragment(const MessageFragment& fragment, QByteArray& message) {
+    if ( fragment.totalSize > static_cast<quint32>(NetworkConstants::MAX_PACKET_SIZE) ) {
+        qCWarning(lcProtocol) << "FragmentAssembler: message too large:" << fragment.totalSize;
+        m_partial.remove(fragment.messageId);
+        return Result::Invalid;
+    }
+
+    auto it = m_partial.find(fragment.messageId);
+    if ( it == m_partial.end() ) {
+        if ( fragment.offset != 0 ) {
+            qCWarning(lcProtocol) << "FragmentAssembler: missing first fragment of message" << fragment.messageId;
+            return Result::Invalid;
+        }
+        if ( m_partial.size() >= NetworkConstants::MAX_PARTIAL_FRAGMENTED_MESSAGES ) {
+            qCWarning(lcProtocol) << "FragmentAssembler: too many partial messages";
+            return Result::Invalid;
+        }
+        QByteArray buffer;
+        buffer.reserve(fragment.totalSize);
+        it = m_partial.insert(fragment.messageId, buffer);
+    }
+
+    QByteArray& buffer = it.value();
+    if ( fragment.offset != static_cast<quint32>(buffer.size())
+        || static_cast<qsizetype>(fragment.totalSize) - buffer.size() < fragment.data.size() ) {
+        qCWarning(lcProtocol) << "FragmentAssembler: out-of-order fragment, message" << fragment.messageId
+            << "offset" << fragment.offset << "received" << buffer.size();
+        m_partial.erase(it);
+        return Result::Invalid;
+    }
+
+    buffer.append(fragment.data);
+    if ( buffer.size() < static_cast<qsizetype>(fragment.totalSize) ) {
+        return Result::Incomplete;
+    }
+
+    message = std::move(buffer);
+    m_partial.erase(it);
+    return Result::Complete;
+}
+
+void FragmentAssembler::clear() {
+    m_partial.clear();
+}
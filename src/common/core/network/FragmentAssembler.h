@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Protocol.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief FRAGMENT 分片重组
+ *
+ * 发送端（PrioritySendQueue）按偏移递增连续发出同一消息的分片，因此这里只接受
+ * 顺序到达的分片：偏移必须等于已收字节数，否则视为协议错误。
+ * 重组完成后返回完整消息字节（含消息头），由调用方按普通消息解析。
+ *
+ * 由所属套接字线程独占使用（非线程安全）。
+ */
+class FragmentAssembler {
+public:
+    enum class Result {
+        Incomplete,   ///< 已接收，等待后续分片
+        Complete,     ///< 消息重组完成
+        Invalid       ///< 分片与已收数据不一致或超出限制
+    };
+
+    /**
+     * @brief 添加一个分片
+     * @param fragment 已解码的分片（data 只需在调用期间有效）
+     * @param message 输出：Complete 时为完整消息字节
+     */
+    Result addFragment(const MessageFragment& fragment, QByteArray& message);
+
+    /// 正在重组的消息数
+    qsizetype pendingMessages() const { return m_partial.size(); }
+
+    void clear();
+
+private:
+    QHash<quint32, QByteArray> m_partial;   ///< messageId -> 已收数据（容量预留为总长度）
+};
@@ -0,0 +1,160 @@
+#include "PrioritySendQueue.h"
+#include "../config/NetworkConstants.h"
+#include <QtCore/QtEndian>
+#include <algorithm>
+#include <utility>
+
+PrioritySendQueue::PrioritySendQueue(Writer writer)
+    : m_writer(std::move(writer))
+    , m_fragmentSize(0)
+    , m_lowWatermark(NetworkConstants::SEND_LOW_WATERMARK)
+    , m_checksumAlgorithm(ChecksumAlgorithm::CRC32)
+    , m_nextMessageId(1) {
+}
+
+SendLane PrioritySendQueue::laneOf(MessageType type) {
+    switch ( type ) {
+        case MessageType::SCREEN_DATA:
+        case MessageType::SCREEN_UPDATE:
+        case MessageType::TILE_UPDATE:
+        case MessageType::MONITOR_LAYOUT:
+        case MessageType::AUDIO_DATA:
+        case MessageType::FILE_DATA:
+            return SendLane::BULK;
+        default:
+            return SendLane::INTERACTIVE;
+    }
+}
+
+void PrioritySendQueue::setFragmentSize(qsizetype fragmentSize) {
+    m_fragmentSize = std::max<qsizetype>(0, fragmentSize);
+}
+
+void PrioritySendQueue::setChecksumAlgorithm(ChecksumAlgorithm algorithm) {
+    m_checksumAlgorithm = algorithm;
+}
+
+void PrioritySendQueue::setLowWatermark(qint64 bytes) {
+    m_lowWatermark = std::max<qint64>(0, bytes);
+}
+
+void PrioritySendQueue::enqueue(MessageSegments segments) {
+    if ( segments.isEmpty() ) {
+        return;
+    }
+
+    MessageHeader header;
+    const bool hasHeader = header.decodeView(segments.head);
+    PendingMessage message;
+    message.segments = std::move(segments);
+    if ( hasHeader && laneOf(header.type) == SendLane::BULK ) {
+        m_bulk.push_back(std::move(message));
+    } else {
+        m_interactive.push_back(std::move(message));
+    }
+}
+
+qint64 PrioritySendQueue::flush(qint64 socketPendingBytes) {
+    qint64 total = 0;
+
+    // 交互消息不受水位限制，始终插在下一个批量分片之前
+    while ( !m_interactive.empty() ) {
+        const qint64 written = writeSegments(m_interactive.front().segments);
+        m_interactive.pop_front();
+        if ( written < 0 ) {
+            return -1;
+        }
+        total += written;
+    }
+
+    // 批量消息：套接字积压低于水位时才继续写，避免整帧堆在交互消息前面
+    while ( !m_bulk.empty() && socketPendingBytes + total < m_lowWatermark ) {
+        PendingMessage& message = m_bulk.front();
+        qint64 written = 0;
+        if ( m_fragmentSize > 0 && message.segments.size() > m_fragmentSize ) {
+            written = writeNextFragment(message);
+            if ( written >= 0 && message.sent >= message.segments.size() ) {
+                m_bulk.pop_front();
+            }
+        } else {
+            written = writeSegments(message.segments);
+            m_bulk.pop_front();
+        }
+        if ( written < 0 ) {
+            return -1;
+        }
+        total += written;
+    }
+    return total;
+}
+
+void PrioritySendQueue::clear() {
+    m_interactive.clear();
+    m_bulk.clear();
+    m_scratch = QByteArray();
+}
+
+qint64 PrioritySendQueue::writeSegments(const MessageSegments& segments) {
+    qint64 total = 0;
+    for ( const QByteArray* part : { &segments.head, &segments.body, &segments.tail } ) {
+        if ( part->isEmpty() ) {
+            continue;
+        }
+        const qint64 written = m_writer(part->constData(), part->size());
+        if ( written < 0 ) {
+            return -1;
+        }
+        total += written;
+    }
+    return total;
+}
+
+qint64 PrioritySendQueue::writeNextFragment(PendingMessage& message) {
+    const MessageSegments& segments = message.segments;
+    const qint64 totalSize = segments.size();
+    const qint64 length = std::min<qint64>(m_fragmentSize, totalSize - message.sent);
+
+    // 分片落在单个段内时直接引用；跨段时（仅消息首尾各一次）拷贝到复用缓冲
+    QByteArrayView data;
+    qint64 segmentStart = 0;
+    for ( const QByteArray* part : { &segments.head, &segments.body, &segments.tail } ) {
+        const qint64 segmentEnd = segmentStart + part->size();
+        if ( message.sent >= segmentStart && message.sent + length <= segmentEnd ) {
+            data = QByteArrayView(part->constData() + (message.sent - segmentStart), length);
+            break;
+        }
+        segmentStart = segmentEnd;
+    }
+    if ( data.isNull() ) {
+        m_scratch.resize(length);
+        qint64 copied = 0;
+        segmentStart = 0;
+        for ( const QByteArray* part : { &segments.head, &segments.body, &segments.tail } ) {
+            const qint64 segmentEnd = segmentStart + part->size();
+            const qint64 from = std::max(message.sent + copied, segmentStart);
+            const qint64 to = std::min(message.sent + length, segmentEnd);
+            if ( from < to ) {
+                std::copy_n(part->constData() + (from - segmentStart), to - from, m_scratch.data() + copied);
+                copied += to - from;
+            }
+            segmentStart = segmentEnd;
+        }
+        data = QByteArrayView(m_scratch.constData(), length);
+    }
+
+    if ( message.sent == 0 ) {
+        message.messageId = m_nextMessageId++;
+    }
+
+    MessageFragment fragment;
+    fragment.messageId = message.messageId;
+    fragment.totalSize = static_cast<quint32>(totalSize);
+    fragment.offset = static_cast<quint32>(message.sent);
+    fragment.data = data;
+
+    const qint64 written = writeSegments(Protocol::createMessageSegments(MessageType::FRAGMENT, fragment, m_checksumAlgorithm));
+    if ( written >= 0 ) {
+        message.sent += length;
+    }
+    return written;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Protocol.h"
+#include <QtCore/QByteArray>
+#include <QtCore/qglobal.h>
+#include <deque>
+#include <functional>
+
+// 发送通道：交互通道总是先于批量通道写出
+enum class SendLane : quint8 {
+    INTERACTIVE = 0,   ///< 输入、控制、心跳、光标、剪贴板：立即写出，不分片
+    BULK = 1           ///< 屏幕（含图块更新）、音频、文件数据：受低水位限制，可分片
+};
+
+/**
+ * @brief 按优先级调度并分片的发送队列
+ *
+ * 原实现把多MB的 SCREEN_DATA 一次写入套接字，之后的心跳、光标、输入回复都要排在
+ * 整帧之后。这里把待发消息分为交互/批量两个通道：
+ * - 交互消息在 flush() 时立即写出
+ * - 批量消息只在套接字待发字节低于低水位时写出；对端支持分片时每次只写一个分片
+ * 因此交互消息的排队延迟上限约为 (低水位 + 分片大小) 字节的发送时间，与帧大小无关。
+ *
+ * 由所属套接字线程独占使用（非线程安全）。所有者在入队后及套接字 bytesWritten 时调用 flush()。
+ */
+class PrioritySendQueue {
+public:
+    /// 写出函数：返回写入字节数，出错返回 -1
+    using Writer = std::function<qint64(const char* data, qint64 length)>;
+
+    explicit PrioritySendQueue(Writer writer);
+
+    static SendLane laneOf(MessageType type);
+
+    /**
+     * @brief 设置分片大小（对端声明 FRAGMENTATION 后启用）
+     * @param fragmentSize 每片数据字节数；<= 0 表示不分片
+     */
+    void setFragmentSize(qsizetype fragmentSize);
+    qsizetype fragmentSize() const { return m_fragmentSize; }
+
+    /// 分片消息使用的校验算法（与连接协商结果一致）
+    void setChecksumAlgorithm(ChecksumAlgorithm algorithm);
+
+    /// 批量通道的低水位（字节）
+    void setLowWatermark(qint64 bytes);
+
+    /**
+     * @brief 入队一条已编码的完整消息，通道由消息头中的类型决定
+     */
+    void enqueue(MessageSegments segments);
+
+    /**
+     * @brief 写出队列中的数据
+     * @param socketPendingBytes 套接字当前尚未发出的字节数
+     * @return 本次写出的字节数；写出失败返回 -1
+     */
+    qint64 flush(qint64 socketPendingBytes);
+
+    bool isEmpty() const { return m_interactive.empty() && m_bulk.empty(); }
+    qsizetype pendingBulkMessages() const { return static_cast<qsizetype>(m_bulk.size()); }
+
+    /// 丢弃所有未发送的数据（断开连接时调用）
+    void clear();
+
+private:
+    struct PendingMessage {
+        MessageSegments segments;
+        qint64 sent = 0;          ///< 已写出的字节数（分片发送进度）
+        quint32 messageId = 0;    ///< 分片消息编号（首个分片时分配）
+    };
+
+    qint64 writeSegments(const MessageSegments& segments);
+    qint64 writeNextFragment(PendingMessage& message);
+
+    Writer m_writer;
+    std::deque<PendingMessage> m_interactive;
+    std::deque<PendingMessage> m_bulk;
+    qsizetype m_fragmentSize;
+    qint64 m_lowWatermark;
+    ChecksumAlgorithm m_checksumAlgorithm;
+    quint32 m_nextMessageId;
+    QByteArray m_scratch;         ///< 跨段分片的拼接缓冲（复用）
+};
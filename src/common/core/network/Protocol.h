@@ -1,10 +1,15 @@
 #pragma once
 
 #include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
 #include <QtCore/QDataStream>
 #include <QtCore/QIODevice>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QRect>
 #include <QtCore/qglobal.h>
 #include <QtCore/Qt>
+#include "Checksum.h"
 
 // 取消Windows SDK中的宏定义,避免命名冲突
 #ifdef _WIN32
@@ -21,6 +26,8 @@ inline constexpr quint32 PROTOCOL_VERSION = 1;
 inline constexpr quint32 PROTOCOL_MAGIC = 0x52444350;  // "RDCP" in hex
 // Serialized header size: 5 × quint32 + 1 × quint64 = 28 bytes
 inline constexpr quint32 SERIALIZED_HEADER_SIZE = 5 * sizeof(quint32) + sizeof(quint64);
+// 能力集格式版本（与 PROTOCOL_VERSION 独立：后者只描述帧格式）
+inline constexpr quint16 CAPABILITY_SET_VERSION = 1;
 
 // 消息类型枚举
 enum class MessageType : quint32 {
@@ -32,17 +39,23 @@ enum class MessageType : quint32 {
     HEARTBEAT = 0x0006,
     HEARTBEAT_RESPONSE = 0x0007,
     AUTH_CHALLENGE = 0x0008,
+    FRAGMENT = 0x0009,          ///< 大消息分片（需协商 Capability::FRAGMENTATION）
 
     // 屏幕数据
     SCREEN_DATA = 0x1001,
     SCREEN_UPDATE = 0x1002,
     SCREEN_RESOLUTION = 0x1003,
     CURSOR_POSITION = 0x1004,
-    CURSOR_SHAPE = 0x1005,
+    CURSOR_SHAPE = 0x1005,      ///< 光标图像或缓存ID（需协商 Capability::CURSOR_SHAPE）
+    CURSOR_STATE = 0x1006,      ///< 光标坐标与类型，仅在变化时发送（需协商 Capability::CURSOR_STREAM）
+    TILE_UPDATE = 0x1007,       ///< 图块更新：缓存引用或新图块（需协商 Capability::TILE_CACHE）
+    MONITOR_LAYOUT = 0x1008,    ///< 显示器布局与本会话查看的显示器（需协商 Capability::MULTI_MONITOR）
+    MONITOR_SELECT = 0x1009,    ///< 客户端选择查看的显示器（需协商 Capability::MULTI_MONITOR）
 
     // 输入事件
     MOUSE_EVENT = 0x2001,
     KEYBOARD_EVENT = 0x2002,
+    INPUT_BATCH = 0x2003,       ///< 批量输入事件（需协商 Capability::INPUT_BATCH）
 
     // 音频数据
     AUDIO_DATA = 0x3001,
@@ -109,6 +122,14 @@ public:
 
     // 从接收缓冲区尝试解析一帧，成功则填充header与payload，并从buffer移除已消费字节
     [[nodiscard]] virtual bool decode(const QByteArray& dataBuffer) = 0;
+
+    // 把编码结果追加到 out 末尾（不产生中间缓冲区）；默认实现追加 encode() 的结果
+    virtual void appendTo(QByteArray& out) const;
+
+    // 分段编码：固定字段追加到 head，大块数据以隐式共享放入 body，可选尾部字段写入 tail
+    // 三段依次拼接即为 encode() 的结果。默认实现把 encode() 整体追加到 head；
+    // 携带大块数据的消息应重写以避免拷贝
+    [[nodiscard]] virtual bool encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const;
 };
 
 // 消息头结构
@@ -122,6 +143,10 @@ struct MessageHeader : public IMessageCodec {
 
     QByteArray encode() const;
     bool decode(const QByteArray& dataBuffer);
+    // 原地解析，不拷贝输入
+    bool decodeView(QByteArrayView dataBuffer);
+    // 原地序列化到 out（至少 SERIALIZED_HEADER_SIZE 字节）
+    void encodeInto(char* out) const;
 };
 
 //基础数据
@@ -132,6 +157,71 @@ struct BaseMessage : public IMessageCodec {
     bool decode(const QByteArray& dataBuffer);
 };
 
+// 心跳时间戳（NTP对称模式，HEARTBEAT/HEARTBEAT_RESPONSE 载荷）
+// 旧版本对端发送空载荷，decode 失败时按普通心跳处理即可
+struct HeartbeatMessage : public IMessageCodec {
+    quint64 originTimestamp;    ///< 回显：对端上一条心跳的发送时间（对端时钟，毫秒）
+    quint64 receiveTimestamp;   ///< 本端收到对端上一条心跳的时间（本端时钟，毫秒）
+    quint64 transmitTimestamp;  ///< 本条心跳的发送时间（本端时钟，毫秒）
+
+    HeartbeatMessage() : originTimestamp(0), receiveTimestamp(0), transmitTimestamp(0) {}
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+};
+
+// 能力标识（握手时协商）
+// 新增能力只需追加ID；对端不认识的ID会被忽略，因此无需提升 PROTOCOL_VERSION
+enum class Capability : quint16 {
+    CLOCK_SYNC = 0x0001,          ///< 心跳携带时间戳，用于时钟偏移估计
+    CAPTURE_TIMESTAMP = 0x0002,   ///< ScreenData 携带捕获时间尾部字段
+    ZSTD_SCREEN = 0x0003,         ///< 可接收zstd二次压缩的屏幕数据；未声明时服务端发送解压后的JPEG
+    SCALED_SCREEN = 0x0004,       ///< 保留：所有客户端都能显示缩放帧（SCALED 标志早于能力协商），不再声明
+    CLIPBOARD_IMAGE = 0x0005,     ///< 支持图片剪贴板同步；未协商时客户端只同步文本
+    MAX_MESSAGE_SIZE = 0x0006,    ///< 参数：quint32 接收端可接受的最大消息载荷（字节），服务端跳过超过该大小的屏幕帧
+    CHECKSUM = 0x0007,            ///< 参数：quint32 请求中为支持的算法位掩码，响应中为选定的 ChecksumAlgorithm
+    FRAGMENTATION = 0x0008,       ///< 可接收 FRAGMENT 分片，发送端据此把大消息切分并与交互消息交错发送
+    INPUT_BATCH = 0x0009,         ///< 可接收 INPUT_BATCH，客户端合并鼠标移动并批量发送输入事件
+    CURSOR_STREAM = 0x000A,       ///< 可接收 CURSOR_STATE，由客户端在本地绘制远程光标
+    CURSOR_SHAPE = 0x000B,        ///< 参数：quint32 光标图像缓存条目数；响应中为双方取小后的值
+    TILE_CACHE = 0x000C,          ///< 参数：quint32 图块缓存条目数；响应中为双方取小后的值
+    COPY_RECT = 0x000D,           ///< 可应用 TileUpdate 中的区域复制（滚动时复用已有画面）
+    MULTI_MONITOR = 0x000E        ///< 可接收 MONITOR_LAYOUT 并发送 MONITOR_SELECT，按显示器查看
+};
+
+/**
+ * @brief 版本化能力集
+ *
+ * 作为握手请求/响应的可选尾部字段传输（TLV 编码）：
+ *   quint16 version | quint16 count | count × { quint16 id | quint16 length | length 字节参数 }
+ * 旧版本对端不写该字段、也不会读取它，解码时缺失即视为空能力集。
+ *
+ * 协商流程：客户端在握手请求中声明自身能力，服务端回复双方共同支持的能力
+ * （参数为服务端自己的取值），之后双方各自保留对端参数用于发送决策。
+ */
+struct CapabilitySet {
+    quint16 version = CAPABILITY_SET_VERSION;
+    QMap<quint16, QByteArray> entries;    ///< 能力ID -> 参数（可为空）
+
+    bool isEmpty() const { return entries.isEmpty(); }
+    bool has(Capability capability) const { return entries.contains(static_cast<quint16>(capability)); }
+    void set(Capability capability, const QByteArray& params = QByteArray());
+    void setUInt32(Capability capability, quint32 value);
+    QByteArray params(Capability capability) const;
+    // 读取 quint32 参数，缺失或长度不符时返回 defaultValue
+    quint32 uint32Param(Capability capability, quint32 defaultValue = 0) const;
+
+    // 返回双方都支持的能力，参数取自 this
+    CapabilitySet intersected(const CapabilitySet& other) const;
+
+    // 本端支持的能力（客户端与服务端共用）
+    static CapabilitySet local();
+
+    void encode(QDataStream& ds) const;
+    bool decode(QDataStream& ds);
+};
+
 // 握手请求数据
 struct HandshakeRequest : public IMessageCodec {
     quint32 clientVersion;
@@ -140,6 +230,7 @@ struct HandshakeRequest : public IMessageCodec {
     quint8 colorDepth;
     QString clientName;
     QString clientOS;
+    CapabilitySet capabilities;   ///< 客户端能力（可选尾部字段，旧版本客户端为空）
 
     // 将当前结构体序列化为QByteArray（小端）
     QByteArray encode() const;
@@ -153,9 +244,10 @@ struct HandshakeResponse : public IMessageCodec {
     quint16 screenWidth;
     quint16 screenHeight;
     quint8 colorDepth;
-    quint8 supportedFeatures;
+    quint8 supportedFeatures;     ///< 已废弃，保留以兼容旧版本线格式，始终为0；请使用 capabilities
     QString serverName;
     QString serverOS;
+    CapabilitySet capabilities;   ///< 协商后的共同能力（可选尾部字段，旧版本服务端为空）
 
     QByteArray encode() const;
     bool decode(const QByteArray& dataBuffer);
@@ -168,6 +260,7 @@ struct AuthenticationRequest : public IMessageCodec {
     quint32 authMethod;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -178,6 +271,7 @@ struct AuthenticationResponse : public IMessageCodec {
     quint32 permissions;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -189,6 +283,7 @@ struct AuthChallenge : public IMessageCodec {
     QString saltHex;     // 盐（hex字符串）
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -200,6 +295,7 @@ struct MouseEvent : public IMessageCodec {
     qint16 wheelDelta;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -211,9 +307,37 @@ struct KeyboardEvent : public IMessageCodec {
     QString text;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
+// 批量输入中的单个事件
+struct InputBatchEvent {
+    enum class Kind : quint8 {
+        MOUSE = 0,
+        KEYBOARD = 1
+    };
+
+    Kind kind = Kind::MOUSE;
+    quint16 timeOffsetMs = 0;   ///< 相对批次 baseTimestamp 的偏移（毫秒）
+    MouseEvent mouse{};         ///< kind == MOUSE 时有效
+    KeyboardEvent keyboard{};   ///< kind == KEYBOARD 时有效
+};
+
+// 批量输入事件：quint64 baseTimestamp | quint16 count | count × { quint8 kind | quint16 timeOffsetMs | 事件载荷 }
+// 事件按产生顺序排列，接收端按顺序重放
+struct InputBatch : public IMessageCodec {
+    static constexpr int MAX_EVENTS = 256;
+
+    quint64 baseTimestamp = 0;  ///< 第一个事件的客户端时间（毫秒）
+    QList<InputBatchEvent> events;
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+    bool decodeView(QByteArrayView dataBuffer);
+};
+
 // 屏幕数据压缩类型标志
 enum class ScreenDataFlags : quint8 {
     NONE = 0x00,           ///< 无特殊标志（仅JPEG压缩）
@@ -232,11 +356,152 @@ struct ScreenData : public IMessageCodec {
     quint32 dataSize;
     quint8 flags;              ///< 压缩标志 (ScreenDataFlags)
     QByteArray imageData;
+    QByteArrayView imageView;  ///< decodeView() 填充：指向输入缓冲区中的图像字节，输入存活期间有效
+    quint64 captureTimestamp;  ///< 服务端捕获时间（服务端时钟，毫秒；0表示未知）。可选尾部字段，旧版本解码时忽略
+
+    static constexpr qsizetype FIXED_FIELDS_SIZE = 17;  ///< 图像数据之前的固定字段长度
 
-    ScreenData() : x(0), y(0), width(0), height(0), originalWidth(0), originalHeight(0), dataSize(0), flags(0) {}
+    ScreenData() : x(0), y(0), width(0), height(0), originalWidth(0), originalHeight(0), dataSize(0), flags(0), captureTimestamp(0) {}
 
     QByteArray encode() const; // 附带数据体
+    // 图像数据以隐式共享放入 body，不拷贝
+    bool encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const;
+    // 解码并拷贝图像数据到 imageData
     bool decode(const QByteArray& dataBuffer);
+    // 零拷贝解码：只填充 imageView，调用方需保证输入在使用期间存活
+    bool decodeView(QByteArrayView dataBuffer);
+};
+
+// TileUpdate 中单个图块记录的类型
+enum class TileRecordKind : quint8 {
+    CACHED = 0,    ///< 绘制缓存中的图块（cacheId）到 (x,y)
+    ENCODED = 1,   ///< 携带 JPEG 数据：解码后存入缓存（cacheId）并绘制
+    STORE = 2,     ///< 不绘制：把当前画面中该矩形存入缓存（紧随整帧 SCREEN_DATA 发送）
+    VIDEO = 3      ///< 视频区域：携带 JPEG 数据（可能已缩小），放大到矩形尺寸后绘制，不入缓存（cacheId 为 0）
+};
+
+// 图块记录：quint8 kind | quint32 cacheId | quint16 x | quint16 y | quint16 width | quint16 height | [quint32 dataSize | JPEG]
+// 只有 ENCODED/VIDEO 携带数据；VIDEO 的矩形不要求按图块对齐
+struct TileRecord {
+    TileRecordKind kind = TileRecordKind::CACHED;
+    quint32 cacheId = 0;
+    quint16 x = 0;
+    quint16 y = 0;
+    quint16 width = 0;
+    quint16 height = 0;
+    QByteArray data;           ///< kind == ENCODED/VIDEO 时为 JPEG 数据
+
+    QRect rect() const { return QRect(x, y, width, height); }
+    bool hasData() const { return kind == TileRecordKind::ENCODED || kind == TileRecordKind::VIDEO; }
+};
+
+// 画面内区域复制：把当前画面中 (srcX, srcY) 起的 width×height 区域复制到 (x, y)，源与目标可重叠
+// 线上格式：quint16 srcX | srcY | x | y | width | height
+struct CopyRect {
+    quint16 srcX = 0;
+    quint16 srcY = 0;
+    quint16 x = 0;
+    quint16 y = 0;
+    quint16 width = 0;
+    quint16 height = 0;
+
+    QRect sourceRect() const { return QRect(srcX, srcY, width, height); }
+    QRect targetRect() const { return QRect(x, y, width, height); }
+};
+
+/**
+ * @brief 图块更新消息
+ *
+ * 服务端按内容哈希为图块分配缓存ID，客户端已持有的图块只发送 "缓存ID 位于 x,y"，
+ * 未持有的才携带编码数据。双方各自维护容量相同（握手协商）的 LRU，
+ * 按记录顺序插入（ENCODED/STORE）和访问（CACHED），淘汰结果因此一致。
+ * 坐标与尺寸为传输帧（可能已缩放）的像素坐标，语义同 ScreenData。
+ *
+ * 滚动时服务端检测到的位移以 CopyRect 发送（需协商 Capability::COPY_RECT），
+ * 客户端先在画面内复制，再应用图块记录，只有新露出的部分需要编码。
+ *
+ * 线上格式：width | height | originalWidth | originalHeight | flags | captureTimestamp | quint32 count | count × TileRecord
+ *          [| quint16 copyCount | copyCount × CopyRect]（可选尾部，没有复制时省略）
+ */
+struct TileUpdate : public IMessageCodec {
+    static constexpr quint32 MAX_RECORDS = 65536;
+    static constexpr quint16 MAX_COPIES = 16;
+
+    quint16 width;             ///< 传输帧宽度（可能是缩放后的）
+    quint16 height;            ///< 传输帧高度
+    quint16 originalWidth;     ///< 原始屏幕宽度（缩放前）
+    quint16 originalHeight;    ///< 原始屏幕高度
+    quint8 flags;              ///< ScreenDataFlags（仅 SCALED 有意义）
+    quint64 captureTimestamp;  ///< 服务端捕获时间（毫秒；0表示未知）
+    QList<TileRecord> records; ///< 按顺序应用
+    QList<CopyRect> copies;    ///< 先于 records 按顺序应用
+
+    TileUpdate() : width(0), height(0), originalWidth(0), originalHeight(0), flags(0), captureTimestamp(0) {}
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+};
+
+// MonitorInfo 标志位
+enum class MonitorFlags : quint8 {
+    NONE = 0x00,
+    PRIMARY = 0x01,     ///< 主显示器
+    VIEWED = 0x02       ///< 本会话正在查看
+};
+
+// 单个显示器：quint8 id | quint8 flags | qint16 x | qint16 y | quint16 width | quint16 height
+// 几何为服务端虚拟桌面中的逻辑坐标（与 MouseEvent 换算前的屏幕坐标一致）
+struct MonitorInfo {
+    quint8 id = 0;
+    quint8 flags = 0;          ///< MonitorFlags 位组合
+    qint16 x = 0;
+    qint16 y = 0;
+    quint16 width = 0;
+    quint16 height = 0;
+
+    QRect geometry() const { return QRect(x, y, width, height); }
+    bool isPrimary() const { return (flags & static_cast<quint8>(MonitorFlags::PRIMARY)) != 0; }
+    bool isViewed() const { return (flags & static_cast<quint8>(MonitorFlags::VIEWED)) != 0; }
+};
+
+/**
+ * @brief 显示器布局消息（服务端 -> 客户端）
+ *
+ * 认证成功后以及本会话查看的显示器变化后发送。与屏幕数据同走批量通道，
+ * 客户端按到达顺序切换显示方式，之前排队的旧视图帧不会被按新布局拼合。
+ * 只查看一个显示器时与旧版相同：ScreenData 的 x,y 为 0，画面即该显示器；
+ * 查看多个时 ScreenData 的 x,y 为帧区域相对 viewedBounds() 左上角的偏移、originalWidth/originalHeight 为帧区域的尺寸
+ * （均为逻辑坐标；配置了抓取区域时帧只覆盖显示器的一部分），由客户端拼合，不使用图块缓存。
+ *
+ * 线上格式：quint8 count | count × MonitorInfo
+ */
+struct MonitorLayout : public IMessageCodec {
+    static constexpr int MAX_MONITORS = 16;
+
+    QList<MonitorInfo> monitors;
+
+    // 查看中的显示器的外接矩形（逻辑坐标）
+    QRect viewedBounds() const;
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+};
+
+/**
+ * @brief 显示器选择消息（客户端 -> 服务端）
+ *
+ * 列出要查看的显示器ID：一个即单屏查看，全部即查看全部，再次发送即切换。
+ * 服务端只捕获至少有一个会话在查看的显示器，并以新的 MONITOR_LAYOUT 确认。
+ * 线上格式：quint8 count | count × quint8 id
+ */
+struct MonitorSelect : public IMessageCodec {
+    QList<quint8> monitorIds;
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
 };
 
 // 音频数据
@@ -248,6 +513,7 @@ struct AudioData : public IMessageCodec {
     // 实际音频数据跟在后面
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -259,6 +525,71 @@ struct CursorMessage : public IMessageCodec {
     explicit CursorMessage(Qt::CursorShape type);
 
     QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+};
+
+// CursorState 标志位
+enum class CursorStateFlags : quint8 {
+    NONE = 0x00,
+    VISIBLE = 0x01      ///< 远程光标可见
+};
+
+/**
+ * @brief 光标状态消息（定长 6 字节）
+ *
+ * 服务端以高频率轮询指针，只有坐标、类型或可见性变化时才发送，
+ * 客户端据此在本地叠加绘制光标，不依赖屏幕帧的解码与显示。
+ * 坐标为服务端屏幕坐标（与 MouseEvent 一致）。
+ */
+struct CursorState : public IMessageCodec {
+    qint16 x;
+    qint16 y;
+    Qt::CursorShape cursorType;
+    quint8 flags;                      // CursorStateFlags 位组合
+
+    CursorState();
+
+    bool isVisible() const { return (flags & static_cast<quint8>(CursorStateFlags::VISIBLE)) != 0; }
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
+    bool decode(const QByteArray& dataBuffer) override;
+};
+
+// CursorShapeMessage 标志位
+enum class CursorShapeFlags : quint8 {
+    NONE = 0x00,
+    HAS_BITMAP = 0x01   ///< 携带位图（首次发送该图像）；否则只引用缓存ID
+};
+
+/**
+ * @brief 光标图像消息
+ *
+ * 服务端按内容哈希为光标图像分配缓存ID，首次发送时携带位图，之后只发送ID。
+ * 双方各自维护容量相同（握手协商）的 LRU，按相同顺序插入和访问，
+ * 因此服务端的镜像索引与客户端缓存的淘汰结果一致。
+ *
+ * 线上格式：cacheId | flags | width | height | hotspotX | hotspotY | [位图]
+ * 位图为 width*height 个预乘 ARGB32 像素，逐像素小端 quint32，行间无填充。
+ */
+struct CursorShapeMessage : public IMessageCodec {
+    static constexpr int MAX_DIMENSION = 128;     ///< 单边最大像素数（交互通道不分片，限制消息大小）
+
+    quint32 cacheId;
+    quint8 flags;                      // CursorShapeFlags 位组合
+    quint16 width;
+    quint16 height;
+    qint16 hotspotX;
+    qint16 hotspotY;
+    QByteArray pixels;                 // HAS_BITMAP 时为 width*height*4 字节
+
+    CursorShapeMessage();
+
+    bool hasBitmap() const { return (flags & static_cast<quint8>(CursorShapeFlags::HAS_BITMAP)) != 0; }
+
+    QByteArray encode() const override;
+    void appendTo(QByteArray& out) const override;
     bool decode(const QByteArray& dataBuffer) override;
 };
 
@@ -270,6 +601,7 @@ struct FileTransferRequest : public IMessageCodec {
     quint8 direction;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -280,6 +612,7 @@ struct FileTransferResponse : public IMessageCodec {
     QString errorMessage;
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -291,6 +624,7 @@ struct FileData : public IMessageCodec {
     // 实际文件数据跟在后面
 
     QByteArray encode() const;
+    void appendTo(QByteArray& out) const;
     bool decode(const QByteArray& dataBuffer);
 };
 
@@ -320,22 +654,65 @@ struct ClipboardMessage : public IMessageCodec {
     bool decode(const QByteArray& dataBuffer) override;
 };
 
+// 消息分片（FRAGMENT 载荷）
+// 完整消息（含消息头）按字节切分，每片作为独立的 FRAGMENT 消息发送；接收端按序拼接后再整体解析。
+// 同一消息的分片按偏移递增连续发出，期间可穿插其他非分片消息。
+struct MessageFragment : public IMessageCodec {
+    quint32 messageId;     ///< 发送端递增的消息编号
+    quint32 totalSize;     ///< 完整消息总字节数（含消息头）
+    quint32 offset;        ///< 本分片在完整消息中的偏移
+    QByteArrayView data;   ///< 分片数据：编码时指向待发送消息，decodeView() 后指向输入缓冲区
+
+    static constexpr qsizetype FIXED_FIELDS_SIZE = 12;
+
+    MessageFragment() : messageId(0), totalSize(0), offset(0) {}
+
+    QByteArray encode() const override;
+    // 分片数据以 fromRawData 放入 body，不拷贝；segments 必须在 data 指向的内存存活期间写出
+    bool encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const override;
+    // 解码后 data 指向 dataBuffer 内部
+    bool decode(const QByteArray& dataBuffer) override;
+    bool decodeView(QByteArrayView dataBuffer);
+};
+
+// 分段编码的完整消息：head | body | tail 依次写出即为完整消息
+// head 包含消息头与载荷固定字段；body 与消息对象隐式共享（如 ProcessedData 的图像字节），不做拷贝
+struct MessageSegments {
+    QByteArray head;
+    QByteArray body;
+    QByteArray tail;
+
+    bool isEmpty() const { return head.isEmpty(); }
+    qsizetype size() const { return head.size() + body.size() + tail.size(); }
+    // 合并为连续缓冲区（一次分配）
+    QByteArray toByteArray() const;
+};
+
 // 协议工具类（TLS负责传输层加密，协议层不再加密）
 class Protocol {
 public:
-    // 创建消息
-    [[nodiscard]] static QByteArray createMessage(MessageType type, const IMessageCodec& message);
+    // 分段创建消息：预留消息头空间，载荷字段直接写在其后，校验和跨段增量计算
+    // 编码失败时返回空结果
+    [[nodiscard]] static MessageSegments createMessageSegments(MessageType type, const IMessageCodec& message,
+                                                               ChecksumAlgorithm algorithm = ChecksumAlgorithm::CRC32);
+
+    // 创建消息（algorithm 为握手协商的校验算法，握手完成前固定为 CRC32）
+    [[nodiscard]] static QByteArray createMessage(MessageType type, const IMessageCodec& message,
+                                                  ChecksumAlgorithm algorithm = ChecksumAlgorithm::CRC32);
 
-    // 解析消息
-    [[nodiscard]] static qsizetype parseMessage(const QByteArray& data, MessageHeader& header, QByteArray& payload);
+    // 解析消息（零拷贝）：payload 指向 data 内部，data 存活且未修改期间有效
+    // 返回值：-1 表示数据不完整，0 表示数据无效，>0 表示已消费的完整消息长度
+    [[nodiscard]] static qsizetype parseMessage(QByteArrayView data, MessageHeader& header, QByteArrayView& payload,
+                                                ChecksumAlgorithm algorithm = ChecksumAlgorithm::CRC32);
+
+    // 解析消息：payload 为独立拷贝
+    [[nodiscard]] static qsizetype parseMessage(QByteArrayView data, MessageHeader& header, QByteArray& payload,
+                                                ChecksumAlgorithm algorithm = ChecksumAlgorithm::CRC32);
 
 private:
     // 验证接收数据的完整性（检查数据长度是否完整）
     // 参数：data - 接收缓冲区数据，header - 输出参数，数据完整时填充消息头信息
     // 返回值：-1 表示数据不完整需要等待更多数据，0 表示数据无效，>0 表示完整消息的总长度
-    static qsizetype validateReceivedDataIntegrity(const QByteArray& data, MessageHeader& header);
-
-    // 计算校验和
-    static quint32 calculateChecksum(const QByteArray& data);
+    static qsizetype validateReceivedDataIntegrity(QByteArrayView data, MessageHeader& header, ChecksumAlgorithm algorithm);
 };
 
@@ -6,50 +6,100 @@
 #include <QtCore/QtEndian>
 #include "../logging/LoggingCategories.h"
 #include "../config/NetworkConstants.h"
+#include "WireFormat.h"
 #include <cstring>
-#include <array>
+#include <algorithm>
 
 // Protocol 类的静态函数实现（TLS负责传输层加密，协议层不再加密）
-QByteArray Protocol::createMessage(MessageType type, const IMessageCodec& message) {
-    // 步骤1：编码消息载荷（明文，由TLS保护）
-    QByteArray payload = message.encode();
+static constexpr qsizetype SMALL_PAYLOAD_RESERVE = 64;
+
+MessageSegments Protocol::createMessageSegments(MessageType type, const IMessageCodec& message, ChecksumAlgorithm algorithm) {
+    // 步骤1：预留消息头空间，载荷固定字段直接写在其后（明文，由TLS保护）
+    // 预留的容量足以容纳常见输入/控制消息，整条消息只分配一次
+    MessageSegments segments;
+    segments.head.reserve(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE) + SMALL_PAYLOAD_RESERVE);
+    segments.head.resize(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE));
+    if ( !message.encodeSegments(segments.head, segments.body, segments.tail) ) {
+        return MessageSegments();
+    }
+
+    // 步骤2：构建消息头，校验和跨段增量计算，不需要先拼接载荷
+    const QByteArrayView fixedFields = QByteArrayView(segments.head).sliced(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE));
+    quint32 checksum = Checksum::compute(algorithm, fixedFields);
+    checksum = Checksum::compute(algorithm, segments.body, checksum);
+    checksum = Checksum::compute(algorithm, segments.tail, checksum);
 
-    // 步骤2：构建消息头
     MessageHeader header;
     header.magic = PROTOCOL_MAGIC;
     header.version = PROTOCOL_VERSION;
     header.type = type;
-    header.length = static_cast<quint32>(payload.size());
+    header.length = static_cast<quint32>(segments.size() - static_cast<qsizetype>(SERIALIZED_HEADER_SIZE));
     header.timestamp = QDateTime::currentMSecsSinceEpoch();
-    header.checksum = calculateChecksum(payload);
-    QByteArray headerData = header.encode();
+    header.checksum = checksum;
+
+    // 步骤3：原地写入预留的消息头
+    header.encodeInto(segments.head.data());
+    return segments;
+}
 
-    // 步骤3：组合完整消息
-    return headerData + payload;
+QByteArray Protocol::createMessage(MessageType type, const IMessageCodec& message, ChecksumAlgorithm algorithm) {
+    return createMessageSegments(type, message, algorithm).toByteArray();
 }
 
-qsizetype Protocol::parseMessage(const QByteArray& data, MessageHeader& header, QByteArray& payload) {
+QByteArray MessageSegments::toByteArray() const {
+    // 无大块数据的消息只有 head 一段，直接共享返回
+    if ( body.isEmpty() && tail.isEmpty() ) {
+        return head;
+    }
+    QByteArray joined;
+    joined.reserve(size());
+    joined.append(head);
+    joined.append(body);
+    joined.append(tail);
+    return joined;
+}
+
+void IMessageCodec::appendTo(QByteArray& out) const {
+    out.append(encode());
+}
+
+bool IMessageCodec::encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const {
+    Q_UNUSED(body);
+    Q_UNUSED(tail);
+    appendTo(head);
+    return true;
+}
+
+qsizetype Protocol::parseMessage(QByteArrayView data, MessageHeader& header, QByteArrayView& payload, ChecksumAlgorithm algorithm) {
     // 步骤1：验证数据完整性，同时获取MessageHeader
-    qsizetype validationResult = validateReceivedDataIntegrity(data, header);
+    qsizetype validationResult = validateReceivedDataIntegrity(data, header, algorithm);
     if ( validationResult <= 0 ) {
         return validationResult;
     }
 
-    // 步骤2：获取消息载荷（明文，由TLS保护）
-    payload = data.mid(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE), static_cast<qsizetype>(header.length));
+    // 步骤2：载荷直接指向输入数据（明文，由TLS保护），不拷贝
+    payload = data.sliced(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE), static_cast<qsizetype>(header.length));
 
     return validationResult;
 }
 
-qsizetype Protocol::validateReceivedDataIntegrity(const QByteArray& data, MessageHeader& header) {
+qsizetype Protocol::parseMessage(QByteArrayView data, MessageHeader& header, QByteArray& payload, ChecksumAlgorithm algorithm) {
+    QByteArrayView payloadView;
+    qsizetype result = parseMessage(data, header, payloadView, algorithm);
+    if ( result > 0 ) {
+        payload = payloadView.toByteArray();
+    }
+    return result;
+}
+
+qsizetype Protocol::validateReceivedDataIntegrity(QByteArrayView data, MessageHeader& header, ChecksumAlgorithm algorithm) {
     // 步骤1：检查数据是否足够包含消息头
     if ( data.size() < static_cast<qsizetype>(SERIALIZED_HEADER_SIZE) ) {
         return -1;
     }
 
-    // 步骤2：反序列化消息头（明文，由TLS保护）
-    QByteArray headerData = data.left(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE));
-    if ( !header.decode(headerData) ) {
+    // 步骤2：原地反序列化消息头（明文，由TLS保护）
+    if ( !header.decodeView(data) ) {
         qCWarning(lcProtocol) << "Protocol::validateReceivedDataIntegrity() - Failed to parse message header";
         return 0;
     }
@@ -84,9 +134,12 @@ qsizetype Protocol::validateReceivedDataIntegrity(const QByteArray& data, Messag
         return -1;
     }
 
-    // 步骤8：验证校验和
-    QByteArray payload = data.mid(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE), static_cast<qsizetype>(header.length));
-    quint32 calculatedChecksum = calculateChecksum(payload);
+    // 步骤8：原地验证校验和（协商为 NONE 时由 TLS 保证完整性，跳过）
+    if ( algorithm == ChecksumAlgorithm::NONE ) {
+        return totalMessageSize;
+    }
+    QByteArrayView payload = data.sliced(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE), static_cast<qsizetype>(header.length));
+    quint32 calculatedChecksum = Checksum::compute(algorithm, payload);
     if ( calculatedChecksum != header.checksum ) {
         qCWarning(lcProtocol)
             << "Checksum mismatch. Expected:" << Qt::hex << header.checksum
@@ -97,34 +150,6 @@ qsizetype Protocol::validateReceivedDataIntegrity(const QByteArray& data, Messag
     return totalMessageSize;
 }
 
-// CRC-32 lookup table (ISO 3309 / ITU-T V.42, polynomial 0xEDB88320)
-// Generated at compile time for zero runtime cost.
-static constexpr std::array<quint32, 256> generateCrc32Table() {
-    std::array<quint32, 256> table{};
-    for ( quint32 i = 0; i < 256; ++i ) {
-        quint32 crc = i;
-        for ( int j = 0; j < 8; ++j ) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0u);
-        }
-        table[i] = crc;
-    }
-    return table;
-}
-
-static constexpr auto kCrc32Table = generateCrc32Table();
-
-quint32 Protocol::calculateChecksum(const QByteArray& data) {
-    // CRC-32: purpose-appropriate for integrity checks, ~10x faster than MD5.
-    // Note: this is NOT a security hash — TLS handles authentication.
-    quint32 crc = 0xFFFFFFFFu;
-    const auto* bytes = reinterpret_cast<const quint8*>(data.constData());
-    const auto len = static_cast<qsizetype>(data.size());
-    for ( qsizetype i = 0; i < len; ++i ) {
-        crc = kCrc32Table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFFu;
-}
-
 // 辅助函数：写入长度前缀字符串（quint32长度 + UTF-8数据）
 static void writePrefixedString(QDataStream& ds, const QString& s) {
     QByteArray utf8 = s.toUtf8();
@@ -158,43 +183,170 @@ static QString readPrefixedString(QDataStream& ds, quint32 maxLen = MAX_GENERIC_
     return QString::fromUtf8(buf);
 }
 
+// 线上布局声明（字段顺序即编码顺序），与原 QDataStream 实现逐字节一致
+using WireFormat::Scalar;
+using WireFormat::PrefixedString;
+
+using MessageHeaderWire = WireFormat::Layout<
+    Scalar<&MessageHeader::magic, quint32>,
+    Scalar<&MessageHeader::version, quint32>,
+    Scalar<&MessageHeader::type, quint32>,
+    Scalar<&MessageHeader::length, quint32>,
+    Scalar<&MessageHeader::checksum, quint32>,
+    Scalar<&MessageHeader::timestamp, quint64>>;
+static_assert(MessageHeaderWire::size == SERIALIZED_HEADER_SIZE);
+
+using HeartbeatWire = WireFormat::Layout<
+    Scalar<&HeartbeatMessage::originTimestamp, quint64>,
+    Scalar<&HeartbeatMessage::receiveTimestamp, quint64>,
+    Scalar<&HeartbeatMessage::transmitTimestamp, quint64>>;
+
+using AuthenticationRequestWire = WireFormat::Layout<
+    PrefixedString<&AuthenticationRequest::username, MAX_USERNAME_LENGTH>,
+    PrefixedString<&AuthenticationRequest::passwordHash, MAX_PASSWORD_HASH_LENGTH>,
+    Scalar<&AuthenticationRequest::authMethod, quint32>>;
+
+using AuthenticationResponseWire = WireFormat::Layout<
+    Scalar<&AuthenticationResponse::result, quint8>,
+    PrefixedString<&AuthenticationResponse::sessionId, MAX_SESSION_ID_LENGTH>,
+    Scalar<&AuthenticationResponse::permissions, quint32>>;
+
+using AuthChallengeWire = WireFormat::Layout<
+    Scalar<&AuthChallenge::method, quint32>,
+    Scalar<&AuthChallenge::iterations, quint32>,
+    Scalar<&AuthChallenge::keyLength, quint32>,
+    PrefixedString<&AuthChallenge::saltHex, MAX_PASSWORD_HASH_LENGTH>>;
+
+using MouseEventWire = WireFormat::Layout<
+    Scalar<&MouseEvent::eventType, quint8>,
+    Scalar<&MouseEvent::x, qint16>,
+    Scalar<&MouseEvent::y, qint16>,
+    Scalar<&MouseEvent::wheelDelta, qint16>>;
+static_assert(MouseEventWire::isFixed && MouseEventWire::size == 7);
+
+using KeyboardEventWire = WireFormat::Layout<
+    Scalar<&KeyboardEvent::eventType, quint8>,
+    Scalar<&KeyboardEvent::keyCode, quint32>,
+    Scalar<&KeyboardEvent::modifiers, quint32>,
+    PrefixedString<&KeyboardEvent::text, MAX_TEXT_LENGTH>>;
+
+using InputBatchWire = WireFormat::Layout<
+    Scalar<&InputBatch::baseTimestamp, quint64>>;
+
+using InputBatchEventWire = WireFormat::Layout<
+    Scalar<&InputBatchEvent::kind, quint8>,
+    Scalar<&InputBatchEvent::timeOffsetMs, quint16>>;
+
+using ScreenDataWire = WireFormat::Layout<
+    Scalar<&ScreenData::x, quint16>,
+    Scalar<&ScreenData::y, quint16>,
+    Scalar<&ScreenData::width, quint16>,
+    Scalar<&ScreenData::height, quint16>,
+    Scalar<&ScreenData::originalWidth, quint16>,
+    Scalar<&ScreenData::originalHeight, quint16>,
+    Scalar<&ScreenData::dataSize, quint32>,
+    Scalar<&ScreenData::flags, quint8>>;
+static_assert(ScreenDataWire::size == ScreenData::FIXED_FIELDS_SIZE);
+
+using AudioDataWire = WireFormat::Layout<
+    Scalar<&AudioData::sampleRate, quint32>,
+    Scalar<&AudioData::channels, quint8>,
+    Scalar<&AudioData::bitsPerSample, quint8>,
+    Scalar<&AudioData::dataSize, quint32>>;
+
+using CursorMessageWire = WireFormat::Layout<
+    Scalar<&CursorMessage::cursorType, quint8>>;
+
+using CursorStateWire = WireFormat::Layout<
+    Scalar<&CursorState::x, qint16>,
+    Scalar<&CursorState::y, qint16>,
+    Scalar<&CursorState::cursorType, quint8>,
+    Scalar<&CursorState::flags, quint8>>;
+static_assert(CursorStateWire::isFixed && CursorStateWire::size == 6);
+
+using CursorShapeWire = WireFormat::Layout<
+    Scalar<&CursorShapeMessage::cacheId, quint32>,
+    Scalar<&CursorShapeMessage::flags, quint8>,
+    Scalar<&CursorShapeMessage::width, quint16>,
+    Scalar<&CursorShapeMessage::height, quint16>,
+    Scalar<&CursorShapeMessage::hotspotX, qint16>,
+    Scalar<&CursorShapeMessage::hotspotY, qint16>>;
+
+using TileUpdateWire = WireFormat::Layout<
+    Scalar<&TileUpdate::width, quint16>,
+    Scalar<&TileUpdate::height, quint16>,
+    Scalar<&TileUpdate::originalWidth, quint16>,
+    Scalar<&TileUpdate::originalHeight, quint16>,
+    Scalar<&TileUpdate::flags, quint8>,
+    Scalar<&TileUpdate::captureTimestamp, quint64>>;
+
+using TileRecordWire = WireFormat::Layout<
+    Scalar<&TileRecord::kind, quint8>,
+    Scalar<&TileRecord::cacheId, quint32>,
+    Scalar<&TileRecord::x, quint16>,
+    Scalar<&TileRecord::y, quint16>,
+    Scalar<&TileRecord::width, quint16>,
+    Scalar<&TileRecord::height, quint16>>;
+static_assert(TileRecordWire::isFixed && TileRecordWire::size == 13);
+
+using CopyRectWire = WireFormat::Layout<
+    Scalar<&CopyRect::srcX, quint16>,
+    Scalar<&CopyRect::srcY, quint16>,
+    Scalar<&CopyRect::x, quint16>,
+    Scalar<&CopyRect::y, quint16>,
+    Scalar<&CopyRect::width, quint16>,
+    Scalar<&CopyRect::height, quint16>>;
+static_assert(CopyRectWire::isFixed && CopyRectWire::size == 12);
+
+using MonitorInfoWire = WireFormat::Layout<
+    Scalar<&MonitorInfo::id, quint8>,
+    Scalar<&MonitorInfo::flags, quint8>,
+    Scalar<&MonitorInfo::x, qint16>,
+    Scalar<&MonitorInfo::y, qint16>,
+    Scalar<&MonitorInfo::width, quint16>,
+    Scalar<&MonitorInfo::height, quint16>>;
+static_assert(MonitorInfoWire::isFixed && MonitorInfoWire::size == 10);
+
+using FileTransferRequestWire = WireFormat::Layout<
+    PrefixedString<&FileTransferRequest::fileName, MAX_FILENAME_LENGTH>,
+    Scalar<&FileTransferRequest::fileSize, quint64>,
+    Scalar<&FileTransferRequest::transferId, quint32>,
+    Scalar<&FileTransferRequest::direction, quint8>>;
+
+using FileTransferResponseWire = WireFormat::Layout<
+    Scalar<&FileTransferResponse::transferId, quint32>,
+    Scalar<&FileTransferResponse::status, quint8>,
+    PrefixedString<&FileTransferResponse::errorMessage, MAX_ERROR_MESSAGE_LENGTH>>;
+
+using MessageFragmentWire = WireFormat::Layout<
+    Scalar<&MessageFragment::messageId, quint32>,
+    Scalar<&MessageFragment::totalSize, quint32>,
+    Scalar<&MessageFragment::offset, quint32>>;
+static_assert(MessageFragmentWire::size == MessageFragment::FIXED_FIELDS_SIZE);
+
+using FileDataWire = WireFormat::Layout<
+    Scalar<&FileData::transferId, quint32>,
+    Scalar<&FileData::offset, quint64>,
+    Scalar<&FileData::dataSize, quint32>>;
+
 // MessageHeader 序列化和反序列化实现
 QByteArray MessageHeader::encode() const {
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-
-    stream << magic;
-    stream << version;
-    stream << static_cast<quint32>(type);
-    stream << length;
-    stream << checksum;
-    stream << timestamp;
-
+    QByteArray data(static_cast<qsizetype>(SERIALIZED_HEADER_SIZE), Qt::Uninitialized);
+    encodeInto(data.data());
     return data;
 }
 
-bool MessageHeader::decode(const QByteArray& data) {
-    if ( data.size() < static_cast<qsizetype>(SERIALIZED_HEADER_SIZE) ) {
-        return false;
-    }
-
-    QDataStream stream(data);
-    stream.setByteOrder(QDataStream::LittleEndian);
-
-    quint32 typeValue;
-    stream >> magic;
-    stream >> version;
-    stream >> typeValue;
-    stream >> length;
-    stream >> checksum;
-    stream >> timestamp;
-
-    type = static_cast<MessageType>(typeValue);
+void MessageHeader::encodeInto(char* out) const {
+    MessageHeaderWire::write(*this, out);
+}
 
-    if ( stream.status() != QDataStream::Ok ) return false;
+bool MessageHeader::decode(const QByteArray& data) {
+    return decodeView(data);
+}
 
-    return true;
+bool MessageHeader::decodeView(QByteArrayView data) {
+    // 固定布局小端字段，直接按偏移读取，避免构造 QDataStream
+    return MessageHeaderWire::read(*this, data);
 }
 
 QByteArray BaseMessage::encode() const {
@@ -211,6 +363,121 @@ bool BaseMessage::decode(const QByteArray& rawData) {
     return true;
 }
 
+// HeartbeatMessage 序列化和反序列化实现
+QByteArray HeartbeatMessage::encode() const {
+    return HeartbeatWire::encode(*this);
+}
+
+void HeartbeatMessage::appendTo(QByteArray& out) const {
+    HeartbeatWire::appendTo(*this, out);
+}
+
+bool HeartbeatMessage::decode(const QByteArray& bytes) {
+    return HeartbeatWire::read(*this, bytes);
+}
+
+// CapabilitySet 实现
+static constexpr quint16 MAX_CAPABILITY_COUNT = 256;
+static constexpr quint16 MAX_CAPABILITY_PARAM_LENGTH = 1024;
+
+void CapabilitySet::set(Capability capability, const QByteArray& params) {
+    entries.insert(static_cast<quint16>(capability), params);
+}
+
+void CapabilitySet::setUInt32(Capability capability, quint32 value) {
+    QByteArray bytes(sizeof(quint32), Qt::Uninitialized);
+    qToLittleEndian<quint32>(value, bytes.data());
+    set(capability, bytes);
+}
+
+QByteArray CapabilitySet::params(Capability capability) const {
+    return entries.value(static_cast<quint16>(capability));
+}
+
+quint32 CapabilitySet::uint32Param(Capability capability, quint32 defaultValue) const {
+    auto it = entries.constFind(static_cast<quint16>(capability));
+    if ( it == entries.constEnd() || it->size() != static_cast<qsizetype>(sizeof(quint32)) ) {
+        return defaultValue;
+    }
+    return qFromLittleEndian<quint32>(it->constData());
+}
+
+CapabilitySet CapabilitySet::intersected(const CapabilitySet& other) const {
+    CapabilitySet result;
+    result.version = std::min(version, other.version);
+    for ( auto it = entries.constBegin(); it != entries.constEnd(); ++it ) {
+        if ( other.entries.contains(it.key()) ) {
+            result.entries.insert(it.key(), it.value());
+        }
+    }
+    return result;
+}
+
+CapabilitySet CapabilitySet::local() {
+    CapabilitySet caps;
+    caps.set(Capability::CLOCK_SYNC);
+    caps.set(Capability::CAPTURE_TIMESTAMP);
+    caps.set(Capability::ZSTD_SCREEN);
+    caps.set(Capability::CLIPBOARD_IMAGE);
+    caps.setUInt32(Capability::MAX_MESSAGE_SIZE, static_cast<quint32>(NetworkConstants::MAX_PACKET_SIZE));
+    // 不含 NONE：是否声明取决于具体连接是否已加密，由连接方覆盖
+    caps.setUInt32(Capability::CHECKSUM, Checksum::supportedMask(false));
+    caps.set(Capability::FRAGMENTATION);
+    caps.set(Capability::INPUT_BATCH);
+    caps.set(Capability::CURSOR_STREAM);
+    caps.setUInt32(Capability::CURSOR_SHAPE, static_cast<quint32>(NetworkConstants::CURSOR_SHAPE_CACHE_SIZE));
+    caps.setUInt32(Capability::TILE_CACHE, static_cast<quint32>(NetworkConstants::TILE_CACHE_SIZE));
+    caps.set(Capability::COPY_RECT);
+    caps.set(Capability::MULTI_MONITOR);
+    return caps;
+}
+
+void CapabilitySet::encode(QDataStream& ds) const {
+    ds << version;
+    ds << static_cast<quint16>(entries.size());
+    for ( auto it = entries.constBegin(); it != entries.constEnd(); ++it ) {
+        ds << it.key();
+        ds << static_cast<quint16>(it.value().size());
+        ds.writeRawData(it.value().constData(), it.value().size());
+    }
+}
+
+bool CapabilitySet::decode(QDataStream& ds) {
+    entries.clear();
+    version = 0;
+
+    // 旧版本对端不发送能力集：视为空集合
+    if ( ds.atEnd() ) {
+        return true;
+    }
+
+    quint16 count = 0;
+    ds >> version;
+    ds >> count;
+    if ( ds.status() != QDataStream::Ok || count > MAX_CAPABILITY_COUNT ) {
+        qCWarning(lcProtocol) << "CapabilitySet decode failed: invalid header, count:" << count;
+        return false;
+    }
+
+    for ( quint16 i = 0; i < count; ++i ) {
+        quint16 id = 0;
+        quint16 length = 0;
+        ds >> id;
+        ds >> length;
+        if ( ds.status() != QDataStream::Ok || length > MAX_CAPABILITY_PARAM_LENGTH ) {
+            qCWarning(lcProtocol) << "CapabilitySet decode failed: invalid entry" << id << "length:" << length;
+            return false;
+        }
+        QByteArray value(length, Qt::Uninitialized);
+        if ( length > 0 && ds.readRawData(value.data(), length) != length ) {
+            return false;
+        }
+        // 未知ID同样保留：intersected() 时自然被过滤
+        entries.insert(id, value);
+    }
+    return ds.status() == QDataStream::Ok;
+}
+
 // HandshakeRequest 序列化和反序列化实现
 QByteArray HandshakeRequest::encode() const {
     QByteArray bytes;
@@ -222,6 +489,7 @@ QByteArray HandshakeRequest::encode() const {
     ds << colorDepth;
     writePrefixedString(ds, clientName);
     writePrefixedString(ds, clientOS);
+    capabilities.encode(ds);
     return bytes;
 }
 
@@ -234,7 +502,8 @@ bool HandshakeRequest::decode(const QByteArray& bytes) {
     ds >> colorDepth;
     clientName = readPrefixedString(ds, MAX_HOSTNAME_LENGTH);
     clientOS = readPrefixedString(ds, MAX_HOSTNAME_LENGTH);
-    return ds.status() == QDataStream::Ok;
+    if ( ds.status() != QDataStream::Ok ) return false;
+    return capabilities.decode(ds);
 }
 
 // HandshakeResponse 序列化和反序列化实现
@@ -249,6 +518,7 @@ QByteArray HandshakeResponse::encode() const {
     ds << supportedFeatures;
     writePrefixedString(ds, serverName);
     writePrefixedString(ds, serverOS);
+    capabilities.encode(ds);
     return bytes;
 }
 
@@ -262,218 +532,234 @@ bool HandshakeResponse::decode(const QByteArray& bytes) {
     ds >> supportedFeatures;
     serverName = readPrefixedString(ds, MAX_HOSTNAME_LENGTH);
     serverOS = readPrefixedString(ds, MAX_HOSTNAME_LENGTH);
-    return ds.status() == QDataStream::Ok;
+    if ( ds.status() != QDataStream::Ok ) return false;
+    return capabilities.decode(ds);
 }
 
 // AuthenticationRequest 序列化和反序列化实现
 QByteArray AuthenticationRequest::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    writePrefixedString(ds, username);
-    writePrefixedString(ds, passwordHash);
-    ds << static_cast<quint32>(authMethod);
-    return bytes;
+    return AuthenticationRequestWire::encode(*this);
+}
+
+void AuthenticationRequest::appendTo(QByteArray& out) const {
+    AuthenticationRequestWire::appendTo(*this, out);
 }
 
 bool AuthenticationRequest::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    username = readPrefixedString(ds, MAX_USERNAME_LENGTH);
-    passwordHash = readPrefixedString(ds, MAX_PASSWORD_HASH_LENGTH);
-    quint32 method = 0;
-    ds >> method;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    authMethod = method;
-    return true;
+    return AuthenticationRequestWire::read(*this, bytes);
 }
 
 // AuthenticationResponse 序列化和反序列化实现
 QByteArray AuthenticationResponse::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint8>(result);
-    writePrefixedString(ds, sessionId);
-    ds << static_cast<quint32>(permissions);
-    return bytes;
+    return AuthenticationResponseWire::encode(*this);
+}
+
+void AuthenticationResponse::appendTo(QByteArray& out) const {
+    AuthenticationResponseWire::appendTo(*this, out);
 }
 
 bool AuthenticationResponse::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint8 res8 = 0;
-    ds >> res8;
-    sessionId = readPrefixedString(ds, MAX_SESSION_ID_LENGTH);
-    quint32 perms = 0;
-    ds >> perms;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    result = static_cast<AuthResult>(res8);
-    permissions = perms;
-    return true;
+    return AuthenticationResponseWire::read(*this, bytes);
 }
 
 // MouseEvent 序列化和反序列化实现
 QByteArray MouseEvent::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint8>(eventType);
-    ds << static_cast<qint16>(x);
-    ds << static_cast<qint16>(y);
-    ds << static_cast<qint16>(wheelDelta);
-    return bytes;
+    return MouseEventWire::encode(*this);
+}
+
+void MouseEvent::appendTo(QByteArray& out) const {
+    MouseEventWire::appendTo(*this, out);
 }
 
 bool MouseEvent::decode(const QByteArray& bytes) {
-    if ( bytes.size() < (1 + 2 + 2 + 2) ) return false;
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint8 type8 = 0; qint16 x_val = 0, y_val = 0; qint16 wheel = 0;
-    ds >> type8; ds >> x_val; ds >> y_val; ds >> wheel;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    eventType = static_cast<MouseEventType>(type8);
-    x = x_val; y = y_val; wheelDelta = wheel;
-    return true;
+    return MouseEventWire::read(*this, bytes);
 }
 
 // KeyboardEvent 序列化和反序列化实现
 QByteArray KeyboardEvent::encode() const {
+    return KeyboardEventWire::encode(*this);
+}
+
+void KeyboardEvent::appendTo(QByteArray& out) const {
+    KeyboardEventWire::appendTo(*this, out);
+}
+
+bool KeyboardEvent::decode(const QByteArray& bytes) {
+    return KeyboardEventWire::read(*this, bytes);
+}
+
+// InputBatch 序列化和反序列化实现
+QByteArray InputBatch::encode() const {
     QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint8>(eventType);
-    ds << static_cast<quint32>(keyCode);
-    ds << static_cast<quint32>(modifiers);
-    writePrefixedString(ds, text);
+    appendTo(bytes);
     return bytes;
 }
 
-bool KeyboardEvent::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint8 type8 = 0; quint32 key = 0, mods = 0;
-    ds >> type8; ds >> key; ds >> mods;
-    text = readPrefixedString(ds, MAX_TEXT_LENGTH);
-    if ( ds.status() != QDataStream::Ok ) return false;
-    eventType = static_cast<KeyboardEventType>(type8);
-    keyCode = key; modifiers = mods;
+void InputBatch::appendTo(QByteArray& out) const {
+    const qsizetype count = std::min<qsizetype>(events.size(), MAX_EVENTS);
+    out.reserve(out.size() + InputBatchWire::size + sizeof(quint16)
+        + count * (InputBatchEventWire::size + MouseEventWire::size));
+    InputBatchWire::appendTo(*this, out);
+    const qsizetype countOffset = out.size();
+    out.resize(countOffset + static_cast<qsizetype>(sizeof(quint16)));
+    qToLittleEndian<quint16>(static_cast<quint16>(count), out.data() + countOffset);
+
+    for ( qsizetype i = 0; i < count; ++i ) {
+        const InputBatchEvent& event = events.at(i);
+        InputBatchEventWire::appendTo(event, out);
+        if ( event.kind == InputBatchEvent::Kind::KEYBOARD ) {
+            KeyboardEventWire::appendTo(event.keyboard, out);
+        } else {
+            MouseEventWire::appendTo(event.mouse, out);
+        }
+    }
+}
+
+bool InputBatch::decode(const QByteArray& bytes) {
+    return decodeView(bytes);
+}
+
+bool InputBatch::decodeView(QByteArrayView bytes) {
+    events.clear();
+    qsizetype pos = InputBatchWire::size;
+    if ( !InputBatchWire::read(*this, bytes) || bytes.size() - pos < static_cast<qsizetype>(sizeof(quint16)) ) {
+        return false;
+    }
+    const quint16 count = qFromLittleEndian<quint16>(bytes.constData() + pos);
+    pos += static_cast<qsizetype>(sizeof(quint16));
+    if ( count > MAX_EVENTS ) {
+        qCWarning(lcProtocol) << "InputBatch decode failed: too many events" << count;
+        return false;
+    }
+
+    events.reserve(count);
+    for ( quint16 i = 0; i < count; ++i ) {
+        InputBatchEvent event;
+        qsizetype consumed = 0;
+        bool ok = InputBatchEventWire::read(event, bytes.sliced(pos));
+        if ( ok ) {
+            pos += InputBatchEventWire::size;
+            if ( event.kind == InputBatchEvent::Kind::MOUSE ) {
+                ok = MouseEventWire::read(event.mouse, bytes.sliced(pos), &consumed);
+            } else if ( event.kind == InputBatchEvent::Kind::KEYBOARD ) {
+                ok = KeyboardEventWire::read(event.keyboard, bytes.sliced(pos), &consumed);
+            } else {
+                ok = false;
+            }
+        }
+        if ( !ok ) {
+            qCWarning(lcProtocol) << "InputBatch decode failed at event" << i;
+            events.clear();
+            return false;
+        }
+        pos += consumed;
+        events.append(std::move(event));
+    }
     return true;
 }
 
 // FileTransferRequest 序列化和反序列化实现
 QByteArray FileTransferRequest::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    writePrefixedString(ds, fileName);
-    ds << static_cast<quint64>(fileSize);
-    ds << static_cast<quint32>(transferId);
-    ds << static_cast<quint8>(direction);
-    return bytes;
+    return FileTransferRequestWire::encode(*this);
+}
+
+void FileTransferRequest::appendTo(QByteArray& out) const {
+    FileTransferRequestWire::appendTo(*this, out);
 }
 
 bool FileTransferRequest::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    fileName = readPrefixedString(ds, MAX_FILENAME_LENGTH);
-    quint64 size = 0; quint32 tid = 0; quint8 dir = 0;
-    ds >> size; ds >> tid; ds >> dir;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    fileSize = size; transferId = tid; direction = dir;
-    return true;
+    return FileTransferRequestWire::read(*this, bytes);
 }
 
 // FileTransferResponse 序列化和反序列化实现
 QByteArray FileTransferResponse::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint32>(transferId);
-    ds << static_cast<quint8>(status);
-    writePrefixedString(ds, errorMessage);
-    return bytes;
+    return FileTransferResponseWire::encode(*this);
+}
+
+void FileTransferResponse::appendTo(QByteArray& out) const {
+    FileTransferResponseWire::appendTo(*this, out);
 }
 
 bool FileTransferResponse::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint32 tid = 0; quint8 st = 0;
-    ds >> tid; ds >> st;
-    errorMessage = readPrefixedString(ds, MAX_ERROR_MESSAGE_LENGTH);
-    if ( ds.status() != QDataStream::Ok ) return false;
-    transferId = tid; status = static_cast<FileTransferStatus>(st);
-    return true;
+    return FileTransferResponseWire::read(*this, bytes);
 }
 
 // FileData 序列化和反序列化实现
 QByteArray FileData::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint32>(transferId);
-    ds << static_cast<quint64>(offset);
-    ds << static_cast<quint32>(dataSize);
-    // if (!chunk.isEmpty()) ds.writeRawData(chunk.constData(), chunk.size());
-    return bytes;
+    return FileDataWire::encode(*this);
+}
+
+void FileData::appendTo(QByteArray& out) const {
+    FileDataWire::appendTo(*this, out);
 }
 
 bool FileData::decode(const QByteArray& bytes) {
-    if ( bytes.size() < (4 + 8 + 4) ) return false;
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint32 tid = 0; quint64 off = 0; quint32 len = 0;
-    ds >> tid; ds >> off; ds >> len;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    // 长度校验
-    qsizetype need = qsizetype(4 + 8 + 4) + qsizetype(len);
-    if ( bytes.size() < need ) return false;
-    // chunkOut = bytes.mid(qsizetype(4 + 8 + 4), len);
-    transferId = tid; offset = off; dataSize = len;
-    return true;
+    if ( !FileDataWire::read(*this, bytes) ) return false;
+    // 长度校验：文件数据紧跟在定长字段之后
+    return bytes.size() >= FileDataWire::size + qsizetype(dataSize);
 }
 
 // ScreenData 序列化和反序列化实现
 QByteArray ScreenData::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint16>(x);
-    ds << static_cast<quint16>(y);
-    ds << static_cast<quint16>(width);
-    ds << static_cast<quint16>(height);
-    ds << static_cast<quint16>(originalWidth);
-    ds << static_cast<quint16>(originalHeight);
+    QByteArray head;
+    QByteArray body;
+    QByteArray tail;
+    if ( !encodeSegments(head, body, tail) ) {
+        return QByteArray();
+    }
+    head.reserve(head.size() + body.size() + tail.size());
+    head.append(body);
+    head.append(tail);
+    return head;
+}
 
+bool ScreenData::encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const {
     // 验证数据大小一致性，防止缓冲区溢出
     quint32 actualDataSize = static_cast<quint32>(imageData.size());
     if ( dataSize != actualDataSize ) {
         qCWarning(lcProtocol) << "ScreenData::encode() - Data size mismatch: dataSize=" << dataSize << ", actual=" << actualDataSize;
         // 使用实际大小以确保数据一致性
-        ds << actualDataSize;
-    } else {
-        ds << static_cast<quint32>(dataSize);
     }
 
-    // 写入压缩标志位
-    ds << static_cast<quint8>(flags);
-
     // 检查数据大小限制，防止内存问题
     const quint32 MAX_SCREEN_DATA_SIZE = 50 * 1024 * 1024; // 50MB限制
     if ( actualDataSize > MAX_SCREEN_DATA_SIZE ) {
         qCWarning(lcProtocol) << "ScreenData::encode() - Data too large: " << actualDataSize << " bytes, exceeds limit " << MAX_SCREEN_DATA_SIZE << " bytes";
-        return QByteArray(); // 返回空数据，避免崩溃
+        return false; // 返回失败，避免崩溃
+    }
+
+    // 固定字段直接写入 head 末尾
+    const qsizetype offset = head.size();
+    ScreenDataWire::appendTo(*this, head);
+    if ( dataSize != actualDataSize ) {
+        qToLittleEndian<quint32>(actualDataSize, head.data() + offset + ScreenDataWire::offsetOf<6>());
     }
 
-    if ( !imageData.isEmpty() ) {
-        ds.writeRawData(imageData.constData(), imageData.size());
+    // 图像数据隐式共享，不拷贝
+    body = imageData;
+
+    // 可选尾部字段：捕获时间戳（旧版本解码器只读取 dataSize 字节图像数据，会忽略尾部）
+    if ( captureTimestamp != 0 ) {
+        tail.resize(sizeof(quint64));
+        qToLittleEndian<quint64>(captureTimestamp, tail.data());
     }
-    return bytes;
+    return true;
 }
 
 bool ScreenData::decode(const QByteArray& bytes) {
+    if ( !decodeView(bytes) ) {
+        return false;
+    }
+
+    // 拷贝图像数据，使结果不依赖输入缓冲区的生命周期
+    imageData = imageView.toByteArray();
+    imageView = QByteArrayView();
+    return true;
+}
+
+bool ScreenData::decodeView(QByteArrayView bytes) {
     // 检查最小头部大小：x(2) + y(2) + width(2) + height(2) + originalWidth(2) + originalHeight(2) + dataSize(4) + flags(1) = 17字节
-    const qsizetype headerSize = 2 + 2 + 2 + 2 + 2 + 2 + 4 + 1;
+    const qsizetype headerSize = FIXED_FIELDS_SIZE;
     if ( bytes.size() < headerSize ) {
         qCWarning(lcProtocol)
             << "ScreenData decode failed: insufficient header size"
@@ -481,29 +767,14 @@ bool ScreenData::decode(const QByteArray& bytes) {
         return false;
     }
 
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-
-    quint16 x_val = 0, y_val = 0, w = 0, h = 0;
-    quint16 origW = 0, origH = 0;
-    quint32 size = 0;
-    quint8 flagsVal = 0;
-
-    ds >> x_val;
-    ds >> y_val;
-    ds >> w;
-    ds >> h;
-    ds >> origW;
-    ds >> origH;
-    ds >> size;
-    ds >> flagsVal;
-
-    if ( ds.status() != QDataStream::Ok ) {
-        qCWarning(lcProtocol)
-            << "ScreenData decode failed: QDataStream error during header parsing"
-            << "- stream status:" << ds.status();
+    // 固定布局小端字段，先解到临时对象，校验通过后再赋值
+    ScreenData fixed;
+    if ( !ScreenDataWire::read(fixed, bytes) ) {
         return false;
     }
+    const quint16 w = fixed.width;
+    const quint16 h = fixed.height;
+    const quint32 size = fixed.dataSize;
 
     // 验证字段合理性
     if ( w == 0 || h == 0 ) {
@@ -531,79 +802,89 @@ bool ScreenData::decode(const QByteArray& bytes) {
     }
 
     // 赋值解码后的数据
-    x = x_val;
-    y = y_val;
+    x = fixed.x;
+    y = fixed.y;
     width = w;
     height = h;
-    originalWidth = origW;
-    originalHeight = origH;
+    originalWidth = fixed.originalWidth;
+    originalHeight = fixed.originalHeight;
     dataSize = size;
-    flags = flagsVal;
+    flags = fixed.flags;
 
-    // 提取图像数据
-    if ( size > 0 ) {
-        imageData = bytes.mid(headerSize, size);
-        if ( imageData.size() != static_cast<qsizetype>(size) ) {
-            qCWarning(lcProtocol)
-                << "ScreenData decode warning: extracted image data size mismatch"
-                << "- expected:" << size << "actual:" << imageData.size();
+    // 图像数据以视图形式指向输入，不拷贝
+    imageData = QByteArray();
+    imageView = bytes.sliced(headerSize, qsizetype(size));
 
-            return false;
-        }
-    } else {
-        imageData = QByteArray();
+    // 可选尾部字段：捕获时间戳
+    captureTimestamp = 0;
+    if ( bytes.size() >= totalNeeded + static_cast<qsizetype>(sizeof(quint64)) ) {
+        captureTimestamp = qFromLittleEndian<quint64>(bytes.constData() + totalNeeded);
     }
 
     return true;
 }
 
-// AudioData 序列化和反序列化实现
-QByteArray AudioData::encode() const {
+// MessageFragment 序列化和反序列化实现
+QByteArray MessageFragment::encode() const {
     QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << static_cast<quint32>(sampleRate);
-    ds << static_cast<quint8>(channels);
-    ds << static_cast<quint8>(bitsPerSample);
-    ds << static_cast<quint32>(dataSize);
-    // if (!pcm.isEmpty()) ds.writeRawData(pcm.constData(), pcm.size());
+    bytes.reserve(FIXED_FIELDS_SIZE + data.size());
+    MessageFragmentWire::appendTo(*this, bytes);
+    bytes.append(data);
     return bytes;
 }
 
-bool AudioData::decode(const QByteArray& bytes) {
-    if ( bytes.size() < (4 + 1 + 1 + 4) ) return false;
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    quint32 rate = 0, size = 0; quint8 ch = 0, bits = 0;
-    ds >> rate; ds >> ch; ds >> bits; ds >> size;
-    if ( ds.status() != QDataStream::Ok ) return false;
-    qsizetype need = qsizetype(4 + 1 + 1 + 4) + qsizetype(size);
-    if ( bytes.size() < need ) return false;
-    sampleRate = rate; channels = ch; bitsPerSample = bits; dataSize = size;
-    // pcmOut = bytes.mid(qsizetype(4 + 1 + 1 + 4), size);
+bool MessageFragment::encodeSegments(QByteArray& head, QByteArray& body, QByteArray& tail) const {
+    Q_UNUSED(tail);
+    MessageFragmentWire::appendTo(*this, head);
+    // 分片数据不拷贝：调用方在 data 存活期间写出
+    body = QByteArray::fromRawData(data.constData(), data.size());
     return true;
 }
 
+bool MessageFragment::decode(const QByteArray& bytes) {
+    return decodeView(bytes);
+}
+
+bool MessageFragment::decodeView(QByteArrayView bytes) {
+    if ( !MessageFragmentWire::read(*this, bytes) ) {
+        return false;
+    }
+    data = bytes.sliced(FIXED_FIELDS_SIZE);
+    if ( data.isEmpty() || totalSize < SERIALIZED_HEADER_SIZE
+        || offset > totalSize || static_cast<qsizetype>(totalSize - offset) < data.size() ) {
+        qCWarning(lcProtocol) << "MessageFragment decode failed: id" << messageId << "offset" << offset
+            << "size" << data.size() << "total" << totalSize;
+        return false;
+    }
+    return true;
+}
+
+// AudioData 序列化和反序列化实现
+QByteArray AudioData::encode() const {
+    return AudioDataWire::encode(*this);
+}
+
+void AudioData::appendTo(QByteArray& out) const {
+    AudioDataWire::appendTo(*this, out);
+}
+
+bool AudioData::decode(const QByteArray& bytes) {
+    if ( !AudioDataWire::read(*this, bytes) ) return false;
+    // 长度校验：音频数据紧跟在定长字段之后
+    return bytes.size() >= AudioDataWire::size + qsizetype(dataSize);
+}
+
 // AuthChallenge 序列化和反序列化实现
 QByteArray AuthChallenge::encode() const {
-    QByteArray bytes;
-    QDataStream ds(&bytes, QIODevice::WriteOnly);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds << method;
-    ds << iterations;
-    ds << keyLength;
-    writePrefixedString(ds, saltHex);
-    return bytes;
+    return AuthChallengeWire::encode(*this);
+}
+
+void AuthChallenge::appendTo(QByteArray& out) const {
+    AuthChallengeWire::appendTo(*this, out);
 }
 
 bool AuthChallenge::decode(const QByteArray& bytes) {
-    QDataStream ds(bytes);
-    ds.setByteOrder(QDataStream::LittleEndian);
-    ds >> method;
-    ds >> iterations;
-    ds >> keyLength;
-    saltHex = readPrefixedString(ds, MAX_PASSWORD_HASH_LENGTH);
-    return ds.status() == QDataStream::Ok;
+    return AuthChallengeWire::read(*this, bytes);
 }
 
 // CursorMessage 实现
@@ -616,26 +897,281 @@ CursorMessage::CursorMessage(Qt::CursorShape type)
 }
 
 QByteArray CursorMessage::encode() const {
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << static_cast<quint8>(cursorType);
-    return data;
+    return CursorMessageWire::encode(*this);
+}
+
+void CursorMessage::appendTo(QByteArray& out) const {
+    CursorMessageWire::appendTo(*this, out);
+}
+
+bool CursorMessage::decode(const QByteArray& bytes) {
+    return CursorMessageWire::read(*this, bytes);
+}
+
+// CursorState 实现
+CursorState::CursorState()
+    : x(0), y(0), cursorType(Qt::ArrowCursor), flags(static_cast<quint8>(CursorStateFlags::VISIBLE)) {
 }
 
-bool CursorMessage::decode(const QByteArray& dataBuffer) {
-    if ( dataBuffer.isEmpty() ) {
+QByteArray CursorState::encode() const {
+    return CursorStateWire::encode(*this);
+}
+
+void CursorState::appendTo(QByteArray& out) const {
+    CursorStateWire::appendTo(*this, out);
+}
+
+bool CursorState::decode(const QByteArray& bytes) {
+    return CursorStateWire::read(*this, bytes);
+}
+
+// CursorShapeMessage 实现
+CursorShapeMessage::CursorShapeMessage()
+    : cacheId(0), flags(static_cast<quint8>(CursorShapeFlags::NONE)), width(0), height(0), hotspotX(0), hotspotY(0) {
+}
+
+QByteArray CursorShapeMessage::encode() const {
+    QByteArray out;
+    appendTo(out);
+    return out;
+}
+
+void CursorShapeMessage::appendTo(QByteArray& out) const {
+    out.reserve(out.size() + CursorShapeWire::size + (hasBitmap() ? pixels.size() : 0));
+    CursorShapeWire::appendTo(*this, out);
+    if ( hasBitmap() ) {
+        out.append(pixels);
+    }
+}
+
+bool CursorShapeMessage::decode(const QByteArray& bytes) {
+    pixels.clear();
+    qsizetype consumed = 0;
+    if ( !CursorShapeWire::read(*this, bytes, &consumed) ) {
+        return false;
+    }
+    if ( !hasBitmap() ) {
+        return true;
+    }
+    if ( width == 0 || height == 0 || width > MAX_DIMENSION || height > MAX_DIMENSION ) {
         return false;
     }
+    const qsizetype bitmapSize = qsizetype(width) * height * 4;
+    if ( bytes.size() - consumed < bitmapSize ) {
+        return false;
+    }
+    pixels = bytes.mid(consumed, bitmapSize);
+    return true;
+}
 
-    QDataStream stream(dataBuffer);
-    stream.setByteOrder(QDataStream::LittleEndian);
+// TileUpdate 实现
+QByteArray TileUpdate::encode() const {
+    QByteArray out;
+    appendTo(out);
+    return out;
+}
 
-    quint8 type;
-    stream >> type;
-    cursorType = static_cast<Qt::CursorShape>(type);
+void TileUpdate::appendTo(QByteArray& out) const {
+    const qsizetype count = std::min<qsizetype>(records.size(), MAX_RECORDS);
+    const qsizetype copyCount = std::min<qsizetype>(copies.size(), MAX_COPIES);
+    qsizetype dataBytes = 0;
+    for ( qsizetype i = 0; i < count; ++i ) {
+        dataBytes += records.at(i).data.size();
+    }
+    out.reserve(out.size() + TileUpdateWire::size + static_cast<qsizetype>(sizeof(quint32))
+        + count * (TileRecordWire::size + static_cast<qsizetype>(sizeof(quint32))) + dataBytes
+        + static_cast<qsizetype>(sizeof(quint16)) + copyCount * CopyRectWire::size);
+
+    TileUpdateWire::appendTo(*this, out);
+    const qsizetype countOffset = out.size();
+    out.resize(countOffset + static_cast<qsizetype>(sizeof(quint32)));
+    qToLittleEndian<quint32>(static_cast<quint32>(count), out.data() + countOffset);
+
+    for ( qsizetype i = 0; i < count; ++i ) {
+        const TileRecord& record = records.at(i);
+        TileRecordWire::appendTo(record, out);
+        if ( record.hasData() ) {
+            const qsizetype sizeOffset = out.size();
+            out.resize(sizeOffset + static_cast<qsizetype>(sizeof(quint32)));
+            qToLittleEndian<quint32>(static_cast<quint32>(record.data.size()), out.data() + sizeOffset);
+            out.append(record.data);
+        }
+    }
 
-    return stream.status() == QDataStream::Ok;
+    if ( copyCount > 0 ) {
+        const qsizetype copyOffset = out.size();
+        out.resize(copyOffset + static_cast<qsizetype>(sizeof(quint16)));
+        qToLittleEndian<quint16>(static_cast<quint16>(copyCount), out.data() + copyOffset);
+        for ( qsizetype i = 0; i < copyCount; ++i ) {
+            CopyRectWire::appendTo(copies.at(i), out);
+        }
+    }
+}
+
+bool TileUpdate::decode(const QByteArray& bytes) {
+    records.clear();
+    copies.clear();
+    qsizetype pos = TileUpdateWire::size;
+    if ( !TileUpdateWire::read(*this, bytes) || bytes.size() - pos < static_cast<qsizetype>(sizeof(quint32)) ) {
+        return false;
+    }
+    const quint32 count = qFromLittleEndian<quint32>(bytes.constData() + pos);
+    pos += static_cast<qsizetype>(sizeof(quint32));
+    if ( count > MAX_RECORDS
+        || static_cast<qsizetype>(count) * TileRecordWire::size > bytes.size() - pos ) {
+        qCWarning(lcProtocol) << "TileUpdate decode failed: invalid record count" << count;
+        return false;
+    }
+
+    records.reserve(count);
+    const QByteArrayView view(bytes);
+    for ( quint32 i = 0; i < count; ++i ) {
+        TileRecord record;
+        bool ok = TileRecordWire::read(record, view.sliced(pos));
+        if ( ok ) {
+            pos += TileRecordWire::size;
+            const QRect frame(0, 0, width, height);
+            ok = record.width > 0 && record.height > 0 && frame.contains(record.rect())
+                && record.kind <= TileRecordKind::VIDEO;
+        }
+        if ( ok && record.hasData() ) {
+            ok = bytes.size() - pos >= static_cast<qsizetype>(sizeof(quint32));
+            if ( ok ) {
+                const quint32 dataSize = qFromLittleEndian<quint32>(bytes.constData() + pos);
+                pos += static_cast<qsizetype>(sizeof(quint32));
+                ok = static_cast<qsizetype>(dataSize) <= bytes.size() - pos;
+                if ( ok ) {
+                    record.data = bytes.mid(pos, dataSize);
+                    pos += dataSize;
+                }
+            }
+        }
+        if ( !ok ) {
+            qCWarning(lcProtocol) << "TileUpdate decode failed at record" << i;
+            records.clear();
+            return false;
+        }
+        records.append(std::move(record));
+    }
+
+    // 可选尾部：区域复制
+    if ( pos == bytes.size() ) {
+        return true;
+    }
+    if ( bytes.size() - pos < static_cast<qsizetype>(sizeof(quint16)) ) {
+        return false;
+    }
+    const quint16 copyCount = qFromLittleEndian<quint16>(bytes.constData() + pos);
+    pos += static_cast<qsizetype>(sizeof(quint16));
+    if ( copyCount > MAX_COPIES || qsizetype(copyCount) * CopyRectWire::size > bytes.size() - pos ) {
+        qCWarning(lcProtocol) << "TileUpdate decode failed: invalid copy count" << copyCount;
+        records.clear();
+        return false;
+    }
+    copies.reserve(copyCount);
+    const QRect frame(0, 0, width, height);
+    for ( quint16 i = 0; i < copyCount; ++i ) {
+        CopyRect copy;
+        if ( !CopyRectWire::read(copy, view.sliced(pos)) || copy.width == 0 || copy.height == 0
+            || !frame.contains(copy.sourceRect()) || !frame.contains(copy.targetRect()) ) {
+            qCWarning(lcProtocol) << "TileUpdate decode failed at copy" << i;
+            records.clear();
+            copies.clear();
+            return false;
+        }
+        pos += CopyRectWire::size;
+        copies.append(copy);
+    }
+    return true;
+}
+
+// MonitorLayout 实现
+QRect MonitorLayout::viewedBounds() const {
+    QRect bounds;
+    for ( const MonitorInfo& monitor : monitors ) {
+        if ( monitor.isViewed() ) {
+            bounds = bounds.united(monitor.geometry());
+        }
+    }
+    return bounds;
+}
+
+QByteArray MonitorLayout::encode() const {
+    QByteArray out;
+    appendTo(out);
+    return out;
+}
+
+void MonitorLayout::appendTo(QByteArray& out) const {
+    const qsizetype count = std::min<qsizetype>(monitors.size(), MAX_MONITORS);
+    out.reserve(out.size() + 1 + count * MonitorInfoWire::size);
+    out.append(static_cast<char>(count));
+    for ( qsizetype i = 0; i < count; ++i ) {
+        MonitorInfoWire::appendTo(monitors.at(i), out);
+    }
+}
+
+bool MonitorLayout::decode(const QByteArray& bytes) {
+    monitors.clear();
+    if ( bytes.isEmpty() ) {
+        return false;
+    }
+    const int count = static_cast<quint8>(bytes.at(0));
+    if ( count > MAX_MONITORS || bytes.size() < 1 + qsizetype(count) * MonitorInfoWire::size ) {
+        qCWarning(lcProtocol) << "MonitorLayout decode failed: invalid monitor count" << count;
+        return false;
+    }
+    const QByteArrayView view(bytes);
+    QList<MonitorInfo> decoded;
+    decoded.reserve(count);
+    for ( int i = 0; i < count; ++i ) {
+        MonitorInfo monitor;
+        const bool ok = MonitorInfoWire::read(monitor, view.sliced(1 + qsizetype(i) * MonitorInfoWire::size))
+            && monitor.width > 0 && monitor.height > 0
+            && std::none_of(decoded.cbegin(), decoded.cend(), [&](const MonitorInfo& other) { return other.id == monitor.id; });
+        if ( !ok ) {
+            qCWarning(lcProtocol) << "MonitorLayout decode failed at monitor" << i;
+            return false;
+        }
+        decoded.append(monitor);
+    }
+    monitors = std::move(decoded);
+    return true;
+}
+
+// MonitorSelect 实现
+QByteArray MonitorSelect::encode() const {
+    QByteArray out;
+    appendTo(out);
+    return out;
+}
+
+void MonitorSelect::appendTo(QByteArray& out) const {
+    const qsizetype count = std::min<qsizetype>(monitorIds.size(), MonitorLayout::MAX_MONITORS);
+    out.reserve(out.size() + 1 + count);
+    out.append(static_cast<char>(count));
+    for ( qsizetype i = 0; i < count; ++i ) {
+        out.append(static_cast<char>(monitorIds.at(i)));
+    }
+}
+
+bool MonitorSelect::decode(const QByteArray& bytes) {
+    monitorIds.clear();
+    if ( bytes.isEmpty() ) {
+        return false;
+    }
+    const int count = static_cast<quint8>(bytes.at(0));
+    if ( count == 0 || count > MonitorLayout::MAX_MONITORS || bytes.size() < 1 + count ) {
+        qCWarning(lcProtocol) << "MonitorSelect decode failed: invalid monitor count" << count;
+        return false;
+    }
+    for ( int i = 0; i < count; ++i ) {
+        const quint8 id = static_cast<quint8>(bytes.at(1 + i));
+        if ( !monitorIds.contains(id) ) {
+            monitorIds.append(id);
+        }
+    }
+    return true;
 }
 
 // ClipboardMessage 实现
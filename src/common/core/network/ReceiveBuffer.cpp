@@ -0,0 +1,81 @@
+#include "ReceiveBuffer.h"
+#include <QtCore/QIODevice>
+#include <algorithm>
+#include <cstring>
+
+ReceiveBuffer::ReceiveBuffer(qsizetype initialCapacity)
+    : m_buffer(std::max<qsizetype>(1, initialCapacity), Qt::Uninitialized)
+    , m_readPos(0)
+    , m_writePos(0) {
+}
+
+qint64 ReceiveBuffer::readFrom(QIODevice* device) {
+    if ( !device ) {
+        return -1;
+    }
+
+    const qint64 available = device->bytesAvailable();
+    if ( available <= 0 ) {
+        return 0;
+    }
+
+    char* tail = reserveTail(static_cast<qsizetype>(available));
+    const qint64 bytesRead = device->read(tail, available);
+    if ( bytesRead > 0 ) {
+        m_writePos += static_cast<qsizetype>(bytesRead);
+    }
+    return bytesRead;
+}
+
+void ReceiveBuffer::append(const char* bytes, qsizetype length) {
+    if ( !bytes || length <= 0 ) {
+        return;
+    }
+    std::memcpy(reserveTail(length), bytes, static_cast<size_t>(length));
+    m_writePos += length;
+}
+
+void ReceiveBuffer::consume(qsizetype length) {
+    m_readPos += std::clamp<qsizetype>(length, 0, size());
+
+    // 读空时游标归零，无需搬移数据
+    if ( m_readPos == m_writePos ) {
+        m_readPos = 0;
+        m_writePos = 0;
+        if ( m_buffer.size() > MAX_RETAINED_CAPACITY ) {
+            // 超大帧过后释放内存，避免长期占用
+            m_buffer = QByteArray(DEFAULT_CAPACITY, Qt::Uninitialized);
+        }
+    }
+}
+
+void ReceiveBuffer::clear() {
+    m_readPos = 0;
+    m_writePos = 0;
+    if ( m_buffer.size() > DEFAULT_CAPACITY ) {
+        m_buffer = QByteArray(DEFAULT_CAPACITY, Qt::Uninitialized);
+    }
+}
+
+char* ReceiveBuffer::reserveTail(qsizetype length) {
+    if ( m_buffer.size() - m_writePos >= length ) {
+        return m_buffer.data() + m_writePos;
+    }
+
+    // 尾部空间不足：先把未读数据前移到开头（通常只是一条不完整消息）
+    const qsizetype unread = size();
+    if ( m_readPos > 0 ) {
+        if ( unread > 0 ) {
+            std::memmove(m_buffer.data(), m_buffer.constData() + m_readPos, static_cast<size_t>(unread));
+        }
+        m_readPos = 0;
+        m_writePos = unread;
+    }
+
+    // 仍不足则按倍数扩容，摊还扩容次数
+    if ( m_buffer.size() - m_writePos < length ) {
+        const qsizetype required = m_writePos + length;
+        m_buffer.resize(std::max(required, m_buffer.size() * 2));
+    }
+    return m_buffer.data() + m_writePos;
+}
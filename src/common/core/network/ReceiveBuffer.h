@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/qglobal.h>
+
+class QIODevice;
+
+/**
+ * @brief 基于读写游标的接收缓冲区
+ *
+ * 替代 "readAll() + append() + remove(0, n)" 的接收方式：
+ * - 直接从套接字读入预分配空间，不产生临时 QByteArray
+ * - 解析完一条消息只前移读游标（O(1)），不搬移剩余数据
+ * - 读空时游标归零；仅当尾部空间不足时才把未读数据整体前移一次（压缩）
+ *
+ * 大帧后面跟着大量小输入消息时，原实现每条消息都要 memmove 数MB，
+ * 这里每次 readyRead 至多一次压缩。非线程安全，由所属套接字线程独占使用。
+ */
+class ReceiveBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param initialCapacity 初始容量（字节）
+     */
+    explicit ReceiveBuffer(qsizetype initialCapacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 未读数据字节数
+     */
+    qsizetype size() const { return m_writePos - m_readPos; }
+    bool isEmpty() const { return m_writePos == m_readPos; }
+
+    /**
+     * @brief 当前分配的容量（字节）
+     */
+    qsizetype capacity() const { return m_buffer.size(); }
+
+    /**
+     * @brief 未读数据的起始指针，下一次写入前有效
+     */
+    const char* data() const { return m_buffer.constData() + m_readPos; }
+
+    /**
+     * @brief 未读数据的只读视图，下一次写入前有效
+     */
+    QByteArrayView view() const { return QByteArrayView(data(), size()); }
+
+    /**
+     * @brief 从设备读取当前所有可用数据到缓冲区
+     * @param device 数据源（如 QSslSocket）
+     * @return 读取的字节数；出错返回 -1
+     */
+    qint64 readFrom(QIODevice* device);
+
+    /**
+     * @brief 追加数据（测试及非套接字数据源使用）
+     */
+    void append(const char* bytes, qsizetype length);
+
+    /**
+     * @brief 消费已解析的数据（前移读游标）
+     * @param length 消费的字节数
+     */
+    void consume(qsizetype length);
+
+    /**
+     * @brief 丢弃所有数据，并释放超出默认容量的内存
+     */
+    void clear();
+
+    static constexpr qsizetype DEFAULT_CAPACITY = 256 * 1024;          ///< 默认容量，与套接字接收缓冲一致
+    static constexpr qsizetype MAX_RETAINED_CAPACITY = 8 * 1024 * 1024; ///< 读空后保留的最大容量
+
+private:
+    /**
+     * @brief 确保尾部至少有 length 字节可写空间，必要时压缩或扩容
+     * @return 可写位置指针
+     */
+    char* reserveTail(qsizetype length);
+
+    QByteArray m_buffer;     ///< 底层存储（size 即容量）
+    qsizetype m_readPos;     ///< 读游标
+    qsizetype m_writePos;    ///< 写游标
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QString>
+#include <QtCore/QtEndian>
+#include <QtCore/qglobal.h>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief 编译期字段描述符序列化
+ *
+ * 每条消息用一组字段描述符声明线上布局（顺序即编码顺序，全部小端）：
+ *
+ *   using MouseEventWire = WireFormat::Layout<
+ *       WireFormat::Scalar<&MouseEvent::eventType, quint8>,
+ *       WireFormat::Scalar<&MouseEvent::x, qint16>, ...>;
+ *
+ * 模板展开为按固定偏移的 qToLittleEndian / qFromLittleEndian，不构造 QDataStream：
+ * - 纯定长布局：size 为编译期常量，可直接写入调用方缓冲区，编解码均无堆分配
+ * - 含长度前缀字符串的布局：按定长部分一次预留，再追加变长部分
+ * - 解码前检查最小长度，变长字段逐个检查剩余字节，越界或超长返回 false
+ *
+ * 线上格式与原 QDataStream(LittleEndian) 实现逐字节一致，新旧版本可互通。
+ */
+namespace WireFormat {
+
+namespace detail {
+
+template <typename T>
+struct MemberTraits;
+
+template <typename Owner, typename Value>
+struct MemberTraits<Value Owner::*> {
+    using OwnerType = Owner;
+    using ValueType = Value;
+};
+
+} // namespace detail
+
+/**
+ * @brief 定长整数字段：成员按 Wire 类型传输（枚举、窄化类型显式转换）
+ */
+template <auto Member, typename Wire>
+struct Scalar {
+    using Owner = typename detail::MemberTraits<decltype(Member)>::OwnerType;
+    using Value = typename detail::MemberTraits<decltype(Member)>::ValueType;
+    static_assert(std::is_integral_v<Wire>, "Wire type must be an integer type");
+
+    static constexpr bool isFixed = true;
+    static constexpr qsizetype fixedSize = sizeof(Wire);
+
+    static void write(const Owner& owner, char* out) {
+        qToLittleEndian<Wire>(static_cast<Wire>(owner.*Member), out);
+    }
+
+    static void read(Owner& owner, const char* in) {
+        owner.*Member = static_cast<Value>(qFromLittleEndian<Wire>(in));
+    }
+};
+
+/**
+ * @brief 长度前缀字符串：quint32 字节数 + UTF-8 数据
+ * @tparam MaxBytes 解码时允许的最大字节数，防止恶意长度耗尽内存
+ */
+template <auto Member, quint32 MaxBytes>
+struct PrefixedString {
+    using Owner = typename detail::MemberTraits<decltype(Member)>::OwnerType;
+    static_assert(std::is_same_v<typename detail::MemberTraits<decltype(Member)>::ValueType, QString>,
+                  "PrefixedString requires a QString member");
+
+    static constexpr bool isFixed = false;
+    static constexpr qsizetype fixedSize = sizeof(quint32);   ///< 仅长度前缀
+
+    static void append(const Owner& owner, QByteArray& out) {
+        const QByteArray utf8 = (owner.*Member).toUtf8();
+        const qsizetype offset = out.size();
+        out.resize(offset + fixedSize);
+        qToLittleEndian<quint32>(static_cast<quint32>(utf8.size()), out.data() + offset);
+        out.append(utf8);
+    }
+
+    static bool read(Owner& owner, QByteArrayView in, qsizetype& pos) {
+        if ( in.size() - pos < fixedSize ) {
+            return false;
+        }
+        const quint32 length = qFromLittleEndian<quint32>(in.constData() + pos);
+        pos += fixedSize;
+        if ( length > MaxBytes || in.size() - pos < static_cast<qsizetype>(length) ) {
+            return false;
+        }
+        owner.*Member = QString::fromUtf8(in.constData() + pos, static_cast<qsizetype>(length));
+        pos += static_cast<qsizetype>(length);
+        return true;
+    }
+};
+
+/**
+ * @brief 字段序列：由字段描述符组合出编解码函数
+ */
+template <typename... Fields>
+struct Layout {
+    static constexpr bool isFixed = (Fields::isFixed && ...);
+
+    /// 定长部分字节数；纯定长布局即为确切编码长度
+    static constexpr qsizetype minSize = (Fields::fixedSize + ... + 0);
+    static constexpr qsizetype size = minSize;
+
+    /// 第 Index 个字段的偏移（仅对其前面全为定长字段的位置有意义）
+    template <std::size_t Index>
+    static constexpr qsizetype offsetOf() {
+        constexpr qsizetype sizes[] = { Fields::fixedSize..., 0 };
+        qsizetype offset = 0;
+        for ( std::size_t i = 0; i < Index; ++i ) {
+            offset += sizes[i];
+        }
+        return offset;
+    }
+
+    /**
+     * @brief 写入 out（至少 size 字节），仅用于纯定长布局
+     */
+    template <typename Owner>
+    static void write(const Owner& owner, char* out) {
+        static_assert(isFixed, "write() requires a fixed-size layout; use appendTo()");
+        writeFixed(owner, out, std::index_sequence_for<Fields...>{});
+    }
+
+    /**
+     * @brief 追加到 out 末尾，out 原有内容保持不变
+     */
+    template <typename Owner>
+    static void appendTo(const Owner& owner, QByteArray& out) {
+        const qsizetype offset = out.size();
+        if constexpr ( isFixed ) {
+            out.resize(offset + size);
+            write(owner, out.data() + offset);
+        } else {
+            out.reserve(offset + minSize);
+            (appendField<Fields>(owner, out), ...);
+        }
+    }
+
+    template <typename Owner>
+    static QByteArray encode(const Owner& owner) {
+        QByteArray out;
+        appendTo(owner, out);
+        return out;
+    }
+
+    /**
+     * @brief 从 in 起始处解码；多余的尾部字节被忽略（向前兼容）
+     * @param consumed 可选，输出已解码的字节数
+     * @return 数据不足或字段越界时返回 false（owner 可能已部分更新）
+     */
+    template <typename Owner>
+    static bool read(Owner& owner, QByteArrayView in, qsizetype* consumed = nullptr) {
+        if ( in.size() < minSize ) {
+            return false;
+        }
+        qsizetype pos = 0;
+        if constexpr ( isFixed ) {
+            readFixed(owner, in.constData(), std::index_sequence_for<Fields...>{});
+            pos = size;
+        } else {
+            if ( !(readField<Fields>(owner, in, pos) && ...) ) {
+                return false;
+            }
+        }
+        if ( consumed ) {
+            *consumed = pos;
+        }
+        return true;
+    }
+
+private:
+    template <typename Owner, std::size_t... Index>
+    static void writeFixed(const Owner& owner, char* out, std::index_sequence<Index...>) {
+        (Fields::write(owner, out + offsetOf<Index>()), ...);
+    }
+
+    template <typename Owner, std::size_t... Index>
+    static void readFixed(Owner& owner, const char* in, std::index_sequence<Index...>) {
+        (Fields::read(owner, in + offsetOf<Index>()), ...);
+    }
+
+    template <typename Field, typename Owner>
+    static void appendField(const Owner& owner, QByteArray& out) {
+        if constexpr ( Field::isFixed ) {
+            const qsizetype offset = out.size();
+            out.resize(offset + Field::fixedSize);
+            Field::write(owner, out.data() + offset);
+        } else {
+            Field::append(owner, out);
+        }
+    }
+
+    template <typename Field, typename Owner>
+    static bool readField(Owner& owner, QByteArrayView in, qsizetype& pos) {
+        if constexpr ( Field::isFixed ) {
+            if ( in.size() - pos < Field::fixedSize ) {
+                return false;
+            }
+            Field::read(owner, in.constData() + pos);
+            pos += Field::fixedSize;
+            return true;
+        } else {
+            return Field::read(owner, in, pos);
+        }
+    }
+};
+
+} // namespace WireFormat
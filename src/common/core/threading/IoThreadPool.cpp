@@ -0,0 +1,82 @@
+#include "IoThreadPool.h"
+#include "../logging/LoggingCategories.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <algorithm>
+#include <utility>
+
+IoThreadPool::IoThreadPool(int threadCount, const QString& name, QObject* parent)
+    : QObject(parent) {
+    const int count = threadCount > 0 ? threadCount : std::max(1, QThread::idealThreadCount());
+    m_lanes.reserve(count);
+    for ( int i = 0; i < count; ++i ) {
+        Lane lane;
+        lane.thread = new QThread();
+        lane.thread->setObjectName(QStringLiteral("%1_%2").arg(name).arg(i));
+        lane.thread->start();
+        m_lanes.append(lane);
+    }
+    qCInfo(lcThreading) << "IoThreadPool 启动" << count << "个I/O线程:" << name;
+}
+
+IoThreadPool::~IoThreadPool() {
+    shutdown();
+}
+
+QThread* IoThreadPool::attach(QObject* object) {
+    QMutexLocker locker(&m_mutex);
+    if ( m_lanes.isEmpty() || !object ) {
+        return nullptr;
+    }
+    auto lane = std::min_element(m_lanes.begin(), m_lanes.end(),
+        [](const Lane& a, const Lane& b) { return a.load < b.load; });
+    object->moveToThread(lane->thread);
+    ++lane->load;
+    return lane->thread;
+}
+
+void IoThreadPool::detach(QThread* thread) {
+    QMutexLocker locker(&m_mutex);
+    for ( Lane& lane : m_lanes ) {
+        if ( lane.thread == thread ) {
+            lane.load = std::max(0, lane.load - 1);
+            return;
+        }
+    }
+}
+
+void IoThreadPool::shutdown() {
+    QList<Lane> lanes;
+    {
+        QMutexLocker locker(&m_mutex);
+        lanes.swap(m_lanes);
+    }
+    // 线程结束时会处理剩余的 deleteLater，并销毁该线程的 TimerWheel
+    for ( const Lane& lane : std::as_const(lanes) ) {
+        lane.thread->quit();
+    }
+    for ( const Lane& lane : std::as_const(lanes) ) {
+        if ( lane.thread->wait(3000) ) {
+            delete lane.thread;
+        } else {
+            // 仍在运行时不能直接删除，改为线程结束后延迟删除
+            qCWarning(lcThreading) << "I/O线程未能按时退出:" << lane.thread->objectName();
+            connect(lane.thread, &QThread::finished, lane.thread, &QObject::deleteLater);
+        }
+    }
+}
+
+int IoThreadPool::threadCount() const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_lanes.size());
+}
+
+QList<int> IoThreadPool::loads() const {
+    QMutexLocker locker(&m_mutex);
+    QList<int> result;
+    result.reserve(m_lanes.size());
+    for ( const Lane& lane : m_lanes ) {
+        result.append(lane.load);
+    }
+    return result;
+}
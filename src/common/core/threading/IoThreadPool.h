@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+class QThread;
+
+/**
+ * @brief 固定数量的事件循环 I/O 线程池
+ *
+ * 每个线程只运行 Qt 事件循环，多个事件驱动的对象（如客户端会话）共享同一个线程，
+ * 由套接字通知和 TimerWheel 驱动，而不是各占一个忙轮询的线程。
+ * attach() 把对象移到当前负载最小的线程，detach() 归还负载计数。
+ *
+ * 线程在构造时启动，析构（或 shutdown()）时退出；退出前仍在线程中的对象由调用方负责清理。
+ * 公共方法线程安全。
+ */
+class IoThreadPool : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 线程数；<= 0 时按 CPU 核心数（QThread::idealThreadCount()）
+     * @param name 线程名前缀（线程名为 "<name>_<序号>"）
+     * @param parent 父对象
+     */
+    explicit IoThreadPool(int threadCount = 0, const QString& name = QStringLiteral("IoThread"), QObject* parent = nullptr);
+    ~IoThreadPool() override;
+
+    IoThreadPool(const IoThreadPool&) = delete;
+    IoThreadPool& operator=(const IoThreadPool&) = delete;
+
+    /**
+     * @brief 把对象移到负载最小的线程
+     *
+     * 对象不能有父对象，且必须属于调用线程（QObject::moveToThread 的要求）。
+     * @return 对象所在的线程；线程池已关闭时返回 nullptr（对象不移动）
+     */
+    QThread* attach(QObject* object);
+
+    /**
+     * @brief 归还 attach() 分配的负载计数（不移动对象）
+     */
+    void detach(QThread* thread);
+
+    /**
+     * @brief 退出并等待所有线程
+     */
+    void shutdown();
+
+    [[nodiscard]] int threadCount() const;
+
+    /**
+     * @brief 每个线程当前承载的对象数
+     */
+    [[nodiscard]] QList<int> loads() const;
+
+private:
+    struct Lane {
+        QThread* thread = nullptr;
+        int load = 0;
+    };
+
+    mutable QMutex m_mutex;
+    QList<Lane> m_lanes;
+};
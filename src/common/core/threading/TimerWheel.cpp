@@ -0,0 +1,135 @@
+#include "TimerWheel.h"
+#include "../logging/LoggingCategories.h"
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimer>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+QThreadStorage<TimerWheel*> s_threadWheels;
+}
+
+TimerWheel::TimerWheel(int tickMs, int slotCount, QObject* parent)
+    : QObject(parent)
+    , m_tickMs(std::max(1, tickMs))
+    , m_slots(static_cast<size_t>(std::max(1, slotCount)))
+    , m_nextId(1)
+    , m_currentTick(0)
+    , m_remainderMs(0)
+    , m_driver(new QTimer(this))
+    , m_running(false) {
+    m_driver->setTimerType(Qt::PreciseTimer);
+    m_driver->setSingleShot(true);
+    connect(m_driver, &QTimer::timeout, this, &TimerWheel::onTimeout);
+}
+
+TimerWheel::~TimerWheel() = default;
+
+TimerWheel* TimerWheel::forCurrentThread() {
+    if ( !s_threadWheels.hasLocalData() ) {
+        s_threadWheels.setLocalData(new TimerWheel());
+        qCDebug(lcThreading) << "TimerWheel created for thread" << QThread::currentThread();
+    }
+    return s_threadWheels.localData();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int intervalMs, Callback callback, bool repeat) {
+    Entry entry;
+    entry.intervalTicks = static_cast<quint64>(std::max(1, (intervalMs + m_tickMs - 1) / m_tickMs));
+    entry.dueTick = m_currentTick + entry.intervalTicks;
+    entry.repeat = repeat;
+    entry.callback = std::move(callback);
+
+    const TimerId id = m_nextId++;
+    const quint64 dueTick = entry.dueTick;
+    m_entries.insert(id, std::move(entry));
+    place(id, dueTick);
+    updateDriver();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    // 槽中的ID在轮到该槽时因找不到条目而丢弃，无需在此查找
+    const bool removed = m_entries.remove(id) > 0;
+    if ( removed ) {
+        updateDriver();
+    }
+    return removed;
+}
+
+int TimerWheel::advance(qint64 elapsedMs) {
+    m_remainderMs += std::max<qint64>(0, elapsedMs);
+    const quint64 ticks = static_cast<quint64>(m_remainderMs / m_tickMs);
+    m_remainderMs %= m_tickMs;
+    if ( ticks == 0 ) {
+        return 0;
+    }
+
+    // 线程被阻塞而落后多个刻度时，周期定时器只补触发一次，而不是每个错过的刻度各一次
+    const quint64 targetTick = m_currentTick + ticks;
+    int fired = 0;
+    while ( m_currentTick < targetTick ) {
+        ++m_currentTick;
+        const size_t slot = static_cast<size_t>(m_currentTick % m_slots.size());
+        const QList<TimerId> candidates = std::exchange(m_slots[slot], QList<TimerId>());
+        for ( TimerId id : candidates ) {
+            auto it = m_entries.find(id);
+            if ( it == m_entries.end() ) {
+                continue;   // 已取消
+            }
+            if ( it->dueTick > m_currentTick ) {
+                m_slots[slot].append(id);   // 后续轮次才到期
+                continue;
+            }
+
+            Callback callback = it->callback;
+            if ( it->repeat ) {
+                it->dueTick = std::max(it->dueTick + it->intervalTicks, targetTick + 1);
+                place(id, it->dueTick);
+            } else {
+                m_entries.erase(it);
+            }
+            callback();
+            ++fired;
+        }
+    }
+    return fired;
+}
+
+void TimerWheel::place(TimerId id, quint64 dueTick) {
+    m_slots[static_cast<size_t>(dueTick % m_slots.size())].append(id);
+}
+
+void TimerWheel::onTimeout() {
+    advance(m_clock.restart());
+    updateDriver();
+}
+
+void TimerWheel::updateDriver() {
+    if ( m_entries.isEmpty() ) {
+        m_driver->stop();
+        m_running = false;
+        return;
+    }
+    if ( !m_running ) {
+        // 空闲期间不计时：从重新启动的时刻开始推进（单次驱动触发后仍在计时，保留不足一个刻度的累积）
+        m_remainderMs = 0;
+        m_clock.start();
+        m_running = true;
+    }
+
+    // 只在最近的到期刻度唤醒，而不是每个刻度：只剩长周期定时器（心跳）时线程在两次到期之间保持空闲。
+    // 遍历所有条目，但每个线程上的定时器只有几十个
+    quint64 nextDueTick = std::numeric_limits<quint64>::max();
+    for ( const Entry& entry : std::as_const(m_entries) ) {
+        nextDueTick = std::min(nextDueTick, entry.dueTick);
+    }
+    const qint64 dueMs = static_cast<qint64>(nextDueTick - m_currentTick) * m_tickMs - m_remainderMs - m_clock.elapsed();
+    m_driver->start(static_cast<int>(std::clamp<qint64>(dueMs, 0, std::numeric_limits<int>::max())));
+}
+
+int TimerWheel::driverIntervalMs() const {
+    return m_driver->isActive() ? m_driver->interval() : -1;
+}
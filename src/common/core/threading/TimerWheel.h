@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QElapsedTimer>
+#include <functional>
+#include <vector>
+
+class QTimer;
+
+/**
+ * @brief 单线程哈希定时轮
+ *
+ * 把同一线程上大量会话的周期定时器（心跳、光标轮询等）合并到一个 QTimer 上：
+ * 时间按 tickMs 划分为刻度，定时器按到期刻度挂在 slotCount 个槽中的一个，
+ * 每个刻度只检查一个槽，调度和取消都是 O(1)。间隔向上取整到刻度，超过一圈的定时器留在槽中等待后续轮次。
+ * 驱动 QTimer 是单次定时器，只在最近的到期时间唤醒线程；没有待触发的定时器时停止，空闲线程不会被唤醒。
+ *
+ * 非线程安全：只能在所属线程使用。forCurrentThread() 为每个线程提供一个实例。
+ */
+class TimerWheel : public QObject {
+    Q_OBJECT
+
+public:
+    using TimerId = quint64;
+    using Callback = std::function<void()>;
+
+    static constexpr int DEFAULT_TICK_MS = 8;          ///< 默认刻度（毫秒）
+    static constexpr int DEFAULT_SLOT_COUNT = 512;     ///< 默认槽数（一圈约 4 秒）
+
+    /**
+     * @brief 构造函数
+     * @param tickMs 刻度（毫秒）
+     * @param slotCount 槽数
+     * @param parent 父对象
+     */
+    explicit TimerWheel(int tickMs = DEFAULT_TICK_MS, int slotCount = DEFAULT_SLOT_COUNT, QObject* parent = nullptr);
+    ~TimerWheel() override;
+
+    /**
+     * @brief 当前线程的定时轮（首次调用时创建，线程结束时销毁）
+     */
+    [[nodiscard]] static TimerWheel* forCurrentThread();
+
+    /**
+     * @brief 调度定时器
+     * @param intervalMs 间隔（毫秒），向上取整到刻度，至少一个刻度
+     * @param callback 回调；可以在回调中调度或取消定时器（包括自身）
+     * @param repeat 是否周期触发
+     * @return 定时器ID（从不为 0）
+     */
+    TimerId schedule(int intervalMs, Callback callback, bool repeat = true);
+
+    /**
+     * @brief 取消定时器；ID 无效或已触发（单次）时返回 false
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief 推进时间并触发到期的定时器
+     *
+     * 驱动 QTimer 按实际经过的时间调用；测试可直接调用以获得确定的结果。
+     * @param elapsedMs 经过的毫秒数（不足一个刻度的部分累积到下次）
+     * @return 本次触发的回调数
+     */
+    int advance(qint64 elapsedMs);
+
+    [[nodiscard]] int pendingCount() const { return static_cast<int>(m_entries.size()); }
+    [[nodiscard]] int tickMs() const { return m_tickMs; }
+
+    /**
+     * @brief 驱动 QTimer 下次唤醒的间隔（毫秒）；驱动停止时返回 -1
+     */
+    [[nodiscard]] int driverIntervalMs() const;
+
+private:
+    struct Entry {
+        quint64 dueTick = 0;
+        quint64 intervalTicks = 1;
+        bool repeat = false;
+        Callback callback;
+    };
+
+    void place(TimerId id, quint64 dueTick);
+    void onTimeout();
+    void updateDriver();
+
+    int m_tickMs;
+    std::vector<QList<TimerId>> m_slots;     ///< 槽 i 挂着到期刻度 % slotCount == i 的定时器
+    QHash<TimerId, Entry> m_entries;
+    TimerId m_nextId;
+    quint64 m_currentTick;                   ///< 已处理到的刻度
+    qint64 m_remainderMs;                    ///< 不足一个刻度的累积时间
+    QTimer* m_driver;
+    QElapsedTimer m_clock;                   ///< 驱动计时（按实际经过时间推进，补偿定时器抖动）
+    bool m_running;                          ///< 是否有待触发的定时器（驱动在两次唤醒之间也为 true）
+};
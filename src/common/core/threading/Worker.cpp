@@ -118,6 +118,16 @@ void Worker::stop(bool waitForFinish) {
     // 唤醒可能在暂停状态等待的线程
     m_pauseCondition.wakeAll();
 
+    // 事件驱动模式没有需要等待结束的工作循环：在所属线程中直接收尾
+    if ( m_eventDriven ) {
+        if ( QThread::currentThread() == thread() ) {
+            doStop();
+        } else {
+            QMetaObject::invokeMethod(this, &Worker::doStop, Qt::QueuedConnection);
+        }
+        return;
+    }
+
     // 根据waitForFinish调整强制停止超时时间
     int forceStopTimeout = waitForFinish ? 2000 : 500;
 
@@ -226,6 +236,10 @@ void Worker::emitError(const QString& error) {
     emit errorOccurred(error);
 }
 
+void Worker::setEventDriven(bool eventDriven) {
+    m_eventDriven = eventDriven;
+}
+
 void Worker::setDidWork(bool didWork) {
     m_adaptiveSleepEnabled.store(true);
     m_lastDidWork.store(didWork);
@@ -296,6 +310,11 @@ void Worker::doStart() {
         m_uptimeTimer.start();
         emit started();
 
+        // 事件驱动模式：之后由事件循环驱动，直到 stop()
+        if ( m_eventDriven ) {
+            return;
+        }
+
         // 开始工作循环
         workLoop();
 
@@ -322,8 +341,9 @@ void Worker::doStop() {
     // 确保事件循环退出：
     // 说明：当工作循环正常结束或强制停止触发时，统一在所属线程中请求退出事件循环，
     // 避免线程保持运行导致 QThread 在销毁时仍在运行的错误。
+    // 事件驱动的 Worker 共享所在线程，不能退出它
     QThread* workerThread = this->thread();
-    if ( workerThread && workerThread->isRunning() ) {
+    if ( !m_eventDriven && workerThread && workerThread->isRunning() ) {
         qCDebug(lcApp) << "[DEBUG] Worker::doStop() requesting thread quit for:" << m_name;
         workerThread->quit();
     }
@@ -240,6 +240,17 @@ protected:
      */
     void setDidWork(bool didWork);
 
+    /**
+     * @brief 设置为事件驱动模式（须在 start() 之前调用）
+     *
+     * 事件驱动的 Worker 不运行 workLoop()/processTask() 循环，只在所在线程的事件循环中
+     * 响应信号和定时器，因此多个 Worker 可以共享同一个线程（见 IoThreadPool）。
+     * 停止时在所在线程直接收尾，且不退出该线程；不支持 pause()/resume()。
+     */
+    void setEventDriven(bool eventDriven);
+
+    [[nodiscard]] bool isEventDriven() const { return m_eventDriven; }
+
     /**
      * @brief 初始化工作线程
      *
@@ -298,6 +309,7 @@ private:
     QElapsedTimer m_uptimeTimer;        ///< 运行时间计时器
 
     bool m_waitForFinish;               ///< 是否等待完成
+    bool m_eventDriven = false;         ///< 事件驱动模式（无工作循环，共享线程）
 
     // Adaptive sleep: when a subclass calls setDidWork(false), workLoop
     // sleeps 1ms; when setDidWork(true), it skips the sleep. Subclasses
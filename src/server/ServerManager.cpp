@@ -6,25 +6,46 @@
 #include "capture/ScreenCapture.h"
 #include "clienthandler/ClientHandlerWorker.h"
 #include "../common/core/threading/ThreadManager.h"
+#include "../common/core/threading/IoThreadPool.h"
 #include "../common/core/network/Protocol.h"
 #include "dataflow/QueueManager.h"
 #include "../common/core/config/Constants.h"
+#include "../common/core/config/NetworkConstants.h"
 #include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
+#include <QtNetwork/QTcpSocket>
+#include <algorithm>
 #include <memory>
 // 新增：引入日志分类声明头，使用统一的日志分类（lcServerManager）
 #include "../common/core/logging/LoggingCategories.h"
 
+namespace {
+
+// 显示器布局条目：几何为全局逻辑坐标，超出协议字段范围的部分截断
+MonitorInfo makeMonitorInfo(quint8 id, const QRect& geometry, bool primary) {
+    MonitorInfo monitor;
+    monitor.id = id;
+    monitor.flags = primary ? static_cast<quint8>(MonitorFlags::PRIMARY) : static_cast<quint8>(MonitorFlags::NONE);
+    monitor.x = static_cast<qint16>(std::clamp(geometry.x(), -32768, 32767));
+    monitor.y = static_cast<qint16>(std::clamp(geometry.y(), -32768, 32767));
+    monitor.width = static_cast<quint16>(std::clamp(geometry.width(), 0, 65535));
+    monitor.height = static_cast<quint16>(std::clamp(geometry.height(), 0, 65535));
+    return monitor;
+}
+
+} // namespace
+
 ServerManager::ServerManager(QObject* parent, ThreadManager* threadMgr, QueueManager* queueMgr)
     : QObject(parent)
     , m_threadManager(threadMgr ? threadMgr : ThreadManager::instance())
     , m_isServerRunning(false)
     , m_currentPort(0)
     , m_screenCapture(nullptr)
-    , m_dataWorker(nullptr)
     , m_queueManager(nullptr)
-    , m_currentClient(nullptr)
-    , m_currentClientThreadName() {
+    , m_ioThreadPool(nullptr) {
     qCDebug(lcServerManager) << "ServerManager::ServerManager() - Initializing ServerManager";
 
     // Use injected QueueManager or fall back to singleton
@@ -32,7 +53,10 @@ ServerManager::ServerManager(QObject* parent, ThreadManager* threadMgr, QueueMan
     m_queueManager->initialize(120, 120); // 捕获队列120, 处理队列120
 
     // 创建屏幕捕获管理器（在主线程创建）
-    m_screenCapture = new ScreenCapture(this);
+    m_screenCapture = new ScreenCapture(this, m_queueManager);
+
+    // 每个显示器一条流水线，主显示器使用上面的队列管理器和捕获管理器
+    createScreenPipelines();
 
     // 设置与ServerWorker的信号连接
     setupWorkerConnections();
@@ -47,8 +71,11 @@ ServerManager::~ServerManager() {
     // 停止屏幕捕获和数据处理
     stopWorkerThreads();
 
-    // 清理客户端连接
-    cleanupDisconnectedClient();
+    // 清理客户端连接，然后退出会话共享的I/O线程
+    cleanupAllClients();
+    if ( m_ioThreadPool ) {
+        m_ioThreadPool->shutdown();
+    }
 
     // 只有在没有进行优雅关闭的情况下才调用gracefulShutdown
     if ( !m_gracefulShuttingDown.load() ) {
@@ -61,14 +88,18 @@ ServerManager::~ServerManager() {
     // 断开与ServerWorker的信号连接
     disconnectWorkerSignals();
 
-    // 清理屏幕捕获
+    // 清理屏幕捕获；其他显示器的捕获管理器先于其队列管理器删除
+    for ( qsizetype i = 1; i < m_pipelines.size(); ++i ) {
+        delete m_pipelines[i].capture;
+        delete m_pipelines[i].queueManager;
+    }
+    m_pipelines.clear();
     if ( m_screenCapture ) {
         m_screenCapture->deleteLater();
         m_screenCapture = nullptr;
     }
 
-    m_dataWorker = nullptr; // 由ThreadManager管理生命周期
-    m_queueManager = nullptr; // 单例，不需要删除
+    m_queueManager = nullptr; // 注入的流水线或单例，不由本类删除
 
     qCDebug(lcServerManager) << "ServerManager::~ServerManager() - Destructor complete";
 }
@@ -278,7 +309,9 @@ void ServerManager::onWorkerServerStopped() {
         QMutexLocker lock(&m_stateMutex);
         m_isServerRunning = false;
         m_currentPort = 0;
-        m_captureStarted = false;
+    }
+    for ( ScreenPipeline& pipeline : m_pipelines ) {
+        pipeline.started = false;
     }
     qCDebug(lcServerManager) << "ServerManager::onWorkerServerStopped() - Server stopped";
     qCInfo(lcServerManager) << "ServerManager::onWorkerServerStopped() - Server stopped";
@@ -346,7 +379,7 @@ ServerWorker* ServerManager::getServerWorker() const {
 DataProcessingWorker* ServerManager::getDataProcessingWorker() const {
     QMutexLocker lock(&m_workerMutex);
 
-    const ThreadManager::ThreadInfo* threadInfo = m_threadManager->getThreadInfo("DataProcessingWorker");
+    const ThreadManager::ThreadInfo* threadInfo = m_threadManager->getThreadInfo(m_queueManager->threadName(QStringLiteral("DataProcessingWorker")));
     if ( !threadInfo || !threadInfo->worker ) {
         return nullptr;
     }
@@ -459,143 +492,204 @@ void ServerManager::gracefulShutdown() {
     qCDebug(lcServerManager) << "ServerManager::gracefulShutdown() - Graceful shutdown complete";
 }
 
+void ServerManager::createScreenPipelines() {
+    // 主显示器使用注入的流水线，ID 固定为 0
+    QGuiApplication* app = qobject_cast<QGuiApplication*>(QCoreApplication::instance());
+    QScreen* primaryScreen = app ? app->primaryScreen() : nullptr;
+    ScreenPipeline primary;
+    primary.monitor = makeMonitorInfo(0, primaryScreen ? primaryScreen->geometry() : QRect(), true);
+    primary.queueManager = m_queueManager;
+    primary.capture = m_screenCapture;
+    m_pipelines.append(primary);
+    if ( !app ) {
+        return;
+    }
+
+    // 其他显示器各有独立的队列、捕获线程与编码线程，互相并行；只在有会话查看时启动
+    const QList<QScreen*> screens = app->screens();
+    for ( QScreen* screen : screens ) {
+        if ( screen == primaryScreen ) {
+            continue;
+        }
+        if ( m_pipelines.size() >= MonitorLayout::MAX_MONITORS ) {
+            qCWarning(lcServerManager) << "ServerManager::createScreenPipelines() - Too many monitors, ignoring" << screen->name();
+            continue;
+        }
+        ScreenPipeline pipeline;
+        pipeline.monitor = makeMonitorInfo(static_cast<quint8>(m_pipelines.size()), screen->geometry(), false);
+        pipeline.queueManager = new QueueManager(QStringLiteral("screen%1").arg(pipeline.monitor.id), this);
+        pipeline.capture = new ScreenCapture(this, pipeline.queueManager);
+        CaptureConfig config = pipeline.capture->getCaptureConfig();
+        config.screenName = screen->name();
+        pipeline.capture->updateCaptureConfig(config);
+        m_pipelines.append(pipeline);
+    }
+
+    for ( const ScreenPipeline& pipeline : std::as_const(m_pipelines) ) {
+        qCInfo(lcServerManager) << "ServerManager::createScreenPipelines() - Monitor" << pipeline.monitor.id
+            << pipeline.monitor.geometry() << (pipeline.monitor.isPrimary() ? "(primary)" : "");
+    }
+}
+
 void ServerManager::stopWorkerThreads() {
-    qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Stopping worker threads (screen capture and data processing)";
+    qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Stopping worker threads of all monitors";
+    for ( ScreenPipeline& pipeline : m_pipelines ) {
+        stopPipeline(pipeline);
+    }
+    qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Worker threads stopped";
+}
+
+void ServerManager::updateCapturedMonitors() {
+    // 只捕获至少有一个已认证会话在查看的显示器
+    QList<quint8> viewed;
+    {
+        QMutexLocker locker(&m_clientMutex);
+        for ( const QList<quint8>& monitorIds : std::as_const(m_clientViews) ) {
+            for ( quint8 id : monitorIds ) {
+                if ( !viewed.contains(id) ) {
+                    viewed.append(id);
+                }
+            }
+        }
+    }
+    for ( ScreenPipeline& pipeline : m_pipelines ) {
+        if ( viewed.contains(pipeline.monitor.id) ) {
+            if ( !pipeline.started ) {
+                startPipeline(pipeline);
+            }
+        } else if ( pipeline.started ) {
+            stopPipeline(pipeline);
+        }
+    }
+}
+
+void ServerManager::stopPipeline(ScreenPipeline& pipeline) {
+    qCDebug(lcServerManager) << "ServerManager::stopPipeline() - Stopping monitor" << pipeline.monitor.id
+        << "(screen capture and data processing)";
 
     // 停止并销毁数据处理线程
-    const QString dataWorkerName = QStringLiteral("DataProcessingWorker");
+    const QString dataWorkerName = pipeline.queueManager->threadName(QStringLiteral("DataProcessingWorker"));
     if ( m_threadManager && m_threadManager->hasThread(dataWorkerName) ) {
-        qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Stopping DataProcessingWorker thread";
+        qCDebug(lcServerManager) << "ServerManager::stopPipeline() - Stopping DataProcessingWorker thread" << dataWorkerName;
 
         // 先请求工作器清空队列
-        if ( m_dataWorker ) {
-            QMetaObject::invokeMethod(m_dataWorker, "stopProcessingAndClearQueues", Qt::QueuedConnection);
+        if ( pipeline.dataWorker ) {
+            QMetaObject::invokeMethod(pipeline.dataWorker, "stopProcessingAndClearQueues", Qt::QueuedConnection);
         }
 
         // 同步停止线程
         bool stopSuccess = m_threadManager->stopThread(dataWorkerName, true);
         if ( stopSuccess ) {
-            qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - DataProcessingWorker thread stopped";
+            qCDebug(lcServerManager) << "ServerManager::stopPipeline() - DataProcessingWorker thread stopped";
         } else {
-            qCWarning(lcServerManager) << "ServerManager::stopWorkerThreads() - Failed to stop DataProcessingWorker thread";
+            qCWarning(lcServerManager) << "ServerManager::stopPipeline() - Failed to stop DataProcessingWorker thread" << dataWorkerName;
         }
 
         // 销毁线程
         bool destroySuccess = m_threadManager->destroyThread(dataWorkerName);
         if ( destroySuccess ) {
-            qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - DataProcessingWorker thread destroyed";
+            qCDebug(lcServerManager) << "ServerManager::stopPipeline() - DataProcessingWorker thread destroyed";
         } else {
-            qCWarning(lcServerManager) << "ServerManager::stopWorkerThreads() - Failed to destroy DataProcessingWorker thread";
+            qCWarning(lcServerManager) << "ServerManager::stopPipeline() - Failed to destroy DataProcessingWorker thread" << dataWorkerName;
         }
-
-        m_dataWorker = nullptr;
     }
+    pipeline.dataWorker = nullptr;
 
     // 停止屏幕捕获 — 无论 isCapturing() 返回什么，都必须尝试停止。
     // 原因：ScreenCapture::onThreadStopped() 可能因 auto-restart 等原因已将 m_isCapturing
     // 置为 false，但线程可能仍在 ThreadManager 中（待重启或已重启完成仍在运行）。
-    if ( m_screenCapture ) {
-        qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Stopping screen capture"
-            << "(isCapturing=" << m_screenCapture->isCapturing() << ")";
-        m_screenCapture->stopCapture();
-        qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Screen capture stopped";
+    if ( pipeline.capture ) {
+        qCDebug(lcServerManager) << "ServerManager::stopPipeline() - Stopping screen capture"
+            << "(isCapturing=" << pipeline.capture->isCapturing() << ")";
+        pipeline.capture->stopCapture();
+        qCDebug(lcServerManager) << "ServerManager::stopPipeline() - Screen capture stopped";
     }
 
     // 更新状态标志
-    {
-        QMutexLocker lock(&m_stateMutex);
-        m_captureStarted = false;
-    }
-
-    qCDebug(lcServerManager) << "ServerManager::stopWorkerThreads() - Worker threads stopped";
+    pipeline.started = false;
 }
 
-void ServerManager::startWorkerThreads() {
-    qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Starting worker threads (data processing and screen capture)";
+void ServerManager::startPipeline(ScreenPipeline& pipeline) {
+    qCDebug(lcServerManager) << "ServerManager::startPipeline() - Starting monitor" << pipeline.monitor.id
+        << "(data processing and screen capture)";
 
     if ( !m_threadManager ) {
-        qCWarning(lcServerManager) << "ServerManager::startWorkerThreads() - ThreadManager does not exist, cannot start worker threads";
+        qCWarning(lcServerManager) << "ServerManager::startPipeline() - ThreadManager does not exist, cannot start worker threads";
         return;
     }
 
     // 幂等保护：如果已启动则直接返回
-    {
-        QMutexLocker lock(&m_stateMutex);
-        if ( m_captureStarted ) {
-            qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Worker threads already started, skipping";
-            return;
-        }
+    if ( pipeline.started ) {
+        qCDebug(lcServerManager) << "ServerManager::startPipeline() - Worker threads already started, skipping";
+        return;
     }
 
     // 1. 启动屏幕捕获
-    if ( m_screenCapture ) {
-        qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Starting screen capture";
-        m_screenCapture->startCapture();
-        qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Screen capture started";
+    if ( pipeline.capture ) {
+        qCDebug(lcServerManager) << "ServerManager::startPipeline() - Starting screen capture";
+        pipeline.capture->startCapture();
+        qCDebug(lcServerManager) << "ServerManager::startPipeline() - Screen capture started";
     }
 
-    // 2. 创建和启动 DataProcessingWorker 线程
-    const QString dataWorkerName = QStringLiteral("DataProcessingWorker");
+    // 2. 创建和启动 DataProcessingWorker 线程（每个显示器一个编码线程）
+    const QString dataWorkerName = pipeline.queueManager->threadName(QStringLiteral("DataProcessingWorker"));
     if ( !m_threadManager->hasThread(dataWorkerName) ) {
-        qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Creating DataProcessingWorker thread";
+        qCDebug(lcServerManager) << "ServerManager::startPipeline() - Creating DataProcessingWorker thread" << dataWorkerName;
 
         // 创建数据处理配置
         auto processingConfig = std::make_shared<DataProcessingConfig>();
 
         // 创建数据处理工作线程
-        auto dataWorker = std::make_unique<DataProcessingWorker>();
+        auto dataWorker = std::make_unique<DataProcessingWorker>(pipeline.queueManager);
         DataProcessingWorker* dataWorkerPtr = dataWorker.get();
         dataWorkerPtr->setProcessingConfig(processingConfig);
         dataWorkerPtr->setMaxQueueSize(CoreConstants::Performance::MAX_QUEUE_SIZE);
         dataWorkerPtr->setProcessingTimeout(2000);
 
         if ( !m_threadManager->createThread(dataWorkerName, std::move(dataWorker), false, true, 3) ) {
-            qCCritical(lcServerManager) << "ServerManager::startWorkerThreads() - Failed to create DataProcessingWorker thread";
-            m_dataWorker = nullptr;
+            qCCritical(lcServerManager) << "ServerManager::startPipeline() - Failed to create DataProcessingWorker thread";
+            pipeline.dataWorker = nullptr;
             return;
         }
 
         if ( !m_threadManager->startThread(dataWorkerName) ) {
-            qCCritical(lcServerManager) << "ServerManager::startWorkerThreads() - Failed to start DataProcessingWorker thread";
+            qCCritical(lcServerManager) << "ServerManager::startPipeline() - Failed to start DataProcessingWorker thread";
             m_threadManager->destroyThread(dataWorkerName);
-            m_dataWorker = nullptr;
+            pipeline.dataWorker = nullptr;
             return;
         }
 
-        m_dataWorker = dataWorkerPtr;
-        qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - DataProcessingWorker thread created and started";
+        pipeline.dataWorker = dataWorkerPtr;
+        qCDebug(lcServerManager) << "ServerManager::startPipeline() - DataProcessingWorker thread created and started";
 
         // 恢复数据处理
-        QMetaObject::invokeMethod(m_dataWorker, "resumeProcessing", Qt::QueuedConnection);
+        QMetaObject::invokeMethod(pipeline.dataWorker, "resumeProcessing", Qt::QueuedConnection);
     } else {
         // 线程已存在，确保其处于运行状态
         const ThreadManager::ThreadInfo* info = m_threadManager->getThreadInfo(dataWorkerName);
         if ( info && info->worker ) {
-            m_dataWorker = qobject_cast<DataProcessingWorker*>(info->worker);
+            pipeline.dataWorker = qobject_cast<DataProcessingWorker*>(info->worker);
         }
 
         if ( !m_threadManager->isThreadRunning(dataWorkerName) ) {
-            qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Starting existing DataProcessingWorker thread";
+            qCDebug(lcServerManager) << "ServerManager::startPipeline() - Starting existing DataProcessingWorker thread";
             if ( m_threadManager->startThread(dataWorkerName) ) {
-                qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - DataProcessingWorker thread started";
+                qCDebug(lcServerManager) << "ServerManager::startPipeline() - DataProcessingWorker thread started";
             } else {
-                qCWarning(lcServerManager) << "ServerManager::startWorkerThreads() - Failed to start existing DataProcessingWorker thread";
+                qCWarning(lcServerManager) << "ServerManager::startPipeline() - Failed to start existing DataProcessingWorker thread";
             }
         }
 
-        if ( m_dataWorker ) {
-            qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Resuming DataProcessingWorker data processing";
-            QMetaObject::invokeMethod(m_dataWorker, "resumeProcessing", Qt::QueuedConnection);
+        if ( pipeline.dataWorker ) {
+            qCDebug(lcServerManager) << "ServerManager::startPipeline() - Resuming DataProcessingWorker data processing";
+            QMetaObject::invokeMethod(pipeline.dataWorker, "resumeProcessing", Qt::QueuedConnection);
         }
     }
 
     // 设置状态为已启动
-    {
-        QMutexLocker lock(&m_stateMutex);
-        m_captureStarted = true;
-    }
+    pipeline.started = true;
 
-    qCDebug(lcServerManager) << "ServerManager::startWorkerThreads() - Worker threads started";
+    qCDebug(lcServerManager) << "ServerManager::startPipeline() - Worker threads started";
 }
 
 void ServerManager::onNewClientConnection(qintptr socketDescriptor) {
@@ -603,11 +697,14 @@ void ServerManager::onNewClientConnection(qintptr socketDescriptor) {
 
     QMutexLocker locker(&m_clientMutex);
 
-    // 单连接模式：如果已有客户端连接，拒绝新连接
-    if ( m_currentClient ) {
-        qCDebug(lcServerManager) << "ServerManager::onNewClientConnection() - Existing client connected, rejecting new connection";
-        // 发送拒绝消息的逻辑可以在这里实现
-        
+    // 会话数达到上限时拒绝新连接：接管描述符后立即关闭，避免泄漏
+    if ( m_clients.size() >= NetworkConstants::MAX_VIEWER_SESSIONS ) {
+        qCWarning(lcServerManager) << "ServerManager::onNewClientConnection() - Viewer session limit reached ("
+            << NetworkConstants::MAX_VIEWER_SESSIONS << "), rejecting new connection";
+        QTcpSocket rejected;
+        if ( rejected.setSocketDescriptor(socketDescriptor) ) {
+            rejected.abort();
+        }
         return;
     }
 
@@ -620,77 +717,115 @@ void ServerManager::onNewClientConnection(qintptr socketDescriptor) {
         key = sw->sslPrivateKey();
     }
     auto worker = std::make_unique<ClientHandlerWorker>(socketDescriptor, cert, key);
+    worker->setQueueManager(m_queueManager);
+    QList<MonitorPipeline> monitors;
+    for ( const ScreenPipeline& pipeline : std::as_const(m_pipelines) ) {
+        monitors.append({ pipeline.monitor, pipeline.queueManager });
+    }
+    worker->setMonitorPipelines(monitors);
 
-    // 保存Worker裸指针（在move之前）
-    m_currentClient = worker.get();
-
-    // 创建线程名称
-    m_currentClientThreadName = QString("ClientHandler_%1").arg(socketDescriptor);
-
-    // 使用ThreadManager创建并启动Worker线程
-    if ( !m_threadManager->createThread(m_currentClientThreadName, std::move(worker), true) ) {
-        qCCritical(lcServerManager) << "ServerManager::onNewClientConnection() - Failed to create ClientHandlerWorker thread";
-        m_currentClient = nullptr;
-        m_currentClientThreadName.clear();
+    // 会话是事件驱动的，分配到负载最小的共享I/O线程，而不是各占一个线程
+    if ( !m_ioThreadPool ) {
+        m_ioThreadPool = new IoThreadPool(std::min(QThread::idealThreadCount(), NetworkConstants::MAX_IO_THREADS),
+            QStringLiteral("ClientIo"), this);
+    }
+    QThread* ioThread = m_ioThreadPool->attach(worker.get());
+    if ( !ioThread ) {
+        qCCritical(lcServerManager) << "ServerManager::onNewClientConnection() - No I/O thread available for ClientHandlerWorker";
         return;
     }
+    // 所有权交给I/O线程：cleanupDisconnectedClient 中在该线程内 deleteLater
+    ClientHandlerWorker* client = worker.release();
+    m_clients.insert(client, ioThread);
 
-    // Worker已经在新线程中，现在建立信号连接
-    connect(m_currentClient, &ClientHandlerWorker::disconnected,
+    // Worker已经在I/O线程中，先建立信号连接再启动
+    connect(client, &ClientHandlerWorker::disconnected,
         this, &ServerManager::onClientHandlerDisconnected, Qt::QueuedConnection);
 
-    connect(m_currentClient, &ClientHandlerWorker::authenticated,
+    connect(client, &ClientHandlerWorker::authenticated,
         this, &ServerManager::onClientHandlerAuthenticated, Qt::QueuedConnection);
 
-    connect(m_currentClient, &ClientHandlerWorker::errorOccurred,
+    connect(client, &ClientHandlerWorker::errorOccurred,
         this, &ServerManager::onClientHandlerError, Qt::QueuedConnection);
 
-    connect(m_currentClient, &ClientHandlerWorker::messageReceived,
+    connect(client, &ClientHandlerWorker::messageReceived,
         this, &ServerManager::onClientHandlerMessageReceived, Qt::QueuedConnection);
 
-    qCDebug(lcServerManager) << "ServerManager::onNewClientConnection() - ClientHandlerWorker started in thread";
+    connect(client, &ClientHandlerWorker::monitorSelectionChanged,
+        this, &ServerManager::onClientHandlerMonitorSelectionChanged, Qt::QueuedConnection);
+
+    QMetaObject::invokeMethod(client, "start", Qt::QueuedConnection);
+
+    qCDebug(lcServerManager) << "ServerManager::onNewClientConnection() - ClientHandlerWorker started in thread"
+        << ioThread->objectName() << "sessions:" << m_clients.size();
 }
 
 void ServerManager::onClientHandlerDisconnected() {
+    ClientHandlerWorker* client = qobject_cast<ClientHandlerWorker*>(sender());
     QString clientAddress;
-    if ( m_currentClient ) {
-        clientAddress = m_currentClient->clientAddress();
+    {
+        QMutexLocker locker(&m_clientMutex);
+        if ( !client || !m_clients.contains(client) ) {
+            return;
+        }
+        clientAddress = client->clientAddress();
     }
 
     qCDebug(lcServerManager) << "ServerManager::onClientHandlerDisconnected() - Client disconnected:" << clientAddress;
 
     // 清理客户端
-    cleanupDisconnectedClient();
+    cleanupDisconnectedClient(client);
 
-    // 停止工作线程
-    stopWorkerThreads();
+    // 最后一个会话断开时停止全部工作线程；否则只停止不再有人查看的显示器
+    bool lastClient = false;
+    {
+        QMutexLocker locker(&m_clientMutex);
+        lastClient = m_clients.isEmpty();
+    }
+    if ( lastClient ) {
+        stopWorkerThreads();
+    } else {
+        updateCapturedMonitors();
+    }
 
     emit clientDisconnected(clientAddress);
 }
 
 void ServerManager::onClientHandlerAuthenticated() {
-    if ( !m_currentClient ) return;
-
-    QString clientAddress = m_currentClient->clientAddress();
-    qCDebug(lcServerManager) << "ServerManager::onClientHandlerAuthenticated() - Client authenticated:" << clientAddress;
-
-    // 检查是否已启动工作线程
-    bool alreadyStarted = false;
+    ClientHandlerWorker* client = qobject_cast<ClientHandlerWorker*>(sender());
+    QString clientAddress;
     {
-        QMutexLocker lock(&m_stateMutex);
-        alreadyStarted = m_captureStarted;
+        QMutexLocker locker(&m_clientMutex);
+        if ( !client || !m_clients.contains(client) ) {
+            return;
+        }
+        clientAddress = client->clientAddress();
     }
+    qCDebug(lcServerManager) << "ServerManager::onClientHandlerAuthenticated() - Client authenticated:" << clientAddress;
 
-    if ( !alreadyStarted ) {
-        qCDebug(lcServerManager) << "ServerManager::onClientHandlerAuthenticated() - First client authenticated, starting DataProcessingWorker and ScreenCapture";
-        startWorkerThreads();
-    } else {
-        qCDebug(lcServerManager) << "ServerManager::onClientHandlerAuthenticated() - Worker threads already running, skipping start";
+    // 会话认证后默认查看主显示器：第一个会话认证时启动主显示器的捕获与编码，之后的会话共享编码流
+    {
+        QMutexLocker locker(&m_clientMutex);
+        m_clientViews.insert(client, { m_pipelines.first().monitor.id });
     }
+    updateCapturedMonitors();
 
     emit clientAuthenticated(clientAddress);
 }
 
+void ServerManager::onClientHandlerMonitorSelectionChanged(const QList<quint8>& monitorIds) {
+    ClientHandlerWorker* client = qobject_cast<ClientHandlerWorker*>(sender());
+    {
+        QMutexLocker locker(&m_clientMutex);
+        if ( !client || !m_clients.contains(client) ) {
+            return;
+        }
+        m_clientViews.insert(client, monitorIds);
+    }
+    qCDebug(lcServerManager) << "ServerManager::onClientHandlerMonitorSelectionChanged() - Client views monitors:" << monitorIds;
+    updateCapturedMonitors();
+}
+
 void ServerManager::onClientHandlerError(const QString& error) {
     qCCritical(lcServerManager) << "ServerManager::onClientHandlerError() - Client error:" << error;
     emit serverError(error);
@@ -705,22 +840,48 @@ void ServerManager::onClientHandlerMessageReceived(MessageType type, const QByte
     Q_UNUSED(data);
 }
 
-void ServerManager::cleanupDisconnectedClient() {
-    QString threadNameToDestroy;
+void ServerManager::cleanupDisconnectedClient(ClientHandlerWorker* worker) {
+    QThread* ioThread = nullptr;
     {
         QMutexLocker locker(&m_clientMutex);
-        if ( m_currentClient ) {
+        if ( worker && m_clients.contains(worker) ) {
             // 断开Worker信号连接
-            m_currentClient->disconnect(this);
-            // 在锁内保存线程名称并清空状态，避免持锁时调用 destroyThread 进入事件循环导致死锁
-            threadNameToDestroy = m_currentClientThreadName;
-            m_currentClient = nullptr;
-            m_currentClientThreadName.clear();
+            worker->disconnect(this);
+            // 在锁内取出并移除，避免持锁时等待I/O线程
+            ioThread = m_clients.take(worker);
+            m_clientViews.remove(worker);
         }
     }
-    // 在锁外调用 destroyThread，避免持锁时重入事件循环
-    if ( !threadNameToDestroy.isEmpty() && m_threadManager ) {
-        m_threadManager->stopThread(threadNameToDestroy, false);
-        m_threadManager->destroyThread(threadNameToDestroy);
+    if ( !ioThread ) {
+        return;
+    }
+    // 在会话所在的I/O线程中停止（事件驱动的 stop 在本线程内同步完成清理）并延迟删除；
+    // 阻塞到清理完成，返回后会话不再访问流水线（随后 stopWorkerThreads 可能销毁队列）。
+    // 当前就在该线程，或该线程已不再处理事件时，阻塞投递会死锁，改为直接停止
+    if ( ioThread == QThread::currentThread() ) {
+        worker->stop(false);
+        worker->deleteLater();
+    } else if ( !ioThread->isRunning() ) {
+        worker->stop(false);
+        delete worker;
+    } else {
+        QMetaObject::invokeMethod(worker, [worker]() {
+            worker->stop(false);
+            worker->deleteLater();
+        }, Qt::BlockingQueuedConnection);
+    }
+    if ( m_ioThreadPool ) {
+        m_ioThreadPool->detach(ioThread);
+    }
+}
+
+void ServerManager::cleanupAllClients() {
+    QList<ClientHandlerWorker*> clients;
+    {
+        QMutexLocker locker(&m_clientMutex);
+        clients = m_clients.keys();
+    }
+    for ( ClientHandlerWorker* client : clients ) {
+        cleanupDisconnectedClient(client);
     }
 }
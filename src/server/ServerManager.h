@@ -15,6 +15,8 @@ class ClientHandlerWorker;
 class ScreenCapture;
 class DataProcessingWorker;
 class QueueManager;
+class IoThreadPool;
+class QThread;
 class QTimer;
 
 /**
@@ -22,6 +24,14 @@ class QTimer;
  *
  * 作为服务器工作线程的代理，提供线程安全的服务器管理接口。
  * 所有服务器操作都通过ServerWorker在独立线程中执行。
+ *
+ * 支持多个客户端会话同时观看（最多 MAX_VIEWER_SESSIONS 个）：捕获与编码只做一次，
+ * 每个会话从处理队列的广播环读取；第一个会话认证时启动捕获，最后一个断开时停止。
+ * 会话不各占线程，而是分配到按CPU核心数创建的共享I/O线程池（IoThreadPool）上。
+ *
+ * 每个显示器有独立的流水线（队列、捕获线程、编码线程），彼此并行；主显示器的 ID 为 0。
+ * 会话通过 MONITOR_SELECT 选择查看的显示器，只有至少一个会话在查看的显示器才会被捕获。
+ * 显示器在构造时枚举，运行期间的热插拔不会增删流水线。
  */
 class ServerManager : public QObject {
     Q_OBJECT
@@ -93,6 +103,7 @@ private slots:
     void onClientHandlerAuthenticated();
     void onClientHandlerError(const QString& error);
     void onClientHandlerMessageReceived(MessageType type, const QByteArray& data);
+    void onClientHandlerMonitorSelectionChanged(const QList<quint8>& monitorIds);
 
 private:
     /**
@@ -123,21 +134,53 @@ private:
     class DataProcessingWorker* getDataProcessingWorker() const;
 
     /**
-     * @brief 停止工作线程（DataProcessingWorker和ScreenCaptureWorker）
+     * @brief 一个显示器的捕获/编码流水线
+     */
+    struct ScreenPipeline {
+        MonitorInfo monitor;                        ///< 显示器ID与几何（ID 0 为主显示器）
+        QueueManager* queueManager = nullptr;       ///< 队列管理器
+        ScreenCapture* capture = nullptr;           ///< 屏幕捕获管理器
+        DataProcessingWorker* dataWorker = nullptr; ///< 数据处理工作线程（由ThreadManager管理生命周期）
+        bool started = false;                       ///< 捕获/数据处理是否已启动（避免重复启动）
+    };
+
+    /**
+     * @brief 为每个显示器创建流水线（构造时调用）
+     */
+    void createScreenPipelines();
+
+    /**
+     * @brief 停止所有显示器的工作线程（DataProcessingWorker和ScreenCaptureWorker）
      * 在最后一个客户端断开连接时调用，完全停止线程以节省资源
      */
     void stopWorkerThreads();
 
     /**
-     * @brief 启动工作线程（DataProcessingWorker和ScreenCaptureWorker）
-     * 在第一个客户端连接时调用，重新启动必要的工作线程
+     * @brief 按各会话查看的显示器启动或停止流水线
+     * 会话认证、切换显示器或断开时调用：有人查看的启动，无人查看的停止
+     */
+    void updateCapturedMonitors();
+
+    /**
+     * @brief 启动一个显示器的工作线程
+     */
+    void startPipeline(ScreenPipeline& pipeline);
+
+    /**
+     * @brief 停止一个显示器的工作线程
      */
-    void startWorkerThreads();
+    void stopPipeline(ScreenPipeline& pipeline);
 
     /**
      * @brief 清理断开的客户端
+     * @param worker 要清理的客户端处理器
      */
-    void cleanupDisconnectedClient();
+    void cleanupDisconnectedClient(ClientHandlerWorker* worker);
+
+    /**
+     * @brief 清理所有客户端（析构时调用）
+     */
+    void cleanupAllClients();
 
 private:
     ThreadManager* m_threadManager;     ///< 线程管理器
@@ -149,16 +192,16 @@ private:
     mutable QMutex m_stateMutex;        ///< 状态互斥锁
     bool m_isServerRunning;             ///< 服务器运行状态
     quint16 m_currentPort;              ///< 当前端口
-    bool m_captureStarted{ false };       ///< 屏幕捕获/数据处理是否已启动（避免重复启动）
 
-    // 屏幕捕获和数据处理组件
-    ScreenCapture* m_screenCapture;                                     ///< 屏幕捕获管理器
-    DataProcessingWorker* m_dataWorker;                                 ///< 数据处理工作线程
-    QueueManager* m_queueManager;                                       ///< 队列管理器
+    // 屏幕捕获和数据处理组件（只在本对象所在线程访问）
+    ScreenCapture* m_screenCapture;                                     ///< 主显示器的屏幕捕获管理器
+    QueueManager* m_queueManager;                                       ///< 主显示器的队列管理器
+    QList<ScreenPipeline> m_pipelines;                                  ///< 各显示器的流水线（第一个为主显示器）
 
-    // 客户端管理
-    ClientHandlerWorker* m_currentClient;   ///< 当前客户端处理器
-    QString m_currentClientThreadName;      ///< 当前客户端线程名称
+    // 客户端管理（多个会话共享同一条捕获/编码流水线）
+    IoThreadPool* m_ioThreadPool;                     ///< 会话共享的I/O线程池（首个连接时创建）
+    QHash<ClientHandlerWorker*, QThread*> m_clients;  ///< 客户端处理器 -> 所在I/O线程
+    QHash<ClientHandlerWorker*, QList<quint8>> m_clientViews; ///< 已认证会话 -> 查看中的显示器ID
     mutable QMutex m_clientMutex;           ///< 客户端互斥锁
 };
 
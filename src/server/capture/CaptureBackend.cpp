@@ -0,0 +1,43 @@
+#include "CaptureBackend.h"
+#include "XShmCaptureBackend.h"
+#include "../../common/core/logging/LoggingCategories.h"
+#include <QtGui/QGuiApplication>
+#include <QtGui/QPixmap>
+#include <QtGui/QScreen>
+
+std::unique_ptr<CaptureBackend> CaptureBackend::create(QScreen* screen) {
+#ifdef Q_OS_LINUX
+    // XShm 直接读取 X 服务器的根窗口，只有 Qt 本身运行在 xcb 上时坐标才与 QScreen 一致
+    if ( QGuiApplication::platformName() == QLatin1String("xcb") ) {
+        auto xshm = std::make_unique<XShmCaptureBackend>();
+        if ( xshm->open(screen) ) {
+            qCInfo(lcCaptureBackend) << "使用 XShm 捕获后端";
+            return xshm;
+        }
+        qCInfo(lcCaptureBackend) << "XShm 不可用，回退到 QScreen 捕获后端";
+    }
+#endif
+    auto backend = std::make_unique<QScreenCaptureBackend>();
+    backend->open(screen);
+    return backend;
+}
+
+bool QScreenCaptureBackend::open(QScreen* screen) {
+    m_screen = screen;
+    return m_screen != nullptr;
+}
+
+QImage QScreenCaptureBackend::grab(const QRect& rect) {
+    if ( !m_screen || rect.isEmpty() ) {
+        return QImage();
+    }
+    const QPixmap pixmap = m_screen->grabWindow(0, rect.x(), rect.y(), rect.width(), rect.height());
+    if ( pixmap.isNull() ) {
+        return QImage();
+    }
+    return pixmap.toImage();
+}
+
+void QScreenCaptureBackend::close() {
+    m_screen = nullptr;
+}
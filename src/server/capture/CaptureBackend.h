@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QtCore/QRect>
+#include <QtCore/QString>
+#include <QtGui/QImage>
+#include <QtGui/QRegion>
+#include <memory>
+
+class QScreen;
+
+/**
+ * @brief 屏幕抓取后端接口
+ *
+ * ScreenCaptureWorker 通过该接口抓取像素，平台相关的快速路径（如 Linux XShm）
+ * 与通用的 QScreen::grabWindow 路径可以互相替换。
+ * 后端只在创建它的捕获线程中使用，非线程安全；grab() 返回的 QImage 可以交给其他线程。
+ */
+class CaptureBackend {
+public:
+    virtual ~CaptureBackend() = default;
+
+    /**
+     * @brief 后端名称（用于日志和测试）
+     */
+    [[nodiscard]] virtual QString name() const = 0;
+
+    /**
+     * @brief 打开后端并绑定屏幕
+     * @return 是否可用；失败时调用方应改用其他后端
+     */
+    virtual bool open(QScreen* screen) = 0;
+
+    /**
+     * @brief 抓取一帧
+     * @param rect 抓取区域（全局逻辑坐标，与 QScreen::geometry() 相同）
+     * @return 抓取的图像（物理像素）；失败时返回空图像
+     */
+    virtual QImage grab(const QRect& rect) = 0;
+
+    /**
+     * @brief 取出自上次调用以来 rect 内变化的区域
+     *
+     * 能跟踪屏幕变化的后端（如 X Damage）返回 true，调用方可以在没有变化时跳过抓取。
+     * @param rect 抓取区域（全局逻辑坐标）
+     * @param changed [out] 变化区域（图像坐标，即相对 rect 左上角的物理像素）
+     * @return 后端是否跟踪变化；false 时 changed 无意义，调用方应视整帧为已变化
+     */
+    virtual bool takeDamage(const QRect& rect, QRegion& changed) {
+        Q_UNUSED(rect);
+        changed = QRegion();
+        return false;
+    }
+
+    /**
+     * @brief 查询窗口当前在屏幕上的区域
+     *
+     * 用于只共享一个窗口：调用方每帧查询一次，窗口移动或改变大小后抓取区域随之变化。
+     * 抓取的是屏幕上该区域的像素，遮挡在窗口上方的其他窗口也会被抓到。
+     * @param window 平台窗口 ID（X11 为 Window）
+     * @return 窗口内容区域（全局逻辑坐标）；后端不支持、窗口不存在或未映射时返回空
+     */
+    virtual QRect windowGeometry(quintptr window) {
+        Q_UNUSED(window);
+        return QRect();
+    }
+
+    /**
+     * @brief 释放后端资源；已返回的图像仍然有效
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief 为屏幕创建最快的可用后端
+     *
+     * Linux xcb 平台优先使用 XShm，不可用时（远程 X、offscreen 等）回退到 QScreen。
+     * @return 已打开的后端（从不为空）
+     */
+    [[nodiscard]] static std::unique_ptr<CaptureBackend> create(QScreen* screen);
+};
+
+/**
+ * @brief 基于 QScreen::grabWindow 的通用后端
+ *
+ * 每帧分配 QPixmap 并转换为 QImage，所有平台可用，作为回退路径。
+ */
+class QScreenCaptureBackend : public CaptureBackend {
+public:
+    [[nodiscard]] QString name() const override { return QStringLiteral("QScreen"); }
+    bool open(QScreen* screen) override;
+    QImage grab(const QRect& rect) override;
+    void close() override;
+
+private:
+    QScreen* m_screen = nullptr;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtCore/QRect>
+#include <QtCore/QString>
 #include <chrono>
 
 /**
@@ -11,10 +12,13 @@
  */
 struct CaptureConfig {
     int frameRate = 30;                    ///< 目标帧率
+    int idleFrameRate = 2;                 ///< 画面静止时逐步降到的最低帧率（不超过 frameRate）
     bool highDefinition = true;            ///< 高清模式
     bool antiAliasing = true;              ///< 抗锯齿
     bool highScaleQuality = true;          ///< 高质量缩放
-    QRect captureRect;                     ///< 捕获区域 (空表示全屏)
+    QRect captureRect;                     ///< 捕获区域（全局逻辑坐标，空表示全屏）
+    quintptr captureWindow = 0;            ///< 跟随的窗口（X11 窗口 ID，0 表示不跟随）；设置后优先于 captureRect
+    QString screenName;                    ///< 捕获的显示器（QScreen::name()，空表示主屏幕）；只在 initialize() 时生效
     int maxQueueSize = 10;                 ///< 最大队列大小
     
     /**
@@ -31,10 +35,13 @@ struct CaptureConfig {
      */
     void reset() {
         frameRate = 30;
+        idleFrameRate = 2;
         highDefinition = true;
         antiAliasing = true;
         highScaleQuality = true;
         captureRect = QRect();
+        captureWindow = 0;
+        screenName.clear();
         maxQueueSize = 10;
     }
     
@@ -45,10 +52,13 @@ struct CaptureConfig {
      */
     bool operator==(const CaptureConfig& other) const {
         return frameRate == other.frameRate &&
+               idleFrameRate == other.idleFrameRate &&
                highDefinition == other.highDefinition &&
                antiAliasing == other.antiAliasing &&
                highScaleQuality == other.highScaleQuality &&
                captureRect == other.captureRect &&
+               captureWindow == other.captureWindow &&
+               screenName == other.screenName &&
                maxQueueSize == other.maxQueueSize;
     }
     
@@ -70,6 +80,8 @@ struct CaptureConfig {
 struct CaptureStats {
     quint64 totalFramesCaptured = 0;       ///< 总捕获帧数
     quint64 droppedFrames = 0;             ///< 丢弃帧数
+    quint64 unchangedFrames = 0;           ///< 画面未变化而跳过的帧数
+    std::chrono::milliseconds currentFrameDelay{0}; ///< 当前帧间隔（画面静止时逐步加倍到空闲帧率的间隔）
     double currentFrameRate = 0.0;         ///< 当前帧率
     std::chrono::milliseconds avgCaptureTime{0}; ///< 平均捕获时间
     std::chrono::milliseconds maxCaptureTime{0}; ///< 最大捕获时间
@@ -83,6 +95,8 @@ struct CaptureStats {
     void reset() {
         totalFramesCaptured = 0;
         droppedFrames = 0;
+        unchangedFrames = 0;
+        currentFrameDelay = std::chrono::milliseconds{0};
         currentFrameRate = 0.0;
         avgCaptureTime = std::chrono::milliseconds{0};
         maxCaptureTime = std::chrono::milliseconds{0};
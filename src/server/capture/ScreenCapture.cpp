@@ -14,9 +14,10 @@
 #include <algorithm>
 
 
-ScreenCapture::ScreenCapture(QObject* parent)
+ScreenCapture::ScreenCapture(QObject* parent, QueueManager* queueManager)
     : QObject(parent)
     , m_threadManager(ThreadManager::instance())
+    , m_queueManager(queueManager ? queueManager : QueueManager::instance())
     , m_isCapturing(false)
     , m_statsTimer(new QTimer(this)) {
     qCDebug(lcScreenCaptureManager) << "ScreenCapture 多线程管理器构造函数调用";
@@ -29,10 +30,12 @@ ScreenCapture::ScreenCapture(QObject* parent)
     m_captureConfig.captureRect = QRect(); // 空矩形表示全屏
 
     // 确保队列管理器初始化（测试环境可能未主动初始化）
-    if ( QueueManager::instance() ) {
-        QueueManager::instance()->initialize(120, 120);
+    if ( m_queueManager ) {
+        m_queueManager->initialize(120, 120);
+        m_threadName = m_queueManager->threadName(QStringLiteral("ScreenCaptureWorker"));
     } else {
-        qCWarning(lcScreenCaptureManager) << "QueueManager::instance()返回空指针，队列功能不可用";
+        qCWarning(lcScreenCaptureManager) << "队列管理器为空，队列功能不可用";
+        m_threadName = QStringLiteral("ScreenCaptureWorker");
     }
 
     // 初始化性能统计
@@ -87,12 +90,12 @@ void ScreenCapture::startCapture() {
     configureWorkers();
 
     // 确保队列在开始捕获前处于运行状态
-    if ( QueueManager::instance() ) {
-        QueueManager::instance()->restartAllQueues();
+    if ( m_queueManager ) {
+        m_queueManager->restartAllQueues();
     }
 
     // 直接调用Worker开始捕获（通过ThreadManager确保在其线程执行）
-    const QString threadName = "ScreenCaptureWorker";
+    const QString threadName = m_threadName;
     if ( m_threadManager->hasThread(threadName) ) {
         bool startSuccess = m_threadManager->startThread(threadName);
         if ( startSuccess ) {
@@ -131,7 +134,7 @@ void ScreenCapture::startCapture() {
 
 void ScreenCapture::stopCapture() {
     const bool wasCapturing = m_isCapturing.exchange(false);
-    const QString threadName = QStringLiteral("ScreenCaptureWorker");
+    const QString threadName = m_threadName;
     const bool threadExists = m_threadManager && m_threadManager->hasThread(threadName);
 
     // 若既未在捕获，线程也不存在，则无事可做
@@ -147,8 +150,8 @@ void ScreenCapture::stopCapture() {
     m_statsTimer->stop();
 
     // 优先停止队列以唤醒可能阻塞的生产者，确保后续线程停止不会卡住
-    if ( QueueManager::instance() ) {
-        QueueManager::instance()->stopAllQueues();
+    if ( m_queueManager ) {
+        m_queueManager->stopAllQueues();
     }
 
     // 通知Worker停止捕获
@@ -195,7 +198,7 @@ bool ScreenCapture::initializeThreads() {
     // 移除：不再创建线程安全队列
 
     // 通过ThreadManager创建Worker实例
-    const QString threadName = "ScreenCaptureWorker";
+    const QString threadName = m_threadName;
     if ( m_threadManager->hasThread(threadName) ) {
         qCWarning(lcScreenCaptureManager) << "ScreenCaptureWorker线程已存在，先停止并销毁旧线程";
         bool stopped = m_threadManager->stopThread(threadName, true);
@@ -212,7 +215,7 @@ bool ScreenCapture::initializeThreads() {
     // 由ThreadManager创建并持有Worker对象（构造函数已无队列参数）
     bool success = m_threadManager->createThread(
         threadName,
-        std::unique_ptr<Worker>(new ScreenCaptureWorker(QueueManager::instance())),
+        std::unique_ptr<Worker>(new ScreenCaptureWorker(m_queueManager)),
         false,  // 不自动启动
         true,   // 自动重启
         3       // 最大重启次数
@@ -241,7 +244,7 @@ bool ScreenCapture::initializeThreads() {
 void ScreenCapture::cleanupThreads() {
     qCInfo(lcScreenCaptureManager) << "使用ThreadManager清理ScreenCaptureWorker线程";
 
-    const QString threadName = "ScreenCaptureWorker";
+    const QString threadName = m_threadName;
     if ( m_threadManager && m_threadManager->hasThread(threadName) ) {
         bool destroySuccess = m_threadManager->destroyThread(threadName);
         if ( destroySuccess ) {
@@ -259,7 +262,7 @@ void ScreenCapture::cleanupThreads() {
 
 void ScreenCapture::onThreadStarted(const QString& name) {
     qCInfo(lcScreenCaptureManager) << "线程启动: " << name;
-    if ( name == "ScreenCaptureWorker" ) {
+    if ( name == m_threadName ) {
         Worker* worker = m_threadManager ? m_threadManager->getWorker(name) : nullptr;
         ScreenCaptureWorker* captureWorker = worker ? qobject_cast<ScreenCaptureWorker*>(worker) : nullptr;
         if ( captureWorker ) {
@@ -272,7 +275,7 @@ void ScreenCapture::onThreadStarted(const QString& name) {
 
 void ScreenCapture::onThreadStopped(const QString& name) {
     qCInfo(lcScreenCaptureManager) << "线程停止: " << name;
-    if ( name == "ScreenCaptureWorker" ) {
+    if ( name == m_threadName ) {
         if ( m_isCapturing.load() ) {
             m_isCapturing.store(false);
             qCWarning(lcScreenCaptureManager) << "ScreenCaptureWorker线程意外停止，捕获状态已重置";
@@ -288,7 +291,7 @@ void ScreenCapture::onThreadError(const QString& name, const QString& error) {
     qCCritical(lcScreenCaptureManager) << "线程错误 [" << name << "]: " << error;
 
     // 如果是ScreenCaptureWorker线程出错，尝试重启
-    if ( name == "ScreenCaptureWorker" ) {
+    if ( name == m_threadName ) {
         qCWarning(lcScreenCaptureManager) << "ScreenCaptureWorker线程出错，尝试重启线程";
 
         // 停止当前捕获
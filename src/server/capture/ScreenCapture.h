@@ -13,6 +13,7 @@
 // 前向声明
 class ScreenCaptureWorker;
 class ThreadManager;
+class QueueManager;
 class QTimer;
 
 /**
@@ -21,13 +22,20 @@ class QTimer;
  * 重构后的ScreenCapture类作为多线程架构的协调器，
  * 管理ScreenCaptureWorker工作线程，
  * 通过Qt信号/槽直接传递帧，降低耦合、减少阻塞点。
+ *
+ * 捕获的帧写入所属流水线的 QueueManager；每条流水线各有一个 ScreenCapture，
+ * 工作线程名由 QueueManager::threadName() 区分。
  */
 class ScreenCapture : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit ScreenCapture(QObject *parent = nullptr);
+    /**
+     * @param parent 父对象
+     * @param queueManager 所属流水线的队列管理器，为空时使用 QueueManager::instance()
+     */
+    explicit ScreenCapture(QObject *parent = nullptr, QueueManager* queueManager = nullptr);
     ~ScreenCapture();
 
     // 捕获控制方法
@@ -124,6 +132,8 @@ private:
 private:
     // 成员变量
     ThreadManager* m_threadManager;                                    ///< 线程管理器
+    QueueManager* m_queueManager;                                      ///< 所属流水线（不拥有）
+    QString m_threadName;                                              ///< 捕获工作线程名
     QPointer<ScreenCaptureWorker> m_captureWorker;                     ///< 非拥有指针，由ThreadManager管理生命周期
     
     // 状态控制
@@ -12,6 +12,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QDateTime>
 #include <QtCore/QMetaObject>
+#include <QtCore/QHashFunctions>
 #include <algorithm>
 #include <chrono>
 #include <cmath>
@@ -21,7 +22,7 @@
 ScreenCaptureWorker::ScreenCaptureWorker(QueueManager* queueManager, QObject* parent)
     : Worker(parent)
     , m_queueManager(queueManager)
-    , m_primaryScreen(nullptr) {
+    , m_screen(nullptr) {
     qCDebug(lcScreenCaptureWorker) << "ScreenCaptureWorker构造函数: 初始化基础配置";
 
     // 初始化配置
@@ -48,20 +49,43 @@ ScreenCaptureWorker::~ScreenCaptureWorker() {
 bool ScreenCaptureWorker::initialize() {
     qCInfo(lcScreenCaptureWorker) << "初始化 ScreenCaptureWorker";
 
-    // 检查并缓存主屏幕
+    // 检查并缓存要捕获的屏幕：按名称查找，未指定或找不到时使用主屏幕
     QGuiApplication* app = qobject_cast<QGuiApplication*>(QCoreApplication::instance());
     if ( !app ) {
         qCWarning(lcScreenCaptureWorker) << "未检测到QGuiApplication实例，某些功能可能受限";
     }
-    m_primaryScreen = app ? app->primaryScreen() : nullptr;
-    if ( m_primaryScreen ) {
-        m_screenGeometry = m_primaryScreen->geometry();
+    QString screenName;
+    {
+        QMutexLocker locker(&m_configMutex);
+        screenName = m_config.screenName;
+    }
+    m_screen = nullptr;
+    if ( app && !screenName.isEmpty() ) {
+        const QList<QScreen*> screens = app->screens();
+        auto it = std::find_if(screens.cbegin(), screens.cend(),
+            [&](const QScreen* screen) { return screen->name() == screenName; });
+        if ( it != screens.cend() ) {
+            m_screen = *it;
+        } else {
+            qCWarning(lcScreenCaptureWorker) << "未找到显示器" << screenName << "，改用主屏幕";
+        }
     }
-    qCDebug(lcScreenCaptureWorker) << "Primary Screen geometry:" << m_screenGeometry.x()
+    if ( !m_screen && app ) {
+        m_screen = app->primaryScreen();
+    }
+    if ( m_screen ) {
+        m_screenGeometry = m_screen->geometry();
+    }
+    qCDebug(lcScreenCaptureWorker) << "Screen" << (m_screen ? m_screen->name() : QString()) << "geometry:" << m_screenGeometry.x()
         << "," << m_screenGeometry.y() << m_screenGeometry.width() << "x" << m_screenGeometry.height();
     if ( m_config.captureRect.isEmpty() ) {
         m_config.captureRect = m_screenGeometry;
     }
+    // 抓取后端持有平台连接（如 X11 Display），必须在执行捕获的线程中创建
+    if ( m_screen && !m_backend ) {
+        m_backend = CaptureBackend::create(m_screen);
+        qCInfo(lcScreenCaptureWorker) << "捕获后端:" << m_backend->name();
+    }
     {
         QMutexLocker locker(&m_statsMutex);
         m_stats = CaptureStats();
@@ -107,6 +131,14 @@ void ScreenCaptureWorker::cleanup() {
         QObject::disconnect(m_captureTimer, &QTimer::timeout, this, &ScreenCaptureWorker::performCapture);
     }
     m_isCapturing.store(false);
+    if ( m_backend ) {
+        m_backend->close();
+        m_backend.reset();
+    }
+    m_hasCapturedFrame = false;
+    m_lastCaptureRect = QRect();
+    m_captureRectLost = false;
+    m_sampleSize = QSize();
     {
         QMutexLocker locker(&m_statsMutex);
         m_captureTimeHistory.clear();
@@ -198,6 +230,9 @@ void ScreenCaptureWorker::processTask() {
                 QThread::msleep(1);
                 setDidWork(false);
             }
+            // 对外报告当前帧间隔（静止降频、输入或整帧请求恢复）
+            QMutexLocker locker(&m_statsMutex);
+            m_stats.currentFrameDelay = m_currentDelay;
         } else {
             // 未处于捕获状态时，轻量休眠避免空转
             QThread::msleep(2);
@@ -235,8 +270,41 @@ void ScreenCaptureWorker::performCapture() {
         return;
     }
     auto captureStartTime = std::chrono::steady_clock::now();
+
+    // 抓取区域每帧解析一次：跟随的窗口移动或改变大小时直接换用新区域，不重启流水线
+    const QRect captureRect = resolveCaptureRect();
+    if ( captureRect.isEmpty() ) {
+        // 跟随的窗口已关闭或最小化：不发布帧（不回退到全屏），按空闲帧率继续查询
+        if ( !m_captureRectLost ) {
+            qCWarning(lcScreenCaptureWorker) << "抓取区域不可见，暂停发布帧";
+            m_captureRectLost = true;
+        }
+        m_currentDelay = m_idleDelay;
+        m_lastCaptureTime = captureStartTime;
+        return;
+    }
+    if ( captureRect != m_lastCaptureRect ) {
+        qCDebug(lcScreenCaptureWorker) << "抓取区域变化:" << m_lastCaptureRect << "->" << captureRect;
+        // 区域移动后旧画面与变化区域都不再对应，发布一帧完整画面
+        m_lastCaptureRect = captureRect;
+        m_fullFrameRequested = true;
+        m_currentDelay = m_frameDelay;
+    }
+    m_captureRectLost = false;
+
+    // 首帧和读者请求的整帧无论画面是否变化都要发布
+    const bool forceFrame = !m_hasCapturedFrame || m_fullFrameRequested;
+
+    // 后端能跟踪屏幕变化时，画面未变化就不抓取也不入队
+    QRegion damage;
+    const bool damageTracked = m_backend && m_backend->takeDamage(captureRect, damage);
+    if ( damageTracked && damage.isEmpty() && !forceFrame ) {
+        skipUnchangedFrame(captureStartTime);
+        return;
+    }
+
     try {
-        QImage capturedImage = captureScreen();
+        QImage capturedImage = captureScreenRegion(captureRect);
         // 捕获后立刻检查停止请求，防止后续处理占用时间
         if ( shouldStop() ) {
             return;
@@ -246,6 +314,24 @@ void ScreenCaptureWorker::performCapture() {
             return;
         }
 
+        // 不能跟踪变化的后端：抽样比较像素。抽样可能漏掉很小的变化，画面静止时仍每隔 IDLE_REFRESH_INTERVAL 发布一帧
+        const bool unchanged = !damageTracked && isSampledUnchanged(capturedImage);
+        if ( unchanged && !forceFrame
+            && captureStartTime - m_lastFrameTime < std::chrono::milliseconds(IDLE_REFRESH_INTERVAL) ) {
+            skipUnchangedFrame(captureStartTime);
+            return;
+        }
+        if ( !damageTracked ) {
+            rememberPublishedFrame(capturedImage);
+        }
+        // 画面有变化时立即恢复全帧率；静止画面的强制帧和刷新帧不影响降频
+        if ( damageTracked ? !damage.isEmpty() : !unchanged ) {
+            m_currentDelay = m_frameDelay;
+        }
+        m_hasCapturedFrame = true;
+        m_fullFrameRequested = false;
+        m_lastFrameTime = captureStartTime;
+
         // 记录捕获耗时
         auto captureEndTime = std::chrono::steady_clock::now();
         auto captureTime = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -269,6 +355,7 @@ void ScreenCaptureWorker::performCapture() {
             frame.timestamp = QDateTime::fromMSecsSinceEpoch(timestamp);
             frame.frameId = m_stats.totalFramesCaptured;
             frame.originalSize = capturedImage.size();
+            frame.sourceRect = captureRect;
 
             // 使用 QueueManager 统一接口入队
             bool enqueued = m_queueManager->enqueueCapturedFrame(frame);
@@ -291,43 +378,36 @@ void ScreenCaptureWorker::performCapture() {
     m_lastCaptureTime = std::chrono::steady_clock::now();
 }
 
-QImage ScreenCaptureWorker::captureScreen() {
+QImage ScreenCaptureWorker::captureScreenRegion(const QRect& region) {
     // 在屏幕抓取前检查停止请求，若已请求停止则立即返回空图像
     if ( shouldStop() ) {
         return QImage();
     }
 
-    if ( !m_primaryScreen ) {
-        qCWarning(lcScreenCaptureWorker) << "主屏幕指针为空";
+    if ( !m_screen || !m_backend ) {
+        qCWarning(lcScreenCaptureWorker) << "屏幕指针或捕获后端为空";
         return QImage();
     }
 
-    // 使用完整的屏幕区域，不使用配置的捕获区域
-    QRect captureRect = m_screenGeometry;
+    // 只抓取屏幕内的部分
+    QRect captureRect = region.intersected(m_screenGeometry);
     if ( captureRect.isEmpty() ) {
-        qCWarning(lcScreenCaptureWorker) << "屏幕区域无效";
+        qCWarning(lcScreenCaptureWorker) << "屏幕区域无效:" << region;
         return QImage();
     }
 
-    // 在调用潜在耗时的 grabWindow 前再次检查停止请求
+    // 在调用潜在耗时的屏幕抓取前再次检查停止请求
     if ( shouldStop() ) {
         return QImage();
     }
 
-    // 直接在当前线程执行屏幕抓取
-    QPixmap pixmap = m_primaryScreen->grabWindow(0,
-        captureRect.x(),
-        captureRect.y(),
-        captureRect.width(),
-        captureRect.height());
-
-    if ( pixmap.isNull() ) {
+    // 直接在当前线程执行屏幕抓取（XShm 后端返回缓冲池中的图像，稳态下不分配内存）
+    QImage image = m_backend->grab(captureRect);
+    if ( image.isNull() ) {
         qCWarning(lcScreenCaptureWorker) << "屏幕捕获失败";
         return QImage();
     }
 
-    QImage image = pixmap.toImage();
-
     // 优化：适度缩小图像以减少数据传输量，同时保持视觉清晰度
     // 缩放比例：75% 可减少约 44% 的数据量，同时保持良好的视觉效果
     // 使用 SmoothTransformation 保证缩放质量
@@ -348,46 +428,97 @@ QImage ScreenCaptureWorker::captureScreen() {
     return image;
 }
 
-QImage ScreenCaptureWorker::captureScreenRegion(const QRect& /*region*/) {
-    if ( !m_primaryScreen ) {
-        return QImage();
+QRect ScreenCaptureWorker::resolveCaptureRect() {
+    QRect configuredRect;
+    quintptr window = 0;
+    {
+        QMutexLocker locker(&m_configMutex);
+        configuredRect = m_config.captureRect;
+        window = m_config.captureWindow;
     }
-
-    // 使用完整的屏幕区域，忽略传入的区域参数
-    QRect captureRect = m_screenGeometry;
-    if ( captureRect.isEmpty() ) {
-        return QImage();
+    if ( window != 0 ) {
+        // 跟随窗口：每次查询当前位置；后端不支持或窗口不可见时返回空
+        return m_backend ? m_backend->windowGeometry(window).intersected(m_screenGeometry) : QRect();
     }
-
-    // 直接在当前线程执行屏幕抓取
-    QPixmap pixmap = m_primaryScreen->grabWindow(0,
-        captureRect.x(),
-        captureRect.y(),
-        captureRect.width(),
-        captureRect.height());
-
-    if ( pixmap.isNull() ) {
-        return QImage();
+    if ( configuredRect.isEmpty() ) {
+        return m_screenGeometry;
     }
-
-    return pixmap.toImage();
+    return configuredRect.intersected(m_screenGeometry);
 }
 
 void ScreenCaptureWorker::calculateFrameDelay() {
     int fps;
+    int idleFps;
     {
         QMutexLocker locker(&m_configMutex);
         fps = m_config.frameRate;
+        idleFps = m_config.idleFrameRate;
     }
     fps = std::clamp(fps, MIN_FRAME_RATE, MAX_FRAME_RATE);
+    idleFps = std::clamp(idleFps, MIN_FRAME_RATE, fps);
     m_frameDelay = std::chrono::milliseconds(1000 / fps);
-    qCDebug(lcScreenCaptureWorker) << "计算帧延迟: " << fps << " fps -> " << m_frameDelay.count() << " ms";
+    m_idleDelay = std::chrono::milliseconds(1000 / idleFps);
+    m_currentDelay = m_frameDelay;
+    qCDebug(lcScreenCaptureWorker) << "计算帧延迟: " << fps << " fps -> " << m_frameDelay.count() << " ms"
+        << "，空闲:" << idleFps << "fps";
 }
 
 bool ScreenCaptureWorker::shouldCaptureFrame() {
+    pollWakeRequests();
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastCaptureTime);
-    return elapsed >= m_frameDelay;
+    return elapsed >= m_currentDelay;
+}
+
+void ScreenCaptureWorker::pollWakeRequests() {
+    if ( !m_queueManager ) {
+        return;
+    }
+    // 新读者需要一帧完整画面；客户端输入预示画面即将变化。两者都立即恢复全帧率
+    if ( m_queueManager->takeFullFrameRequest() ) {
+        m_fullFrameRequested = true;
+        m_currentDelay = m_frameDelay;
+    }
+    if ( m_queueManager->takeInputActivity() ) {
+        m_currentDelay = m_frameDelay;
+    }
+}
+
+void ScreenCaptureWorker::skipUnchangedFrame(std::chrono::steady_clock::time_point now) {
+    {
+        QMutexLocker locker(&m_statsMutex);
+        m_stats.unchangedFrames++;
+    }
+    // 连续静止时帧间隔逐步加倍，直到空闲帧率
+    m_currentDelay = std::min(m_currentDelay * 2, m_idleDelay);
+    m_lastCaptureTime = now;
+}
+
+size_t ScreenCaptureWorker::hashSampledRows(const QImage& image, int phase) {
+    const size_t rowBytes = static_cast<size_t>(image.width()) * static_cast<size_t>(image.depth()) / 8;
+    size_t hash = 0;
+    for ( int y = phase; y < image.height(); y += SAMPLE_PHASES ) {
+        hash = qHashBits(image.constScanLine(y), rowBytes, hash);
+    }
+    return hash;
+}
+
+bool ScreenCaptureWorker::isSampledUnchanged(const QImage& image) {
+    if ( image.size() != m_sampleSize ) {
+        return false;
+    }
+    // 每次只比较 1/SAMPLE_PHASES 的行，相位轮转：只落在部分行内的变化最多 SAMPLE_PHASES 次检查后被发现
+    const int phase = m_samplePhase;
+    m_samplePhase = (m_samplePhase + 1) % SAMPLE_PHASES;
+    return hashSampledRows(image, phase) == m_sampleHashes[static_cast<size_t>(phase)];
+}
+
+void ScreenCaptureWorker::rememberPublishedFrame(const QImage& image) {
+    // 发布的帧计算全部相位（相对编码开销很小），之后的抽样都与最近发布的画面比较
+    m_sampleSize = image.size();
+    for ( int phase = 0; phase < SAMPLE_PHASES; ++phase ) {
+        m_sampleHashes[static_cast<size_t>(phase)] = hashSampledRows(image, phase);
+    }
 }
 
 void ScreenCaptureWorker::recordCaptureTime(std::chrono::milliseconds time) {
@@ -469,6 +600,9 @@ void ScreenCaptureWorker::updateConfig(const CaptureConfig& config) {
         // 边界裁剪：帧率
         if ( normalized.frameRate < MIN_FRAME_RATE ) normalized.frameRate = MIN_FRAME_RATE;
         if ( normalized.frameRate > MAX_FRAME_RATE ) normalized.frameRate = MAX_FRAME_RATE;
+        // 空闲帧率不超过正常帧率
+        if ( normalized.idleFrameRate < MIN_FRAME_RATE ) normalized.idleFrameRate = MIN_FRAME_RATE;
+        if ( normalized.idleFrameRate > normalized.frameRate ) normalized.idleFrameRate = normalized.frameRate;
         QMutexLocker locker(&m_configMutex);
         m_config = normalized;
     }
@@ -6,6 +6,7 @@
 #include "../dataflow/QueueManager.h"
 #include "../dataprocessing/DataProcessing.h"
 #include "CaptureConfig.h"
+#include "CaptureBackend.h"
 #include <QtGui/QImage>
 #include <QtGui/QScreen>
 #include <QtCore/QTimer>
@@ -13,6 +14,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QBuffer>
 #include <memory>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <deque>
@@ -108,12 +110,19 @@ private slots:
 
 private:
     // 核心捕获方法
-    QImage captureScreen();
     QImage captureScreenRegion(const QRect& region);
+    QRect resolveCaptureRect();
 
     // 帧率和时序控制
     void calculateFrameDelay();
     bool shouldCaptureFrame();
+    void pollWakeRequests();
+    void skipUnchangedFrame(std::chrono::steady_clock::time_point now);
+
+    // 静止画面检测（后端不能跟踪变化时使用）
+    static size_t hashSampledRows(const QImage& image, int phase);
+    bool isSampledUnchanged(const QImage& image);
+    void rememberPublishedFrame(const QImage& image);
 
     // 性能监控方法
     void recordCaptureTime(std::chrono::milliseconds time);
@@ -141,6 +150,17 @@ private:
     QTimer* m_captureTimer{ nullptr };                    ///< 捕获定时器（仅在未启动Worker线程或测试环境下使用）
     std::chrono::steady_clock::time_point m_lastCaptureTime; ///< 上次捕获时间
     std::chrono::milliseconds m_frameDelay{ 33 }; ///< 帧间延迟
+    std::chrono::milliseconds m_idleDelay{ 500 }; ///< 空闲帧间延迟（降频上限）
+    std::chrono::milliseconds m_currentDelay{ 33 }; ///< 当前帧间延迟：画面静止时从 m_frameDelay 逐步加倍到 m_idleDelay
+    std::chrono::steady_clock::time_point m_lastFrameTime; ///< 上次发布帧的时间
+    bool m_hasCapturedFrame{ false };                      ///< 当前后端是否已发布过完整帧
+    bool m_fullFrameRequested{ false };                    ///< 有读者等待整帧
+
+    // 静止画面检测
+    static constexpr int SAMPLE_PHASES = 4;                ///< 抽样比较的相位数（每次比较 1/4 的行）
+    std::array<size_t, SAMPLE_PHASES> m_sampleHashes{};   ///< 最近发布帧各相位抽样行的哈希
+    QSize m_sampleSize;                                    ///< 最近发布帧的尺寸（为空表示没有可比较的帧）
+    int m_samplePhase{ 0 };                                ///< 下次比较的相位
 
     // 性能统计
     mutable QMutex m_statsMutex;
@@ -150,8 +170,11 @@ private:
     std::deque<qint64> m_frameTimestamps;      ///< 帧时间戳历史
 
     // 屏幕相关
-    QScreen* m_primaryScreen;                  ///< 主屏幕指针
+    QScreen* m_screen;                         ///< 捕获的屏幕（CaptureConfig::screenName，默认主屏幕）
     QRect m_screenGeometry;                    ///< 屏幕几何信息
+    QRect m_lastCaptureRect;                   ///< 上一帧的抓取区域（全局逻辑坐标）
+    bool m_captureRectLost{ false };           ///< 抓取区域当前不可见（跟随的窗口已关闭或最小化）
+    std::unique_ptr<CaptureBackend> m_backend; ///< 抓取后端（在工作线程中创建）
 
     // 错误处理
     std::atomic<int> m_errorCount{ 0 };
@@ -163,6 +186,7 @@ private:
     static constexpr int MAX_CAPTURE_TIME_HISTORY = 100;   ///< 最大捕获时间历史记录数
     static constexpr int MAX_FRAME_TIMESTAMP_HISTORY = 60; ///< 最大帧时间戳历史记录数
     static constexpr int MAX_ERROR_COUNT = 10;             ///< 最大错误计数
+    static constexpr int IDLE_REFRESH_INTERVAL = 1000;     ///< 抽样比较判定静止时的最长发布间隔(ms)
     static constexpr int MIN_FRAME_RATE = 1;              ///< 最小帧率
     static constexpr int MAX_FRAME_RATE = 120;            ///< 最大帧率
 };
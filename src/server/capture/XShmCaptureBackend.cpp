@@ -0,0 +1,472 @@
+#include "XShmCaptureBackend.h"
+
+#ifdef Q_OS_LINUX
+
+#include "../../common/core/logging/LoggingCategories.h"
+#include "../../common/core/memory/FrameBufferPool.h"
+#include <QtCore/QSysInfo>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtGui/QScreen>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
+
+namespace {
+
+// Xlib 错误处理器是进程级的：同一时刻只允许一个陷阱安装，其他线程的陷阱等待（临界区只有一次往返）
+QMutex s_trapMutex;
+std::atomic<Display*> s_trapDisplay{ nullptr };
+std::atomic<unsigned long> s_trapFirstSerial{ 0 };
+std::atomic<bool> s_trapFailed{ false };
+std::atomic<XErrorHandler> s_previousHandler{ nullptr };
+
+int trapXError(Display* display, XErrorEvent* event) {
+    // 只吞掉陷阱所属连接在陷阱期间发出的请求的错误；
+    // 其他连接（其他屏幕的后端、输入模拟器）的错误照常交给原处理器
+    if ( display == s_trapDisplay.load() && event->serial >= s_trapFirstSerial.load() ) {
+        s_trapFailed.store(true);
+        return 0;
+    }
+    const XErrorHandler previous = s_previousHandler.load();
+    return previous ? previous(display, event) : 0;
+}
+
+/**
+ * @brief 临时拦截某个 X 连接的错误
+ *
+ * Xlib 默认错误处理器会直接退出进程；附加共享内存或根窗口尺寸变化时的抓取失败
+ * 应当只让本次调用失败。错误按 Display 与请求序号匹配，多个捕获线程同时使用时互不误判。
+ * 异步请求需在 failed() 前调用 XSync。
+ */
+class XErrorTrap {
+public:
+    explicit XErrorTrap(Display* display)
+        : m_locker(&s_trapMutex) {
+        s_trapFailed.store(false);
+        s_trapFirstSerial.store(NextRequest(display));
+        s_trapDisplay.store(display);
+        s_previousHandler.store(XSetErrorHandler(trapXError));
+    }
+    ~XErrorTrap() {
+        XSetErrorHandler(s_previousHandler.load());
+        s_trapDisplay.store(nullptr);
+    }
+    XErrorTrap(const XErrorTrap&) = delete;
+    XErrorTrap& operator=(const XErrorTrap&) = delete;
+
+    [[nodiscard]] bool failed() const { return s_trapFailed.load(); }
+
+private:
+    QMutexLocker<QMutex> m_locker;
+};
+
+} // namespace
+
+struct XShmCaptureBackend::Segment {
+    XShmSegmentInfo info{};
+    qsizetype capacity = 0;
+    QRegion stale;                       ///< 自上次填充以来变化的区域（根窗口坐标）
+
+    ~Segment() {
+        if ( info.shmaddr ) {
+            shmdt(info.shmaddr);
+        }
+    }
+};
+
+struct XShmCaptureBackend::Private {
+    Display* display = nullptr;
+    Window root = 0;
+    Visual* visual = nullptr;
+    int depth = 0;
+    QSize rootSize;
+    QRect area;                          ///< 段覆盖的根窗口区域（绑定屏幕的物理像素范围）
+    int bytesPerLine = 0;                ///< 段内行跨度（按 area 宽度）
+    QRect screenGeometry;                ///< 绑定屏幕的逻辑几何
+    qreal devicePixelRatio = 1.0;
+    std::unique_ptr<Segment> segment;     ///< 屏幕内容的常驻副本（只在 grab() 内使用）
+
+    Damage damage = 0;                   ///< 根窗口的损坏跟踪对象（0 表示服务器不支持）
+    XserverRegion damageParts = 0;       ///< 取出损坏区域用的服务器端区域
+    int damageEventBase = 0;
+    QRegion pendingDamage;               ///< 尚未交给 takeDamage() 调用方的变化（根窗口坐标）
+
+    [[nodiscard]] QRect rootRect() const { return QRect(QPoint(0, 0), rootSize); }
+    [[nodiscard]] qsizetype frameBytes() const { return qsizetype(bytesPerLine) * area.height(); }
+};
+
+XShmCaptureBackend::XShmCaptureBackend()
+    : d(std::make_unique<Private>()) {
+}
+
+XShmCaptureBackend::~XShmCaptureBackend() {
+    close();
+}
+
+bool XShmCaptureBackend::open(QScreen* screen) {
+    close();
+    if ( !screen ) {
+        return false;
+    }
+    d->screenGeometry = screen->geometry();
+    d->devicePixelRatio = screen->devicePixelRatio();
+
+    d->display = XOpenDisplay(nullptr);
+    if ( !d->display ) {
+        qCDebug(lcCaptureBackend) << "XShm: 无法连接 X 服务器";
+        return false;
+    }
+    if ( !XShmQueryExtension(d->display) ) {
+        qCDebug(lcCaptureBackend) << "XShm: X 服务器不支持 MIT-SHM 扩展";
+        close();
+        return false;
+    }
+
+    const int screenNumber = DefaultScreen(d->display);
+    d->root = RootWindow(d->display, screenNumber);
+    d->visual = DefaultVisual(d->display, screenNumber);
+    d->depth = DefaultDepth(d->display, screenNumber);
+    d->rootSize = QSize(DisplayWidth(d->display, screenNumber), DisplayHeight(d->display, screenNumber));
+    // 段只覆盖绑定的屏幕：多个显示器各用一个后端时不会重复读取彼此的像素
+    d->area = toPhysical(d->screenGeometry).intersected(d->rootRect());
+    d->bytesPerLine = d->area.width() * 4;
+    if ( d->area.isEmpty() ) {
+        qCDebug(lcCaptureBackend) << "XShm: 屏幕不在根窗口内" << d->screenGeometry;
+        close();
+        return false;
+    }
+
+    // 只接受可以直接按 Format_RGB32 解释的像素布局
+    int bitsPerPixel = 0;
+    int formatCount = 0;
+    if ( XPixmapFormatValues* formats = XListPixmapFormats(d->display, &formatCount) ) {
+        for ( int i = 0; i < formatCount; ++i ) {
+            if ( formats[i].depth == d->depth ) {
+                bitsPerPixel = formats[i].bits_per_pixel;
+            }
+        }
+        XFree(formats);
+    }
+    const int hostByteOrder = QSysInfo::ByteOrder == QSysInfo::LittleEndian ? LSBFirst : MSBFirst;
+    if ( d->depth != 24 || bitsPerPixel != 32
+        || d->visual->red_mask != 0xff0000 || d->visual->green_mask != 0x00ff00 || d->visual->blue_mask != 0x0000ff
+        || ImageByteOrder(d->display) != hostByteOrder ) {
+        qCDebug(lcCaptureBackend) << "XShm: 不支持的像素格式，深度" << d->depth << "位宽" << bitsPerPixel;
+        close();
+        return false;
+    }
+
+    // 预先创建整屏段：远程 X 服务器等无法共享内存的情况在这里失败
+    d->segment = createSegment(d->frameBytes());
+    if ( !d->segment ) {
+        qCDebug(lcCaptureBackend) << "XShm: 无法附加共享内存段";
+        close();
+        return false;
+    }
+
+    // Damage 可选：不支持时每次抓取都整块重读
+    int damageErrorBase = 0;
+    int fixesEventBase = 0;
+    int fixesErrorBase = 0;
+    int major = 0;
+    int minor = 0;
+    if ( XDamageQueryExtension(d->display, &d->damageEventBase, &damageErrorBase)
+        && XDamageQueryVersion(d->display, &major, &minor)
+        && XFixesQueryExtension(d->display, &fixesEventBase, &fixesErrorBase)
+        && XFixesQueryVersion(d->display, &major, &minor) && major >= 2 ) {
+        d->damage = XDamageCreate(d->display, d->root, XDamageReportNonEmpty);
+        d->damageParts = XFixesCreateRegion(d->display, nullptr, 0);
+    } else {
+        qCDebug(lcCaptureBackend) << "XShm: X 服务器不支持 Damage 扩展，不跟踪屏幕变化";
+    }
+
+    qCInfo(lcCaptureBackend) << "XShm 后端已打开，根窗口" << d->rootSize << "屏幕" << d->screenGeometry << "区域" << d->area
+        << "缩放" << d->devicePixelRatio << "跟踪变化" << hasDamageTracking();
+    return true;
+}
+
+QImage XShmCaptureBackend::grab(const QRect& rect) {
+    if ( !d->display || rect.isEmpty() ) {
+        return QImage();
+    }
+    collectDamage();
+    const QRect physical = toPhysical(rect).intersected(d->area);
+    if ( physical.isEmpty() ) {
+        return QImage();
+    }
+
+    if ( !ensureSegment() ) {
+        qCWarning(lcCaptureBackend) << "XShm: 无法重建共享内存段，区域" << physical;
+        return QImage();
+    }
+
+    // 只重读段上次填充后变化过的部分；不跟踪变化时无法判断，整块重读
+    const QRegion region = d->damage ? d->segment->stale.intersected(physical) : QRegion(physical);
+    if ( !fillSegment(*d->segment, region) ) {
+        qCWarning(lcCaptureBackend) << "XShm: 抓取失败，区域" << physical;
+        refreshRootSize();
+        return QImage();
+    }
+    d->segment->stale -= physical;
+    return copyFromSegment(physical);
+}
+
+bool XShmCaptureBackend::takeDamage(const QRect& rect, QRegion& changed) {
+    changed = QRegion();
+    if ( !d->display || !d->damage ) {
+        return false;
+    }
+    collectDamage();
+    const QRect physical = toPhysical(rect).intersected(d->area);
+    changed = d->pendingDamage.intersected(physical).translated(-physical.topLeft());
+    d->pendingDamage = QRegion();
+    return true;
+}
+
+QRect XShmCaptureBackend::windowGeometry(quintptr window) {
+    if ( !d->display || window == 0 ) {
+        return QRect();
+    }
+    XWindowAttributes attributes{};
+    int x = 0;
+    int y = 0;
+    Window child = 0;
+    bool ok = false;
+    {
+        // 窗口可能已经销毁（BadWindow），两个请求都等待回复，错误在返回前已经送达
+        XErrorTrap trap(d->display);
+        ok = XGetWindowAttributes(d->display, static_cast<Window>(window), &attributes)
+            && XTranslateCoordinates(d->display, static_cast<Window>(window), d->root, 0, 0, &x, &y, &child)
+            && !trap.failed();
+    }
+    if ( !ok || attributes.map_state != IsViewable ) {
+        return QRect();
+    }
+    const QRect physical = QRect(x, y, attributes.width, attributes.height).intersected(d->rootRect());
+    return physical.isEmpty() ? QRect() : toLogical(physical);
+}
+
+void XShmCaptureBackend::close() {
+    if ( !d->display ) {
+        return;
+    }
+    if ( d->damageParts ) {
+        XFixesDestroyRegion(d->display, d->damageParts);
+        d->damageParts = 0;
+    }
+    if ( d->damage ) {
+        XDamageDestroy(d->display, d->damage);
+        d->damage = 0;
+    }
+    d->pendingDamage = QRegion();
+    if ( d->segment ) {
+        detachSegment(*d->segment);
+    }
+    XSync(d->display, False);
+    d->segment.reset();
+    XCloseDisplay(d->display);
+    d->display = nullptr;
+}
+
+bool XShmCaptureBackend::hasDamageTracking() const {
+    return d->damage != 0;
+}
+
+bool XShmCaptureBackend::ensureSegment() {
+    const qsizetype bytes = d->frameBytes();
+    if ( d->segment && d->segment->capacity >= bytes ) {
+        return true;
+    }
+    // 根窗口变大后旧段放不下：按新尺寸重建
+    if ( d->segment ) {
+        detachSegment(*d->segment);
+        XSync(d->display, False);
+        d->segment.reset();
+    }
+    d->segment = createSegment(bytes);
+    qCDebug(lcCaptureBackend) << "XShm: 重建共享内存段，大小" << bytes;
+    return d->segment != nullptr;
+}
+
+std::unique_ptr<XShmCaptureBackend::Segment> XShmCaptureBackend::createSegment(qsizetype bytes) {
+    auto segment = std::make_unique<Segment>();
+    segment->info.shmid = shmget(IPC_PRIVATE, static_cast<size_t>(bytes), IPC_CREAT | 0600);
+    if ( segment->info.shmid < 0 ) {
+        qCWarning(lcCaptureBackend) << "XShm: shmget 失败，大小" << bytes;
+        return nullptr;
+    }
+    void* address = shmat(segment->info.shmid, nullptr, 0);
+    if ( address == reinterpret_cast<void*>(-1) ) {
+        shmctl(segment->info.shmid, IPC_RMID, nullptr);
+        qCWarning(lcCaptureBackend) << "XShm: shmat 失败";
+        return nullptr;
+    }
+    segment->info.shmaddr = static_cast<char*>(address);
+    segment->info.readOnly = False;
+
+    bool attached = false;
+    {
+        XErrorTrap trap(d->display);
+        attached = XShmAttach(d->display, &segment->info);
+        XSync(d->display, False);
+        attached = attached && !trap.failed();
+    }
+    // 服务器已完成附加（或失败）后立即标记删除：最后一次 shmdt 时由内核回收，进程崩溃也不会泄漏
+    shmctl(segment->info.shmid, IPC_RMID, nullptr);
+    if ( !attached ) {
+        return nullptr;
+    }
+    segment->capacity = bytes;
+    segment->stale = d->area;
+    return segment;
+}
+
+void XShmCaptureBackend::detachSegment(Segment& segment) {
+    XShmDetach(d->display, &segment.info);
+}
+
+bool XShmCaptureBackend::fillSegment(Segment& segment, const QRegion& region) {
+    // XShmGetImage 按图像宽度决定行跨度，只能写入 area 的整行：把变化区域合并为互不重叠的行条带。
+    // QRegion 的矩形按 y 排序，重叠或相邻的行区间直接合并
+    QList<QPair<int, int>> bands;
+    for ( const QRect& rect : region ) {
+        if ( !bands.isEmpty() && rect.top() <= bands.last().second ) {
+            bands.last().second = std::max(bands.last().second, rect.bottom() + 1);
+        } else {
+            bands.append({ rect.top(), rect.bottom() + 1 });
+        }
+    }
+
+    for ( const QPair<int, int>& band : std::as_const(bands) ) {
+        XImage* image = XShmCreateImage(d->display, d->visual, static_cast<unsigned int>(d->depth), ZPixmap, nullptr,
+            &segment.info, static_cast<unsigned int>(d->area.width()), static_cast<unsigned int>(band.second - band.first));
+        if ( !image ) {
+            return false;
+        }
+        image->data = segment.info.shmaddr + qsizetype(band.first - d->area.y()) * d->bytesPerLine;
+
+        bool ok = false;
+        {
+            // XShmGetImage 等待回复，错误在返回前已经送达
+            XErrorTrap trap(d->display);
+            ok = XShmGetImage(d->display, d->root, image, d->area.x(), band.first, AllPlanes) && !trap.failed();
+        }
+        ok = ok && image->bytes_per_line == d->bytesPerLine;
+        image->data = nullptr;
+        XDestroyImage(image);
+        if ( !ok ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QImage XShmCaptureBackend::copyFromSegment(const QRect& physical) const {
+    // 拷贝到缓冲池的图像中再交给下游：段不被下游占住，下一次抓取仍能只重读变化的条带；
+    // 下游释放图像后内存块回到池里，稳态下每帧只有这一次内存拷贝，没有分配
+    QImage result = FrameBufferPool::instance().acquireImage(physical.size(), QImage::Format_RGB32);
+    if ( result.isNull() ) {
+        result = QImage(physical.size(), QImage::Format_RGB32);
+        if ( result.isNull() ) {
+            return QImage();
+        }
+    }
+    const uchar* source = reinterpret_cast<const uchar*>(d->segment->info.shmaddr)
+        + qsizetype(physical.y() - d->area.y()) * d->bytesPerLine + qsizetype(physical.x() - d->area.x()) * 4;
+    const qsizetype lineBytes = qsizetype(physical.width()) * 4;
+    for ( int row = 0; row < physical.height(); ++row ) {
+        std::memcpy(result.scanLine(row), source + qsizetype(row) * d->bytesPerLine, lineBytes);
+    }
+    return result;
+}
+
+QRect XShmCaptureBackend::toPhysical(const QRect& rect) const {
+    // Qt 高 DPI 下屏幕原点保持原生坐标，只有屏幕内的偏移和尺寸按缩放比例换算
+    const QPoint origin = d->screenGeometry.topLeft();
+    const qreal ratio = d->devicePixelRatio;
+    const QPoint offset = rect.topLeft() - origin;
+    return QRect(origin + QPoint(qRound(offset.x() * ratio), qRound(offset.y() * ratio)),
+        QSize(qRound(rect.width() * ratio), qRound(rect.height() * ratio)));
+}
+
+QRect XShmCaptureBackend::toLogical(const QRect& physical) const {
+    // toPhysical() 的逆变换
+    const QPoint origin = d->screenGeometry.topLeft();
+    const qreal ratio = d->devicePixelRatio;
+    const QPoint offset = physical.topLeft() - origin;
+    return QRect(origin + QPoint(qRound(offset.x() / ratio), qRound(offset.y() / ratio)),
+        QSize(qRound(physical.width() / ratio), qRound(physical.height() / ratio)));
+}
+
+void XShmCaptureBackend::collectDamage() {
+    if ( !d->damage ) {
+        return;
+    }
+    // 只有收到通知才向服务器取区域：画面静止时不产生任何往返
+    bool notified = false;
+    while ( XPending(d->display) > 0 ) {
+        XEvent event;
+        XNextEvent(d->display, &event);
+        if ( event.type == d->damageEventBase + XDamageNotify ) {
+            notified = true;
+        }
+    }
+    if ( !notified ) {
+        return;
+    }
+
+    // 取出并清空服务器端累积的损坏区域；之后的新变化会再次产生通知
+    XDamageSubtract(d->display, d->damage, None, d->damageParts);
+    int count = 0;
+    XRectangle* rects = XFixesFetchRegion(d->display, d->damageParts, &count);
+    if ( !rects ) {
+        return;
+    }
+    std::vector<QRect> damagedRects;
+    damagedRects.reserve(static_cast<size_t>(count));
+    for ( int i = 0; i < count; ++i ) {
+        damagedRects.emplace_back(rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+    }
+    XFree(rects);
+
+    QRegion damaged;
+    damaged.setRects(damagedRects.data(), static_cast<int>(damagedRects.size()));
+    damaged = damaged.intersected(d->area);
+    d->pendingDamage += damaged;
+    if ( d->segment ) {
+        d->segment->stale += damaged;
+    }
+}
+
+void XShmCaptureBackend::refreshRootSize() {
+    XWindowAttributes attributes;
+    if ( !XGetWindowAttributes(d->display, d->root, &attributes) ) {
+        return;
+    }
+    const QSize size(attributes.width, attributes.height);
+    if ( size == d->rootSize ) {
+        return;
+    }
+    // 根窗口尺寸变化后段内布局失效：整块标记为过期，放不下时在 ensureSegment() 中重建
+    qCInfo(lcCaptureBackend) << "XShm: 根窗口尺寸变化" << d->rootSize << "->" << size;
+    d->rootSize = size;
+    d->area = toPhysical(d->screenGeometry).intersected(d->rootRect());
+    d->bytesPerLine = d->area.width() * 4;
+    d->pendingDamage = d->area;
+    if ( d->segment ) {
+        d->segment->stale = d->area;
+    }
+}
+
+#endif // Q_OS_LINUX
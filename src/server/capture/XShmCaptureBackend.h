@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CaptureBackend.h"
+
+#ifdef Q_OS_LINUX
+#include <memory>
+
+/**
+ * @brief Linux X11 MIT-SHM 抓取后端
+ *
+ * X 服务器把根窗口像素直接写入与本进程共享的内存段，省去 grabWindow 的 QPixmap 分配与 toImage() 转换。
+ * 段是屏幕内容的常驻副本，只在 grab() 调用期间使用：返回的图像是从段拷贝到 FrameBufferPool 内存块的副本，
+ * 下游（处理队列、编码线程）持有多少帧都不会占住段，也不需要退化为 XGetImage。
+ *
+ * X 服务器支持 Damage 扩展时跟踪根窗口的变化：段记录自上次填充以来变化的区域，
+ * 每次抓取只重新读取覆盖这些区域的整行条带，画面静止时不发出任何抓取请求；
+ * takeDamage() 把变化区域交给调用方，没有变化时可以跳过整帧。
+ *
+ * 段只覆盖绑定屏幕在根窗口中的区域；
+ * 多显示器时每个屏幕各有一个后端，互不重复读取，变化区域也按屏幕分别跟踪。
+ * windowGeometry() 通过 XTranslateCoordinates 查询窗口在根窗口上的位置，用于只抓取单个窗口。
+ * 使用独立的 X 连接，只支持 24 位 TrueColor（xRGB 8888）且字节序与本机一致的显示，
+ * 其他情况 open() 失败，由 CaptureBackend::create() 回退到 QScreen。
+ * X11 头文件只在 .cpp 中包含，避免其宏与 Qt 头文件冲突。
+ */
+class XShmCaptureBackend : public CaptureBackend {
+public:
+    XShmCaptureBackend();
+    ~XShmCaptureBackend() override;
+
+    XShmCaptureBackend(const XShmCaptureBackend&) = delete;
+    XShmCaptureBackend& operator=(const XShmCaptureBackend&) = delete;
+
+    [[nodiscard]] QString name() const override { return QStringLiteral("XShm"); }
+    bool open(QScreen* screen) override;
+    QImage grab(const QRect& rect) override;
+    bool takeDamage(const QRect& rect, QRegion& changed) override;
+    QRect windowGeometry(quintptr window) override;
+    void close() override;
+
+    /**
+     * @brief 是否在跟踪屏幕变化（X 服务器支持 Damage 扩展）
+     */
+    [[nodiscard]] bool hasDamageTracking() const;
+
+private:
+    struct Segment;
+    struct Private;
+
+    bool ensureSegment();
+    std::unique_ptr<Segment> createSegment(qsizetype bytes);
+    void detachSegment(Segment& segment);
+    bool fillSegment(Segment& segment, const QRegion& region);
+    QImage copyFromSegment(const QRect& physical) const;
+    QRect toPhysical(const QRect& rect) const;
+    QRect toLogical(const QRect& physical) const;
+    void collectDamage();
+    void refreshRootSize();
+
+    std::unique_ptr<Private> d;
+};
+
+#endif // Q_OS_LINUX
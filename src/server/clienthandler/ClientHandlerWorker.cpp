@@ -4,6 +4,7 @@
 
 #include "ClientHandlerWorker.h"
 #include "../simulator/InputSimulator.h"
+#include "../simulator/MouseSimulator.h"
 #include "../dataflow/QueueManager.h"
 #include "../dataflow/DataFlowStructures.h"
 
@@ -30,8 +31,37 @@
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QRandomGenerator>
+#include <QtCore/QScopedValueRollback>
 #include <QtConcurrent/QtConcurrent>
+#include <algorithm>
 #include <cstring>
+#include <zstd.h>
+
+namespace {
+
+/**
+ * @brief 解开屏幕数据的 zstd 二次压缩，得到 JPEG 字节
+ *
+ * 用于未声明 ZSTD_SCREEN 的客户端：编码结果由所有会话共享，只能在发送时为该会话解压。
+ * @return JPEG 数据；数据损坏时返回空
+ */
+QByteArray decompressScreenData(const QByteArray& data) {
+    const unsigned long long size = ZSTD_getFrameContentSize(data.constData(), static_cast<size_t>(data.size()));
+    if ( size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR ||
+         size > static_cast<unsigned long long>(NetworkConstants::MAX_PACKET_SIZE) ) {
+        return QByteArray();
+    }
+    QByteArray jpeg(static_cast<qsizetype>(size), Qt::Uninitialized);
+    const size_t result = ZSTD_decompress(jpeg.data(), static_cast<size_t>(size),
+        data.constData(), static_cast<size_t>(data.size()));
+    if ( ZSTD_isError(result) ) {
+        return QByteArray();
+    }
+    jpeg.resize(static_cast<qsizetype>(result));
+    return jpeg;
+}
+
+} // namespace
 
 
 ClientHandlerWorker::ClientHandlerWorker(qintptr socketDescriptor,
@@ -43,24 +73,38 @@ ClientHandlerWorker::ClientHandlerWorker(qintptr socketDescriptor,
     , m_socket(nullptr)
     , m_sslCertificate(certificate)
     , m_sslPrivateKey(privateKey)
+    , m_sendQueue([this](const char* data, qint64 length) { return writeToSocket(data, length); })
     , m_clientPort(0)
     , m_isAuthenticated(false)
     , m_failedAuthCount(0)
     , m_connectionTime(QDateTime::currentDateTime())
     , m_lastHeartbeat(QDateTime::currentDateTime())
-    , m_heartbeatSendTimer(nullptr)
-    , m_heartbeatCheckTimer(nullptr)
-    , m_cursorUpdateTimer(nullptr)
+    , m_timerWheel(nullptr)
+    , m_heartbeatSendTimer(0)
+    , m_heartbeatCheckTimer(0)
+    , m_clockSyncExchanges(0)
+    , m_cursorUpdateTimer(0)
+    , m_cursorStateSent(false)
+    , m_nextCursorShapeId(1)
+    , m_cursorShapeActive(false)
+    , m_tilePlanPending(false)
+    , m_tilePlanGeneration(0)
+    , m_sendingScreenData(false)
+    , m_nextStream(0)
     , m_bytesReceived(0)
     , m_bytesSent(0)
     , m_inputSimulator(nullptr)
     , m_queueManager(nullptr) {
     qCDebug(lcClientHandlerWorker) << "ClientHandlerWorker 构造函数调用，套接字描述符:" << socketDescriptor;
     setName("ClientHandlerWorker");
+    // 会话共享I/O线程，由事件驱动，不运行工作循环
+    setEventDriven(true);
 }
 
 ClientHandlerWorker::~ClientHandlerWorker() {
     qCDebug(lcClientHandlerWorker) << "ClientHandlerWorker 析构函数";
+    // 未经 cleanup() 销毁时，规划任务仍可能在使用镜像
+    m_tilePlan.waitForFinished();
 
     qCDebug(lcClientHandlerWorker) << "ClientHandlerWorker 析构完成";
 }
@@ -109,6 +153,9 @@ bool ClientHandlerWorker::initialize() {
     // 连接套接字信号
     connect(m_socket, &QSslSocket::readyRead, this, &ClientHandlerWorker::onReadyRead);
     connect(m_socket, &QSslSocket::disconnected, this, &ClientHandlerWorker::onDisconnected);
+    // 套接字写缓冲区排空时继续写出批量通道
+    connect(m_socket, &QSslSocket::bytesWritten, this, [this](qint64) { flushSendQueue(); });
+    connect(m_socket, &QSslSocket::encryptedBytesWritten, this, [this](qint64) { flushSendQueue(); });
     connect(m_socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::errorOccurred),
         this, &ClientHandlerWorker::onError);
     connect(m_socket, QOverload<const QList<QSslError>&>::of(&QSslSocket::sslErrors),
@@ -138,20 +185,9 @@ bool ClientHandlerWorker::initialize() {
     // 启动服务端TLS握手
     m_socket->startServerEncryption();
 
-    // 创建心跳检查定时器
-    m_heartbeatCheckTimer = new QTimer(this);
-    m_heartbeatCheckTimer->setInterval(NetworkConstants::HEARTBEAT_TIMEOUT);
-    connect(m_heartbeatCheckTimer, &QTimer::timeout, this, &ClientHandlerWorker::checkHeartbeat);
-
-    // 创建心跳发送定时器
-    m_heartbeatSendTimer = new QTimer(this);
-    m_heartbeatSendTimer->setInterval(NetworkConstants::HEARTBEAT_INTERVAL);
-    connect(m_heartbeatSendTimer, &QTimer::timeout, this, &ClientHandlerWorker::sendHeartbeat);
-
-    // 创建光标类型更新定时器 (60 FPS)
-    m_cursorUpdateTimer = new QTimer(this);
-    m_cursorUpdateTimer->setInterval(10);
-    connect(m_cursorUpdateTimer, &QTimer::timeout, this, &ClientHandlerWorker::sendCursorType);
+    // 定时任务挂在所在I/O线程的定时轮上：同一线程的所有会话共用一个驱动定时器。
+    // 光标状态轮询在认证成功后调度
+    m_timerWheel = TimerWheel::forCurrentThread();
 
     // 创建输入模拟器
     m_inputSimulator = new InputSimulator(this);
@@ -159,17 +195,43 @@ bool ClientHandlerWorker::initialize() {
         qCWarning(lcClientHandlerWorker) << "输入模拟器初始化失败，客户端:" << clientId();
     }
 
-    // 获取队列管理器
-    m_queueManager = QueueManager::instance();
+    // 获取队列管理器（未注入时使用默认流水线）
+    if ( !m_queueManager ) {
+        m_queueManager = m_monitors.isEmpty() ? QueueManager::instance() : m_monitors.first().queueManager;
+    }
     if ( !m_queueManager ) {
         qCWarning(lcClientHandlerWorker) << "无法获取队列管理器实例";
+    } else {
+        // 未设置显示器时只有主显示器一条流水线
+        if ( m_monitors.isEmpty() ) {
+            MonitorPipeline primary;
+            primary.monitor.flags = static_cast<quint8>(MonitorFlags::PRIMARY);
+            primary.queueManager = m_queueManager;
+            m_monitors.append(primary);
+        }
+        // 新帧通知驱动发送（在本会话线程中执行），只响应查看中的显示器所订阅的层
+        for ( const MonitorPipeline& pipeline : std::as_const(m_monitors) ) {
+            QueueManager* queueManager = pipeline.queueManager;
+            connect(queueManager, &QueueManager::processedDataAvailable, this, [this, queueManager](int layer) {
+                const bool subscribed = std::any_of(m_streams.cbegin(), m_streams.cend(), [&](const ScreenStream& stream) {
+                    return stream.queueManager == queueManager && (stream.reader == 0 || stream.layer == layer);
+                });
+                if ( subscribed ) {
+                    processTask();
+                }
+            }, Qt::QueuedConnection);
+        }
+        // 默认查看主显示器，读者延迟到首次发送时注册
+        ScreenStream primary;
+        primary.monitorId = m_monitors.first().monitor.id;
+        primary.queueManager = m_monitors.first().queueManager;
+        m_streams = { primary };
+        m_viewedBounds = m_monitors.first().monitor.geometry();
     }
 
-    // 启动心跳检查定时器
-    m_heartbeatCheckTimer->start();
-
-    // 启动心跳发送定时器
-    m_heartbeatSendTimer->start();
+    // 启动心跳检查与心跳发送定时器
+    m_heartbeatCheckTimer = m_timerWheel->schedule(NetworkConstants::HEARTBEAT_TIMEOUT, [this]() { checkHeartbeat(); });
+    m_heartbeatSendTimer = m_timerWheel->schedule(NetworkConstants::HEARTBEAT_INTERVAL, [this]() { sendHeartbeat(); });
 
     qCInfo(lcClientHandlerWorker) << "ClientHandlerWorker 初始化成功，客户端:" << clientId();
 
@@ -179,30 +241,19 @@ bool ClientHandlerWorker::initialize() {
 void ClientHandlerWorker::cleanup() {
     qCInfo(lcClientHandlerWorker) << "清理 ClientHandlerWorker 资源";
 
-    // 在工作线程中停止并显式删除定时器子对象。
-    // 根本原因修复：这些子 QObject 是在工作线程的 initialize() 中以 this 为 parent 创建的，
-    // 其线程亲缘性属于工作线程。若只停止不删除，Worker 析构时 QObject::~QObject() 会从
-    // 主线程调用 deleteChildren()，触发跨线程的 QSocketNotifier/QTimer 清理，
-    // 进而导致 QCoreApplication::sendEvent 的跨线程致命断言。
-    // 在此（doStop() 调用链，仍在工作线程内）显式删除，确保主线程析构 Worker 时
-    // children 列表已为空，彻底消除跨线程删除子 QObject 的问题。
-    if ( m_heartbeatCheckTimer ) {
-        m_heartbeatCheckTimer->stop();
-        delete m_heartbeatCheckTimer;
-        m_heartbeatCheckTimer = nullptr;
-    }
-
-    if ( m_heartbeatSendTimer ) {
-        m_heartbeatSendTimer->stop();
-        delete m_heartbeatSendTimer;
-        m_heartbeatSendTimer = nullptr;
-    }
+    // 取消定时轮上的定时器：回调捕获了 this，会话销毁后不能再触发
+    cancelTimer(m_heartbeatCheckTimer);
+    cancelTimer(m_heartbeatSendTimer);
+    cancelTimer(m_cursorUpdateTimer);
+    // 图块规划任务引用本会话的镜像
+    discardTilePlan();
 
-    if ( m_cursorUpdateTimer ) {
-        m_cursorUpdateTimer->stop();
-        delete m_cursorUpdateTimer;
-        m_cursorUpdateTimer = nullptr;
+    for ( const MonitorPipeline& pipeline : std::as_const(m_monitors) ) {
+        if ( pipeline.queueManager ) {
+            disconnect(pipeline.queueManager, nullptr, this, nullptr);
+        }
     }
+    releaseProcessedReaders();
 
     // 在工作线程中显式删除输入模拟器
     if ( m_inputSimulator ) {
@@ -213,10 +264,11 @@ void ClientHandlerWorker::cleanup() {
     // 在工作线程中断开并显式删除套接字。
     // QSslSocket 内部的 QSocketNotifier 清理（unregisterSocketNotifier）在错误线程中
     // 会调用 sendEvent，必须在工作线程内完成删除。
+    // I/O线程由多个会话共享，不能阻塞等待断开：未能立即断开时直接中止连接
     if ( m_socket ) {
         m_socket->disconnectFromHost();
         if ( m_socket->state() != QAbstractSocket::UnconnectedState ) {
-            m_socket->waitForDisconnected(3000);
+            m_socket->abort();
         }
         delete m_socket;
         m_socket = nullptr;
@@ -226,8 +278,7 @@ void ClientHandlerWorker::cleanup() {
 }
 
 void ClientHandlerWorker::processTask() {
-    // 在Worker线程中，主要的处理逻辑通过信号槽机制触发
-    // 这里处理周期性任务：连接状态检查、数据接收、屏幕数据发送
+    // 会话由事件驱动：数据接收、心跳通过信号和定时轮处理，这里只在新帧到达时检查连接并发送
 
     // 检查连接状态
     if ( m_socket && m_socket->state() != QAbstractSocket::ConnectedState ) {
@@ -240,23 +291,16 @@ void ClientHandlerWorker::processTask() {
         return;
     }
 
-    // 认证成功后，异步从处理队列获取并发送屏幕数据
-    // Guard flag prevents event queue accumulation: only post if no pending invocation
-    if ( isAuthenticated() && m_queueManager && !m_sendScreenDataPending.exchange(true) ) {
-        QMetaObject::invokeMethod(this, "sendScreenDataFromQueue", Qt::QueuedConnection);
+    // 认证成功后，从处理队列读取新帧并发送
+    if ( isAuthenticated() && m_queueManager ) {
+        sendScreenDataFromQueue();
     }
-
-    // Hint to workLoop: if we posted a send, there's likely work to do — skip idle sleep.
-    setDidWork(isAuthenticated() && m_queueManager != nullptr);
 }
 
 void ClientHandlerWorker::sendScreenDataFromQueue() {
-    // Reset the guard flag so processTask can post the next invocation
-    m_sendScreenDataPending.store(false);
-
-    // Fix 1: 在出队之前先检查 socket 连接状态和认证状态。
-    // 若 socket 已断开，dequeueProcessedData() 会静默消耗队列数据却无法发送，
-    // 造成数据丢失并给调用方留下"仍在传输"的假象。
+    // Fix 1: 在读取之前先检查 socket 连接状态和认证状态。
+    // 若 socket 已断开，读取会推进本会话的游标却无法发送，
+    // 给调用方留下"仍在传输"的假象。
     if ( !m_socket || m_socket->state() != QAbstractSocket::ConnectedState ) {
         return;
     }
@@ -265,21 +309,92 @@ void ClientHandlerWorker::sendScreenDataFromQueue() {
         return;
     }
 
-    // Batch send: dequeue and send up to MAX_SEND_BATCH frames per invocation.
+    // 发送帧时写出腾出的空位会经 flushSendQueue() 再次调用本函数：当前循环会继续读取，无需重入
+    if ( m_sendingScreenData ) {
+        return;
+    }
+    const QScopedValueRollback<bool> sending(m_sendingScreenData, true);
+
+    // Batch send: up to MAX_SEND_PASSES frames per viewed monitor per invocation.
     // This reduces the overhead of workLoop's per-iteration msleep and
     // QMetaObject::invokeMethod round-trip when frames are queued up.
-    static constexpr int MAX_SEND_BATCH = 3;
-    int sent = 0;
+    // 各显示器轮流发送，每轮每个显示器最多一帧，每帧之前都检查背压：一个显示器的连续变化不会挤占其他显示器。
+    // 起始显示器每次调用轮换，批量通道只剩一个空位时各显示器机会均等
+    static constexpr int MAX_SEND_PASSES = 3;
+    const bool multiView = m_streams.size() > 1;
+    const qsizetype streamCount = m_streams.size();
+    if ( streamCount == 0 ) {
+        return;
+    }
+    const qsizetype first = m_nextStream % streamCount;
+    m_nextStream = (first + 1) % streamCount;
+    for ( int pass = 0; pass < MAX_SEND_PASSES; ++pass ) {
+        bool sentAny = false;
+        for ( qsizetype i = 0; i < streamCount; ++i ) {
+            // 图块规划进行中：完成后会继续读取，期间到达的帧由广播环跳过。
+            // 背压：批量通道已有足够待发帧时不再读取，落后的帧由广播环跳过（直接读最新帧），
+            // 而不是堆在发送队列中增加延迟
+            if ( m_tilePlanPending || bulkLaneFull() ) {
+                return;
+            }
+            if ( sendStreamFrame(m_streams[(first + i) % streamCount], multiView) ) {
+                sentAny = true;
+            }
+        }
+        if ( !sentAny ) {
+            break;
+        }
+    }
+}
+
+bool ClientHandlerWorker::bulkLaneFull() const {
+    return m_sendQueue.pendingBulkMessages() >= NetworkConstants::MAX_PENDING_BULK_MESSAGES;
+}
 
-    while ( sent < MAX_SEND_BATCH ) {
-        // Re-check connection before each send in the batch
+bool ClientHandlerWorker::sendStreamFrame(ScreenStream& stream, bool multiView) {
+    // 每个会话在处理队列上有自己的读者：同一帧只编码一次，分发给所有会话。
+    // 延迟到首次发送时注册，处理队列在第一个客户端认证后才开始产出数据
+    if ( stream.reader == 0 ) {
+        stream.layerSelector.setLayerCount(stream.queueManager->processedLayerCount());
+        stream.layer = stream.layerSelector.layer();
+        stream.reader = stream.queueManager->addProcessedReader(stream.layer);
+        if ( stream.reader == 0 ) {
+            return false;
+        }
+        updateTileHashConsumers();
+    }
+
+    const CapabilitySet peer = peerCapabilities();
+    const bool sendZstd = peer.has(Capability::ZSTD_SCREEN);
+    // 客户端声明的最大消息载荷；未声明时按本端上限
+    const qsizetype maxMessageSize = static_cast<qsizetype>(
+        peer.uint32Param(Capability::MAX_MESSAGE_SIZE, static_cast<quint32>(NetworkConstants::MAX_PACKET_SIZE)));
+
+    // 读到一帧可发送的帧为止；过时、无效或过大的帧丢弃后继续读
+    while ( true ) {
         if ( !m_socket || m_socket->state() != QAbstractSocket::ConnectedState ) {
-            break;
+            return false;
         }
 
         ProcessedData processedData;
-        if ( !m_queueManager->dequeueProcessedData(processedData) ) {
-            break; // Queue empty
+        quint64 skipped = 0;
+        if ( !stream.queueManager->readProcessedData(stream.reader, processedData, stream.layer, &skipped) ) {
+            return false; // No new frame for this session
+        }
+
+        // 刚切换层时，新层中不晚于旧层最后一帧的帧已经过时
+        if ( stream.layerSwitchFrameId != 0 ) {
+            if ( processedData.originalFrameId <= stream.layerSwitchFrameId ) {
+                continue;
+            }
+            stream.layerSwitchFrameId = 0;
+        }
+
+        // 跟不上当前层（频繁跳帧）时降层，长期顺畅时升层；本帧照常发送，从下一帧起读新层。
+        // 新层的帧尺寸不同或质量更高时，图块镜像按刷新处理（整帧），因此切换总落在刷新点上
+        const int layer = stream.layerSelector.update(skipped);
+        if ( layer != stream.layer ) {
+            switchProcessedLayer(stream, layer, processedData.originalFrameId);
         }
 
         // 验证数据有效性
@@ -287,42 +402,260 @@ void ClientHandlerWorker::sendScreenDataFromQueue() {
             qCWarning(lcClientHandlerWorker) << "ProcessedData无效，跳过发送，帧ID:" << processedData.originalFrameId;
             continue;
         }
+        // 客户端未声明 ZSTD_SCREEN 时发送解压后的 JPEG
+        if ( processedData.isZstdCompressed && !sendZstd ) {
+            processedData.compressedData = decompressScreenData(processedData.compressedData);
+            if ( processedData.compressedData.isEmpty() ) {
+                qCWarning(lcClientHandlerWorker) << "zstd解压失败，跳过发送，帧ID:" << processedData.originalFrameId;
+                continue;
+            }
+            processedData.isZstdCompressed = false;
+        }
+        // 超过客户端可接收的消息大小：跳过本帧（在图块镜像记录之前，镜像与客户端保持一致）
+        const qsizetype imageSize = processedData.compressedData.size();
+        if ( imageSize + static_cast<qsizetype>(SERIALIZED_HEADER_SIZE) > maxMessageSize ) {
+            qCWarning(lcClientHandlerWorker) << "屏幕数据超过客户端最大消息大小，跳过发送，帧ID:"
+                << processedData.originalFrameId << "大小:" << imageSize << "上限:" << maxMessageSize;
+            continue;
+        }
+
+        // 查看多个显示器时客户端画面是它们的外接矩形，各帧按其区域在其中的位置与逻辑尺寸发送：
+        // 抓取区域可能只是显示器的一部分，客户端不能按显示器的位置和尺寸绘制
+        QPoint offset;
+        if ( multiView ) {
+            m_sourceOrigin = m_viewedBounds.topLeft();
+            offset = processedData.sourceRect.topLeft() - m_viewedBounds.topLeft();
+            if ( !processedData.sourceRect.isEmpty() ) {
+                processedData.originalImageSize = processedData.sourceRect.size();
+            }
+        } else {
+            m_sourceOrigin = processedData.sourceRect.topLeft();
+        }
 
-        // 创建ScreenData消息
-        ScreenData screenData;
-        screenData.x = 0;
-        screenData.y = 0;
-        screenData.imageData = processedData.compressedData;
-        screenData.width = processedData.imageSize.width();
-        screenData.height = processedData.imageSize.height();
-        screenData.originalWidth = processedData.originalImageSize.width();
-        screenData.originalHeight = processedData.originalImageSize.height();
-        screenData.dataSize = processedData.compressedData.size();
-
-        // 设置压缩标志位
-        quint8 flags = static_cast<quint8>(ScreenDataFlags::NONE);
-        if ( processedData.isZstdCompressed ) {
-            flags |= static_cast<quint8>(ScreenDataFlags::ZSTD_COMPRESSED);
+        // 图块缓存：未变化的帧不发送；变化较少时只发送图块记录（命中的只发送缓存ID）。
+        // 镜像只对应一幅画面，查看多个显示器时只发送整帧
+        const bool tileCacheEnabled = !multiView && m_tileMirror.capacity() > 0;
+        if ( tileCacheEnabled && !processedData.tileHashes.isEmpty() ) {
+            startTilePlan(processedData, offset);
+            return true;
         }
-        if ( processedData.isScaled ) {
-            flags |= static_cast<quint8>(ScreenDataFlags::SCALED);
+        if ( tileCacheEnabled ) {
+            // 登记之前编码的帧不带哈希：按整帧发送，镜像随之重新同步
+            m_tileMirror.clear();
         }
-        screenData.flags = flags;
 
-        // 预先编码消息,然后发送
-        QByteArray messageData = Protocol::createMessage(MessageType::SCREEN_DATA, screenData);
+        TileUpdate tileUpdate;
+        sendScreenFrame(processedData, offset, TileCacheMirror::Plan::FullFrame, tileUpdate);
+        return true;
+    }
+}
 
-        if ( messageData.isEmpty() ) {
+void ClientHandlerWorker::startTilePlan(const ProcessedData& processedData, const QPoint& offset) {
+    // 滚动检测与逐块 JPEG 编码在线程池中进行，不占用多个会话共享的 I/O 线程。
+    // 规划期间镜像归任务独占，本会话暂停读取新帧；完成后回到本线程按顺序发送，再读取规划期间到达的帧
+    m_tilePlanPending = true;
+    const quint64 generation = m_tilePlanGeneration;
+    TileCacheMirror* mirror = &m_tileMirror;
+    const qint64 captureTimeMs = processedData.captureTime.isValid() ? processedData.captureTime.toMSecsSinceEpoch() : 0;
+    m_tilePlan = QtConcurrent::run([mirror, processedData, captureTimeMs]() {
+        TilePlanResult result;
+        result.plan = mirror->plan(processedData.frame, processedData.tileHashes, processedData.quality, result.update,
+            captureTimeMs);
+        return result;
+    });
+    m_tilePlan.then(this, [this, processedData, offset, generation](TilePlanResult result) {
+        m_tilePlanPending = false;
+        // 规划期间被 discardTilePlan() 作废（切换显示器、重新握手）时不发送
+        if ( generation == m_tilePlanGeneration && result.plan != TileCacheMirror::Plan::Unchanged ) {
+            sendScreenFrame(processedData, offset, result.plan, result.update);
+        }
+        sendScreenDataFromQueue();
+    });
+}
+
+void ClientHandlerWorker::discardTilePlan() {
+    if ( !m_tilePlanPending ) {
+        return;
+    }
+    // 任务结束后镜像已记录本帧的图块却不会发送：结果作废，镜像清空后重新同步
+    m_tilePlan.waitForFinished();
+    ++m_tilePlanGeneration;
+    m_tileMirror.clear();
+}
+
+void ClientHandlerWorker::sendScreenFrame(const ProcessedData& processedData, const QPoint& offset,
+                                          TileCacheMirror::Plan tilePlan, TileUpdate& tileUpdate) {
+    // 创建ScreenData消息
+    ScreenData screenData;
+    screenData.x = static_cast<quint16>(std::max(0, offset.x()));
+    screenData.y = static_cast<quint16>(std::max(0, offset.y()));
+    screenData.imageData = processedData.compressedData;
+    screenData.width = processedData.imageSize.width();
+    screenData.height = processedData.imageSize.height();
+    screenData.originalWidth = processedData.originalImageSize.width();
+    screenData.originalHeight = processedData.originalImageSize.height();
+    screenData.dataSize = processedData.compressedData.size();
+    if ( peerCapabilities().has(Capability::CAPTURE_TIMESTAMP) && processedData.captureTime.isValid() ) {
+        screenData.captureTimestamp = static_cast<quint64>(processedData.captureTime.toMSecsSinceEpoch());
+    }
+
+    // 设置压缩标志位
+    quint8 flags = static_cast<quint8>(ScreenDataFlags::NONE);
+    if ( processedData.isZstdCompressed ) {
+        flags |= static_cast<quint8>(ScreenDataFlags::ZSTD_COMPRESSED);
+    }
+    if ( processedData.isScaled ) {
+        flags |= static_cast<quint8>(ScreenDataFlags::SCALED);
+    }
+    screenData.flags = flags;
+
+    if ( tilePlan == TileCacheMirror::Plan::FullFrame ) {
+        // 分段编码：图像字节与 ProcessedData 隐式共享，直到写入套接字才拷贝一次
+        const MessageSegments segments = Protocol::createMessageSegments(MessageType::SCREEN_DATA, screenData,
+            m_checksumAlgorithm.load(std::memory_order_relaxed));
+
+        if ( segments.isEmpty() ) {
             qCWarning(lcClientHandlerWorker) << "消息编码失败，messageData为空";
+            // 镜像已记录本帧的 STORE：清空后重新同步（客户端多出的旧条目不会再被引用）
+            m_tileMirror.clear();
+            return;
+        }
+
+        sendMessageSegments(segments);
+    }
+
+    // 整帧之后的 STORE 记录与图块更新同走批量通道，顺序不会被打乱
+    if ( !tileUpdate.records.isEmpty() || !tileUpdate.copies.isEmpty() ) {
+        tileUpdate.originalWidth = screenData.originalWidth;
+        tileUpdate.originalHeight = screenData.originalHeight;
+        tileUpdate.flags = screenData.flags & static_cast<quint8>(ScreenDataFlags::SCALED);
+        tileUpdate.captureTimestamp = screenData.captureTimestamp;
+        const MessageSegments tileSegments = Protocol::createMessageSegments(MessageType::TILE_UPDATE, tileUpdate,
+            m_checksumAlgorithm.load(std::memory_order_relaxed));
+        if ( tileSegments.isEmpty() ) {
+            qCWarning(lcClientHandlerWorker) << "图块更新编码失败，帧ID:" << processedData.originalFrameId;
+            m_tileMirror.clear();
+        } else {
+            sendMessageSegments(tileSegments);
+        }
+    }
+}
+
+void ClientHandlerWorker::releaseProcessedReaders() {
+    for ( ScreenStream& stream : m_streams ) {
+        if ( stream.reader != 0 && stream.queueManager ) {
+            stream.queueManager->removeProcessedReader(stream.reader, stream.layer);
+        }
+        if ( stream.tileHashes && stream.queueManager ) {
+            stream.queueManager->removeTileHashConsumer();
+        }
+        stream.tileHashes = false;
+        stream.reader = 0;
+        stream.layer = 0;
+        stream.layerSwitchFrameId = 0;
+        stream.layerSelector.reset();
+    }
+}
+
+void ClientHandlerWorker::updateTileHashConsumers() {
+    // 图块缓存只用于查看单个显示器，且双方协商了缓存容量
+    const bool wanted = m_streams.size() == 1 && m_tileMirror.capacity() > 0;
+    for ( ScreenStream& stream : m_streams ) {
+        const bool subscribe = wanted && stream.reader != 0 && stream.queueManager;
+        if ( subscribe == stream.tileHashes ) {
             continue;
         }
+        if ( subscribe ) {
+            stream.queueManager->addTileHashConsumer();
+        } else {
+            stream.queueManager->removeTileHashConsumer();
+        }
+        stream.tileHashes = subscribe;
+    }
+}
 
-        sendEncodedMessage(messageData);
-        ++sent;
+bool ClientHandlerWorker::selectMonitors(const QList<quint8>& monitorIds) {
+    QList<ScreenStream> streams;
+    QRect bounds;
+    for ( const MonitorPipeline& pipeline : std::as_const(m_monitors) ) {
+        if ( pipeline.queueManager && monitorIds.contains(pipeline.monitor.id) ) {
+            ScreenStream stream;
+            stream.monitorId = pipeline.monitor.id;
+            stream.queueManager = pipeline.queueManager;
+            streams.append(stream);
+            bounds = bounds.united(pipeline.monitor.geometry());
+        }
+    }
+    if ( streams.isEmpty() ) {
+        return false;
+    }
+
+    // 旧视图的读者立即注销；新视图的读者立即注册，注册时各流水线的下一帧为完整画面
+    releaseProcessedReaders();
+    m_streams = std::move(streams);
+    m_viewedBounds = bounds;
+    QList<quint8> viewed;
+    for ( ScreenStream& stream : m_streams ) {
+        stream.layerSelector.setLayerCount(stream.queueManager->processedLayerCount());
+        stream.layer = stream.layerSelector.layer();
+        stream.reader = stream.queueManager->addProcessedReader(stream.layer);
+        viewed.append(stream.monitorId);
+    }
+    updateTileHashConsumers();
+    // 客户端按新布局重建画面：图块镜像重新同步，下一帧整帧发送
+    discardTilePlan();
+    m_tileMirror.clear();
+    qCInfo(lcClientHandlerWorker) << "客户端" << clientId() << "查看显示器:" << viewed;
+
+    // 布局与帧同走批量通道：客户端先处理完旧视图的帧，再切换到新布局
+    sendMonitorLayout();
+    emit monitorSelectionChanged(viewed);
+    return true;
+}
+
+void ClientHandlerWorker::sendMonitorLayout() {
+    if ( !peerCapabilities().has(Capability::MULTI_MONITOR) ) {
+        return;
+    }
+    MonitorLayout layout;
+    for ( const MonitorPipeline& pipeline : std::as_const(m_monitors) ) {
+        // 没有屏幕几何（无图形界面）时布局无意义，保持旧版单画面行为
+        if ( pipeline.monitor.width == 0 || pipeline.monitor.height == 0 ) {
+            return;
+        }
+        MonitorInfo monitor = pipeline.monitor;
+        const bool viewed = std::any_of(m_streams.cbegin(), m_streams.cend(),
+            [&](const ScreenStream& stream) { return stream.monitorId == monitor.id; });
+        const quint8 viewedFlag = static_cast<quint8>(MonitorFlags::VIEWED);
+        monitor.flags = static_cast<quint8>(viewed ? (monitor.flags | viewedFlag) : (monitor.flags & ~viewedFlag));
+        layout.monitors.append(monitor);
+    }
+    if ( !layout.monitors.isEmpty() ) {
+        sendMessage(MessageType::MONITOR_LAYOUT, layout);
+    }
+}
+
+void ClientHandlerWorker::cancelTimer(TimerWheel::TimerId& timer) {
+    if ( timer != 0 && m_timerWheel ) {
+        m_timerWheel->cancel(timer);
+    }
+    timer = 0;
+}
+
+void ClientHandlerWorker::switchProcessedLayer(ScreenStream& stream, int layer, quint64 lastFrameId) {
+    const quint32 reader = stream.queueManager->addProcessedReader(layer);
+    if ( reader == 0 ) {
+        return;
     }
+    stream.queueManager->removeProcessedReader(stream.reader, stream.layer);
+    qCInfo(lcClientHandlerWorker) << "客户端" << clientId() << "显示器" << stream.monitorId
+        << "切换同播层:" << stream.layer << "->" << layer;
+    stream.reader = reader;
+    stream.layer = layer;
+    stream.layerSwitchFrameId = lastFrameId;
 }
 
-void ClientHandlerWorker::sendCursorType() {
+void ClientHandlerWorker::sendCursorState() {
     // 检查连接和认证状态
     if ( !m_socket || !m_socket->isOpen() ) {
         return;
@@ -336,19 +669,77 @@ void ClientHandlerWorker::sendCursorType() {
         return;
     }
 
-    // 获取当前光标类型
-    int cursorType = m_inputSimulator->getCurrentCursorType();
+    const QPoint position = m_inputSimulator->getCursorPosition() - m_sourceOrigin;
+    CursorState state;
+    state.x = static_cast<qint16>(position.x());
+    state.y = static_cast<qint16>(position.y());
+    state.cursorType = static_cast<Qt::CursorShape>(m_inputSimulator->getCurrentCursorType());
+
+    // 光标图像变化时先发送 CURSOR_SHAPE，之后的状态消息以 BitmapCursor 引用它
+    if ( m_cursorShapeIds.capacity() > 0 ) {
+        CursorImage image;
+        if ( m_inputSimulator->captureCursorImage(image) ) {
+            sendCursorShape(image);
+        }
+        if ( m_cursorShapeActive ) {
+            state.cursorType = Qt::BitmapCursor;
+        }
+    }
+
+    const bool streamPosition = peerCapabilities().has(Capability::CURSOR_STREAM);
+    if ( m_cursorStateSent ) {
+        const bool typeChanged = state.cursorType != m_lastCursorState.cursorType;
+        const bool positionChanged = state.x != m_lastCursorState.x || state.y != m_lastCursorState.y
+            || state.flags != m_lastCursorState.flags;
+        if ( !typeChanged && !(streamPosition && positionChanged) ) {
+            return;
+        }
+    }
+    m_lastCursorState = state;
+    m_cursorStateSent = true;
 
-    // 创建光标类型消息（仅包含类型）
-    CursorMessage message(static_cast<Qt::CursorShape>(cursorType));
+    const ChecksumAlgorithm algorithm = m_checksumAlgorithm.load(std::memory_order_relaxed);
+    if ( streamPosition ) {
+        sendMessageSegments(Protocol::createMessageSegments(MessageType::CURSOR_STATE, state, algorithm));
+        return;
+    }
 
-    // 发送光标类型消息
-    QByteArray messageData = Protocol::createMessage(MessageType::CURSOR_POSITION, message);
+    // 旧版客户端：仅发送光标类型
+    CursorMessage message(state.cursorType);
+    QByteArray messageData = Protocol::createMessage(MessageType::CURSOR_POSITION, message, algorithm);
     if ( !messageData.isEmpty() ) {
         sendEncodedMessage(messageData);
     }
 }
 
+void ClientHandlerWorker::sendCursorShape(const CursorImage& image) {
+    static_assert(CursorImage::MAX_DIMENSION <= CursorShapeMessage::MAX_DIMENSION);
+
+    CursorShapeMessage message;
+    message.flags = static_cast<quint8>(CursorShapeFlags::HAS_BITMAP);
+    message.width = image.width;
+    message.height = image.height;
+    message.hotspotX = image.hotspotX;
+    message.hotspotY = image.hotspotY;
+    message.pixels = image.pixels;
+
+    // 缓存键覆盖尺寸、热点与像素（cacheId 尚为 0）
+    const ContentHash hash = ContentHash::of(message.encode());
+    if ( const quint32* cachedId = m_cursorShapeIds.find(hash) ) {
+        // 客户端缓存仍持有该图像（两端 LRU 同步淘汰），只发送ID
+        message.cacheId = *cachedId;
+        message.flags = static_cast<quint8>(CursorShapeFlags::NONE);
+        message.pixels.clear();
+    } else {
+        message.cacheId = m_nextCursorShapeId++;
+        m_cursorShapeIds.insert(hash, message.cacheId);
+    }
+
+    sendMessageSegments(Protocol::createMessageSegments(MessageType::CURSOR_SHAPE, message,
+        m_checksumAlgorithm.load(std::memory_order_relaxed)));
+    m_cursorShapeActive = true;
+}
+
 QString ClientHandlerWorker::clientAddress() const {
     QMutexLocker locker(&m_clientInfoMutex);
     return m_clientAddress;
@@ -374,6 +765,11 @@ bool ClientHandlerWorker::isAuthenticated() const {
     return m_isAuthenticated;
 }
 
+CapabilitySet ClientHandlerWorker::peerCapabilities() const {
+    QMutexLocker locker(&m_clientInfoMutex);
+    return m_peerCapabilities;
+}
+
 quint64 ClientHandlerWorker::bytesReceived() const {
     QMutexLocker locker(&m_statsMutex);
     return m_bytesReceived;
@@ -396,6 +792,14 @@ void ClientHandlerWorker::setExpectedPasswordDigest(const QByteArray& salt, cons
     m_expectedDigest = digest;
 }
 
+void ClientHandlerWorker::setQueueManager(QueueManager* queueManager) {
+    m_queueManager = queueManager;
+}
+
+void ClientHandlerWorker::setMonitorPipelines(const QList<MonitorPipeline>& monitors) {
+    m_monitors = monitors;
+}
+
 void ClientHandlerWorker::setPbkdf2Params(quint32 iterations, quint32 keyLength) {
     QMutexLocker locker(&m_clientInfoMutex);
     m_pbkdf2Iterations = iterations;
@@ -405,7 +809,8 @@ void ClientHandlerWorker::setPbkdf2Params(quint32 iterations, quint32 keyLength)
 void ClientHandlerWorker::sendMessage(MessageType type, const IMessageCodec& message) {
     try {
         // 使用Protocol::createMessage来创建加密的消息
-        QByteArray messageData = Protocol::createMessage(type, message);
+        QByteArray messageData = Protocol::createMessage(type, message,
+            m_checksumAlgorithm.load(std::memory_order_relaxed));
 
         if ( messageData.isEmpty() ) {
             qCWarning(lcClientHandlerWorker) << "消息数据为空，跳过发送";
@@ -429,46 +834,68 @@ void ClientHandlerWorker::sendMessage(MessageType type, const IMessageCodec& mes
 }
 
 void ClientHandlerWorker::sendEncodedMessage(const QByteArray& messageData) {
+    MessageSegments segments;
+    segments.head = messageData;
+    sendMessageSegments(segments);
+}
+
+void ClientHandlerWorker::sendMessageSegments(const MessageSegments& segments) {
     if ( !m_socket || m_socket->state() != QAbstractSocket::ConnectedState ) {
         qCWarning(lcClientHandlerWorker) << "套接字未连接，无法发送消息";
         return;
     }
 
-    if ( messageData.isEmpty() ) {
+    if ( segments.isEmpty() ) {
         qCWarning(lcClientHandlerWorker) << "消息数据为空，跳过发送";
         return;
     }
 
-    try {
-        // 直接发送完整消息，让TCP层处理分段
-        // 注意：协议层的加密消息是一个完整单元，不能在应用层分块
-        // TCP会自动处理大消息的分段和重组
-        qint64 totalSize = messageData.size();
-        qint64 bytesWritten = m_socket->write(messageData);
-
-        if ( bytesWritten == -1 ) {
-            qCWarning(lcClientHandlerWorker) << "发送消息失败:" << m_socket->errorString();
-            return;
-        }
+    // 交互消息立即写出；屏幕等批量消息按低水位分片写出，不阻塞后续交互消息
+    m_sendQueue.enqueue(segments);
+    flushSendQueue();
+}
 
-        if ( bytesWritten != totalSize ) {
-            qCWarning(lcClientHandlerWorker) << "消息部分发送: 期望" << totalSize << "bytes，实际" << bytesWritten << "bytes";
-        }
+void ClientHandlerWorker::flushSendQueue() {
+    if ( !m_socket || m_socket->state() != QAbstractSocket::ConnectedState || m_sendQueue.isEmpty() ) {
+        return;
+    }
 
-        // 更新统计信息（按写入的字节数，不是消息大小）
-        if ( bytesWritten > 0 ) {
-            QMutexLocker locker(&m_statsMutex);
-            m_bytesSent += bytesWritten;
+    const bool bulkBlocked = bulkLaneFull();
+    try {
+        const qint64 pending = m_socket->bytesToWrite() + m_socket->encryptedBytesToWrite();
+        if ( m_sendQueue.flush(pending) < 0 ) {
+            qCWarning(lcClientHandlerWorker) << "发送队列写出失败，丢弃未发送数据";
+            m_sendQueue.clear();
         }
-
-        // 数据大小和发送数据大小日志
-        // qCDebug(lcClientHandlerWorker) << "数据大小:" << totalSize << "bytes" << "发送数据大小:" << bytesWritten << "bytes";
-
     } catch ( const std::exception& e ) {
         qCWarning(lcClientHandlerWorker) << "发送消息时发生异常:" << e.what();
     } catch ( ... ) {
         qCWarning(lcClientHandlerWorker) << "发送消息时发生未知异常";
     }
+
+    // 背压曾暂停读取：批量通道腾出空位后立即读取最新帧，
+    // 否则它要等下一帧到达才发送（画面静止时会一直滞留在广播环中）
+    if ( bulkBlocked && !bulkLaneFull() && isAuthenticated() ) {
+        sendScreenDataFromQueue();
+    }
+}
+
+qint64 ClientHandlerWorker::writeToSocket(const char* data, qint64 length) {
+    const qint64 written = m_socket->write(data, length);
+    if ( written == -1 ) {
+        qCWarning(lcClientHandlerWorker) << "发送消息失败:" << m_socket->errorString();
+        return -1;
+    }
+    if ( written != length ) {
+        qCWarning(lcClientHandlerWorker) << "消息部分发送: 期望" << length << "bytes，实际" << written << "bytes";
+    }
+
+    // 更新统计信息（按写入的字节数，不是消息大小）
+    if ( written > 0 ) {
+        QMutexLocker locker(&m_statsMutex);
+        m_bytesSent += written;
+    }
+    return written;
 }
 
 void ClientHandlerWorker::disconnectClient() {
@@ -497,6 +924,8 @@ void ClientHandlerWorker::forceDisconnect() {
     qCWarning(lcClientHandlerWorker) << "强制断开客户端连接:" << clientId();
 
     m_receiveBuffer.clear();
+    m_sendQueue.clear();
+    m_fragmentAssembler.clear();
 
     if ( m_socket ) {
         m_socket->abort();
@@ -517,47 +946,58 @@ void ClientHandlerWorker::onReadyRead() {
         return;
     }
 
-    // 一次性读取所有可用数据
-    QByteArray newData = m_socket->readAll();
-    if ( newData.isEmpty() ) {
+    // 检查缓冲区大小，防止无限增长
+    const qint64 available = m_socket->bytesAvailable();
+    if ( available <= 0 ) {
         return;
     }
-
-    // 检查缓冲区大小，防止无限增长
-    if ( m_receiveBuffer.size() + newData.size() > NetworkConstants::MAX_PACKET_SIZE ) {
+    if ( m_receiveBuffer.size() + available > NetworkConstants::MAX_PACKET_SIZE ) {
         qCCritical(lcClientHandlerWorker) << "接收缓冲区超过最大限制:" << NetworkConstants::MAX_PACKET_SIZE
             << "当前大小:" << m_receiveBuffer.size()
-            << "新增数据:" << newData.size();
+            << "新增数据:" << available;
         forceDisconnect();
         return;
     }
 
-    // 预留空间以减少内存分配次数
-    m_receiveBuffer.reserve(m_receiveBuffer.size() + newData.size());
-    m_receiveBuffer.append(newData);
+    // 直接读入接收缓冲区的预分配空间（无临时拷贝）
+    const qint64 bytesRead = m_receiveBuffer.readFrom(m_socket);
+    if ( bytesRead <= 0 ) {
+        return;
+    }
 
     // 更新心跳时间
     m_lastHeartbeat = QDateTime::currentDateTime();
 
     {
         QMutexLocker locker(&m_statsMutex);
-        m_bytesReceived += newData.size();
+        m_bytesReceived += bytesRead;
     }
 
+    // 记录到达时间，用于心跳时钟同步
+    const qint64 receivedAtMs = QDateTime::currentMSecsSinceEpoch();
+
     // 处理缓冲区中的完整消息
     while ( !m_receiveBuffer.isEmpty() ) {
         // 步骤1：先验证数据完整性，同时获取MessageHeader
         MessageHeader header;
-        QByteArray payload;
-        qsizetype result = Protocol::parseMessage(m_receiveBuffer, header, payload);
-        if ( result > 0 ) {
-            // 步骤3：移除已处理的数据
-            m_receiveBuffer.remove(0, result);
+        QByteArrayView payloadView;
+        qsizetype result = Protocol::parseMessage(m_receiveBuffer.view(), header, payloadView,
+            m_checksumAlgorithm.load(std::memory_order_relaxed));
+        if ( result > 0 && header.type == MessageType::FRAGMENT ) {
+            // 分片直接在接收缓冲区上重组，完整后再按普通消息分发
+            handleFragment(payloadView, receivedAtMs);
+            m_receiveBuffer.consume(result);
+        } else if ( result > 0 ) {
+            // 步骤2：消息异步处理且接收缓冲区会被复用，这里做唯一一次载荷拷贝
+            QByteArray payload = payloadView.toByteArray();
+
+            // 步骤3：前移读游标（不搬移剩余数据）
+            m_receiveBuffer.consume(result);
 
             // 步骤4：异步处理消息，使用 QMetaObject::invokeMethod 调度到主线程
             // 这样可以避免跨线程访问 QTcpSocket 的问题
-            QMetaObject::invokeMethod(this, [this, header, payload]() {
-                processMessage(header, payload);
+            QMetaObject::invokeMethod(this, [this, header, payload, receivedAtMs]() {
+                processMessage(header, payload, receivedAtMs);
             }, Qt::QueuedConnection);
         } else if ( result == 0 ) {
             // 消息无效，清空缓冲区
@@ -570,24 +1010,58 @@ void ClientHandlerWorker::onReadyRead() {
     }
 }
 
+void ClientHandlerWorker::handleFragment(QByteArrayView payload, qint64 receivedAtMs) {
+    MessageFragment fragment;
+    QByteArray message;
+    if ( !fragment.decodeView(payload) ) {
+        qCWarning(lcClientHandlerWorker) << "无效的分片消息";
+        return;
+    }
+
+    switch ( m_fragmentAssembler.addFragment(fragment, message) ) {
+        case FragmentAssembler::Result::Incomplete:
+            return;
+        case FragmentAssembler::Result::Invalid:
+            qCWarning(lcClientHandlerWorker) << "分片重组失败，丢弃消息:" << fragment.messageId;
+            return;
+        case FragmentAssembler::Result::Complete:
+            break;
+    }
+
+    MessageHeader header;
+    QByteArrayView innerPayload;
+    const qsizetype result = Protocol::parseMessage(message, header, innerPayload,
+        m_checksumAlgorithm.load(std::memory_order_relaxed));
+    if ( result != message.size() || header.type == MessageType::FRAGMENT ) {
+        qCWarning(lcClientHandlerWorker) << "重组后的消息无效，丢弃:" << fragment.messageId;
+        return;
+    }
+
+    QByteArray innerData = innerPayload.toByteArray();
+    QMetaObject::invokeMethod(this, [this, header, innerData, receivedAtMs]() {
+        processMessage(header, innerData, receivedAtMs);
+    }, Qt::QueuedConnection);
+}
+
 void ClientHandlerWorker::onDisconnected() {
     m_isConnectedAtomic.store(false, std::memory_order_release);
+    m_sendQueue.clear();
+    m_fragmentAssembler.clear();
+    releaseProcessedReaders();
     qCInfo(lcClientHandlerWorker) << "客户端断开连接:" << clientId()
         << "(连接时长:" << m_connectionTime.secsTo(QDateTime::currentDateTime()) << "秒)";
 
     // 停止定时器
-    if ( m_heartbeatCheckTimer ) {
-        m_heartbeatCheckTimer->stop();
-        qCDebug(lcClientHandlerWorker) << "心跳检查定时器已停止";
-    }
-
-    if ( m_heartbeatSendTimer ) {
-        m_heartbeatSendTimer->stop();
-        qCDebug(lcClientHandlerWorker) << "心跳发送定时器已停止";
-    }
+    cancelTimer(m_heartbeatCheckTimer);
+    cancelTimer(m_heartbeatSendTimer);
+    cancelTimer(m_cursorUpdateTimer);
+    qCDebug(lcClientHandlerWorker) << "会话定时器已取消";
 
     // 记录连接统计信息
     qCDebug(lcClientHandlerWorker) << "连接统计 - 接收字节数:" << m_bytesReceived << "发送字节数:" << m_bytesSent;
+    if ( m_inputSimulator ) {
+        qCDebug(lcClientHandlerWorker) << "输入注入耗时:" << m_inputSimulator->injectionLatency().toString();
+    }
 
     // 发送 disconnected 信号,让 ClientHandler 处理后续的停止逻辑
     // 注意:不要在这里调用 stop(),因为会导致信号还未处理完Worker就停止了
@@ -599,13 +1073,7 @@ void ClientHandlerWorker::onDisconnected() {
         qCCritical(lcClientHandlerWorker) << "Worker线程:" << thread();
         emit disconnected();
         qCCritical(lcClientHandlerWorker) << "!!!!! disconnected 信号已发出 !!!!!";
-
-        // !!!!! 终极诊断:强制处理事件队列,看看信号是否在事件队列中 !!!!!
-        qCCritical(lcClientHandlerWorker) << "!!!!! 强制处理事件队列 !!!!!";
-        QCoreApplication::processEvents();
-        QThread::msleep(10); // 给接收线程时间处理
-        QCoreApplication::processEvents();
-        qCCritical(lcClientHandlerWorker) << "!!!!! 事件队列处理完成 !!!!!";
+        // 不在此处理事件或休眠：I/O线程由多个会话共享
     } else {
         qCDebug(lcClientHandlerWorker) << "disconnected 信号已发送过,跳过重复发送";
     }
@@ -670,7 +1138,15 @@ void ClientHandlerWorker::checkHeartbeat() {
     }
 }
 
-void ClientHandlerWorker::processMessage(const MessageHeader& header, const QByteArray& payload) {
+void ClientHandlerWorker::processMessage(const MessageHeader& header, const QByteArray& payload, qint64 receivedAtMs) {
+    // 输入通常紧接着画面变化：让空闲降频的捕获线程立即恢复全帧率
+    if ( header.type == MessageType::MOUSE_EVENT || header.type == MessageType::KEYBOARD_EVENT
+         || header.type == MessageType::INPUT_BATCH ) {
+        for ( const ScreenStream& stream : std::as_const(m_streams) ) {
+            stream.queueManager->noteInputActivity();
+        }
+    }
+
     switch ( header.type ) {
         case MessageType::HANDSHAKE_REQUEST:
             handleHandshakeRequest(payload);
@@ -679,7 +1155,7 @@ void ClientHandlerWorker::processMessage(const MessageHeader& header, const QByt
             handleAuthenticationRequest(payload);
             break;
         case MessageType::HEARTBEAT_RESPONSE:
-            handleHeartbeat();
+            handleHeartbeat(payload, receivedAtMs);
             break;
         case MessageType::MOUSE_EVENT:
             handleMouseEvent(payload);
@@ -687,9 +1163,15 @@ void ClientHandlerWorker::processMessage(const MessageHeader& header, const QByt
         case MessageType::KEYBOARD_EVENT:
             handleKeyboardEvent(payload);
             break;
+        case MessageType::INPUT_BATCH:
+            handleInputBatch(payload);
+            break;
         case MessageType::CLIPBOARD_DATA:
             handleClipboardData(payload);
             break;
+        case MessageType::MONITOR_SELECT:
+            handleMonitorSelect(payload);
+            break;
         default:
             qCWarning(lcClientHandlerWorker) << "未知消息类型:" << static_cast<int>(header.type);
             break;
@@ -697,9 +1179,25 @@ void ClientHandlerWorker::processMessage(const MessageHeader& header, const QByt
 }
 
 void ClientHandlerWorker::handleHandshakeRequest(const QByteArray& data) {
-    Q_UNUSED(data)
-        qCDebug(lcClientHandlerWorker) << "处理握手请求";
-    sendHandshakeResponse();
+    qCDebug(lcClientHandlerWorker) << "处理握手请求";
+
+    HandshakeRequest request;
+    if ( !request.decode(data) ) {
+        // 解析失败时按旧版本客户端处理（不启用任何协商能力）
+        qCWarning(lcClientHandlerWorker) << "握手请求解析失败，按旧版本客户端处理";
+        request.capabilities = CapabilitySet();
+    }
+
+    // 保留双方共同支持的能力，参数取客户端声明值（发送时需遵守客户端的限制）
+    CapabilitySet peerCapabilities = request.capabilities.intersected(CapabilitySet::local());
+    {
+        QMutexLocker locker(&m_clientInfoMutex);
+        m_peerCapabilities = peerCapabilities;
+    }
+    qCDebug(lcClientHandlerWorker) << "客户端能力版本:" << request.capabilities.version
+        << "共同能力数:" << peerCapabilities.entries.size();
+
+    sendHandshakeResponse(request.capabilities);
 }
 
 void ClientHandlerWorker::handleAuthenticationRequest(const QByteArray& data) {
@@ -752,10 +1250,18 @@ void ClientHandlerWorker::handleAuthenticationRequest(const QByteArray& data) {
         sendAuthenticationResponse(AuthResult::SUCCESS, sessionId);
 
         // 启动光标位置更新定时器
-        if ( m_cursorUpdateTimer ) {
-            m_cursorUpdateTimer->start();
+        m_cursorStateSent = false;
+        if ( m_timerWheel && m_cursorUpdateTimer == 0 ) {
+            m_cursorUpdateTimer = m_timerWheel->schedule(NetworkConstants::CURSOR_POLL_INTERVAL_MS,
+                [this]() { sendCursorState(); });
         }
 
+        // 立即开始时钟同步交换
+        m_clockSyncExchanges = 0;
+        m_clockSync.reset();
+        sendHeartbeat();
+        sendMonitorLayout();
+
         emit authenticated();
         qCInfo(lcClientHandlerWorker) << "客户端认证成功: " << clientId();
         return;
@@ -781,10 +1287,18 @@ void ClientHandlerWorker::handleAuthenticationRequest(const QByteArray& data) {
                 sendAuthenticationResponse(AuthResult::SUCCESS, sessionId);
 
                 // 启动光标位置更新定时器
-                if ( m_cursorUpdateTimer ) {
-                    m_cursorUpdateTimer->start();
+                m_cursorStateSent = false;
+                if ( m_timerWheel && m_cursorUpdateTimer == 0 ) {
+                    m_cursorUpdateTimer = m_timerWheel->schedule(NetworkConstants::CURSOR_POLL_INTERVAL_MS,
+                        [this]() { sendCursorState(); });
                 }
 
+                // 立即开始时钟同步交换
+                m_clockSyncExchanges = 0;
+                m_clockSync.reset();
+                sendHeartbeat();
+                sendMonitorLayout();
+
                 emit authenticated();
                 qCInfo(lcClientHandlerWorker) << "客户端认证成功: " << clientId();
             } else {
@@ -815,10 +1329,27 @@ void ClientHandlerWorker::handleAuthenticationRequest(const QByteArray& data) {
     }
 }
 
-void ClientHandlerWorker::handleHeartbeat() {
+void ClientHandlerWorker::handleHeartbeat(const QByteArray& data, qint64 receivedAtMs) {
     // 收到客户端的心跳响应，更新最后心跳时间
     m_lastHeartbeat = QDateTime::currentDateTime();
     qCDebug(lcClientHandlerWorker) << "收到客户端心跳响应:" << clientId();
+
+    // 旧版客户端回复空载荷，不参与时钟同步
+    HeartbeatMessage heartbeat;
+    if ( !heartbeat.decode(data) ) {
+        return;
+    }
+
+    if ( m_clockSync.processIncoming(heartbeat, static_cast<quint64>(receivedAtMs)) ) {
+        ClockSyncEstimate estimate = m_clockSync.estimate();
+        qCDebug(lcClientHandlerWorker) << "时钟同步估计 offset:" << estimate.offsetMs
+            << "ms rtt:" << estimate.rttMs << "ms 样本数:" << estimate.sampleCount;
+
+        // 认证后的预热阶段连续交换几次，使客户端尽快获得可用的偏移估计
+        if ( ++m_clockSyncExchanges < NetworkConstants::CLOCK_SYNC_WARMUP_EXCHANGES ) {
+            sendHeartbeat();
+        }
+    }
 }
 
 void ClientHandlerWorker::sendHeartbeat() {
@@ -832,7 +1363,13 @@ void ClientHandlerWorker::sendHeartbeat() {
         return;
     }
 
-    sendMessage(MessageType::HEARTBEAT, BaseMessage());
+    // 协商了时钟同步时心跳携带时间戳，客户端据此估计时钟偏移
+    if ( peerCapabilities().has(Capability::CLOCK_SYNC) ) {
+        sendMessage(MessageType::HEARTBEAT,
+            m_clockSync.prepareOutgoing(static_cast<quint64>(QDateTime::currentMSecsSinceEpoch())));
+    } else {
+        sendMessage(MessageType::HEARTBEAT, BaseMessage());
+    }
 
     qCDebug(lcClientHandlerWorker) << "发送心跳请求到客户端:" << clientId();
 }
@@ -854,67 +1391,77 @@ void ClientHandlerWorker::handleMouseEvent(const QByteArray& data) {
         return;
     }
 
-    QDataStream stream(data);
-    stream.setByteOrder(QDataStream::LittleEndian);
-
-    quint8 eventType;
-    qint16 x, y;
-    qint16 wheelDelta;
-
-    stream >> eventType >> x >> y >> wheelDelta;
-
-    // 检查数据流状态
-    if ( stream.status() != QDataStream::Ok ) {
+    MouseEvent mouseEvent;
+    if ( !mouseEvent.decode(data) ) {
         qCWarning(lcClientHandlerWorker) << "鼠标事件数据解析失败";
         return;
     }
 
-    // 根据 eventType 处理不同的鼠标事件
-    MouseEventType mouseEventType = static_cast<MouseEventType>(eventType);
+    QList<InputInjection> injections;
+    appendMouseInjection(mouseEvent, injections);
+    m_inputSimulator->injectBatch(injections);
+}
+
+void ClientHandlerWorker::appendMouseInjection(const MouseEvent& mouseEvent, QList<InputInjection>& injections) const {
+    InputInjection injection;
+    injection.x = mouseEvent.x + m_sourceOrigin.x();
+    injection.y = mouseEvent.y + m_sourceOrigin.y();
 
-    switch ( mouseEventType ) {
+    // 根据 eventType 处理不同的鼠标事件
+    switch ( mouseEvent.eventType ) {
         case MouseEventType::MOVE:
-            // 处理鼠标移动
-            m_inputSimulator->simulateMouseMove(x, y);
+            injection.type = InputInjection::Type::MouseMove;
             break;
         case MouseEventType::LEFT_PRESS:
-            m_inputSimulator->simulateMousePress(x, y, Qt::LeftButton);
-            break;
-        case MouseEventType::LEFT_RELEASE:
-            m_inputSimulator->simulateMouseRelease(x, y, Qt::LeftButton);
-            break;
         case MouseEventType::RIGHT_PRESS:
-            m_inputSimulator->simulateMousePress(x, y, Qt::RightButton);
-            break;
-        case MouseEventType::RIGHT_RELEASE:
-            m_inputSimulator->simulateMouseRelease(x, y, Qt::RightButton);
-            break;
         case MouseEventType::MIDDLE_PRESS:
-            m_inputSimulator->simulateMousePress(x, y, Qt::MiddleButton);
+            injection.type = InputInjection::Type::MousePress;
             break;
+        case MouseEventType::LEFT_RELEASE:
+        case MouseEventType::RIGHT_RELEASE:
         case MouseEventType::MIDDLE_RELEASE:
-            m_inputSimulator->simulateMouseRelease(x, y, Qt::MiddleButton);
+            injection.type = InputInjection::Type::MouseRelease;
             break;
         case MouseEventType::LEFT_DOUBLE_CLICK:
-            m_inputSimulator->simulateMouseDoubleClick(x, y, Qt::LeftButton);
-            break;
         case MouseEventType::RIGHT_DOUBLE_CLICK:
-            m_inputSimulator->simulateMouseDoubleClick(x, y, Qt::RightButton);
-            break;
         case MouseEventType::MIDDLE_DOUBLE_CLICK:
-            m_inputSimulator->simulateMouseDoubleClick(x, y, Qt::MiddleButton);
+            injection.type = InputInjection::Type::MouseDoubleClick;
             break;
         case MouseEventType::WHEEL_UP:
         case MouseEventType::WHEEL_DOWN:
             // 处理滚轮事件
-            if ( wheelDelta != 0 ) {
-                m_inputSimulator->simulateMouseWheel(x, y, wheelDelta);
+            if ( mouseEvent.wheelDelta == 0 ) {
+                return;
             }
+            injection.type = InputInjection::Type::MouseWheel;
+            injection.wheelDelta = mouseEvent.wheelDelta;
+            break;
+        default:
+            qCWarning(lcClientHandlerWorker) << "未知的鼠标事件类型: " << static_cast<int>(mouseEvent.eventType);
+            return;
+    }
+
+    switch ( mouseEvent.eventType ) {
+        case MouseEventType::LEFT_PRESS:
+        case MouseEventType::LEFT_RELEASE:
+        case MouseEventType::LEFT_DOUBLE_CLICK:
+            injection.button = Qt::LeftButton;
+            break;
+        case MouseEventType::RIGHT_PRESS:
+        case MouseEventType::RIGHT_RELEASE:
+        case MouseEventType::RIGHT_DOUBLE_CLICK:
+            injection.button = Qt::RightButton;
+            break;
+        case MouseEventType::MIDDLE_PRESS:
+        case MouseEventType::MIDDLE_RELEASE:
+        case MouseEventType::MIDDLE_DOUBLE_CLICK:
+            injection.button = Qt::MiddleButton;
             break;
         default:
-            qCWarning(lcClientHandlerWorker) << "未知的鼠标事件类型: " << static_cast<int>(eventType);
             break;
     }
+
+    injections.append(injection);
 }
 
 void ClientHandlerWorker::handleKeyboardEvent(const QByteArray& data) {
@@ -941,6 +1488,12 @@ void ClientHandlerWorker::handleKeyboardEvent(const QByteArray& data) {
         return;
     }
 
+    QList<InputInjection> injections;
+    appendKeyboardInjection(keyEvent, injections);
+    m_inputSimulator->injectBatch(injections);
+}
+
+void ClientHandlerWorker::appendKeyboardInjection(const KeyboardEvent& keyEvent, QList<InputInjection>& injections) {
     qCDebug(lcClientHandlerWorker) << "键盘事件: eventType=" << static_cast<int>(keyEvent.eventType)
         << "keyCode=" << keyEvent.keyCode << "modifiers=" << keyEvent.modifiers
         << "text=" << keyEvent.text;
@@ -950,31 +1503,67 @@ void ClientHandlerWorker::handleKeyboardEvent(const QByteArray& data) {
     // modifiers() 返回修饰符标志（包含 KeypadModifier: 0x20000000）
     // 我们需要组合它们以便正确识别小键盘按键
 
-    int qtKey = static_cast<int>(keyEvent.keyCode);
-    Qt::KeyboardModifiers qtModifiers = static_cast<Qt::KeyboardModifiers>(keyEvent.modifiers);
+    InputInjection injection;
+    injection.key = static_cast<int>(keyEvent.keyCode);
+    injection.modifiers = static_cast<Qt::KeyboardModifiers>(keyEvent.modifiers);
 
     // 如果 modifiers 包含 KeypadModifier，将其添加到 key 值中
-    if ( qtModifiers & Qt::KeypadModifier ) {
-        qtKey |= 0x20000000;  // 添加 KeypadModifier 标志
-        qCDebug(lcClientHandlerWorker) << "Keypad modifier detected, combined key:" << Qt::hex << qtKey;
+    if ( injection.modifiers & Qt::KeypadModifier ) {
+        injection.key |= 0x20000000;  // 添加 KeypadModifier 标志
+        qCDebug(lcClientHandlerWorker) << "Keypad modifier detected, combined key:" << Qt::hex << injection.key;
     }
 
     if ( keyEvent.eventType == KeyboardEventType::KEY_PRESS ) {
-        m_inputSimulator->simulateKeyPress(qtKey, qtModifiers);
+        injection.type = InputInjection::Type::KeyPress;
     } else if ( keyEvent.eventType == KeyboardEventType::KEY_RELEASE ) {
-        m_inputSimulator->simulateKeyRelease(qtKey, qtModifiers);
+        injection.type = InputInjection::Type::KeyRelease;
     } else {
         qCWarning(lcClientHandlerWorker) << "未知的键盘事件类型: " << static_cast<int>(keyEvent.eventType);
+        return;
     }
+
+    injections.append(injection);
 }
 
-void ClientHandlerWorker::sendHandshakeResponse() {
+void ClientHandlerWorker::handleInputBatch(const QByteArray& data) {
+    if ( !isAuthenticated() ) {
+        qCWarning(lcClientHandlerWorker) << "未认证客户端尝试发送批量输入事件";
+        return;
+    }
+
+    if ( !m_inputSimulator ) {
+        qCWarning(lcClientHandlerWorker) << "输入模拟器未初始化";
+        return;
+    }
+
+    InputBatch batch;
+    if ( !batch.decode(data) ) {
+        qCWarning(lcClientHandlerWorker) << "批量输入事件解析失败";
+        return;
+    }
+
+    // 按原顺序排入注入队列，整批只提交一次
+    QList<InputInjection> injections;
+    injections.reserve(batch.events.size());
+    for ( const InputBatchEvent& event : batch.events ) {
+        if ( event.kind == InputBatchEvent::Kind::KEYBOARD ) {
+            appendKeyboardInjection(event.keyboard, injections);
+        } else {
+            appendMouseInjection(event.mouse, injections);
+        }
+    }
+    if ( !m_inputSimulator->injectBatch(injections) ) {
+        qCDebug(lcClientHandlerWorker) << "批量输入注入部分失败:" << m_inputSimulator->lastError();
+    }
+}
+
+void ClientHandlerWorker::sendHandshakeResponse(const CapabilitySet& clientCapabilities) {
     HandshakeResponse response;
     response.serverVersion = PROTOCOL_VERSION;
     response.screenWidth = 1920; // 默认屏幕宽度
     response.screenHeight = 1080; // 默认屏幕高度
     response.colorDepth = 32; // 32位色深
-    response.supportedFeatures = 0; // 可以根据需要设置服务器特性
+    response.supportedFeatures = 0; // 已废弃，能力通过 capabilities 协商
     response.serverName = QStringLiteral("QtRemoteDesktop Server");
 #ifdef Q_OS_WIN
     response.serverOS = QStringLiteral("Windows");
@@ -983,9 +1572,48 @@ void ClientHandlerWorker::sendHandshakeResponse() {
 #else
     response.serverOS = QStringLiteral("Linux");
 #endif
+    // 回复共同能力（参数取服务端取值）；旧版本客户端未声明能力，回复为空
+    response.capabilities = CapabilitySet::local().intersected(clientCapabilities);
+
+    // 校验算法：响应中回复选定的算法而非掩码
+    ChecksumAlgorithm checksumAlgorithm = ChecksumAlgorithm::CRC32;
+    if ( response.capabilities.has(Capability::CHECKSUM) ) {
+        const bool encrypted = m_socket && m_socket->isEncrypted();
+        checksumAlgorithm = Checksum::choose(Checksum::supportedMask(encrypted),
+            clientCapabilities.uint32Param(Capability::CHECKSUM));
+        response.capabilities.setUInt32(Capability::CHECKSUM, static_cast<quint32>(checksumAlgorithm));
+    }
+
+    // 光标图像缓存：容量取双方较小值，两端 LRU 才能同步淘汰
+    quint32 cursorShapeCacheSize = 0;
+    if ( response.capabilities.has(Capability::CURSOR_SHAPE) ) {
+        cursorShapeCacheSize = std::min(response.capabilities.uint32Param(Capability::CURSOR_SHAPE),
+            clientCapabilities.uint32Param(Capability::CURSOR_SHAPE));
+        response.capabilities.setUInt32(Capability::CURSOR_SHAPE, cursorShapeCacheSize);
+    }
+    // 重复握手（恢复会话）时保留已有条目：容量不变则客户端缓存仍与镜像一致
+    m_cursorShapeIds.setCapacity(cursorShapeCacheSize);
+
+    // 图块缓存：同样取双方较小值；容量变化时镜像清空，客户端缓存同样清空
+    quint32 tileCacheSize = 0;
+    if ( response.capabilities.has(Capability::TILE_CACHE) ) {
+        tileCacheSize = std::min(response.capabilities.uint32Param(Capability::TILE_CACHE),
+            clientCapabilities.uint32Param(Capability::TILE_CACHE));
+        response.capabilities.setUInt32(Capability::TILE_CACHE, tileCacheSize);
+    }
+    discardTilePlan();
+    m_tileMirror.setCapacity(tileCacheSize);
+    m_tileMirror.setCopyRectEnabled(response.capabilities.has(Capability::COPY_RECT));
+    updateTileHashConsumers();
 
+    // 握手响应本身仍使用 CRC32，之后的收发切换到协商算法
     sendMessage(MessageType::HANDSHAKE_RESPONSE, response);
-    qCDebug(lcClientHandlerWorker) << "发送握手响应";
+    m_checksumAlgorithm.store(checksumAlgorithm, std::memory_order_relaxed);
+    m_sendQueue.setChecksumAlgorithm(checksumAlgorithm);
+    // 对端声明支持分片后，大消息按 FRAGMENT_SIZE 切分，交互消息可插在分片之间
+    m_sendQueue.setFragmentSize(response.capabilities.has(Capability::FRAGMENTATION)
+        ? NetworkConstants::FRAGMENT_SIZE : 0);
+    qCDebug(lcClientHandlerWorker) << "发送握手响应，校验算法:" << Checksum::algorithmName(checksumAlgorithm);
 }
 
 void ClientHandlerWorker::sendAuthenticationResponse(AuthResult result, const QString& sessionId) {
@@ -1042,6 +1670,23 @@ QString ClientHandlerWorker::generateSessionId() const {
 
 // ==================== 剪贴板消息处理 ====================
 
+void ClientHandlerWorker::handleMonitorSelect(const QByteArray& data) {
+    if ( !isAuthenticated() ) {
+        qCWarning(lcClientHandlerWorker) << "未认证客户端尝试选择显示器";
+        return;
+    }
+    MonitorSelect select;
+    if ( !select.decode(data) ) {
+        qCWarning(lcClientHandlerWorker) << "显示器选择消息解析失败";
+        return;
+    }
+    if ( !selectMonitors(select.monitorIds) ) {
+        // 全部是未知ID：保持当前视图，重发布局让客户端与实际视图一致
+        qCWarning(lcClientHandlerWorker) << "客户端" << clientId() << "选择了无效的显示器:" << select.monitorIds;
+        sendMonitorLayout();
+    }
+}
+
 void ClientHandlerWorker::handleClipboardData(const QByteArray& data) {
     ClipboardMessage message;
     if ( !message.decode(data) ) {
@@ -1058,6 +1703,11 @@ void ClientHandlerWorker::handleClipboardData(const QByteArray& data) {
         // 广播到其他客户端（通过 ServerManager）
         emit broadcastClipboardText(message.text());
     } else if ( message.isImage() ) {
+        // 图片剪贴板需要协商 CLIPBOARD_IMAGE
+        if ( !peerCapabilities().has(Capability::CLIPBOARD_IMAGE) ) {
+            qCWarning(lcClientHandlerWorker) << "客户端未协商图片剪贴板，忽略剪贴板图片";
+            return;
+        }
         qCDebug(lcClientHandlerWorker) << "接收到剪贴板图片，尺寸:" << message.width << "x" << message.height
             << ", 数据大小:" << message.imageData().size();
 
@@ -1,9 +1,19 @@
 #pragma once
 
 #include "../../common/core/threading/Worker.h"
+#include "../../common/core/threading/TimerWheel.h"
 #include "../../common/core/network/Protocol.h"
+#include "../../common/core/network/ClockSynchronizer.h"
+#include "../../common/core/network/ReceiveBuffer.h"
+#include "../../common/core/network/PrioritySendQueue.h"
+#include "../../common/core/network/FragmentAssembler.h"
+#include "../../common/core/cache/ContentHash.h"
+#include "../../common/core/cache/LruCache.h"
+#include "TileCacheMirror.h"
+#include "SimulcastLayerSelector.h"
 #include <QtCore/QObject>
 #include <QtCore/QDateTime>
+#include <QtCore/QFuture>
 #include <QtCore/QMutex>
 #include <QtCore/QTimer>
 #include <QtNetwork/QAbstractSocket>
@@ -12,8 +22,19 @@
 #include <QtNetwork/QSslKey>
 
 class InputSimulator;
+struct InputInjection;
+struct CursorImage;
 class IMessageCodec;
 class QueueManager;
+struct ProcessedData;
+
+/**
+ * @brief 会话可查看的一个显示器及其捕获/编码流水线
+ */
+struct MonitorPipeline {
+    MonitorInfo monitor;                    ///< 显示器ID、几何与 PRIMARY 标志（VIEWED 由会话填写）
+    QueueManager* queueManager = nullptr;   ///< 该显示器的流水线
+};
 
 /**
  * @brief 客户端处理工作线程类
@@ -22,6 +43,11 @@ class QueueManager;
  * 支持认证、心跳检测、输入事件处理等功能。
  * 设计为单连接模式，每个实例只处理一个客户端连接。
  * 认证成功后自动从处理队列拉取并发送屏幕数据。
+ * 多显示器时每个显示器有独立的流水线，会话只读取客户端选择查看的那些（MONITOR_SELECT），
+ * 查看多个显示器时各自的帧以 ScreenData 的 x,y 标明位置，由客户端拼合。
+ *
+ * 会话是事件驱动的 Worker：多个会话共享 IoThreadPool 的 I/O 线程，由套接字信号、
+ * 处理队列的新帧通知和所在线程的 TimerWheel（心跳、光标轮询）驱动，没有独立的工作循环。
  */
 class ClientHandlerWorker : public Worker {
     Q_OBJECT
@@ -55,6 +81,11 @@ public:
     bool isConnected() const;
     bool isAuthenticated() const;
 
+    /**
+     * @brief 获取握手协商得到的共同能力（参数为客户端声明的取值，线程安全）
+     */
+    CapabilitySet peerCapabilities() const;
+
     // 统计信息获取方法（线程安全）
     quint64 bytesReceived() const;
     quint64 bytesSent() const;
@@ -67,6 +98,20 @@ public:
      */
     Q_INVOKABLE void setExpectedPasswordDigest(const QByteArray& salt, const QByteArray& digest);
 
+    /**
+     * @brief 设置会话读取编码帧的流水线（须在线程启动前调用）
+     * @param queueManager 队列管理器，为空时 initialize() 使用 QueueManager::instance()
+     */
+    void setQueueManager(QueueManager* queueManager);
+
+    /**
+     * @brief 设置可查看的显示器（须在线程启动前调用）
+     *
+     * 第一个为默认查看的主显示器。未设置时只有 setQueueManager() 的一条流水线，不发送显示器布局。
+     * @param monitors 各显示器的布局与流水线
+     */
+    void setMonitorPipelines(const QList<MonitorPipeline>& monitors);
+
     /**
      * @brief 设置PBKDF2参数
      * @param iterations 迭代次数
@@ -108,6 +153,12 @@ signals:
      */
     void authenticated();
 
+    /**
+     * @brief 本会话查看的显示器变化信号（ServerManager 据此只捕获有人查看的显示器）
+     * @param monitorIds 正在查看的显示器ID
+     */
+    void monitorSelectionChanged(const QList<quint8>& monitorIds);
+
     /**
      * @brief 接收到消息信号
      * @param type 消息类型
@@ -160,7 +211,9 @@ protected:
     void cleanup() override;
 
     /**
-     * @brief 处理任务（主要处理网络事件）
+     * @brief 处理任务：检查连接状态并发送新帧
+     *
+     * 事件驱动，在处理队列发布本会话所订阅层的新帧时调用。
      */
     void processTask() override;
 
@@ -196,8 +249,9 @@ private:
      * @brief 处理接收到的消息
      * @param header 消息头
      * @param payload 消息载荷
+     * @param receivedAtMs 消息到达时间（本地时钟，毫秒）
      */
-    void processMessage(const MessageHeader& header, const QByteArray& payload);
+    void processMessage(const MessageHeader& header, const QByteArray& payload, qint64 receivedAtMs);
 
     /**
      * @brief 处理握手请求
@@ -212,9 +266,11 @@ private:
     void handleAuthenticationRequest(const QByteArray& data);
 
     /**
-     * @brief 处理心跳包
+     * @brief 处理心跳响应，更新时钟偏移/RTT估计
+     * @param data 心跳响应数据（旧版客户端为空）
+     * @param receivedAtMs 响应到达时间（本地时钟，毫秒）
      */
-    void handleHeartbeat();
+    void handleHeartbeat(const QByteArray& data, qint64 receivedAtMs);
 
     /**
      * @brief 处理鼠标事件
@@ -228,16 +284,68 @@ private:
      */
     void handleKeyboardEvent(const QByteArray& data);
 
+    /**
+     * @brief 处理批量输入事件，按原顺序重放
+     * @param data InputBatch 数据
+     */
+    void handleInputBatch(const QByteArray& data);
+
+    /**
+     * @brief 把已解码的鼠标事件转换为注入事件追加到 injections
+     */
+    void appendMouseInjection(const MouseEvent& mouseEvent, QList<InputInjection>& injections) const;
+
+    /**
+     * @brief 把已解码的键盘事件转换为注入事件追加到 injections
+     */
+    static void appendKeyboardInjection(const KeyboardEvent& keyEvent, QList<InputInjection>& injections);
+
     /**
      * @brief 处理剪贴板消息
      * @param data 剪贴板数据
      */
     void handleClipboardData(const QByteArray& data);
 
+    /**
+     * @brief 处理客户端的显示器选择，切换查看的显示器
+     * @param data MonitorSelect 数据
+     */
+    void handleMonitorSelect(const QByteArray& data);
+
+    /**
+     * @brief 发送光标图像：客户端缓存中已有时只发送缓存ID
+     */
+    void sendCursorShape(const CursorImage& image);
+
+    /**
+     * @brief 分段写出消息（scatter-gather），图像等大块数据不先拼接到连续缓冲区
+     * @param segments 已编码的消息分段
+     */
+    void sendMessageSegments(const MessageSegments& segments);
+
+    /**
+     * @brief 按优先级写出发送队列（入队后及套接字 bytesWritten 时调用）
+     */
+    void flushSendQueue();
+
+    /**
+     * @brief 发送队列的写出函数
+     * @return 写入字节数，失败返回 -1
+     */
+    qint64 writeToSocket(const char* data, qint64 length);
+
+    /**
+     * @brief 处理 FRAGMENT 消息，重组完成后按普通消息分发
+     * @param payload 分片消息载荷
+     * @param receivedAtMs 分片到达时间（本地时钟，毫秒）
+     */
+    void handleFragment(QByteArrayView payload, qint64 receivedAtMs);
+
     /**
      * @brief 发送握手响应
+     * @param clientCapabilities 客户端声明的能力，响应中回复双方共同支持的部分
      */
-    void sendHandshakeResponse();
+    void sendHandshakeResponse(const CapabilitySet& clientCapabilities);
 
     /**
      * @brief 发送认证响应
@@ -259,14 +367,89 @@ private:
 
     /**
      * @brief 从处理队列发送屏幕数据
-     * 认证成功后在processTask中异步调用，自动拉取并发送屏幕数据
+     * 认证成功后由processTask在新帧到达时调用，拉取并发送屏幕数据
      */
     Q_INVOKABLE void sendScreenDataFromQueue();
+
+    struct ScreenStream;
+
+    /**
+     * @brief 读取并发送一个显示器的一帧新帧
+     * @param stream 查看中的显示器
+     * @param multiView 是否同时查看多个显示器（此时不使用图块缓存）
+     * @return 发送了一帧（或交给图块规划）时返回 true；没有新帧时返回 false
+     */
+    bool sendStreamFrame(ScreenStream& stream, bool multiView);
+
+    /**
+     * @brief 批量通道待发帧是否已达上限（背压）
+     */
+    bool bulkLaneFull() const;
+
+    /**
+     * @brief 在线程池中规划图块发送，完成后回到本线程发送并继续读取新帧
+     * @param processedData 要发送的帧（图像数据已按对端能力处理）
+     * @param offset 帧在客户端画面中的位置
+     */
+    void startTilePlan(const ProcessedData& processedData, const QPoint& offset);
+
+    /**
+     * @brief 等待进行中的图块规划结束并作废其结果，镜像随之清空（在本线程修改镜像之前调用）
+     */
+    void discardTilePlan();
+
+    /**
+     * @brief 发送一帧：整帧 SCREEN_DATA（规划为整帧时）及其后的图块更新
+     * @param processedData 要发送的帧
+     * @param offset 帧在客户端画面中的位置
+     * @param tilePlan 图块规划结果（未使用图块缓存时为 FullFrame）
+     * @param tileUpdate 图块记录（可能为空）
+     */
+    void sendScreenFrame(const ProcessedData& processedData, const QPoint& offset,
+                         TileCacheMirror::Plan tilePlan, TileUpdate& tileUpdate);
+
+    /**
+     * @brief 注销本会话在各处理队列中的读者（断开、清理或切换显示器时调用）
+     */
+    void releaseProcessedReaders();
+
+    /**
+     * @brief 按图块缓存是否可用登记或注销各流水线的图块哈希需求
+     */
+    void updateTileHashConsumers();
+
+    /**
+     * @brief 切换查看的显示器并立即订阅其流水线
+     * @param monitorIds 要查看的显示器ID（未知ID忽略）
+     * @return 是否至少包含一个有效显示器
+     */
+    bool selectMonitors(const QList<quint8>& monitorIds);
+
+    /**
+     * @brief 发送显示器布局（对端支持 MULTI_MONITOR 且布局有效时）
+     */
+    void sendMonitorLayout();
+
+    /**
+     * @brief 取消定时轮上的定时器并清零ID
+     */
+    void cancelTimer(TimerWheel::TimerId& timer);
+
+    /**
+     * @brief 改为订阅另一个同播层
+     * @param stream 查看中的显示器
+     * @param layer 新的层
+     * @param lastFrameId 在旧层最后读取的帧ID
+     */
+    void switchProcessedLayer(ScreenStream& stream, int layer, quint64 lastFrameId);
     
     /**
-     * @brief 发送光标类型到客户端
+     * @brief 轮询指针状态，变化时发送给客户端
+     *
+     * 对端支持 CURSOR_STREAM 时发送 CURSOR_STATE（坐标+类型），
+     * 否则只在类型变化时发送旧版 CURSOR_POSITION（仅类型）。
      */
-    Q_INVOKABLE void sendCursorType();
+    Q_INVOKABLE void sendCursorState();
 
 private:
     // 网络相关
@@ -276,7 +459,10 @@ private:
     // TLS证书和密钥
     QSslCertificate m_sslCertificate;     ///< TLS证书
     QSslKey m_sslPrivateKey;              ///< TLS私钥
-    QByteArray m_receiveBuffer;           ///< 接收缓冲区
+    ReceiveBuffer m_receiveBuffer;        ///< 接收缓冲区（读游标式，避免逐消息搬移）
+    std::atomic<ChecksumAlgorithm> m_checksumAlgorithm{ ChecksumAlgorithm::CRC32 }; ///< 协商的校验算法（发送握手响应后生效）
+    PrioritySendQueue m_sendQueue;        ///< 交互/批量两通道发送队列
+    FragmentAssembler m_fragmentAssembler; ///< 接收分片重组
 
     // 客户端信息（线程安全访问需要互斥锁）
     mutable QMutex m_clientInfoMutex;     ///< 客户端信息互斥锁
@@ -284,6 +470,7 @@ private:
     quint16 m_clientPort;                 ///< 客户端端口
     QString m_clientId;                   ///< 客户端ID
     bool m_isAuthenticated;               ///< 是否已认证
+    CapabilitySet m_peerCapabilities;     ///< 协商后的共同能力（旧版本客户端为空）
 
     // 认证相关
     QByteArray m_expectedSalt;            ///< 期望的密码盐值
@@ -301,11 +488,40 @@ private:
     // 时间和心跳
     QDateTime m_connectionTime;           ///< 连接时间
     QDateTime m_lastHeartbeat;            ///< 最后心跳时间
-    QTimer* m_heartbeatSendTimer;         ///< 心跳发送定时器
-    QTimer* m_heartbeatCheckTimer;        ///< 心跳检查定时器
+    TimerWheel* m_timerWheel;             ///< 所在I/O线程的定时轮（initialize 时获取）
+    TimerWheel::TimerId m_heartbeatSendTimer;    ///< 心跳发送定时器（0表示未调度）
+    TimerWheel::TimerId m_heartbeatCheckTimer;   ///< 心跳检查定时器（0表示未调度）
+    ClockSynchronizer m_clockSync;        ///< 基于心跳时间戳的时钟偏移/RTT估计
+    int m_clockSyncExchanges;             ///< 已完成的时钟同步交换次数
     
+    // 客户端画面对应的屏幕区域：客户端坐标 + 原点 = 屏幕坐标（只共享部分区域或单个窗口时不为零）
+    QPoint m_sourceOrigin;                ///< 最近发送帧的原点（全局逻辑坐标）
+
     // 光标位置发送
-    QTimer* m_cursorUpdateTimer;          ///< 光标位置更新定时器
+    TimerWheel::TimerId m_cursorUpdateTimer;     ///< 光标位置更新定时器（0表示未调度）
+    CursorState m_lastCursorState;        ///< 最近一次发送的光标状态
+    bool m_cursorStateSent;               ///< 本次认证后是否已发送过光标状态
+
+    // 光标图像缓存镜像：内容哈希 -> 缓存ID，与客户端 LRU 同容量、同顺序
+    LruCache<ContentHash, quint32> m_cursorShapeIds;
+    quint32 m_nextCursorShapeId;          ///< 下一个分配的缓存ID（从1开始）
+    bool m_cursorShapeActive;             ///< 已发送过光标图像，状态消息使用 BitmapCursor
+
+    // 图块缓存镜像：客户端持有的图块（容量为 0 表示对端不支持，只发送整帧）
+    TileCacheMirror m_tileMirror;
+
+    /**
+     * @brief 线程池中图块规划的结果
+     */
+    struct TilePlanResult {
+        TileCacheMirror::Plan plan = TileCacheMirror::Plan::FullFrame;
+        TileUpdate update;
+    };
+    QFuture<TilePlanResult> m_tilePlan;   ///< 进行中的图块规划（期间镜像归任务独占）
+    bool m_tilePlanPending;               ///< 规划结果尚未在本线程处理
+    quint64 m_tilePlanGeneration;         ///< discardTilePlan() 的调用次数，规划开始后变化则结果作废
+    bool m_sendingScreenData;             ///< 正在 sendScreenDataFromQueue() 中（防止经写出回调重入）
+    qsizetype m_nextStream;               ///< 下次 sendScreenDataFromQueue() 最先发送的显示器（轮换）
 
     // 连接状态（线程安全，用于跨线程查询替代直接访问 QSslSocket::state()）
     std::atomic<bool> m_isConnectedAtomic{ false };
@@ -321,12 +537,23 @@ private:
     // 输入模拟器
     InputSimulator* m_inputSimulator;     ///< 输入模拟器
 
-    // 屏幕数据发送相关
-    QueueManager* m_queueManager;         ///< 队列管理器
+    /**
+     * @brief 本会话对一个显示器流水线的订阅
+     */
+    struct ScreenStream {
+        quint8 monitorId = 0;                 ///< 显示器ID
+        QueueManager* queueManager = nullptr; ///< 该显示器的流水线
+        quint32 reader = 0;                   ///< 在处理队列广播环中的读者ID（0表示未注册）
+        int layer = 0;                        ///< 订阅的同播层
+        SimulcastLayerSelector layerSelector; ///< 按跳帧情况选择同播层
+        quint64 layerSwitchFrameId = 0;       ///< 切换层前最后读取的帧ID，新层中不晚于它的帧跳过（0表示未在切换）
+        bool tileHashes = false;              ///< 是否已在流水线登记图块哈希需求
+    };
 
-    // Guard flag to prevent event queue accumulation:
-    // processTask posts sendScreenDataFromQueue via QueuedConnection on each tick;
-    // without this flag, pending invocations pile up if the event loop is slow.
-    std::atomic<bool> m_sendScreenDataPending{ false };
+    // 屏幕数据发送相关
+    QueueManager* m_queueManager;         ///< 主显示器的队列管理器
+    QList<MonitorPipeline> m_monitors;    ///< 可查看的显示器（第一个为主显示器）
+    QList<ScreenStream> m_streams;        ///< 正在查看的显示器（按 m_monitors 顺序）
+    QRect m_viewedBounds;                 ///< 查看中的显示器的外接矩形（全局逻辑坐标）
 };
 
@@ -0,0 +1,153 @@
+#include "ScrollDetector.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include <QtCore/QHash>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr quint64 FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr quint64 FNV_PRIME = 1099511628211ULL;
+}
+
+std::optional<CopyRect> ScrollDetector::detect(const QImage& previous, const QImage& current, const QRect& region) {
+    if ( previous.isNull() || previous.size() != current.size() || previous.format() != current.format()
+        || current.depth() % 8 != 0 ) {
+        return std::nullopt;
+    }
+    const QRect area = region.intersected(current.rect());
+    if ( area.isEmpty() ) {
+        return std::nullopt;
+    }
+
+    if ( const std::optional<CopyRect> copy = detectAxis(previous, current, area, Qt::Vertical) ) {
+        return copy;
+    }
+    return detectAxis(previous, current, area, Qt::Horizontal);
+}
+
+QImage ScrollDetector::predict(const QImage& previous, const CopyRect& copy) {
+    QImage predicted = previous.copy();
+    if ( !previous.rect().contains(copy.sourceRect()) || !previous.rect().contains(copy.targetRect()) ) {
+        return predicted;
+    }
+    // 源取自 previous、写入副本，重叠区域不会互相覆盖
+    const int bytesPerPixel = previous.depth() / 8;
+    const qsizetype lineBytes = qsizetype(copy.width) * bytesPerPixel;
+    for ( int row = 0; row < copy.height; ++row ) {
+        std::memcpy(predicted.scanLine(copy.y + row) + qsizetype(copy.x) * bytesPerPixel,
+            previous.constScanLine(copy.srcY + row) + qsizetype(copy.srcX) * bytesPerPixel, lineBytes);
+    }
+    return predicted;
+}
+
+std::optional<CopyRect> ScrollDetector::detectAxis(const QImage& previous, const QImage& current,
+                                                   const QRect& area, Qt::Orientation direction) {
+    const bool vertical = direction == Qt::Vertical;
+    const int length = vertical ? area.height() : area.width();
+    const int minMatches = std::max(NetworkConstants::SCROLL_MIN_MATCH_LINES, length / 4);
+    if ( length < 2 * NetworkConstants::SCROLL_MIN_MATCH_LINES ) {
+        return std::nullopt;
+    }
+
+    const QList<quint64> before = lineHashes(previous, area, direction);
+    const QList<quint64> after = lineHashes(current, area, direction);
+
+    // 上一帧中只出现一次的行：内容 -> 位置；重复出现的记为 -1
+    QHash<quint64, int> unique;
+    unique.reserve(length);
+    for ( int i = 0; i < length; ++i ) {
+        const auto it = unique.find(before.at(i));
+        if ( it == unique.end() ) {
+            unique.insert(before.at(i), i);
+        } else {
+            it.value() = -1;
+        }
+    }
+
+    // 未移动的行不投票，否则静止的背景总会让位移 0 胜出
+    QHash<int, int> votes;
+    for ( int i = 0; i < length; ++i ) {
+        if ( after.at(i) == before.at(i) ) {
+            continue;
+        }
+        const auto it = unique.constFind(after.at(i));
+        if ( it != unique.constEnd() && it.value() >= 0 ) {
+            ++votes[i - it.value()];
+        }
+    }
+    int offset = 0;
+    int bestVotes = 0;
+    for ( auto it = votes.constBegin(); it != votes.constEnd(); ++it ) {
+        if ( it.value() > bestVotes ) {
+            offset = it.key();
+            bestVotes = it.value();
+        }
+    }
+    if ( bestVotes < minMatches ) {
+        return std::nullopt;
+    }
+
+    // 该位移下最长的连续匹配段
+    int runStart = 0;
+    int bestStart = 0;
+    int bestLength = 0;
+    for ( int i = 0; i <= length; ++i ) {
+        const bool matches = i < length && i - offset >= 0 && i - offset < length
+            && after.at(i) == before.at(i - offset);
+        if ( !matches ) {
+            if ( i - runStart > bestLength ) {
+                bestStart = runStart;
+                bestLength = i - runStart;
+            }
+            runStart = i + 1;
+        }
+    }
+    if ( bestLength < minMatches ) {
+        return std::nullopt;
+    }
+
+    CopyRect copy;
+    if ( vertical ) {
+        copy.srcX = static_cast<quint16>(area.x());
+        copy.srcY = static_cast<quint16>(area.y() + bestStart - offset);
+        copy.x = static_cast<quint16>(area.x());
+        copy.y = static_cast<quint16>(area.y() + bestStart);
+        copy.width = static_cast<quint16>(area.width());
+        copy.height = static_cast<quint16>(bestLength);
+    } else {
+        copy.srcX = static_cast<quint16>(area.x() + bestStart - offset);
+        copy.srcY = static_cast<quint16>(area.y());
+        copy.x = static_cast<quint16>(area.x() + bestStart);
+        copy.y = static_cast<quint16>(area.y());
+        copy.width = static_cast<quint16>(bestLength);
+        copy.height = static_cast<quint16>(area.height());
+    }
+    return copy;
+}
+
+QList<quint64> ScrollDetector::lineHashes(const QImage& image, const QRect& area, Qt::Orientation direction) {
+    const int bytesPerPixel = image.depth() / 8;
+    QList<quint64> hashes;
+
+    if ( direction == Qt::Vertical ) {
+        hashes.reserve(area.height());
+        for ( int y = area.top(); y <= area.bottom(); ++y ) {
+            const uchar* line = image.constScanLine(y) + qsizetype(area.x()) * bytesPerPixel;
+            hashes.append(qHashBits(line, size_t(area.width()) * bytesPerPixel));
+        }
+        return hashes;
+    }
+
+    // 列哈希按行顺序累积（FNV-1a，每像素一步），避免按列跨行访问
+    hashes.fill(FNV_OFFSET_BASIS, area.width());
+    quint64* columns = hashes.data();
+    for ( int y = area.top(); y <= area.bottom(); ++y ) {
+        const uchar* line = image.constScanLine(y) + qsizetype(area.x()) * bytesPerPixel;
+        for ( int x = 0; x < area.width(); ++x ) {
+            quint32 pixel = 0;
+            std::memcpy(&pixel, line + qsizetype(x) * bytesPerPixel, std::min(bytesPerPixel, 4));
+            columns[x] = (columns[x] ^ pixel) * FNV_PRIME;
+        }
+    }
+    return hashes;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../../common/core/network/Protocol.h"
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
+#include <optional>
+
+/**
+ * @brief 滚动（整块位移）检测
+ *
+ * 在变化区域内逐行（或逐列）计算哈希，把当前帧每一行与上一帧中只出现一次的同内容行配对，
+ * 按位移投票；得票最多的位移中最长的连续匹配段即为可由客户端在画面内复制得到的区域。
+ * 空白行、纯色行等重复内容不参与投票，但可以包含在匹配段中。
+ *
+ * 先检测垂直位移，未检测到时再检测水平位移；每帧最多返回一个复制区域。
+ * 只处理整字节像素格式，且两帧尺寸、格式必须相同。
+ */
+class ScrollDetector {
+public:
+    /**
+     * @brief 检测 region 内从 previous 到 current 的位移
+     * @param region 变化区域（通常为变化图块的外接矩形）
+     * @return 复制区域（目标位于 region 内）；未检测到位移时为空
+     */
+    static std::optional<CopyRect> detect(const QImage& previous, const QImage& current, const QRect& region);
+
+    /// 对 previous 应用复制后的画面（即客户端应用复制后看到的内容）
+    static QImage predict(const QImage& previous, const CopyRect& copy);
+
+private:
+    static std::optional<CopyRect> detectAxis(const QImage& previous, const QImage& current,
+                                              const QRect& area, Qt::Orientation direction);
+    static QList<quint64> lineHashes(const QImage& image, const QRect& area, Qt::Orientation direction);
+};
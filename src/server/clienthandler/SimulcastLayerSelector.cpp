@@ -0,0 +1,38 @@
+#include "SimulcastLayerSelector.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include <algorithm>
+#include <bit>
+
+SimulcastLayerSelector::SimulcastLayerSelector(int layerCount)
+    : m_layerCount(std::max(1, layerCount))
+    , m_layer(0)
+    , m_history(0)
+    , m_cleanFrames(0) {
+}
+
+void SimulcastLayerSelector::setLayerCount(int layerCount) {
+    m_layerCount = std::max(1, layerCount);
+    m_layer = std::min(m_layer, m_layerCount - 1);
+}
+
+int SimulcastLayerSelector::update(quint64 skipped) {
+    m_history = static_cast<quint16>((m_history << 1) | (skipped > 0 ? 1 : 0));
+    m_cleanFrames = skipped > 0 ? 0 : m_cleanFrames + 1;
+
+    if ( std::popcount(m_history) >= NetworkConstants::SIMULCAST_DOWN_SKIPS && m_layer + 1 < m_layerCount ) {
+        ++m_layer;
+        m_history = 0;
+        m_cleanFrames = 0;
+    } else if ( m_cleanFrames >= NetworkConstants::SIMULCAST_UP_CLEAN_FRAMES && m_layer > 0 ) {
+        --m_layer;
+        m_history = 0;
+        m_cleanFrames = 0;
+    }
+    return m_layer;
+}
+
+void SimulcastLayerSelector::reset() {
+    m_layer = 0;
+    m_history = 0;
+    m_cleanFrames = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief 会话的同播层选择（按读取处理队列时的跳帧情况）
+ *
+ * 会话跟不上所订阅的层时，广播环会让它跳到最新帧。最近 16 帧中跳帧次数达到
+ * SIMULCAST_DOWN_SKIPS 时降一层（更低质量/分辨率）；连续 SIMULCAST_UP_CLEAN_FRAMES 帧
+ * 未跳帧时升一层。升层后再次拥塞会很快降回，因此升层间隔远长于降层。
+ *
+ * 由所属会话线程独占使用（非线程安全）。
+ */
+class SimulcastLayerSelector {
+public:
+    explicit SimulcastLayerSelector(int layerCount = 1);
+
+    /// 设置可用层数；当前层超出范围时降到最低层
+    void setLayerCount(int layerCount);
+    int layerCount() const { return m_layerCount; }
+
+    /// 当前选择的层（0 为最高质量层）
+    int layer() const { return m_layer; }
+
+    /**
+     * @brief 记录读取到的一帧
+     * @param skipped 读取这帧时跳过的帧数
+     * @return 记录后选择的层
+     */
+    int update(quint64 skipped);
+
+    /// 回到层 0 并清空统计（新会话）
+    void reset();
+
+private:
+    int m_layerCount;
+    int m_layer;
+    quint16 m_history;      ///< 最近 16 帧是否跳帧（最低位为最近一帧）
+    int m_cleanFrames;      ///< 连续未跳帧的帧数
+};
@@ -0,0 +1,246 @@
+#include "TileCacheMirror.h"
+#include "ScrollDetector.h"
+#include "../../common/core/cache/TileHasher.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include "../../common/core/logging/LoggingCategories.h"
+#include <QtCore/QBuffer>
+#include <QtCore/QSet>
+#include <algorithm>
+#include <utility>
+
+TileCacheMirror::TileCacheMirror()
+    : m_nextId(1)
+    , m_lastQuality(0)
+    , m_copyRectEnabled(false)
+    , m_lastVideoTimestamp(0) {
+}
+
+void TileCacheMirror::setCopyRectEnabled(bool enabled) {
+    m_copyRectEnabled = enabled;
+    if ( !enabled ) {
+        m_lastFrame = QImage();
+    }
+}
+
+void TileCacheMirror::setCapacity(qsizetype capacity) {
+    if ( capacity == m_ids.capacity() ) {
+        return;
+    }
+    clear();
+    m_ids.setCapacity(capacity);
+}
+
+TileCacheMirror::Plan TileCacheMirror::plan(const QImage& frame, const QList<ContentHash>& tileHashes,
+                                            int quality, TileUpdate& update, qint64 timestampMs) {
+    update.records.clear();
+    update.copies.clear();
+    update.width = static_cast<quint16>(frame.width());
+    update.height = static_cast<quint16>(frame.height());
+
+    const int tileSize = NetworkConstants::TILE_SIZE;
+    const int columns = (frame.width() + tileSize - 1) / tileSize;
+    const int rows = (frame.height() + tileSize - 1) / tileSize;
+    if ( frame.isNull() || tileHashes.size() != qsizetype(columns) * rows ) {
+        // 无法按图块处理：整帧发送，下一帧重新比较
+        m_lastHashes.clear();
+        m_video.clear();
+        return Plan::FullFrame;
+    }
+
+    // 尺寸变化（含缩放调整）时全部图块视为变化；质量提高时整帧重发以替换低质量画面
+    const bool qualityRaised = quality > m_lastQuality;
+    const bool refresh = qualityRaised || frame.size() != m_lastSize || m_lastHashes.size() != tileHashes.size();
+    if ( refresh ) {
+        m_inexact.fill(false, tileHashes.size());
+    }
+
+    const auto tileRect = [&](qsizetype index) {
+        const int x = static_cast<int>(index % columns) * tileSize;
+        const int y = static_cast<int>(index / columns) * tileSize;
+        return QRect(x, y, std::min(tileSize, frame.width() - x), std::min(tileSize, frame.height() - y));
+    };
+
+    // 视频区域按帧间变化统计，与客户端画面无关
+    const QRect videoRegion = m_video.update(tileHashes, frame.size());
+    const auto inVideo = [&](qsizetype index) { return videoRegion.intersects(tileRect(index)); };
+
+    // 与客户端画面相比变化的图块；以视频质量显示或延后发送、且已不在视频区域内的图块也需要重发
+    QList<ContentHash> clientHashes = refresh ? QList<ContentHash>() : m_lastHashes;
+    const auto diff = [&]() {
+        QList<qsizetype> indices;
+        for ( qsizetype i = 0; i < tileHashes.size(); ++i ) {
+            if ( clientHashes.isEmpty() || tileHashes.at(i) != clientHashes.at(i) || (m_inexact.at(i) && !inVideo(i)) ) {
+                indices.append(i);
+            }
+        }
+        return indices;
+    };
+    QList<qsizetype> changed = diff();
+
+    // 滚动：客户端先在画面内复制，之后只需发送与复制结果不同的图块
+    // 客户端画面中有不精确的图块时不复制，否则低质量像素会被当作精确内容移到别处
+    if ( m_copyRectEnabled && !refresh && m_lastFrame.size() == frame.size() && !m_inexact.contains(true)
+        && changed.size() >= NetworkConstants::SCROLL_MIN_CHANGED_TILES ) {
+        QRect region;
+        for ( const qsizetype index : changed ) {
+            region |= tileRect(index);
+        }
+        if ( const std::optional<CopyRect> copy = ScrollDetector::detect(m_lastFrame, frame, region) ) {
+            const QImage predicted = ScrollDetector::predict(m_lastFrame, *copy);
+            QList<ContentHash> predictedHashes = clientHashes;
+            ContentHasher hasher;
+            for ( qsizetype i = 0; i < predictedHashes.size(); ++i ) {
+                const QRect rect = tileRect(i);
+                if ( rect.intersects(copy->targetRect()) ) {
+                    TileHasher::hashTile(predicted, rect, hasher);
+                    predictedHashes[i] = hasher.result();
+                }
+            }
+            std::swap(clientHashes, predictedHashes);
+            const QList<qsizetype> remaining = diff();
+            if ( remaining.size() < changed.size() ) {
+                update.copies.append(*copy);
+                changed = remaining;
+            } else {
+                std::swap(clientHashes, predictedHashes);
+            }
+        }
+    }
+
+    // 视频区域内的变化不按图块发送，不参与整帧判断
+    QList<qsizetype> videoChanged;
+    if ( !refresh && !videoRegion.isEmpty() ) {
+        QList<qsizetype> others;
+        for ( const qsizetype index : changed ) {
+            (inVideo(index) ? videoChanged : others).append(index);
+        }
+        changed = std::move(others);
+    }
+
+    QSet<ContentHash> missing;
+    for ( const qsizetype index : changed ) {
+        if ( !m_ids.contains(tileHashes.at(index)) ) {
+            missing.insert(tileHashes.at(index));
+        }
+    }
+    m_lastHashes = tileHashes;
+    m_lastSize = frame.size();
+    m_lastQuality = quality;
+    if ( m_copyRectEnabled ) {
+        m_lastFrame = frame;
+    }
+
+    const auto makeRecord = [&](TileRecordKind kind, quint32 cacheId, const QRect& rect) {
+        TileRecord record;
+        record.kind = kind;
+        record.cacheId = cacheId;
+        record.x = static_cast<quint16>(rect.x());
+        record.y = static_cast<quint16>(rect.y());
+        record.width = static_cast<quint16>(rect.width());
+        record.height = static_cast<quint16>(rect.height());
+        return record;
+    };
+
+    const bool fullFrame = qualityRaised
+        || missing.size() * 100 > tileHashes.size() * NetworkConstants::TILE_FULL_FRAME_MISS_PERCENT;
+    if ( fullFrame ) {
+        update.copies.clear();
+        // 整帧覆盖视频区域与延后的图块
+        m_inexact.fill(false);
+        // 整帧之后让客户端截取未持有的图块入缓存；已持有的不访问（不改变 LRU 顺序）
+        for ( const qsizetype index : changed ) {
+            const ContentHash& hash = tileHashes.at(index);
+            if ( m_ids.contains(hash) ) {
+                continue;
+            }
+            const quint32 id = m_nextId++;
+            m_ids.insert(hash, id);
+            update.records.append(makeRecord(TileRecordKind::STORE, id, tileRect(index)));
+        }
+        return Plan::FullFrame;
+    }
+
+    // 存在视频区域时整体质量多半因视频而降低，其余图块仍保持清晰
+    const int tileQuality = videoRegion.isEmpty() ? quality : std::max(quality, NetworkConstants::VIDEO_DESKTOP_MIN_QUALITY);
+
+    // 先访问命中的图块使其成为最近使用，本帧新插入的图块不会把它们淘汰
+    QList<qsizetype> encodeList;
+    for ( const qsizetype index : changed ) {
+        m_inexact[index] = false;
+        const ContentHash& hash = tileHashes.at(index);
+        if ( const quint32* cachedId = m_ids.find(hash) ) {
+            update.records.append(makeRecord(TileRecordKind::CACHED, *cachedId, tileRect(index)));
+        } else {
+            encodeList.append(index);
+        }
+    }
+    for ( const qsizetype index : encodeList ) {
+        const ContentHash& hash = tileHashes.at(index);
+        const QRect rect = tileRect(index);
+        // 本帧内重复出现的内容（如大片纯色）只编码第一次
+        if ( const quint32* cachedId = m_ids.find(hash) ) {
+            update.records.append(makeRecord(TileRecordKind::CACHED, *cachedId, rect));
+            continue;
+        }
+        const quint32 id = m_nextId++;
+        m_ids.insert(hash, id);
+        TileRecord record = makeRecord(TileRecordKind::ENCODED, id, rect);
+        record.data = encodeTile(frame, rect, tileQuality);
+        update.records.append(std::move(record));
+    }
+
+    // 视频区域：整块缩小后低质量编码为一条记录，不入缓存；未到帧间隔时延后，之后合并发送最新内容
+    if ( !videoChanged.isEmpty() ) {
+        const qint64 interval = 1000 / NetworkConstants::VIDEO_FRAME_RATE;
+        const bool due = timestampMs <= 0 || m_lastVideoTimestamp <= 0 || timestampMs < m_lastVideoTimestamp
+            || timestampMs - m_lastVideoTimestamp >= interval;
+        if ( due ) {
+            TileRecord record = makeRecord(TileRecordKind::VIDEO, 0, videoRegion);
+            record.data = encodeTile(frame, videoRegion, std::min(quality, NetworkConstants::VIDEO_JPEG_QUALITY),
+                NetworkConstants::VIDEO_SCALE_PERCENT);
+            update.records.append(std::move(record));
+            m_lastVideoTimestamp = timestampMs;
+            for ( qsizetype i = 0; i < tileHashes.size(); ++i ) {
+                if ( inVideo(i) ) {
+                    m_inexact[i] = true;
+                }
+            }
+        } else {
+            for ( const qsizetype index : videoChanged ) {
+                m_lastHashes[index] = clientHashes.at(index);
+                m_inexact[index] = true;
+            }
+        }
+    }
+
+    if ( update.records.isEmpty() && update.copies.isEmpty() ) {
+        return Plan::Unchanged;
+    }
+    return Plan::Tiles;
+}
+
+void TileCacheMirror::clear() {
+    m_ids.clear();
+    m_lastHashes.clear();
+    m_lastFrame = QImage();
+    m_lastSize = QSize();
+    m_lastQuality = 0;
+    m_video.clear();
+    m_inexact.clear();
+    m_lastVideoTimestamp = 0;
+}
+
+QByteArray TileCacheMirror::encodeTile(const QImage& frame, const QRect& rect, int quality, int scalePercent) {
+    QImage image = frame.copy(rect);
+    if ( scalePercent < 100 ) {
+        const QSize scaled(std::max(1, rect.width() * scalePercent / 100), std::max(1, rect.height() * scalePercent / 100));
+        image = image.scaled(scaled, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    QByteArray jpegData;
+    QBuffer buffer(&jpegData);
+    if ( !buffer.open(QIODevice::WriteOnly) || !image.save(&buffer, "JPG", quality) ) {
+        qCWarning(lcClientHandlerWorker) << "图块JPEG编码失败，区域:" << rect;
+    }
+    return jpegData;
+}
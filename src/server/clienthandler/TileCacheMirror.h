@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../../common/core/cache/ContentHash.h"
+#include "../../common/core/cache/LruCache.h"
+#include "../../common/core/network/Protocol.h"
+#include "VideoRegionDetector.h"
+#include <QtCore/QList>
+#include <QtCore/QSize>
+#include <QtGui/QImage>
+
+/**
+ * @brief 图块缓存的服务端镜像索引（每个会话一个）
+ *
+ * 帧按 TILE_SIZE 对齐切分为图块，以像素内容哈希识别：
+ * - 与上一帧相同的图块不发送（客户端画面中已是该内容）
+ * - 变化的图块若客户端缓存仍持有（镜像命中），只发送 "缓存ID 位于 x,y"
+ * - 否则编码为 JPEG 并分配新缓存ID
+ * 镜像与客户端 TileCache 容量相同、按记录顺序插入与访问，因此无需确认即可知道
+ * 客户端持有哪些图块。
+ *
+ * 未命中的图块过多时（整屏内容第一次出现）逐块编码不如整帧 JPEG 划算，此时规划为整帧：
+ * 调用方先发送整帧 SCREEN_DATA，再发送 STORE 记录，由客户端从整帧中截取这些图块入缓存，
+ * 之后切回该内容（alt-tab、切换标签页）时即可命中。
+ *
+ * 启用区域复制时，变化图块较多的帧先在变化区域内检测滚动（ScrollDetector）：
+ * 检测到位移则发送 CopyRect，并以复制后的画面为基准重新比较，只有新露出的部分按图块发送。
+ *
+ * 持续高频变化的矩形区域（VideoRegionDetector）按视频处理：整块缩小、低质量编码为一条 VIDEO 记录，
+ * 不入缓存，并受 VIDEO_FRAME_RATE 限制；其余图块不随之降质。区域消失后其中的图块按普通图块重发。
+ *
+ * 非线程安全：同一时刻只由一个线程使用（所属会话线程，或会话交给线程池的规划任务）。
+ */
+class TileCacheMirror {
+public:
+    enum class Plan {
+        Unchanged,   ///< 与上一帧相同，无需发送
+        Tiles,       ///< 只发送 TileUpdate（CACHED/ENCODED 记录）
+        FullFrame    ///< 发送整帧，之后发送 TileUpdate（STORE 记录，可能为空）
+    };
+
+    TileCacheMirror();
+
+    /// 设置镜像容量（握手协商值）；容量变化时清空，客户端缓存同样从空开始
+    void setCapacity(qsizetype capacity);
+    qsizetype capacity() const { return m_ids.capacity(); }
+
+    /// 是否检测滚动并发送区域复制（对端声明 Capability::COPY_RECT 时启用）
+    void setCopyRectEnabled(bool enabled);
+
+    /**
+     * @brief 规划一帧的发送方式并相应更新镜像
+     * @param frame 传输帧（TileHasher::hashTiles 的输入）
+     * @param tileHashes TileHasher::hashTiles(frame) 的结果
+     * @param quality 图块 JPEG 质量；质量提高时整帧重发
+     * @param update 输出：帧尺寸、区域复制与按顺序应用的图块记录
+     * @param timestampMs 帧捕获时间（毫秒），用于视频区域帧率限制；0 表示未知，不限制
+     */
+    Plan plan(const QImage& frame, const QList<ContentHash>& tileHashes, int quality, TileUpdate& update,
+              qint64 timestampMs = 0);
+
+    /**
+     * @brief 清空镜像与上一帧状态（下一帧按全部变化处理）
+     *
+     * 也用于发送失败后的重新同步：之后分配的ID都是新的，客户端缓存中多出的旧条目
+     * 不会再被引用，且总在新条目之前被淘汰，因此客户端始终持有镜像中的全部条目。
+     */
+    void clear();
+
+private:
+    static QByteArray encodeTile(const QImage& frame, const QRect& rect, int quality, int scalePercent = 100);
+
+    LruCache<ContentHash, quint32> m_ids;   ///< 内容哈希 -> 缓存ID，与客户端 LRU 同步淘汰
+    quint32 m_nextId;                       ///< 下一个分配的缓存ID（从1开始）
+    QList<ContentHash> m_lastHashes;        ///< 上一次发送的帧的图块哈希
+    QImage m_lastFrame;                     ///< 上一次发送的帧（仅启用区域复制时保留，隐式共享）
+    QSize m_lastSize;
+    int m_lastQuality;
+    bool m_copyRectEnabled;
+    VideoRegionDetector m_video;
+    QList<bool> m_inexact;                  ///< 客户端该图块与 m_lastHashes 不完全一致（视频质量或延后发送）
+    qint64 m_lastVideoTimestamp;            ///< 上次发送视频区域的帧时间（毫秒）
+};
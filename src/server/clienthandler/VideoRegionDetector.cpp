@@ -0,0 +1,52 @@
+#include "VideoRegionDetector.h"
+#include "../../common/core/config/NetworkConstants.h"
+#include <bit>
+
+QRect VideoRegionDetector::update(const QList<ContentHash>& tileHashes, const QSize& frameSize) {
+    if ( frameSize != m_frameSize || tileHashes.size() != m_previous.size() ) {
+        m_previous = tileHashes;
+        m_history.fill(0, tileHashes.size());
+        m_hot.fill(false, tileHashes.size());
+        m_frameSize = frameSize;
+        m_region = QRect();
+        return m_region;
+    }
+
+    const int tileSize = NetworkConstants::TILE_SIZE;
+    const int columns = (frameSize.width() + tileSize - 1) / tileSize;
+    QRect bounds;
+    int hotCount = 0;
+    for ( qsizetype i = 0; i < tileHashes.size(); ++i ) {
+        const bool changed = tileHashes.at(i) != m_previous.at(i);
+        const quint16 history = static_cast<quint16>((m_history.at(i) << 1) | (changed ? 1 : 0));
+        m_history[i] = history;
+
+        const int changes = std::popcount(history);
+        if ( changes >= NetworkConstants::VIDEO_HOT_CHANGES ) {
+            m_hot[i] = true;
+        } else if ( changes < NetworkConstants::VIDEO_COOL_CHANGES ) {
+            m_hot[i] = false;
+        }
+        if ( m_hot.at(i) ) {
+            ++hotCount;
+            bounds |= QRect(static_cast<int>(i % columns) * tileSize, static_cast<int>(i / columns) * tileSize,
+                tileSize, tileSize);
+        }
+    }
+    m_previous = tileHashes;
+
+    bounds = bounds.intersected(QRect(QPoint(0, 0), frameSize));
+    const int boundsTiles = ((bounds.width() + tileSize - 1) / tileSize) * ((bounds.height() + tileSize - 1) / tileSize);
+    const bool isRegion = hotCount >= NetworkConstants::VIDEO_MIN_TILES
+        && hotCount * 100 >= boundsTiles * NetworkConstants::VIDEO_MIN_FILL_PERCENT;
+    m_region = isRegion ? bounds : QRect();
+    return m_region;
+}
+
+void VideoRegionDetector::clear() {
+    m_previous.clear();
+    m_history.clear();
+    m_hot.clear();
+    m_frameSize = QSize();
+    m_region = QRect();
+}
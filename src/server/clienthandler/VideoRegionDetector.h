@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../../common/core/cache/ContentHash.h"
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtCore/QSize>
+
+/**
+ * @brief 视频区域检测（按图块变化频率统计）
+ *
+ * 记录每个图块最近 16 帧中是否变化（与上一帧相比），变化次数达到 VIDEO_HOT_CHANGES 的图块
+ * 视为 "热" 图块，降到 VIDEO_COOL_CHANGES 以下才恢复，避免区域在边界上反复进出。
+ * 热图块足够多且集中成矩形（填充率不低于 VIDEO_MIN_FILL_PERCENT）时，其外接矩形即为视频区域；
+ * 分散的零星变化（光标闪烁、时钟）不会形成区域。
+ *
+ * 由所属会话线程独占使用（非线程安全）。
+ */
+class VideoRegionDetector {
+public:
+    /**
+     * @brief 记录一帧的图块哈希并更新视频区域
+     * @param tileHashes TileHasher::hashTiles 的结果（行优先）
+     * @param frameSize 帧尺寸；变化时统计重新开始
+     * @return 视频区域（按图块对齐、裁剪到帧内的像素矩形）；没有时为空
+     */
+    QRect update(const QList<ContentHash>& tileHashes, const QSize& frameSize);
+
+    QRect region() const { return m_region; }
+
+    void clear();
+
+private:
+    QList<ContentHash> m_previous;   ///< 上一帧的图块哈希
+    QList<quint16> m_history;        ///< 每个图块最近 16 帧的变化位（最低位为最近一帧）
+    QList<bool> m_hot;
+    QSize m_frameSize;
+    QRect m_region;
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <algorithm>
+#include <deque>
+
+/**
+ * @brief 单生产者、多读者的广播环形缓冲
+ *
+ * 生产者发布的每个元素对所有读者可见，读者各自持有游标，读取不会移除元素；
+ * 缓冲满时覆盖最旧的元素，生产者从不因读者阻塞。
+ * 读者落后超过其 maxLag（或游标已被覆盖）时直接跳到最新元素，跳过的数量计入 totalSkipped()。
+ * 因此只适合每个元素都可独立使用的数据（如完整编码的帧）。
+ *
+ * 所有方法线程安全。
+ *
+ * @tparam T 元素类型（应为隐式共享或廉价拷贝的类型）
+ */
+template <typename T>
+class BroadcastRing {
+public:
+    using ReaderId = quint32;
+
+    /// 新读者的起始位置
+    enum class Start {
+        Latest,   ///< 从最新的一个元素开始（加入时不补发旧元素）
+        Oldest    ///< 从保留的最旧元素开始
+    };
+
+    explicit BroadcastRing(qsizetype capacity)
+        : m_capacity(std::max<qsizetype>(1, capacity))
+        , m_nextSequence(0)
+        , m_nextReaderId(1)
+        , m_stopped(false)
+        , m_totalPublished(0)
+        , m_totalRead(0)
+        , m_totalSkipped(0) {
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    /// 发布元素；已停止时返回 false
+    bool publish(const T& item) {
+        QMutexLocker locker(&m_mutex);
+        if ( m_stopped ) {
+            return false;
+        }
+        m_items.push_back(item);
+        ++m_nextSequence;
+        ++m_totalPublished;
+        trim();
+        return true;
+    }
+
+    /**
+     * @brief 注册读者
+     * @param start 起始位置
+     * @param maxLag 允许落后的元素数，超过时跳到最新；0 表示只在被覆盖时跳过
+     */
+    ReaderId addReader(Start start = Start::Latest, qsizetype maxLag = 0) {
+        QMutexLocker locker(&m_mutex);
+        Reader reader;
+        reader.cursor = start == Start::Oldest ? oldestSequence()
+                                               : m_nextSequence - std::min<quint64>(1, m_items.size());
+        reader.maxLag = maxLag;
+        const ReaderId id = m_nextReaderId++;
+        m_readers.insert(id, reader);
+        return id;
+    }
+
+    void removeReader(ReaderId id) {
+        QMutexLocker locker(&m_mutex);
+        m_readers.remove(id);
+    }
+
+    /**
+     * @brief 读取读者的下一个元素
+     * @param skipped 输出（可为空）：本次为追上而跳过的元素数
+     * @return 没有新元素、读者未注册或已停止时返回 false
+     */
+    bool read(ReaderId id, T& item, quint64* skipped = nullptr) {
+        QMutexLocker locker(&m_mutex);
+        if ( skipped ) {
+            *skipped = 0;
+        }
+        auto it = m_readers.find(id);
+        if ( m_stopped || it == m_readers.end() || it->cursor >= m_nextSequence ) {
+            return false;
+        }
+
+        Reader& reader = it.value();
+        const quint64 latest = m_nextSequence - 1;
+        const bool overwritten = reader.cursor < oldestSequence();
+        const bool tooFarBehind = reader.maxLag > 0 && latest - reader.cursor >= static_cast<quint64>(reader.maxLag);
+        if ( overwritten || tooFarBehind ) {
+            const quint64 count = latest - reader.cursor;
+            m_totalSkipped += count;
+            if ( skipped ) {
+                *skipped = count;
+            }
+            reader.cursor = latest;
+        }
+
+        item = m_items.at(static_cast<size_t>(reader.cursor - oldestSequence()));
+        ++reader.cursor;
+        ++m_totalRead;
+        return true;
+    }
+
+    /// 保留的元素数
+    qsizetype size() const {
+        QMutexLocker locker(&m_mutex);
+        return static_cast<qsizetype>(m_items.size());
+    }
+
+    /**
+     * @brief 积压：最慢读者游标之后发布的元素数（含已被覆盖的）
+     *
+     * 不受容量限制，可反映读者停顿了多久；没有读者时为保留的元素数。
+     */
+    qsizetype backlog() const {
+        QMutexLocker locker(&m_mutex);
+        if ( m_readers.isEmpty() ) {
+            return static_cast<qsizetype>(m_items.size());
+        }
+        quint64 lag = 0;
+        for ( const Reader& reader : m_readers ) {
+            lag = std::max(lag, m_nextSequence - reader.cursor);
+        }
+        return static_cast<qsizetype>(lag);
+    }
+
+    qsizetype readerCount() const {
+        QMutexLocker locker(&m_mutex);
+        return m_readers.size();
+    }
+
+    qsizetype capacity() const {
+        QMutexLocker locker(&m_mutex);
+        return m_capacity;
+    }
+
+    void setCapacity(qsizetype capacity) {
+        QMutexLocker locker(&m_mutex);
+        m_capacity = std::max<qsizetype>(1, capacity);
+        trim();
+    }
+
+    /// 丢弃所有元素，读者游标移到末尾
+    void clear() {
+        QMutexLocker locker(&m_mutex);
+        m_items.clear();
+        for ( Reader& reader : m_readers ) {
+            reader.cursor = m_nextSequence;
+        }
+    }
+
+    void stop() {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+    }
+
+    void restart() {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = false;
+    }
+
+    quint64 totalPublished() const {
+        QMutexLocker locker(&m_mutex);
+        return m_totalPublished;
+    }
+
+    quint64 totalRead() const {
+        QMutexLocker locker(&m_mutex);
+        return m_totalRead;
+    }
+
+    quint64 totalSkipped() const {
+        QMutexLocker locker(&m_mutex);
+        return m_totalSkipped;
+    }
+
+private:
+    struct Reader {
+        quint64 cursor = 0;    ///< 下一个要读取的序号
+        qsizetype maxLag = 0;
+    };
+
+    quint64 oldestSequence() const { return m_nextSequence - m_items.size(); }
+
+    void trim() {
+        while ( static_cast<qsizetype>(m_items.size()) > m_capacity ) {
+            m_items.pop_front();
+        }
+    }
+
+    mutable QMutex m_mutex;
+    std::deque<T> m_items;              ///< 序号 [oldestSequence(), m_nextSequence) 的元素
+    qsizetype m_capacity;
+    quint64 m_nextSequence;             ///< 下一个发布元素的序号
+    QHash<ReaderId, Reader> m_readers;
+    ReaderId m_nextReaderId;
+    bool m_stopped;
+    quint64 m_totalPublished;
+    quint64 m_totalRead;
+    quint64 m_totalSkipped;
+};
@@ -3,7 +3,9 @@
 #include <QtCore/QObject>
 #include <QtCore/QDateTime>
 #include <QtCore/QByteArray>
+#include <QtCore/QList>
 #include <QtGui/QImage>
+#include "../../common/core/cache/ContentHash.h"
 #include <memory>
 
 /**
@@ -11,12 +13,15 @@
  *
  * 用于在屏幕捕获生产者和数据处理消费者之间传递数据。
  * 包含原始图像数据和相关元信息。
+ * image 可能包装 FrameBufferPool 的内存块（每行字节数可能大于 width*4），
+ * 最后一个副本释放时内存自动归还，因此不要长期持有不再需要的帧。
  */
 struct CapturedFrame {
     QImage image;                    ///< 捕获的屏幕图像
     QDateTime timestamp;             ///< 捕获时间戳
     quint64 frameId;                 ///< 帧ID，用于追踪和调试
     QSize originalSize;              ///< 原始屏幕尺寸
+    QRect sourceRect;                ///< 图像对应的屏幕区域（全局逻辑坐标）
 
     /**
      * @brief 默认构造函数
@@ -81,6 +86,7 @@ struct CapturedFrame {
  *
  * 用于在数据处理消费者和数据发送消费者之间传递数据。
  * 包含处理后的数据和传输所需的元信息。
+ * compressedData 与 frame（缩放或转换格式时）的缓冲取自 FrameBufferPool，下游只读共享；全部副本释放后由池复用。
  */
 struct ProcessedData {
     QByteArray compressedData;       ///< 处理后的图像数据（JPEG编码，可能经过zstd压缩）
@@ -92,6 +98,12 @@ struct ProcessedData {
     bool isZstdCompressed;           ///< 是否使用了zstd二次压缩
     bool isScaled;                   ///< 是否进行了缩放
     QSize originalImageSize;         ///< 原始图像尺寸（缩放前）
+    QDateTime captureTime;           ///< 原始帧捕获时间（用于端到端延迟统计）
+    QRect sourceRect;                ///< 原始图像对应的屏幕区域（全局逻辑坐标），用于换算输入和光标坐标以及多显示器拼合
+    QImage frame;                    ///< 编码前的传输帧（缩放后，隐式共享），图块缓存按需逐块编码
+    QList<ContentHash> tileHashes;   ///< frame 按 TILE_SIZE 切分的图块哈希（行优先；没有会话使用图块缓存时为空）
+    int quality;                     ///< JPEG 编码质量（图块使用相同质量）
+    int layer;                       ///< 同播层（0 为最高质量层）
 
     /**
      * @brief 默认构造函数
@@ -102,7 +114,9 @@ struct ProcessedData {
         , originalDataSize(0)
         , compressedDataSize(0)
         , isZstdCompressed(false)
-        , isScaled(false) {
+        , isScaled(false)
+        , quality(0)
+        , layer(0) {
     }
 
     /**
@@ -121,7 +135,9 @@ struct ProcessedData {
         , compressedDataSize(data.size())
         , isZstdCompressed(false)
         , isScaled(false)
-        , originalImageSize(size) {
+        , originalImageSize(size)
+        , quality(0)
+        , layer(0) {
     }
 
     /**
@@ -136,7 +152,9 @@ struct ProcessedData {
         , compressedDataSize(compressedData.size())
         , isZstdCompressed(false)
         , isScaled(false)
-        , originalImageSize(size) {
+        , originalImageSize(size)
+        , quality(0)
+        , layer(0) {
     }
 
     /**
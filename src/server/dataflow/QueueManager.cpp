@@ -1,27 +1,52 @@
 #include "QueueManager.h"
 #include "../../common/core/logging/LoggingCategories.h"
+#include "../../common/core/config/Constants.h"
 #include <QtCore/QMutexLocker>
+#include <algorithm>
+#include <utility>
 
 
 // 静态成员初始化
 QueueManager* QueueManager::s_instance = nullptr;
 QMutex QueueManager::s_instanceMutex;
+QList<QueueManager*> QueueManager::s_pipelines;
+QMutex QueueManager::s_pipelinesMutex;
 
 QueueManager::QueueManager(QObject* parent)
+    : QueueManager(QString(), parent) {
+}
+
+QueueManager::QueueManager(const QString& pipelineName, QObject* parent)
     : QObject(parent)
+    , m_pipelineName(pipelineName)
+    , m_defaultReader(0)
+    , m_defaultReaderLastFrameId(0)
     , m_statsTimer(new QTimer(this))
     , m_statsEnabled(true)
     , m_statsUpdateInterval(1000)  // 默认1秒更新一次
     , m_initialized(false)
     , m_lastProcessedFrameId(0) {
-    qCDebug(lcQueueManager) << "QueueManager构造函数";
+    qCDebug(lcQueueManager) << "QueueManager构造函数，流水线:" << (m_pipelineName.isEmpty() ? QStringLiteral("default") : m_pipelineName);
 
     // 连接统计更新定时器
     connect(m_statsTimer, &QTimer::timeout, this, &QueueManager::updateStats);
+
+    QMutexLocker locker(&s_pipelinesMutex);
+    s_pipelines.append(this);
 }
 
 QueueManager::~QueueManager() {
     qCDebug(lcQueueManager) << "QueueManager析构函数";
+    {
+        QMutexLocker locker(&s_pipelinesMutex);
+        s_pipelines.removeOne(this);
+    }
+    {
+        QMutexLocker locker(&s_instanceMutex);
+        if ( s_instance == this ) {
+            s_instance = nullptr;
+        }
+    }
     cleanup();
 }
 
@@ -33,6 +58,35 @@ QueueManager* QueueManager::instance() {
     return s_instance;
 }
 
+QList<QueueManager*> QueueManager::pipelines() {
+    QMutexLocker locker(&s_pipelinesMutex);
+    return s_pipelines;
+}
+
+QueueStats QueueManager::aggregatedStats(QueueType type) {
+    QueueStats total;
+    double weightedLatency = 0.0;
+    QMutexLocker locker(&s_pipelinesMutex);
+    for ( const QueueManager* pipeline : std::as_const(s_pipelines) ) {
+        const QueueStats stats = pipeline->getQueueStats(type);
+        total.currentSize += stats.currentSize;
+        total.maxSize += stats.maxSize;
+        total.totalEnqueued += stats.totalEnqueued;
+        total.totalDequeued += stats.totalDequeued;
+        total.totalDropped += stats.totalDropped;
+        weightedLatency += stats.averageLatency * static_cast<double>(stats.totalEnqueued);
+        total.lastUpdateTime = std::max(total.lastUpdateTime, stats.lastUpdateTime);
+    }
+    if ( total.totalEnqueued > 0 ) {
+        total.averageLatency = weightedLatency / static_cast<double>(total.totalEnqueued);
+    }
+    return total;
+}
+
+QString QueueManager::threadName(const QString& role) const {
+    return m_pipelineName.isEmpty() ? role : role + QLatin1Char('_') + m_pipelineName;
+}
+
 bool QueueManager::initialize(int captureQueueSize, int processedQueueSize) {
     qCDebug(lcQueueManager) << "初始化队列管理器，捕获队列大小:" << captureQueueSize
         << "处理队列大小:" << processedQueueSize;
@@ -50,11 +104,11 @@ bool QueueManager::initialize(int captureQueueSize, int processedQueueSize) {
             return false;
         }
 
-        // 创建处理队列
-        m_processedQueue = std::make_unique<ThreadSafeQueue<ProcessedData>>(processedQueueSize);
-        if ( !m_processedQueue ) {
-            qCCritical(lcQueueManager) << "创建处理队列失败";
-            return false;
+        // 创建处理队列（每个同播层一个广播环）
+        m_processedLayers.clear();
+        for ( int layer = 0; layer < CoreConstants::Compression::SIMULCAST_LAYERS; ++layer ) {
+            m_processedLayers.push_back(
+                std::make_unique<BroadcastRing<ProcessedData>>(retainedProcessedFrames(processedQueueSize)));
         }
 
         // 初始化统计信息
@@ -98,7 +152,12 @@ void QueueManager::cleanup() {
 
     // 清理队列
     m_captureQueue.reset();
-    m_processedQueue.reset();
+    {
+        QMutexLocker locker(&m_defaultReaderMutex);
+        m_processedLayers.clear();
+        m_defaultReader = 0;
+        m_defaultReaderLastFrameId = 0;
+    }
 
     // 重置最后入队的帧ID
     m_lastProcessedFrameId = 0;
@@ -133,8 +192,10 @@ void QueueManager::setQueueMaxSize(QueueType type, int maxSize) {
             }
             break;
         case ProcessedQueue:
-            if ( m_processedQueue ) {
-                m_processedQueue->setMaxSize(maxSize);
+            if ( !m_processedLayers.empty() ) {
+                for ( const auto& ring : m_processedLayers ) {
+                    ring->setCapacity(retainedProcessedFrames(maxSize));
+                }
                 QMutexLocker locker(&m_statsMutex);
                 m_processedStats.maxSize = maxSize;
             }
@@ -155,11 +216,15 @@ void QueueManager::clearQueue(QueueType type) {
             }
             break;
         case ProcessedQueue:
-            if ( m_processedQueue ) {
-                m_processedQueue->clear();
+            for ( const auto& ring : m_processedLayers ) {
+                ring->clear();
             }
             // 重置最后入队的帧ID
             m_lastProcessedFrameId = 0;
+            {
+                QMutexLocker locker(&m_defaultReaderMutex);
+                m_defaultReaderLastFrameId = 0;
+            }
             break;
         default:
             qCWarning(lcQueueManager) << "清空队列失败，未知类型:" << type;
@@ -174,8 +239,8 @@ void QueueManager::stopAllQueues() {
         m_captureQueue->stop();
     }
 
-    if ( m_processedQueue ) {
-        m_processedQueue->stop();
+    for ( const auto& ring : m_processedLayers ) {
+        ring->stop();
     }
 }
 
@@ -186,12 +251,16 @@ void QueueManager::restartAllQueues() {
         m_captureQueue->restart();
     }
 
-    if ( m_processedQueue ) {
-        m_processedQueue->restart();
+    for ( const auto& ring : m_processedLayers ) {
+        ring->restart();
     }
 
     // 重置最后入队的帧ID
     m_lastProcessedFrameId = 0;
+    {
+        QMutexLocker locker(&m_defaultReaderMutex);
+        m_defaultReaderLastFrameId = 0;
+    }
 }
 
 bool QueueManager::isQueueHealthy(QueueType type) const {
@@ -248,6 +317,16 @@ void QueueManager::updateStats() {
         return;
     }
 
+    // 单消费者接口已弃用：注销默认读者，它的积压不再计入统计
+    {
+        QMutexLocker locker(&m_defaultReaderMutex);
+        if ( m_defaultReader != 0 && m_defaultReaderLastRead.hasExpired(DEFAULT_READER_IDLE_MS) ) {
+            m_processedLayers.front()->removeReader(m_defaultReader);
+            qCDebug(lcQueueManager) << "默认处理队列读者长时间未出队，注销:" << m_defaultReader;
+            m_defaultReader = 0;
+        }
+    }
+
     updateQueueStats(CaptureQueue);
     updateQueueStats(ProcessedQueue);
 
@@ -261,7 +340,7 @@ void QueueManager::updateQueueStats(QueueType type) {
 
     QueueStats* stats = nullptr;
     ThreadSafeQueue<CapturedFrame>* captureQueue = nullptr;
-    ThreadSafeQueue<ProcessedData>* processedQueue = nullptr;
+    bool processedQueue = false;
 
     switch ( type ) {
         case CaptureQueue:
@@ -270,7 +349,7 @@ void QueueManager::updateQueueStats(QueueType type) {
             break;
         case ProcessedQueue:
             stats = &m_processedStats;
-            processedQueue = m_processedQueue.get();
+            processedQueue = !m_processedLayers.empty();
             break;
         default:
             return;
@@ -286,9 +365,18 @@ void QueueManager::updateQueueStats(QueueType type) {
         stats->totalEnqueued = captureQueue->getTotalEnqueued();
         stats->totalDequeued = captureQueue->getTotalDequeued();
     } else if ( processedQueue ) {
-        stats->currentSize = processedQueue->size();
-        stats->totalEnqueued = processedQueue->getTotalEnqueued();
-        stats->totalDequeued = processedQueue->getTotalDequeued();
+        // 广播环：当前大小为层 0 最慢读者的积压（驱动层 0 的自适应质量，低层的慢读者不拖累它），
+        // 入队为层 0 的帧数，出队与丢弃为所有层、所有读者的合计
+        const BroadcastRing<ProcessedData>* primary = m_processedLayers.front().get();
+        stats->currentSize = static_cast<int>(stats->maxSize > 0
+            ? std::min<qsizetype>(primary->backlog(), stats->maxSize) : primary->backlog());
+        stats->totalEnqueued = primary->totalPublished();
+        stats->totalDequeued = 0;
+        stats->totalDropped = 0;
+        for ( const auto& ring : m_processedLayers ) {
+            stats->totalDequeued += ring->totalRead();
+            stats->totalDropped += ring->totalSkipped();
+        }
     }
 
     // 更新时间戳
@@ -369,7 +457,7 @@ bool QueueManager::dequeueCapturedFrame(CapturedFrame& frame) {
 // ==================== 处理队列统一接口实现 ====================
 
 bool QueueManager::enqueueProcessedData(const ProcessedData& data) {
-    if ( !m_processedQueue ) {
+    if ( m_processedLayers.empty() ) {
         qCWarning(lcQueueManager) << "处理队列未初始化";
         return false;
     }
@@ -380,34 +468,119 @@ bool QueueManager::enqueueProcessedData(const ProcessedData& data) {
         return false;
     }
 
-    // 检查新帧ID是否比最后入队的帧ID小（说明是过期帧）
+    BroadcastRing<ProcessedData>* ring = processedLayer(data.layer);
+    if ( !ring ) {
+        qCWarning(lcQueueManager) << "无效的同播层:" << data.layer << "帧ID:" << data.originalFrameId;
+        return false;
+    }
+
+    // 检查新帧ID是否比最后入队的帧ID小（说明是过期帧）；同一帧的各层ID相同，依次入队
     if ( m_lastProcessedFrameId > 0 && data.originalFrameId < m_lastProcessedFrameId ) {
         qCDebug(lcQueueManager) << "新帧ID" << data.originalFrameId
             << "小于最后入队帧ID" << m_lastProcessedFrameId << "，舍弃新帧";
         return false;
     }
 
-    // 如果队列满了，先丢弃最旧的帧，然后再尝试入队
-    if ( m_processedQueue->isFull() ) {
-        ProcessedData oldData;
-        if ( m_processedQueue->tryDequeue(oldData) ) {
-            qCDebug(lcQueueManager) << "处理队列已满，丢弃最旧的帧ID:" << oldData.originalFrameId;
-        }
-    }
-
-    // 使用 tryEnqueue 尝试入队
-    bool result = m_processedQueue->tryEnqueue(data);
+    // 广播环满时覆盖最旧的帧，不等待读者
+    bool result = ring->publish(data);
     if ( result ) {
         // 更新最后入队的帧ID
         m_lastProcessedFrameId = data.originalFrameId;
+        emit processedDataAvailable(data.layer);
     }
     return result;
 }
 
 bool QueueManager::dequeueProcessedData(ProcessedData& data) {
-    if ( !m_processedQueue ) {
+    QMutexLocker locker(&m_defaultReaderMutex);
+    if ( m_processedLayers.empty() ) {
         qCWarning(lcQueueManager) << "处理队列未初始化";
         return false;
     }
-    return m_processedQueue->tryDequeue(data);
+    BroadcastRing<ProcessedData>* ring = m_processedLayers.front().get();
+    if ( m_defaultReader == 0 ) {
+        m_defaultReader = ring->addReader(BroadcastRing<ProcessedData>::Start::Oldest);
+    }
+    m_defaultReaderLastRead.start();
+    // 注销后重新注册的读者从最旧一帧开始：跳过注销前已读过的帧
+    while ( ring->read(m_defaultReader, data) ) {
+        if ( data.originalFrameId > m_defaultReaderLastFrameId ) {
+            m_defaultReaderLastFrameId = data.originalFrameId;
+            return true;
+        }
+    }
+    return false;
+}
+
+void QueueManager::releaseDefaultReader() {
+    QMutexLocker locker(&m_defaultReaderMutex);
+    if ( m_defaultReader != 0 && !m_processedLayers.empty() ) {
+        m_processedLayers.front()->removeReader(m_defaultReader);
+        qCDebug(lcQueueManager) << "注销默认处理队列读者:" << m_defaultReader;
+    }
+    m_defaultReader = 0;
+}
+
+// ==================== 处理队列广播读者实现 ====================
+
+quint32 QueueManager::addProcessedReader(int layer) {
+    BroadcastRing<ProcessedData>* ring = processedLayer(layer);
+    if ( !ring ) {
+        qCWarning(lcQueueManager) << "处理队列未初始化或同播层无效，无法注册读者，层:" << layer;
+        return 0;
+    }
+    const quint32 readerId = ring->addReader(BroadcastRing<ProcessedData>::Start::Latest, MAX_READER_LAG);
+    requestFullFrame();
+    qCDebug(lcQueueManager) << "注册处理队列读者:" << readerId << "层:" << layer << "读者数:" << ring->readerCount();
+    return readerId;
+}
+
+void QueueManager::removeProcessedReader(quint32 readerId, int layer) {
+    BroadcastRing<ProcessedData>* ring = processedLayer(layer);
+    if ( !ring || readerId == 0 ) {
+        return;
+    }
+    ring->removeReader(readerId);
+    qCDebug(lcQueueManager) << "注销处理队列读者:" << readerId << "层:" << layer << "读者数:" << ring->readerCount();
+
+    // 无人订阅的层不再编码：丢弃保留的帧，之后订阅的会话不会读到过期画面
+    if ( layer > 0 && ring->readerCount() == 0 ) {
+        ring->clear();
+    }
+}
+
+bool QueueManager::readProcessedData(quint32 readerId, ProcessedData& data, int layer, quint64* skipped) {
+    BroadcastRing<ProcessedData>* ring = processedLayer(layer);
+    if ( !ring ) {
+        return false;
+    }
+    quint64 skippedFrames = 0;
+    const bool result = ring->read(readerId, data, &skippedFrames);
+    if ( skippedFrames > 0 ) {
+        qCDebug(lcQueueManager) << "读者" << readerId << "(层" << layer << ") 落后，跳过" << skippedFrames << "帧";
+    }
+    if ( skipped ) {
+        *skipped = skippedFrames;
+    }
+    return result;
+}
+
+int QueueManager::processedReaderCount(int layer) const {
+    const BroadcastRing<ProcessedData>* ring = processedLayer(layer);
+    return ring ? static_cast<int>(ring->readerCount()) : 0;
+}
+
+int QueueManager::processedLayerCount() const {
+    return static_cast<int>(m_processedLayers.size());
+}
+
+BroadcastRing<ProcessedData>* QueueManager::processedLayer(int layer) const {
+    if ( layer < 0 || layer >= static_cast<int>(m_processedLayers.size()) ) {
+        return nullptr;
+    }
+    return m_processedLayers[static_cast<size_t>(layer)].get();
+}
+
+qsizetype QueueManager::retainedProcessedFrames(int maxSize) {
+    return maxSize > 0 ? std::min(maxSize, MAX_RETAINED_PROCESSED_FRAMES) : MAX_RETAINED_PROCESSED_FRAMES;
 }
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "DataFlowStructures.h"
+#include "BroadcastRing.h"
 #include "../../common/core/threading/ThreadSafeQueue.h"
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtCore/QMutex>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 /**
  * @brief 队列管理器类
@@ -14,6 +19,16 @@
  * 1. CaptureQueue: 屏幕捕获 -> 数据处理
  * 2. ProcessedQueue: 数据处理 -> 数据发送
  *
+ * ProcessedQueue 是广播环（BroadcastRing）：每帧只编码一次，每个客户端会话注册一个读者、
+ * 按自己的游标读取，互不消耗对方的数据；慢的读者跳到最新帧，不阻塞处理线程。
+ * 每个同播层（ProcessedData::layer）各有一个广播环，会话只订阅一层；统计与 dequeueProcessedData()
+ * （单消费者接口，使用内部默认读者）针对层 0。
+ *
+ * 每个实例是一条独立的流水线（捕获 -> 处理 -> 发送），拥有自己的队列，注入到该流水线的
+ * ScreenCapture / DataProcessingWorker / ClientHandlerWorker；可以创建多个实例（如每个显示器一条），
+ * 未注入时各组件回退到 instance() 这条默认流水线。所有存活实例登记在进程级列表中，
+ * aggregatedStats() 汇总它们的统计。
+ *
  * 提供队列统计、监控和配置功能。
  */
 class QueueManager : public QObject {
@@ -29,11 +44,18 @@ public:
     };
 
     /**
-     * @brief 构造函数
+     * @brief 构造函数（默认流水线，名称为空）
      * @param parent 父对象
      */
     explicit QueueManager(QObject* parent = nullptr);
 
+    /**
+     * @brief 构造函数
+     * @param pipelineName 流水线名称（如 "screen1"），用于区分各流水线的工作线程名
+     * @param parent 父对象
+     */
+    explicit QueueManager(const QString& pipelineName, QObject* parent = nullptr);
+
     /**
      * @brief 析构函数
      */
@@ -45,10 +67,37 @@ public:
      */
     [[nodiscard]] static QueueManager* instance();
 
+    /**
+     * @brief 当前存活的所有流水线（含已创建的单例）
+     */
+    [[nodiscard]] static QList<QueueManager*> pipelines();
+
+    /**
+     * @brief 汇总所有流水线同类队列的统计
+     *
+     * 大小与计数相加，平均延迟按入队数加权，更新时间取最新。
+     * @param type 队列类型
+     */
+    [[nodiscard]] static QueueStats aggregatedStats(QueueType type);
+
+    /**
+     * @brief 流水线名称；默认流水线为空
+     */
+    [[nodiscard]] QString pipelineName() const { return m_pipelineName; }
+
+    /**
+     * @brief 本流水线中某个工作线程的名称
+     *
+     * 默认流水线直接使用 role（保持原有线程名），其他流水线追加 "_<流水线名称>"，
+     * 使多条流水线的线程可以在同一个 ThreadManager 中共存。
+     * @param role 线程角色（如 "DataProcessingWorker"）
+     */
+    [[nodiscard]] QString threadName(const QString& role) const;
+
     /**
      * @brief 初始化队列管理器
      * @param captureQueueSize 捕获队列最大大小（0表示无限制）
-     * @param processedQueueSize 处理队列最大大小（0表示无限制）
+     * @param processedQueueSize 处理队列最大积压（统计与健康检查用）；实际保留的帧数不超过 MAX_RETAINED_PROCESSED_FRAMES
      * @return true 初始化成功，false 初始化失败
      */
     bool initialize(int captureQueueSize = 10, int processedQueueSize = 5);
@@ -138,12 +187,108 @@ public:
     bool enqueueProcessedData(const ProcessedData& data);
 
     /**
-     * @brief 处理队列出队
+     * @brief 处理队列出队（单消费者接口，线程安全）
+     *
+     * 首次调用时注册默认读者，从保留的最旧一帧开始按顺序读取。
+     * 默认读者超过 DEFAULT_READER_IDLE_MS 未出队时由统计定时器注销，之后再调用重新注册（已读过的帧不重复出队）：
+     * 弃用的默认读者不再积压，也不再计入层 0 的积压统计（否则会一直压低自适应编码质量）。
      * @param data 用于接收出队数据的引用
-     * @return true 出队成功，false 队列已停止
+     * @return true 出队成功，false 无新数据或队列已停止
      */
     bool dequeueProcessedData(ProcessedData& data);
 
+    /**
+     * @brief 注销 dequeueProcessedData() 的默认读者（线程安全）
+     */
+    void releaseDefaultReader();
+
+    // ==================== 处理队列广播读者 ====================
+
+    /**
+     * @brief 注册处理队列读者（每个客户端会话一个）
+     *
+     * 从最新一帧开始读取；未读帧超过 MAX_READER_LAG 时跳到最新帧。
+     * @param layer 订阅的同播层
+     * @return 读者ID（在该层内唯一）；队列未初始化或层无效时返回 0
+     */
+    quint32 addProcessedReader(int layer = 0);
+
+    /**
+     * @brief 注销处理队列读者
+     * @param readerId addProcessedReader() 返回的ID
+     * @param layer 注册时的同播层
+     */
+    void removeProcessedReader(quint32 readerId, int layer = 0);
+
+    /**
+     * @brief 按读者游标读取下一帧
+     * @param readerId 读者ID
+     * @param data 用于接收数据的引用
+     * @param layer 注册时的同播层
+     * @param skipped 输出（可为空）：本次为追上最新帧而跳过的帧数
+     * @return true 读取成功，false 无新数据、读者未注册或队列已停止
+     */
+    bool readProcessedData(quint32 readerId, ProcessedData& data, int layer = 0, quint64* skipped = nullptr);
+
+    /**
+     * @brief 某个同播层已注册的读者数（层 0 含默认读者）
+     *
+     * 数据处理线程据此决定是否编码该层。
+     */
+    [[nodiscard]] int processedReaderCount(int layer = 0) const;
+
+    /**
+     * @brief 同播层数；队列未初始化时为 0
+     */
+    [[nodiscard]] int processedLayerCount() const;
+
+    // ==================== 捕获唤醒提示 ====================
+
+    /**
+     * @brief 记录客户端输入（线程安全）
+     *
+     * 输入通常紧接着画面变化，捕获线程据此从空闲降频立即恢复全帧率。
+     */
+    void noteInputActivity() { m_inputActivity.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 取出并清除输入标记（捕获线程调用）
+     */
+    bool takeInputActivity() { return m_inputActivity.exchange(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief 请求捕获线程尽快发布一帧，即使画面没有变化（线程安全）
+     *
+     * 画面静止时捕获线程不入队新帧，新订阅的读者（尤其是此前被清空的同播层）需要一帧完整画面。
+     * addProcessedReader() 会自动调用。
+     */
+    void requestFullFrame() { m_fullFrameRequested.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 取出并清除整帧请求（捕获线程调用）
+     */
+    bool takeFullFrameRequest() { return m_fullFrameRequested.exchange(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief 登记使用图块缓存的会话（线程安全）
+     *
+     * 图块哈希只服务于图块缓存，没有会话登记时处理线程不计算。登记时请求整帧，新会话的第一帧即带哈希。
+     */
+    void addTileHashConsumer() {
+        m_tileHashConsumers.fetch_add(1, std::memory_order_relaxed);
+        requestFullFrame();
+    }
+
+    /**
+     * @brief 注销 addTileHashConsumer() 登记的会话（线程安全）
+     */
+    void removeTileHashConsumer() { m_tileHashConsumers.fetch_sub(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief 是否有会话需要图块哈希（处理线程每批查询一次）
+     */
+    bool tileHashesWanted() const { return m_tileHashConsumers.load(std::memory_order_relaxed) > 0; }
+
 signals:
     /**
      * @brief 队列统计更新信号
@@ -166,6 +311,14 @@ signals:
      */
     void queueError(QueueType type, const QString& error);
 
+    /**
+     * @brief 新的编码帧已发布到处理队列（在入队线程发出）
+     *
+     * 事件驱动的会话据此读取新帧，而不是轮询处理队列。
+     * @param layer 同播层
+     */
+    void processedDataAvailable(int layer);
+
 private slots:
     /**
      * @brief 更新统计信息
@@ -195,9 +348,17 @@ private:
 private:
     static QueueManager* s_instance;                                    ///< 单例实例
     static QMutex s_instanceMutex;                                      ///< 单例互斥锁
+    static QList<QueueManager*> s_pipelines;                            ///< 存活的流水线
+    static QMutex s_pipelinesMutex;                                     ///< 流水线列表互斥锁
+
+    QString m_pipelineName;                                             ///< 流水线名称（默认流水线为空）
 
     std::unique_ptr<ThreadSafeQueue<CapturedFrame>> m_captureQueue;     ///< 捕获队列
-    std::unique_ptr<ThreadSafeQueue<ProcessedData>> m_processedQueue;   ///< 处理队列
+    std::vector<std::unique_ptr<BroadcastRing<ProcessedData>>> m_processedLayers;   ///< 处理队列（每个同播层一个广播环）
+    mutable QMutex m_defaultReaderMutex;                                ///< 保护默认读者的注册与注销
+    quint32 m_defaultReader;                                            ///< dequeueProcessedData 使用的读者（0表示未注册）
+    QElapsedTimer m_defaultReaderLastRead;                              ///< 默认读者上次出队的时间
+    quint64 m_defaultReaderLastFrameId;                                 ///< 默认读者上次出队的帧ID（重新注册后不重复出队）
 
     mutable QMutex m_statsMutex;                                        ///< 统计互斥锁
     QueueStats m_captureStats;                                          ///< 捕获队列统计
@@ -211,9 +372,23 @@ private:
 
     quint64 m_lastProcessedFrameId;                                     ///< 最后入队的处理帧ID
 
+    std::atomic<bool> m_inputActivity{ false };                         ///< 上次捕获后是否有客户端输入
+    std::atomic<bool> m_fullFrameRequested{ false };                    ///< 是否有读者等待整帧
+    std::atomic<int> m_tileHashConsumers{ 0 };                          ///< 使用图块缓存的会话数
+
     // 健康检查阈值
     static constexpr int QUEUE_WARNING_THRESHOLD = 80;                  ///< 队列警告阈值（百分比）
     static constexpr int QUEUE_ERROR_THRESHOLD = 95;                    ///< 队列错误阈值（百分比）
     static constexpr int MAX_LATENCY_WARNING = 1000;                    ///< 最大延迟警告阈值（毫秒）
+
+    // 会话读者未读帧超过该数时跳到最新帧（每帧都是完整编码，可以从任意一帧开始显示）
+    static constexpr int MAX_READER_LAG = 3;
+    // 默认读者未出队超过该时间（毫秒）视为弃用
+    static constexpr qint64 DEFAULT_READER_IDLE_MS = 5000;
+    // 处理队列实际保留的帧数上限：每帧带整帧图像，积压统计仍按 maxSize 计算
+    static constexpr int MAX_RETAINED_PROCESSED_FRAMES = 8;
+
+    static qsizetype retainedProcessedFrames(int maxSize);
+    BroadcastRing<ProcessedData>* processedLayer(int layer) const;
 };
 
@@ -1,19 +1,48 @@
 #include "DataProcessingWorker.h"
 #include "../../common/core/logging/LoggingCategories.h"
 #include "../../common/core/config/Constants.h"
+#include "../../common/core/memory/FrameBufferPool.h"
+#include "../../common/core/cache/TileHasher.h"
 #include <QtCore/QMutexLocker>
 #include <QtCore/QThread>
 #include <QtCore/QIODevice>
 #include <QtCore/QBuffer>
 #include <QtGui/QImageWriter>
+#include <QtGui/QPainter>
 #include <QtConcurrent/QtConcurrent>
 #include <cstring>
 #include <algorithm>
 #include <zstd.h>
 
+namespace {
 
-DataProcessingWorker::DataProcessingWorker(QObject* parent)
+/**
+ * @brief 把 source 绘制到缓冲池中的图像上（格式转换或最近邻缩放）
+ * @return 池化图像；缓冲池分配失败时返回空图像，调用方回退到 Qt 的分配路径
+ */
+QImage drawIntoPooledImage(const QImage& source, const QSize& size, QImage::Format format) {
+    QImage target = FrameBufferPool::instance().acquireImage(size, format);
+    if ( target.isNull() ) {
+        return target;
+    }
+    {
+        QPainter painter(&target);
+        if ( !painter.isActive() ) {
+            return QImage();
+        }
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter.drawImage(QRect(QPoint(0, 0), size), source);
+    }
+    return target;
+}
+
+} // namespace
+
+
+DataProcessingWorker::DataProcessingWorker(QueueManager* queueManager, QObject* parent)
     : Worker(parent)
+    , m_pipeline(queueManager)
     , m_queueManager(nullptr)
     , m_config(nullptr)
     , m_dataProcessor(nullptr)
@@ -95,8 +124,8 @@ bool DataProcessingWorker::initialize() {
     qCDebug(lcDataProcessingWorker) << "初始化 DataProcessingWorker";
 
     try {
-        // 获取队列管理器实例
-        QueueManager* queueManager = QueueManager::instance();
+        // 获取所属流水线的队列管理器，未注入时使用默认流水线
+        QueueManager* queueManager = m_pipeline ? m_pipeline : QueueManager::instance();
         if ( !queueManager ) {
             qCCritical(lcDataProcessingWorker) << "无法获取队列管理器实例";
             return false;
@@ -282,6 +311,21 @@ int DataProcessingWorker::processBatchParallel(const std::vector<CapturedFrame>&
     int currentQuality = m_currentQuality.load();
     double currentScale = m_currentScale.load();
 
+    // 同播层：层 0 总是编码；其余层只在有会话订阅时编码，质量与缩放不高于层 0
+    QList<EncodeLayer> layers{ { 0, currentQuality, currentScale } };
+    const int layerCount = std::min(m_queueManager ? m_queueManager->processedLayerCount() : 1,
+                                    CoreConstants::Compression::SIMULCAST_LAYERS);
+    for ( int layer = 1; layer < layerCount; ++layer ) {
+        if ( m_queueManager->processedReaderCount(layer) > 0 ) {
+            layers.append({ layer,
+                            std::min(currentQuality, CoreConstants::Compression::SIMULCAST_LAYER_QUALITY[layer]),
+                            std::min(currentScale, CoreConstants::Compression::SIMULCAST_LAYER_SCALE[layer]) });
+        }
+    }
+
+    // 图块哈希只在有会话使用图块缓存时计算
+    const bool tileHashes = m_queueManager && m_queueManager->tileHashesWanted();
+
     // 过滤无效帧
     std::vector<const CapturedFrame*> framesToProcess;
     framesToProcess.reserve(frames.size());
@@ -315,30 +359,41 @@ int DataProcessingWorker::processBatchParallel(const std::vector<CapturedFrame>&
         frameList.append(frame);
     }
 
-    // 并行编码所有图像，传入当前质量和缩放参数
-    QFuture<ProcessedData> future = QtConcurrent::mapped(frameList,
-        [currentQuality, currentScale](const CapturedFrame* frame) -> ProcessedData {
-        return DataProcessingWorker::encodeImageParallel(frame->image, frame->frameId, 
-                                                         currentQuality, currentScale);
+    // 并行编码所有图像，每帧编码所有订阅中的同播层
+    QFuture<QList<ProcessedData>> future = QtConcurrent::mapped(frameList,
+        [layers, tileHashes](const CapturedFrame* frame) -> QList<ProcessedData> {
+        QList<ProcessedData> encoded = DataProcessingWorker::encodeLayersParallel(frame->image, frame->frameId, layers,
+                                                                                  tileHashes);
+        for ( ProcessedData& data : encoded ) {
+            data.captureTime = frame->timestamp;
+            data.sourceRect = frame->sourceRect;
+        }
+        return encoded;
     });
 
     // 等待所有编码完成
     future.waitForFinished();
 
-    // 收集结果并入队
-    QList<ProcessedData> results = future.results();
-    for ( const auto& processedData : results ) {
-        if ( processedData.isValid() ) {
+    // 收集结果并入队（同一帧的各层依次入队）
+    const QList<QList<ProcessedData>> results = future.results();
+    for ( const QList<ProcessedData>& frameLayers : results ) {
+        bool primaryQueued = false;
+        for ( const auto& processedData : frameLayers ) {
+            if ( !processedData.isValid() ) {
+                continue;
+            }
             // 使用 QueueManager 统一接口入队
             if ( m_queueManager && m_queueManager->enqueueProcessedData(processedData) ) {
-                successCount++;
-                m_processedFrames++;
+                primaryQueued = primaryQueued || processedData.layer == 0;
             } else {
                 // 队列已停止
-                droppedCount++;
-                m_droppedFrames++;
-                qCWarning(lcDataProcessingWorker) << "处理队列已停止，无法入队，帧ID:" << processedData.originalFrameId;
+                qCWarning(lcDataProcessingWorker) << "处理队列已停止，无法入队，帧ID:" << processedData.originalFrameId
+                    << "层:" << processedData.layer;
             }
+        }
+        if ( primaryQueued ) {
+            successCount++;
+            m_processedFrames++;
         } else {
             droppedCount++;
             m_droppedFrames++;
@@ -363,143 +418,219 @@ int DataProcessingWorker::processBatchParallel(const std::vector<CapturedFrame>&
 
 ProcessedData DataProcessingWorker::encodeImageParallel(const QImage& image, quint64 frameId,
                                                         int quality, double scaleFactor) {
-    ProcessedData result;
+    const QList<ProcessedData> layers = encodeLayersParallel(image, frameId, { { 0, quality, scaleFactor } });
+    return layers.isEmpty() ? ProcessedData() : layers.first();
+}
+
+QList<ProcessedData> DataProcessingWorker::encodeLayersParallel(const QImage& image, quint64 frameId,
+                                                                const QList<EncodeLayer>& layers,
+                                                                bool computeTileHashes) {
+    QList<ProcessedData> results;
 
     try {
         // 验证输入图像
         if ( image.isNull() || image.size().isEmpty() ) {
             qCWarning(lcDataProcessingWorker) << "输入图像无效，帧ID:" << frameId
                 << "isNull:" << image.isNull() << "size:" << image.size();
-            return result;
+            return results;
         }
 
-        // 应用缩放（如果缩放因子不为1.0）
-        QImage workingImage = image;
-        if ( scaleFactor < 1.0 && scaleFactor > 0.1 ) {
-            int newWidth = static_cast<int>(image.width() * scaleFactor);
-            int newHeight = static_cast<int>(image.height() * scaleFactor);
-            workingImage = image.scaled(newWidth, newHeight, Qt::KeepAspectRatio, 
-                                        Qt::FastTransformation);
-            if ( workingImage.isNull() ) {
-                qCWarning(lcDataProcessingWorker) << "图像缩放失败，帧ID:" << frameId;
-                workingImage = image; // 回退到原始图像
+        // 确保图像格式为 RGB32 或 RGB888，这是 JPEG 编码推荐的格式
+        // 在原始分辨率上只转换一次，各层共享
+        QImage source = image;
+        if ( image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_RGB888 ) {
+            qCDebug(lcDataProcessingWorker) << "转换图像格式，原格式:" << image.format()
+                << "目标格式: RGB32，帧ID:" << frameId;
+            source = drawIntoPooledImage(image, image.size(), QImage::Format_RGB32);
+            if ( source.isNull() ) {
+                source = image.convertToFormat(QImage::Format_RGB32);
             }
-        }
 
-        // 确保图像格式为 RGB888，这是 JPEG 格式推荐的格式
-        // 在Windows下，Format_RGB32 更常用且兼容性更好
-        QImage convertedImage = workingImage;
-        if ( workingImage.format() != QImage::Format_RGB32 && workingImage.format() != QImage::Format_RGB888 ) {
-            qCDebug(lcDataProcessingWorker) << "转换图像格式，原格式:" << workingImage.format() 
-                << "目标格式: RGB32，帧ID:" << frameId;
-            convertedImage = workingImage.convertToFormat(QImage::Format_RGB32);
-            
-            if ( convertedImage.isNull() ) {
+            if ( source.isNull() ) {
                 qCWarning(lcDataProcessingWorker) << "图像格式转换失败，帧ID:" << frameId;
-                return result;
+                return results;
             }
         }
 
-        // 使用 QBuffer 将图像编码为 JPEG 格式
-        QByteArray jpegData;
-        QBuffer buffer(&jpegData);
-        
-        if ( !buffer.open(QIODevice::WriteOnly) ) {
-            qCWarning(lcDataProcessingWorker) << "无法打开QBuffer，帧ID:" << frameId;
-            return result;
-        }
-
-        //输出原始图像信息和缩放后的信息
-        qCDebug(lcDataProcessingWorker) << "编码JPEG，帧ID:" << frameId
-            << "原始尺寸:" << image.size()
-            << "处理后尺寸:" << convertedImage.size()
-            << "缩放因子:" << scaleFactor
-            << "质量:" << quality;
-
-        // 使用传入的JPEG质量参数
-        bool saveSuccess = convertedImage.save(&buffer, "JPG", quality);
-        buffer.close();
-        
-        if ( !saveSuccess ) {
-            // 第一次诊断输出，记录更详细的错误信息
-            static bool diagnosticPrinted = false;
-            if ( !diagnosticPrinted ) {
-                qCWarning(lcDataProcessingWorker) << "JPEG编码失败诊断信息:";
-                qCWarning(lcDataProcessingWorker) << "  图像尺寸:" << convertedImage.size();
-                qCWarning(lcDataProcessingWorker) << "  图像格式:" << convertedImage.format();
-                qCWarning(lcDataProcessingWorker) << "  支持的图像格式:" 
-                    << QImageWriter::supportedImageFormats();
-                diagnosticPrinted = true;
+        // 已缩放的传输帧（按尺寸共享）
+        struct ScaledFrame {
+            QImage frame;
+            double scaleFactor;
+            QList<ContentHash> tileHashes;
+        };
+        QList<ScaledFrame> scaledFrames;
+
+        for ( const EncodeLayer& layer : layers ) {
+            // 应用缩放（如果缩放因子不为1.0）
+            const bool scale = layer.scaleFactor < 1.0 && layer.scaleFactor > 0.1;
+            const QSize targetSize = scale
+                ? source.size().scaled(static_cast<int>(source.width() * layer.scaleFactor),
+                                       static_cast<int>(source.height() * layer.scaleFactor), Qt::KeepAspectRatio)
+                : source.size();
+
+            // 尺寸与质量都与已编码的层相同：共享编码结果
+            const auto encoded = std::find_if(results.cbegin(), results.cend(), [&](const ProcessedData& data) {
+                return data.imageSize == targetSize && data.quality == layer.quality;
+            });
+            if ( encoded != results.cend() ) {
+                ProcessedData shared = *encoded;
+                shared.layer = layer.layer;
+                results.append(shared);
+                continue;
             }
-            
-            qCWarning(lcDataProcessingWorker) << "无法将图像编码为JPEG格式，帧ID:" << frameId
-                << "图像尺寸:" << convertedImage.size() << "格式:" << convertedImage.format();
-            return result;
-        }
 
-        if ( jpegData.isEmpty() ) {
-            qCWarning(lcDataProcessingWorker) << "JPEG编码结果为空，帧ID:" << frameId;
-            return result;
-        }
+            auto scaled = std::find_if(scaledFrames.begin(), scaledFrames.end(), [&](const ScaledFrame& candidate) {
+                return candidate.frame.size() == targetSize;
+            });
+            if ( scaled == scaledFrames.end() ) {
+                ScaledFrame prepared{ source, 1.0, {} };
+                if ( scale ) {
+                    QImage scaledImage = drawIntoPooledImage(source, targetSize, source.format());
+                    if ( scaledImage.isNull() ) {
+                        scaledImage = source.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+                    }
+                    if ( scaledImage.isNull() ) {
+                        qCWarning(lcDataProcessingWorker) << "图像缩放失败，帧ID:" << frameId;
+                    } else {
+                        prepared.frame = scaledImage;
+                        prepared.scaleFactor = layer.scaleFactor;
+                    }
+                }
+                if ( computeTileHashes ) {
+                    prepared.tileHashes = TileHasher::hashTiles(prepared.frame);
+                }
+                scaledFrames.append(prepared);
+                scaled = scaledFrames.end() - 1;
+            }
 
-        // 对JPEG数据进行zstd压缩（如果启用且数据足够大）
-        // 使用zstd进行二次压缩，提供更高的压缩率和更快的解压速度
-        QByteArray finalData = jpegData;
-        bool zstdCompressed = false;
-        
-        if ( CoreConstants::Compression::ENABLE_ZSTD_COMPRESSION && 
-             jpegData.size() >= CoreConstants::Compression::MIN_SIZE_FOR_ZSTD ) {
-            
-            // 计算压缩后的最大可能大小
-            size_t compressedBound = ZSTD_compressBound(static_cast<size_t>(jpegData.size()));
-            QByteArray compressedData(static_cast<int>(compressedBound), '\0');
-            
-            // 使用zstd压缩，级别3提供良好的压缩率/速度平衡
-            size_t compressedSize = ZSTD_compress(
-                compressedData.data(),
-                compressedBound,
-                jpegData.constData(),
-                static_cast<size_t>(jpegData.size()),
-                CoreConstants::Compression::ZSTD_COMPRESSION_LEVEL
-            );
-            
-            if ( !ZSTD_isError(compressedSize) && compressedSize < static_cast<size_t>(jpegData.size()) ) {
-                // 压缩成功且压缩后更小，使用压缩数据
-                compressedData.resize(static_cast<int>(compressedSize));
-                finalData = compressedData;
-                zstdCompressed = true;
+            ProcessedData data = encodeFrame(image, scaled->frame, frameId, layer.quality, scaled->scaleFactor,
+                                             scaled->tileHashes);
+            if ( !data.isValid() ) {
+                break;
             }
-            // 如果压缩失败或压缩后更大，保持原JPEG数据
+            data.layer = layer.layer;
+            results.append(data);
         }
-
-        // 判断是否进行了缩放
-        bool wasScaled = (scaleFactor < 1.0 && scaleFactor > 0.1);
-
-        //输出原始数据大小和压缩后数据大小的对比日志
-        qCDebug(lcDataProcessingWorker) << "帧ID:" << frameId
-            << "原始图像尺寸:" << image.size() 
-            << "处理后尺寸:" << convertedImage.size()
-            << "缩放:" << (wasScaled ? QString::number(scaleFactor) : "无")
-            << "质量:" << quality
-            << "原始JPEG大小:" << jpegData.size() << "字节,"
-            << (zstdCompressed ? "zstd压缩后:" : "最终:") << finalData.size() << "字节";
-
-        // 构造ProcessedData
-        result.originalFrameId = frameId;
-        result.compressedData = finalData;
-        result.imageSize = convertedImage.size();         // 当前图像尺寸（可能是缩放后的）
-        result.originalImageSize = image.size();          // 原始图像尺寸
-        result.processedTime = QDateTime::currentDateTime();
-        result.originalDataSize = image.sizeInBytes();    // 原始图像数据大小
-        result.compressedDataSize = finalData.size();
-        result.isZstdCompressed = zstdCompressed;         // 标记是否使用了zstd压缩
-        result.isScaled = wasScaled;                      // 标记是否进行了缩放
     } catch ( const std::exception& e ) {
         qCCritical(lcDataProcessingWorker) << "图像处理异常:" << e.what() << "帧ID:" << frameId;
     } catch ( ... ) {
         qCCritical(lcDataProcessingWorker) << "图像处理未知异常，帧ID:" << frameId;
     }
 
+    return results;
+}
+
+ProcessedData DataProcessingWorker::encodeFrame(const QImage& source, const QImage& frame, quint64 frameId,
+                                                int quality, double scaleFactor,
+                                                const QList<ContentHash>& tileHashes) {
+    ProcessedData result;
+
+    // 使用 QBuffer 将图像编码为 JPEG 格式
+    // 输出缓冲是取自缓冲池的临时缓冲，按每像素 4 位预留；超出时由 QBuffer 扩容，扩容后的数组随后同样回到池中
+    FrameBufferPool& pool = FrameBufferPool::instance();
+    QByteArray jpegData = pool.acquireBytes(static_cast<qsizetype>(frame.width()) * frame.height() / 2);
+    QBuffer buffer(&jpegData);
+
+    if ( !buffer.open(QIODevice::WriteOnly) ) {
+        qCWarning(lcDataProcessingWorker) << "无法打开QBuffer，帧ID:" << frameId;
+        return result;
+    }
+
+    //输出原始图像信息和缩放后的信息
+    qCDebug(lcDataProcessingWorker) << "编码JPEG，帧ID:" << frameId
+        << "原始尺寸:" << source.size()
+        << "处理后尺寸:" << frame.size()
+        << "缩放因子:" << scaleFactor
+        << "质量:" << quality;
+
+    // 使用传入的JPEG质量参数
+    bool saveSuccess = frame.save(&buffer, "JPG", quality);
+    buffer.close();
+
+    if ( !saveSuccess ) {
+        // 第一次诊断输出，记录更详细的错误信息
+        static bool diagnosticPrinted = false;
+        if ( !diagnosticPrinted ) {
+            qCWarning(lcDataProcessingWorker) << "JPEG编码失败诊断信息:";
+            qCWarning(lcDataProcessingWorker) << "  图像尺寸:" << frame.size();
+            qCWarning(lcDataProcessingWorker) << "  图像格式:" << frame.format();
+            qCWarning(lcDataProcessingWorker) << "  支持的图像格式:"
+                << QImageWriter::supportedImageFormats();
+            diagnosticPrinted = true;
+        }
+
+        qCWarning(lcDataProcessingWorker) << "无法将图像编码为JPEG格式，帧ID:" << frameId
+            << "图像尺寸:" << frame.size() << "格式:" << frame.format();
+        return result;
+    }
+
+    if ( jpegData.isEmpty() ) {
+        qCWarning(lcDataProcessingWorker) << "JPEG编码结果为空，帧ID:" << frameId;
+        return result;
+    }
+
+    // 对JPEG数据进行zstd压缩（如果启用且数据足够大）
+    // 使用zstd进行二次压缩，提供更高的压缩率和更快的解压速度
+    QByteArrayView finalData = jpegData;
+    bool zstdCompressed = false;
+    QByteArray compressedData;
+
+    if ( CoreConstants::Compression::ENABLE_ZSTD_COMPRESSION &&
+         jpegData.size() >= CoreConstants::Compression::MIN_SIZE_FOR_ZSTD ) {
+
+        // 计算压缩后的最大可能大小
+        size_t compressedBound = ZSTD_compressBound(static_cast<size_t>(jpegData.size()));
+        compressedData = pool.acquireBytes(static_cast<qsizetype>(compressedBound));
+        compressedData.resize(static_cast<qsizetype>(compressedBound));
+
+        // 使用zstd压缩，级别3提供良好的压缩率/速度平衡
+        size_t compressedSize = ZSTD_compress(
+            compressedData.data(),
+            compressedBound,
+            jpegData.constData(),
+            static_cast<size_t>(jpegData.size()),
+            CoreConstants::Compression::ZSTD_COMPRESSION_LEVEL
+        );
+
+        if ( !ZSTD_isError(compressedSize) && compressedSize < static_cast<size_t>(jpegData.size()) ) {
+            // 压缩成功且压缩后更小，使用压缩数据
+            compressedData.resize(static_cast<qsizetype>(compressedSize));
+            finalData = compressedData;
+            zstdCompressed = true;
+        }
+        // 如果压缩失败或压缩后更大，保持原JPEG数据
+    }
+
+    // 判断是否进行了缩放
+    bool wasScaled = (scaleFactor < 1.0 && scaleFactor > 0.1);
+
+    //输出原始数据大小和压缩后数据大小的对比日志
+    qCDebug(lcDataProcessingWorker) << "帧ID:" << frameId
+        << "原始图像尺寸:" << source.size()
+        << "处理后尺寸:" << frame.size()
+        << "缩放:" << (wasScaled ? QString::number(scaleFactor) : "无")
+        << "质量:" << quality
+        << "原始JPEG大小:" << jpegData.size() << "字节,"
+        << (zstdCompressed ? "zstd压缩后:" : "最终:") << finalData.size() << "字节";
+
+    // 发布按实际大小拷贝的数据：临时缓冲按整帧预留，若直接发布，这部分容量会随帧在处理队列、
+    // 广播环和发送队列中滞留。拷贝后两个临时缓冲都不再被引用，交回池中立即可供下一帧复用
+    result.compressedData = finalData.toByteArray();
+    pool.recycle(std::move(jpegData));
+    pool.recycle(std::move(compressedData));
+
+    // 构造ProcessedData
+    result.originalFrameId = frameId;
+    result.imageSize = frame.size();                  // 当前图像尺寸（可能是缩放后的）
+    result.originalImageSize = source.size();         // 原始图像尺寸
+    result.processedTime = QDateTime::currentDateTime();
+    result.originalDataSize = source.sizeInBytes();   // 原始图像数据大小
+    result.compressedDataSize = finalData.size();
+    result.isZstdCompressed = zstdCompressed;         // 标记是否使用了zstd压缩
+    result.isScaled = wasScaled;                      // 标记是否进行了缩放
+    result.frame = frame;                             // 图块缓存逐块编码使用（隐式共享，不拷贝）
+    result.tileHashes = tileHashes;
+    result.quality = quality;
     return result;
 }
 
@@ -25,6 +25,8 @@
  * 2. 对帧数据进行处理
  * 3. 将处理后的数据放入处理队列
  *
+ * 同播：每帧除层 0（自适应质量）外，还为有会话订阅的其他层各编码一份（质量/缩放上限见
+ * CoreConstants::Compression::SIMULCAST_LAYER_*），格式转换只做一次，同尺寸的层共享缩放与图块哈希。
  */
 class DataProcessingWorker : public Worker {
     Q_OBJECT
@@ -32,9 +34,10 @@ class DataProcessingWorker : public Worker {
 public:
     /**
      * @brief 构造函数
+     * @param queueManager 所属流水线的队列管理器，为空时使用 QueueManager::instance()
      * @param parent 父对象
      */
-    explicit DataProcessingWorker(QObject* parent = nullptr);
+    explicit DataProcessingWorker(QueueManager* queueManager = nullptr, QObject* parent = nullptr);
 
     /**
      * @brief 析构函数
@@ -219,6 +222,42 @@ private:
                                              int quality = CoreConstants::Compression::DEFAULT_JPEG_QUALITY,
                                              double scaleFactor = 1.0);
 
+    /**
+     * @brief 同播层编码参数
+     */
+    struct EncodeLayer {
+        int layer;              ///< 同播层
+        int quality;            ///< JPEG质量 (0-100)
+        double scaleFactor;     ///< 缩放因子 (0.1-1.0)
+    };
+
+    /**
+     * @brief 把一帧编码为多个同播层（线程安全的静态方法）
+     *
+     * 格式转换只做一次；尺寸相同的层共享缩放结果与图块哈希，尺寸与质量都相同时共享编码结果。
+     * @param image 图像数据
+     * @param frameId 帧ID
+     * @param layers 要编码的层（第一个通常为层 0）
+     * @param computeTileHashes 是否计算图块哈希（有会话使用图块缓存时）
+     * @return 各层的处理数据（顺序同 layers）；某层编码失败时只返回它之前的层
+     */
+    static QList<ProcessedData> encodeLayersParallel(const QImage& image, quint64 frameId,
+                                                     const QList<EncodeLayer>& layers,
+                                                     bool computeTileHashes = false);
+
+    /**
+     * @brief 把已转换格式、已缩放的传输帧编码为 JPEG（按需 zstd 二次压缩）
+     * @param source 原始图像（用于记录原始尺寸与大小）
+     * @param frame 传输帧
+     * @param frameId 帧ID
+     * @param quality JPEG质量
+     * @param scaleFactor 实际应用的缩放因子（1.0 表示未缩放）
+     * @param tileHashes frame 的图块哈希
+     * @return 处理后的数据；编码失败时无效
+     */
+    static ProcessedData encodeFrame(const QImage& source, const QImage& frame, quint64 frameId, int quality,
+                                     double scaleFactor, const QList<ContentHash>& tileHashes);
+
     /**
      * @brief 根据队列状态调整编码质量
      */
@@ -244,7 +283,8 @@ private:
     void checkPerformance();
 
 private:
-    QueueManager* m_queueManager;                                       ///< 队列管理器
+    QueueManager* m_pipeline;                                           ///< 注入的流水线（为空时使用单例）
+    QueueManager* m_queueManager;                                       ///< 队列管理器（initialize 后有效）
 
     std::shared_ptr<DataProcessingConfig> m_config;                     ///< 处理配置
     std::unique_ptr<DataProcessor> m_dataProcessor;                     ///< 数据处理器
@@ -16,6 +16,7 @@
 
 #include "../../common/core/logging/LoggingCategories.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QMutexLocker>
 
 InputSimulator::InputSimulator(QObject* parent)
@@ -208,6 +209,76 @@ bool InputSimulator::simulateKeyRelease(int key, Qt::KeyboardModifiers modifiers
     return result;
 }
 
+bool InputSimulator::injectBatch(const QList<InputInjection>& events) {
+    QMutexLocker locker(&m_mutex);
+
+    if ( !m_initialized || !m_mouseSimulator || !m_keyboardSimulator ) {
+        setLastError("Input simulator not initialized");
+        return false;
+    }
+    if ( events.isEmpty() ) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 批内各事件只排队，末尾统一提交
+    m_mouseSimulator->setAutoFlush(false);
+    m_keyboardSimulator->setAutoFlush(false);
+
+    bool allSucceeded = true;
+    for ( const InputInjection& event : events ) {
+        allSucceeded = injectLocked(event) && allSucceeded;
+    }
+
+    m_mouseSimulator->flush();
+    m_keyboardSimulator->flush();
+    m_mouseSimulator->setAutoFlush(true);
+    m_keyboardSimulator->setAutoFlush(true);
+
+    m_injectionLatency.record(static_cast<double>(timer.nsecsElapsed()) / 1.0e6);
+    return allSucceeded;
+}
+
+LatencyStats::Summary InputSimulator::injectionLatency() const {
+    return m_injectionLatency.summary();
+}
+
+bool InputSimulator::injectLocked(const InputInjection& event) {
+    bool result = false;
+    switch ( event.type ) {
+        case InputInjection::Type::MouseMove:
+            result = m_mouseSimulator->simulateMouseMove(event.x, event.y);
+            break;
+        case InputInjection::Type::MousePress:
+            result = m_mouseSimulator->simulateMousePress(event.x, event.y, event.button);
+            break;
+        case InputInjection::Type::MouseRelease:
+            result = m_mouseSimulator->simulateMouseRelease(event.x, event.y, event.button);
+            break;
+        case InputInjection::Type::MouseDoubleClick:
+            result = m_mouseSimulator->simulateMouseDoubleClick(event.x, event.y, event.button);
+            break;
+        case InputInjection::Type::MouseWheel:
+            result = m_mouseSimulator->simulateMouseWheel(event.x, event.y, 0, event.wheelDelta);
+            break;
+        case InputInjection::Type::KeyPress:
+            result = m_keyboardSimulator->simulateKeyPress(event.key, event.modifiers);
+            break;
+        case InputInjection::Type::KeyRelease:
+            result = m_keyboardSimulator->simulateKeyRelease(event.key, event.modifiers);
+            break;
+    }
+
+    if ( !result ) {
+        const bool isKeyboard = event.type == InputInjection::Type::KeyPress
+            || event.type == InputInjection::Type::KeyRelease;
+        setLastError(isKeyboard ? m_keyboardSimulator->lastError() : m_mouseSimulator->lastError());
+    }
+    return result;
+}
+
 QSize InputSimulator::getScreenSize() const {
     if ( !m_mouseSimulator ) {
         return QSize(0, 0);
@@ -232,6 +303,16 @@ int InputSimulator::getCurrentCursorType() const {
     return m_mouseSimulator->getCurrentCursorType();
 }
 
+bool InputSimulator::captureCursorImage(CursorImage& image) {
+    QMutexLocker locker(&m_mutex);
+
+    if ( !m_initialized || !m_mouseSimulator ) {
+        return false;
+    }
+
+    return m_mouseSimulator->captureCursorImage(image);
+}
+
 void InputSimulator::setEnabled(bool enabled) {
     QMutexLocker locker(&m_mutex);
 
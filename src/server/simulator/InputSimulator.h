@@ -5,11 +5,37 @@
 #include <QtCore/QSize>
 #include <QtCore/QString>
 #include <QtCore/QMutex>
+#include <QtCore/QList>
+#include "../../common/core/metrics/LatencyStats.h"
 #include <memory>
 
 // 前向声明
 class MouseSimulator;
 class KeyboardSimulator;
+struct CursorImage;
+
+/**
+ * @brief 待注入的单个输入事件（平台无关）
+ */
+struct InputInjection {
+    enum class Type : quint8 {
+        MouseMove,
+        MousePress,
+        MouseRelease,
+        MouseDoubleClick,
+        MouseWheel,
+        KeyPress,
+        KeyRelease
+    };
+
+    Type type = Type::MouseMove;
+    int x = 0;
+    int y = 0;
+    Qt::MouseButton button = Qt::NoButton;     ///< 鼠标按键事件使用
+    int wheelDelta = 0;                        ///< MouseWheel 使用
+    int key = 0;                               ///< 键盘事件使用（Qt::Key，可含 KeypadModifier 标志）
+    Qt::KeyboardModifiers modifiers = Qt::NoModifier;
+};
 
 class InputSimulator : public QObject {
     Q_OBJECT
@@ -34,6 +60,18 @@ public:
     bool simulateKeyPress(int key, Qt::KeyboardModifiers modifiers = Qt::NoModifier);
     bool simulateKeyRelease(int key, Qt::KeyboardModifiers modifiers = Qt::NoModifier);
 
+    /**
+     * @brief 按顺序注入一批事件，全部排入平台事件队列后只提交一次
+     *
+     * X11 下逐事件 XFlush 意味着每个事件一次到 X 服务器的写出；批量注入时
+     * 只在末尾 XFlush 一次。单个事件失败不会中断后续事件。
+     * @return 全部事件注入成功返回 true
+     */
+    bool injectBatch(const QList<InputInjection>& events);
+
+    /// 批量注入耗时分布（每批一个样本，毫秒）
+    LatencyStats::Summary injectionLatency() const;
+
     // 屏幕信息
     QSize getScreenSize() const;
     QPoint getCursorPosition() const;
@@ -41,6 +79,11 @@ public:
     // 光标信息
     int getCurrentCursorType() const;
 
+    /**
+     * @brief 获取当前光标图像（仅在变化时返回 true，见 MouseSimulator::captureCursorImage）
+     */
+    bool captureCursorImage(CursorImage& image);
+
     // 配置
     void setEnabled(bool enabled);
     bool isEnabled() const;
@@ -60,6 +103,12 @@ private:
     bool m_initialized;
     QString m_lastError;
 
+    // 单个事件注入（调用方持有 m_mutex）
+    bool injectLocked(const InputInjection& event);
+
+    // 批量注入耗时
+    LatencyStats m_injectionLatency;
+
     // 线程安全
     QMutex m_mutex;
 };
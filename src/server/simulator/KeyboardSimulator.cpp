@@ -4,6 +4,7 @@ KeyboardSimulator::KeyboardSimulator(QObject* parent)
     : QObject(parent)
     , m_initialized(false)
     , m_enabled(true)
+    , m_autoFlush(true)
 {
 }
 
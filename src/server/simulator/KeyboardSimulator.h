@@ -28,6 +28,11 @@ public:
     void setEnabled(bool enabled) { m_enabled = enabled; }
     bool isEnabled() const { return m_enabled; }
 
+    // 批量注入：关闭自动提交后各操作只排入平台事件队列，由 flush() 一次性提交
+    void setAutoFlush(bool autoFlush) { m_autoFlush = autoFlush; }
+    bool autoFlush() const { return m_autoFlush; }
+    virtual void flush() {}
+
     // 错误处理
     QString lastError() const { return m_lastError; }
 
@@ -37,6 +42,7 @@ protected:
 
     bool m_initialized;
     bool m_enabled;
+    bool m_autoFlush;
     QString m_lastError;
 };
 
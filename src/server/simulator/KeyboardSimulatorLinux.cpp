@@ -5,7 +5,12 @@
 #include "../../common/core/logging/LoggingCategories.h"
 
 
-KeyboardSimulatorLinux::KeyboardSimulatorLinux() : KeyboardSimulator(), m_display(nullptr) {
+KeyboardSimulatorLinux::KeyboardSimulatorLinux()
+    : KeyboardSimulator()
+    , m_display(nullptr)
+    , m_controlKeycode(0)
+    , m_shiftKeycode(0)
+    , m_altKeycode(0) {
     initializeKeyMappings();
 }
 
@@ -25,10 +30,13 @@ bool KeyboardSimulatorLinux::initialize() {
         return false;
     }
 
+    buildKeycodeCache();
+
     m_initialized = true;
     qCDebug(lcInputSimulator) << "KeyboardSimulatorLinux: Initialized successfully";
     qCDebug(lcInputSimulator) << "Standard key mappings:" << m_standardKeyMap.size();
     qCDebug(lcInputSimulator) << "Numpad key mappings:" << m_numpadKeyMap.size();
+    qCDebug(lcInputSimulator) << "Cached keycodes:" << m_keycodeCache.size();
     return true;
 }
 
@@ -37,6 +45,10 @@ void KeyboardSimulatorLinux::cleanup() {
         XCloseDisplay(m_display);
         m_display = nullptr;
     }
+    m_keycodeCache.clear();
+    m_controlKeycode = 0;
+    m_shiftKeycode = 0;
+    m_altKeycode = 0;
     m_initialized = false;
 }
 
@@ -85,7 +97,7 @@ bool KeyboardSimulatorLinux::simulateKeyboardEvent(KeySym key, bool press, unsig
         return false;
     }
 
-    KeyCode keycode = XKeysymToKeycode(m_display, key);
+    KeyCode keycode = keycodeFor(key);
     if (keycode == 0) {
         qCWarning(lcKeyboardSimulatorLinux) << "Failed to convert KeySym to KeyCode:" << key;
         return false;
@@ -102,62 +114,95 @@ bool KeyboardSimulatorLinux::simulateKeyboardEvent(KeySym key, bool press, unsig
         << "press=" << press << "modifiers=" << modifiers 
         << "isMainKeyModifier=" << isMainKeyModifier;
 
-    // 对于修饰键本身，直接发送
+    bool result = false;
     if (isMainKeyModifier) {
-        bool result = XTestFakeKeyEvent(m_display, keycode, press ? True : False, CurrentTime) == True;
-        XFlush(m_display);
+        // 对于修饰键本身，直接发送
+        result = XTestFakeKeyEvent(m_display, keycode, press ? True : False, CurrentTime) == True;
         qCDebug(lcKeyboardSimulatorLinux) << "Modifier key event sent: key=" << key;
-        return result;
-    }
-
-    // 对于普通键，根据 modifiers 参数完整处理修饰键
-    // 按下修饰键（仅在按键按下时）
-    if (press) {
-        if (modifiers & ControlMask) {
-            KeyCode ctrlKey = XKeysymToKeycode(m_display, XK_Control_L);
-            XTestFakeKeyEvent(m_display, ctrlKey, True, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Pressing Control";
+    } else {
+        // 对于普通键，根据 modifiers 参数完整处理修饰键
+        // 按下修饰键（仅在按键按下时）
+        if (press) {
+            if ((modifiers & ControlMask) && m_controlKeycode) {
+                XTestFakeKeyEvent(m_display, m_controlKeycode, True, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Pressing Control";
+            }
+            if ((modifiers & ShiftMask) && m_shiftKeycode) {
+                XTestFakeKeyEvent(m_display, m_shiftKeycode, True, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Pressing Shift";
+            }
+            if ((modifiers & Mod1Mask) && m_altKeycode) {  // Alt
+                XTestFakeKeyEvent(m_display, m_altKeycode, True, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Pressing Alt";
+            }
         }
-        if (modifiers & ShiftMask) {
-            KeyCode shiftKey = XKeysymToKeycode(m_display, XK_Shift_L);
-            XTestFakeKeyEvent(m_display, shiftKey, True, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Pressing Shift";
-        }
-        if (modifiers & Mod1Mask) {  // Alt
-            KeyCode altKey = XKeysymToKeycode(m_display, XK_Alt_L);
-            XTestFakeKeyEvent(m_display, altKey, True, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Pressing Alt";
+
+        // 主键事件
+        result = XTestFakeKeyEvent(m_display, keycode, press ? True : False, CurrentTime) == True;
+
+        // 释放修饰键（仅在按键释放时）
+        if (!press) {
+            if ((modifiers & Mod1Mask) && m_altKeycode) {  // Alt
+                XTestFakeKeyEvent(m_display, m_altKeycode, False, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Releasing Alt";
+            }
+            if ((modifiers & ShiftMask) && m_shiftKeycode) {
+                XTestFakeKeyEvent(m_display, m_shiftKeycode, False, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Releasing Shift";
+            }
+            if ((modifiers & ControlMask) && m_controlKeycode) {
+                XTestFakeKeyEvent(m_display, m_controlKeycode, False, CurrentTime);
+                qCDebug(lcKeyboardSimulatorLinux) << "Releasing Control";
+            }
         }
     }
 
-    // 主键事件
-    bool result = XTestFakeKeyEvent(m_display, keycode, press ? True : False, CurrentTime) == True;
-
-    // 释放修饰键（仅在按键释放时）
-    if (!press) {
-        if (modifiers & Mod1Mask) {  // Alt
-            KeyCode altKey = XKeysymToKeycode(m_display, XK_Alt_L);
-            XTestFakeKeyEvent(m_display, altKey, False, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Releasing Alt";
-        }
-        if (modifiers & ShiftMask) {
-            KeyCode shiftKey = XKeysymToKeycode(m_display, XK_Shift_L);
-            XTestFakeKeyEvent(m_display, shiftKey, False, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Releasing Shift";
-        }
-        if (modifiers & ControlMask) {
-            KeyCode ctrlKey = XKeysymToKeycode(m_display, XK_Control_L);
-            XTestFakeKeyEvent(m_display, ctrlKey, False, CurrentTime);
-            qCDebug(lcKeyboardSimulatorLinux) << "Releasing Control";
-        }
+    // 批量注入时由 flush() 统一提交
+    if (m_autoFlush) {
+        XFlush(m_display);
     }
 
-    XFlush(m_display);
-    
     qCDebug(lcKeyboardSimulatorLinux) << "Keyboard event simulated successfully";
     return result;
 }
 
+void KeyboardSimulatorLinux::flush() {
+    if (m_display) {
+        XFlush(m_display);
+    }
+}
+
+void KeyboardSimulatorLinux::buildKeycodeCache() {
+    m_keycodeCache.clear();
+    if (!m_display) {
+        return;
+    }
+
+    m_keycodeCache.reserve(m_standardKeyMap.size() + m_numpadKeyMap.size() + 3);
+    for (const auto& entry : m_standardKeyMap) {
+        m_keycodeCache.emplace(entry.second, XKeysymToKeycode(m_display, entry.second));
+    }
+    for (const auto& entry : m_numpadKeyMap) {
+        m_keycodeCache.emplace(entry.second, XKeysymToKeycode(m_display, entry.second));
+    }
+
+    m_controlKeycode = keycodeFor(XK_Control_L);
+    m_shiftKeycode = keycodeFor(XK_Shift_L);
+    m_altKeycode = keycodeFor(XK_Alt_L);
+}
+
+KeyCode KeyboardSimulatorLinux::keycodeFor(KeySym keysym) {
+    auto it = m_keycodeCache.find(keysym);
+    if (it != m_keycodeCache.end()) {
+        return it->second;
+    }
+
+    // 映射表之外的 KeySym（如 Latin-1 字符）按需解析后缓存
+    const KeyCode keycode = m_display ? XKeysymToKeycode(m_display, keysym) : 0;
+    m_keycodeCache.emplace(keysym, keycode);
+    return keycode;
+}
+
 KeySym KeyboardSimulatorLinux::qtKeyToLinuxKey(int qtKey) const {
     // 检测是否是小键盘按键 (Qt::KeypadModifier = 0x20000000)
     bool isKeypad = (qtKey & 0x20000000) != 0;
@@ -21,6 +21,7 @@ public:
     // 键盘操作
     bool simulateKeyPress(int qtKey, Qt::KeyboardModifiers modifiers) override;
     bool simulateKeyRelease(int qtKey, Qt::KeyboardModifiers modifiers) override;
+    void flush() override;
 
 private:
     Display* m_display;
@@ -42,10 +43,22 @@ private:
     
     // 初始化按键映射表
     void initializeKeyMappings();
+
+    // 预先解析映射表中所有 KeySym 对应的 KeyCode（initialize() 时调用）
+    void buildKeycodeCache();
+
+    // 查询 KeyCode：命中缓存直接返回，未命中时解析并加入缓存
+    KeyCode keycodeFor(KeySym keysym);
     
     // 按键映射表
     std::unordered_map<int, KeySym> m_standardKeyMap;    // 标准按键映射
     std::unordered_map<int, KeySym> m_numpadKeyMap;      // 小键盘按键映射
+
+    // KeySym -> KeyCode 缓存，避免每次按键都往返 XKeysymToKeycode
+    std::unordered_map<KeySym, KeyCode> m_keycodeCache;
+    KeyCode m_controlKeycode;
+    KeyCode m_shiftKeycode;
+    KeyCode m_altKeycode;
 };
 
 #endif // Q_OS_LINUX
@@ -5,6 +5,7 @@ MouseSimulator::MouseSimulator(QObject* parent)
     : QObject(parent)
     , m_initialized(false)
     , m_enabled(true)
+    , m_autoFlush(true)
     , m_screenSize(1920, 1080) // 默认值
 {
 }
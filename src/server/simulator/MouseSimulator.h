@@ -1,10 +1,24 @@
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
 #include <QtCore/QSize>
 #include <QtCore/QString>
 
+/**
+ * @brief 光标图像（平台无关）
+ */
+struct CursorImage {
+    static constexpr int MAX_DIMENSION = 128;   ///< 超过该尺寸的光标不读取
+
+    quint16 width = 0;
+    quint16 height = 0;
+    qint16 hotspotX = 0;
+    qint16 hotspotY = 0;
+    QByteArray pixels;     ///< 预乘 ARGB32，逐像素小端 quint32，行间无填充
+};
+
 /**
  * @brief 鼠标模拟器抽象基类
  * 
@@ -36,10 +50,22 @@ public:
     // 光标信息
     virtual int getCurrentCursorType() const = 0;
 
+    /**
+     * @brief 获取当前光标图像
+     * @return 首次调用或光标自上次获取后发生变化时返回 true 并填充 image；
+     *         光标未变化或平台不支持时返回 false
+     */
+    virtual bool captureCursorImage(CursorImage& image) { Q_UNUSED(image); return false; }
+
     // 配置
     void setEnabled(bool enabled) { m_enabled = enabled; }
     bool isEnabled() const { return m_enabled; }
 
+    // 批量注入：关闭自动提交后各操作只排入平台事件队列，由 flush() 一次性提交
+    void setAutoFlush(bool autoFlush) { m_autoFlush = autoFlush; }
+    bool autoFlush() const { return m_autoFlush; }
+    virtual void flush() {}
+
     // 错误处理
     QString lastError() const { return m_lastError; }
 
@@ -49,6 +75,7 @@ protected:
 
     bool m_initialized;
     bool m_enabled;
+    bool m_autoFlush;
     QString m_lastError;
     QSize m_screenSize;
 };
@@ -3,9 +3,15 @@
 #ifdef Q_OS_LINUX
 
 #include "../../common/core/logging/LoggingCategories.h"
+#include <QtCore/QtEndian>
 
 
-MouseSimulatorLinux::MouseSimulatorLinux() : MouseSimulator(), m_display(nullptr) {
+MouseSimulatorLinux::MouseSimulatorLinux()
+    : MouseSimulator()
+    , m_display(nullptr)
+    , m_hasXFixes(false)
+    , m_xfixesEventBase(0)
+    , m_cursorChanged(true) {
 }
 
 MouseSimulatorLinux::~MouseSimulatorLinux() {
@@ -25,6 +31,17 @@ bool MouseSimulatorLinux::initialize() {
     }
 
     m_screenSize = getScreenSize();
+
+    // 订阅光标变化通知，仅在光标改变时才读取图像
+    int xfixesErrorBase = 0;
+    m_hasXFixes = XFixesQueryExtension(m_display, &m_xfixesEventBase, &xfixesErrorBase) == True;
+    if (m_hasXFixes) {
+        XFixesSelectCursorInput(m_display, DefaultRootWindow(m_display), XFixesDisplayCursorNotifyMask);
+        m_cursorChanged = true;
+    } else {
+        qCWarning(lcInputSimulator) << "MouseSimulatorLinux: XFixes not available, cursor images disabled";
+    }
+
     m_initialized = true;
     qCDebug(lcInputSimulator) << "MouseSimulatorLinux: Initialized successfully";
     return true;
@@ -35,6 +52,8 @@ void MouseSimulatorLinux::cleanup() {
         XCloseDisplay(m_display);
         m_display = nullptr;
     }
+    m_hasXFixes = false;
+    m_cursorChanged = true;
     m_initialized = false;
 }
 
@@ -133,6 +152,54 @@ int MouseSimulatorLinux::getCurrentCursorType() const {
     return Qt::ArrowCursor; // 默认返回 Qt::ArrowCursor (0)
 }
 
+bool MouseSimulatorLinux::captureCursorImage(CursorImage& image) {
+    if (!m_display || !m_hasXFixes) {
+        return false;
+    }
+
+    // 该连接只订阅了光标通知，排空事件队列即可得知光标是否变化
+    while (XPending(m_display) > 0) {
+        XEvent event;
+        XNextEvent(m_display, &event);
+        if (event.type == m_xfixesEventBase + XFixesCursorNotify) {
+            m_cursorChanged = true;
+        }
+    }
+    if (!m_cursorChanged) {
+        return false;
+    }
+    m_cursorChanged = false;
+
+    XFixesCursorImage* cursor = XFixesGetCursorImage(m_display);
+    if (!cursor) {
+        return false;
+    }
+
+    const bool validSize = cursor->width > 0 && cursor->height > 0
+        && cursor->width <= CursorImage::MAX_DIMENSION && cursor->height <= CursorImage::MAX_DIMENSION;
+    if (!validSize) {
+        qCDebug(lcMouseSimulatorLinux) << "Cursor image size not supported:" << cursor->width << "x" << cursor->height;
+        XFree(cursor);
+        return false;
+    }
+
+    image.width = cursor->width;
+    image.height = cursor->height;
+    image.hotspotX = static_cast<qint16>(cursor->xhot);
+    image.hotspotY = static_cast<qint16>(cursor->yhot);
+
+    // XFixes 像素为 unsigned long（64 位平台上高 32 位为 0），低 32 位为预乘 ARGB
+    const qsizetype pixelCount = qsizetype(cursor->width) * cursor->height;
+    image.pixels.resize(pixelCount * 4);
+    char* out = image.pixels.data();
+    for (qsizetype i = 0; i < pixelCount; ++i) {
+        qToLittleEndian<quint32>(static_cast<quint32>(cursor->pixels[i]), out + i * 4);
+    }
+
+    XFree(cursor);
+    return true;
+}
+
 bool MouseSimulatorLinux::simulateMouseEvent(int x, int y, unsigned int button, bool press) {
     if (!m_display) {
         return false;
@@ -143,19 +210,28 @@ bool MouseSimulatorLinux::simulateMouseEvent(int x, int y, unsigned int button,
     if (button == 0) {
         // 鼠标移动
         result = XTestFakeMotionEvent(m_display, -1, x, y, CurrentTime) == True;
-        XFlush(m_display);
         qCDebug(lcMouseSimulatorLinux) << "Mouse move: x=" << x << "y=" << y << "result=" << result;
     } else {
         // 鼠标按键
         result = XTestFakeButtonEvent(m_display, button, press ? True : False, CurrentTime) == True;
-        XFlush(m_display);
         qCDebug(lcMouseSimulatorLinux) << "Mouse button: button=" << button 
             << "press=" << press << "result=" << result;
     }
 
+    // 批量注入时由 flush() 统一提交
+    if (m_autoFlush) {
+        XFlush(m_display);
+    }
+
     return result;
 }
 
+void MouseSimulatorLinux::flush() {
+    if (m_display) {
+        XFlush(m_display);
+    }
+}
+
 unsigned int MouseSimulatorLinux::qtButtonToX11Button(Qt::MouseButton button) const {
     switch (button) {
         case Qt::LeftButton:
@@ -5,6 +5,7 @@
 #ifdef Q_OS_LINUX
 #include <X11/Xlib.h>
 #include <X11/extensions/XTest.h>
+#include <X11/extensions/Xfixes.h>
 
 
 class MouseSimulatorLinux : public MouseSimulator {
@@ -21,6 +22,7 @@ public:
     bool simulateMousePress(int x, int y, Qt::MouseButton button) override;
     bool simulateMouseRelease(int x, int y, Qt::MouseButton button) override;
     bool simulateMouseWheel(int x, int y, int deltaX, int deltaY) override;
+    void flush() override;
     
     // 屏幕信息
     QSize getScreenSize() const override;
@@ -28,9 +30,15 @@ public:
 
     // 光标信息
     int getCurrentCursorType() const override;
+    bool captureCursorImage(CursorImage& image) override;
 
 private:
     Display* m_display;
+
+    // XFixes 光标变化通知
+    bool m_hasXFixes;
+    int m_xfixesEventBase;
+    bool m_cursorChanged;
     
     // 鼠标事件模拟
     bool simulateMouseEvent(int x, int y, unsigned int button, bool press);
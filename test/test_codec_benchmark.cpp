@@ -0,0 +1,171 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QtCore/QDataStream>
+#include "../src/common/core/logging/LoggingCategories.h"
+#include "../src/common/core/network/Protocol.h"
+
+/**
+ * @brief 消息编解码耗时基准（ns/消息）
+ *
+ * 对比字段描述符实现与原 QDataStream 实现（此处内联保留作为基线），
+ * 覆盖高频输入消息 MouseEvent、KeyboardEvent 及 ScreenData 定长头部。
+ * 运行：test_codec_benchmark -tickcounter 或 -iterations 100000
+ */
+class TestCodecBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void benchmark_mouseEncode();
+    void benchmark_mouseEncodeDataStream();
+    void benchmark_mouseDecode();
+    void benchmark_mouseDecodeDataStream();
+
+    void benchmark_keyboardEncode();
+    void benchmark_keyboardEncodeDataStream();
+    void benchmark_keyboardDecode();
+
+    void benchmark_screenHeaderEncode();
+    void benchmark_screenHeaderDecode();
+
+private:
+    static MouseEvent sampleMouse();
+    static KeyboardEvent sampleKeyboard();
+    static ScreenData sampleScreen();
+};
+
+MouseEvent TestCodecBenchmark::sampleMouse() {
+    MouseEvent event{};
+    event.eventType = MouseEventType::MOVE;
+    event.x = 960;
+    event.y = 540;
+    event.wheelDelta = 0;
+    return event;
+}
+
+KeyboardEvent TestCodecBenchmark::sampleKeyboard() {
+    KeyboardEvent event{};
+    event.eventType = KeyboardEventType::KEY_PRESS;
+    event.keyCode = Qt::Key_A;
+    event.modifiers = 0;
+    event.text = QStringLiteral("a");
+    return event;
+}
+
+ScreenData TestCodecBenchmark::sampleScreen() {
+    // 空图像：只测量定长头部
+    ScreenData screen;
+    screen.width = 1920;
+    screen.height = 1080;
+    screen.originalWidth = 1920;
+    screen.originalHeight = 1080;
+    return screen;
+}
+
+void TestCodecBenchmark::benchmark_mouseEncode() {
+    const MouseEvent event = sampleMouse();
+    QByteArray out;
+    out.reserve(64);
+    QBENCHMARK {
+        out.resize(0);
+        event.appendTo(out);
+    }
+    QCOMPARE(out.size(), qsizetype(7));
+}
+
+void TestCodecBenchmark::benchmark_mouseEncodeDataStream() {
+    const MouseEvent event = sampleMouse();
+    QByteArray out;
+    QBENCHMARK {
+        out = QByteArray();
+        QDataStream ds(&out, QIODevice::WriteOnly);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        ds << static_cast<quint8>(event.eventType) << event.x << event.y << event.wheelDelta;
+    }
+    QCOMPARE(out, event.encode());
+}
+
+void TestCodecBenchmark::benchmark_mouseDecode() {
+    const QByteArray bytes = sampleMouse().encode();
+    MouseEvent decoded{};
+    QBENCHMARK {
+        QVERIFY(decoded.decode(bytes));
+    }
+    QCOMPARE(decoded.x, qint16(960));
+}
+
+void TestCodecBenchmark::benchmark_mouseDecodeDataStream() {
+    const QByteArray bytes = sampleMouse().encode();
+    qint16 x = 0;
+    QBENCHMARK {
+        QDataStream ds(bytes);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        quint8 type8 = 0;
+        qint16 y = 0, wheel = 0;
+        ds >> type8 >> x >> y >> wheel;
+        QVERIFY(ds.status() == QDataStream::Ok);
+    }
+    QCOMPARE(x, qint16(960));
+}
+
+void TestCodecBenchmark::benchmark_keyboardEncode() {
+    const KeyboardEvent event = sampleKeyboard();
+    QByteArray out;
+    out.reserve(64);
+    QBENCHMARK {
+        out.resize(0);
+        event.appendTo(out);
+    }
+    QCOMPARE(out, event.encode());
+}
+
+void TestCodecBenchmark::benchmark_keyboardEncodeDataStream() {
+    const KeyboardEvent event = sampleKeyboard();
+    QByteArray out;
+    QBENCHMARK {
+        out = QByteArray();
+        QDataStream ds(&out, QIODevice::WriteOnly);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        const QByteArray utf8 = event.text.toUtf8();
+        ds << static_cast<quint8>(event.eventType) << event.keyCode << event.modifiers << static_cast<quint32>(utf8.size());
+        ds.writeRawData(utf8.constData(), utf8.size());
+    }
+    QCOMPARE(out, event.encode());
+}
+
+void TestCodecBenchmark::benchmark_keyboardDecode() {
+    const QByteArray bytes = sampleKeyboard().encode();
+    KeyboardEvent decoded{};
+    QBENCHMARK {
+        QVERIFY(decoded.decode(bytes));
+    }
+    QCOMPARE(decoded.keyCode, quint32(Qt::Key_A));
+}
+
+void TestCodecBenchmark::benchmark_screenHeaderEncode() {
+    const ScreenData screen = sampleScreen();
+    QByteArray head;
+    QByteArray body;
+    QByteArray tail;
+    head.reserve(64);
+    QBENCHMARK {
+        head.resize(0);
+        QVERIFY(screen.encodeSegments(head, body, tail));
+    }
+    QCOMPARE(head.size(), ScreenData::FIXED_FIELDS_SIZE);
+}
+
+void TestCodecBenchmark::benchmark_screenHeaderDecode() {
+    // 附带1字节图像，满足 decodeView 的合理性检查
+    ScreenData screen = sampleScreen();
+    screen.imageData = QByteArray(1, 'x');
+    screen.dataSize = 1;
+    const QByteArray bytes = screen.encode();
+    ScreenData decoded;
+    QBENCHMARK {
+        QVERIFY(decoded.decodeView(bytes));
+    }
+    QCOMPARE(decoded.width, quint16(1920));
+}
+
+QTEST_MAIN(TestCodecBenchmark)
+#include "test_codec_benchmark.moc"
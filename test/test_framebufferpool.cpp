@@ -0,0 +1,78 @@
+#include <QtTest/QtTest>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+#include <memory>
+#include "../src/common/core/memory/FrameBufferPool.h"
+
+/**
+ * @brief 帧缓冲池（FrameBufferPool）测试
+ */
+class TestFrameBufferPool : public QObject {
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief 测试帧缓冲池的对齐与引用计数归还
+     */
+    void test_frameBufferPool();
+};
+
+void TestFrameBufferPool::test_frameBufferPool()
+{
+    FrameBufferPool pool;
+
+    // 起始地址与行跨度按 64 字节对齐
+    QImage image = pool.acquireImage(QSize(100, 50), QImage::Format_RGB32);
+    QVERIFY(!image.isNull());
+    QCOMPARE(image.size(), QSize(100, 50));
+    QCOMPARE(image.bytesPerLine(), qsizetype(448));
+    QCOMPARE(reinterpret_cast<quintptr>(image.constBits()) % FrameBufferPool::ALIGNMENT, quintptr(0));
+    image.fill(Qt::red);
+    const uchar* block = image.constBits();
+
+    // 仍有副本存活时内存块不归还
+    QImage copy = image;
+    image = QImage();
+    QCOMPARE(pool.stats().idleBlocks, 0);
+    QCOMPARE(copy.pixel(99, 49), QColor(Qt::red).rgb());
+
+    // 最后一个副本释放后，相同尺寸的请求复用同一块内存
+    copy = QImage();
+    QCOMPARE(pool.stats().idleBlocks, 1);
+    QImage reused = pool.acquireImage(QSize(100, 50), QImage::Format_RGB32);
+    QCOMPARE(reused.constBits(), block);
+    QCOMPARE(pool.stats().imageHits, quint64(1));
+
+    // 远小于空闲块的请求不占用整块
+    reused = QImage();
+    QImage small = pool.acquireImage(QSize(8, 8), QImage::Format_RGB32);
+    QVERIFY(small.constBits() != block);
+    QCOMPARE(pool.stats().idleBlocks, 1);
+
+    // 交回的字节数组在下游释放前不会再次借出
+    QByteArray bytes = pool.acquireBytes(4096);
+    QVERIFY(bytes.isEmpty());
+    QVERIFY(bytes.capacity() >= 4096);
+    bytes.append(1000, 'x');
+    const char* storage = bytes.constData();
+    QByteArray downstream = bytes;
+    pool.recycle(std::move(bytes));
+    QByteArray other = pool.acquireBytes(1024);
+    QVERIFY(other.constData() != storage);
+    QCOMPARE(downstream, QByteArray(1000, 'x'));
+
+    downstream = QByteArray();
+    QByteArray recycled = pool.acquireBytes(1024);
+    QCOMPARE(recycled.constData(), storage);
+    QVERIFY(recycled.isEmpty());
+
+    // 池先于借出的图像销毁时，图像仍然有效
+    auto shortLived = std::make_unique<FrameBufferPool>();
+    QImage survivor = shortLived->acquireImage(QSize(16, 16), QImage::Format_RGB32);
+    shortLived.reset();
+    survivor.fill(Qt::blue);
+    QCOMPARE(survivor.pixel(0, 0), QColor(Qt::blue).rgb());
+}
+
+QTEST_MAIN(TestFrameBufferPool)
+#include "test_framebufferpool.moc"
@@ -0,0 +1,72 @@
+#include <QtTest/QtTest>
+#include "../src/client/managers/InputBatcher.h"
+#include "../src/common/core/config/NetworkConstants.h"
+
+/**
+ * @brief 客户端输入批量合并（InputBatcher）测试
+ */
+class TestInputBatcher : public QObject {
+    Q_OBJECT
+
+private slots:
+    void test_inputBatcherCoalescesMoves();
+};
+
+void TestInputBatcher::test_inputBatcherCoalescesMoves() {
+    QList<InputBatch> sent;
+    InputBatcher batcher([&sent](const InputBatch& batch) { sent.append(batch); });
+
+    // 连续移动合并为一个事件，保留最后位置
+    batcher.addMouseMove(1, 1, 1000);
+    batcher.addMouseMove(2, 2, 1002);
+    batcher.addMouseMove(3, 3, 1004);
+    QCOMPARE(batcher.pendingEvents(), qsizetype(1));
+    QCOMPARE(batcher.coalescedMoves(), quint64(2));
+    QVERIFY(sent.isEmpty());
+
+    // 按键事件追加在移动之后，顺序不变
+    MouseEvent press{};
+    press.eventType = MouseEventType::LEFT_PRESS;
+    press.x = 3;
+    press.y = 3;
+    batcher.addMouseEvent(press, 1005);
+    QVERIFY(!batcher.hasOnlyMoves());
+
+    // 按键之后的移动不会越过按键与之前的移动合并
+    batcher.addMouseMove(10, 10, 1006);
+    batcher.addMouseMove(12, 12, 1007);
+    KeyboardEvent key{};
+    key.eventType = KeyboardEventType::KEY_PRESS;
+    key.keyCode = Qt::Key_A;
+    batcher.addKeyboardEvent(key, 1008);
+    QVERIFY(sent.isEmpty());
+
+    batcher.flush();
+    QVERIFY(batcher.isEmpty());
+    QCOMPARE(sent.size(), qsizetype(1));
+    const QList<InputBatchEvent>& events = sent[0].events;
+    QCOMPARE(sent[0].baseTimestamp, quint64(1000));
+    QCOMPARE(events.size(), qsizetype(4));
+    QCOMPARE(events[0].mouse.eventType, MouseEventType::MOVE);
+    QCOMPARE(events[0].mouse.x, qint16(3));
+    QCOMPARE(events[0].timeOffsetMs, quint16(4));
+    QCOMPARE(events[1].mouse.eventType, MouseEventType::LEFT_PRESS);
+    QCOMPARE(events[1].timeOffsetMs, quint16(5));
+    QCOMPARE(events[2].mouse.x, qint16(12));
+    QCOMPARE(events[3].kind, InputBatchEvent::Kind::KEYBOARD);
+
+    // 达到事件数上限时立即发送
+    sent.clear();
+    MouseEvent wheel{};
+    wheel.eventType = MouseEventType::WHEEL_UP;
+    wheel.wheelDelta = 120;
+    for ( int i = 0; i < NetworkConstants::INPUT_BATCH_MAX_EVENTS + 1; ++i ) {
+        batcher.addMouseEvent(wheel, 2000);
+    }
+    QCOMPARE(sent.size(), qsizetype(1));
+    QCOMPARE(sent[0].events.size(), qsizetype(NetworkConstants::INPUT_BATCH_MAX_EVENTS));
+    QCOMPARE(batcher.pendingEvents(), qsizetype(1));
+}
+
+QTEST_MAIN(TestInputBatcher)
+#include "test_inputbatcher.moc"
@@ -0,0 +1,120 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include "../src/common/core/logging/LoggingCategories.h"
+#include "../src/server/simulator/InputSimulator.h"
+#include "../src/server/simulator/MouseSimulator.h"
+
+/**
+ * @brief 输入注入测试（X11）
+ *
+ * 验证 InputSimulator::injectBatch 的批量注入路径：
+ * 1. 一批鼠标移动注入后指针停在最后一个位置
+ * 2. 键盘按下/释放批次注入成功（使用缓存的键码）
+ * 3. 每批记录一个注入耗时样本
+ * 4. 光标图像只在首次和变化后返回（XFixes）
+ *
+ * 需要 X 服务器：无 DISPLAY 时跳过，可用 xvfb-run ctest -R InputSimulatorTest 运行。
+ */
+class TestInputSimulator : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void test_emptyBatch();
+    void test_mouseMoveBatch();
+    void test_keyboardBatch();
+    void test_injectionLatencyRecorded();
+    void test_cursorImageOnlyOnChange();
+
+private:
+    InputSimulator* m_simulator = nullptr;
+};
+
+void TestInputSimulator::initTestCase() {
+    if ( qEnvironmentVariableIsEmpty("DISPLAY") ) {
+        QSKIP("DISPLAY 未设置，需要 X 服务器（例如 xvfb-run）");
+    }
+
+    m_simulator = new InputSimulator(this);
+    QVERIFY2(m_simulator->initialize(), qPrintable(m_simulator->lastError()));
+    qCInfo(lcTest) << "Screen size:" << m_simulator->getScreenSize();
+}
+
+void TestInputSimulator::cleanupTestCase() {
+    if ( m_simulator ) {
+        m_simulator->cleanup();
+    }
+}
+
+void TestInputSimulator::test_emptyBatch() {
+    QVERIFY(m_simulator->injectBatch({}));
+}
+
+void TestInputSimulator::test_mouseMoveBatch() {
+    const QSize screen = m_simulator->getScreenSize();
+    QVERIFY(screen.width() > 20 && screen.height() > 20);
+
+    QList<InputInjection> events;
+    for ( int i = 0; i < 16; ++i ) {
+        InputInjection move;
+        move.type = InputInjection::Type::MouseMove;
+        move.x = 10 + i;
+        move.y = 10 + i;
+        events.append(move);
+    }
+
+    QVERIFY(m_simulator->injectBatch(events));
+    QTRY_COMPARE_WITH_TIMEOUT(m_simulator->getCursorPosition(), QPoint(25, 25), 1000);
+}
+
+void TestInputSimulator::test_keyboardBatch() {
+    // Shift+A：按下 Shift、A，按相反顺序释放
+    const QList<QPair<InputInjection::Type, int>> sequence = {
+        { InputInjection::Type::KeyPress, Qt::Key_Shift },
+        { InputInjection::Type::KeyPress, Qt::Key_A },
+        { InputInjection::Type::KeyRelease, Qt::Key_A },
+        { InputInjection::Type::KeyRelease, Qt::Key_Shift }
+    };
+
+    QList<InputInjection> events;
+    for ( const auto& step : sequence ) {
+        InputInjection event;
+        event.type = step.first;
+        event.key = step.second;
+        events.append(event);
+    }
+
+    QVERIFY(m_simulator->injectBatch(events));
+}
+
+void TestInputSimulator::test_injectionLatencyRecorded() {
+    const int before = m_simulator->injectionLatency().count;
+
+    InputInjection move;
+    move.type = InputInjection::Type::MouseMove;
+    move.x = 30;
+    move.y = 30;
+    QVERIFY(m_simulator->injectBatch({ move, move }));
+
+    const LatencyStats::Summary summary = m_simulator->injectionLatency();
+    QCOMPARE(summary.count, before + 1);
+    qCInfo(lcTest) << "Injection latency:" << summary.toString();
+}
+
+void TestInputSimulator::test_cursorImageOnlyOnChange() {
+    CursorImage image;
+    if ( !m_simulator->captureCursorImage(image) ) {
+        QSKIP("XFixes 不可用或光标尺寸不受支持");
+    }
+    QVERIFY(image.width > 0 && image.height > 0);
+    QCOMPARE(image.pixels.size(), qsizetype(image.width) * image.height * 4);
+
+    // 光标未变化时不再返回图像
+    CursorImage unchanged;
+    QVERIFY(!m_simulator->captureCursorImage(unchanged));
+}
+
+QTEST_GUILESS_MAIN(TestInputSimulator)
+#include "test_inputsimulator.moc"
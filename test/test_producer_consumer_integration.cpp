@@ -275,6 +275,8 @@ void TestProducerConsumerIntegration::test_basicProducerConsumer() {
     bool dequeued = m_queueManager->dequeueProcessedData(processedData);
     QVERIFY(dequeued);
     QVERIFY(verifyProcessedData(processedData, testFrame));
+    // 发布的数据按实际大小分配：编码用的整帧预留缓冲不随帧滞留在下游
+    QCOMPARE(processedData.compressedData.capacity(), processedData.compressedData.size());
 
     // 在退出线程前，确保在所属线程同步调用stop以触发cleanup，
     // 避免跨线程析构导致内部QTimer停止时出现killTimer警告
@@ -0,0 +1,1098 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QtCore/QDebug>
+
+// 包含需要测试的类
+#include "../src/common/core/logging/LoggingCategories.h"
+#include "../src/common/core/network/Protocol.h"
+#include "../src/common/core/network/ClockSynchronizer.h"
+#include "../src/common/core/metrics/LatencyStats.h"
+#include "../src/common/core/network/ReceiveBuffer.h"
+#include "../src/common/core/network/PrioritySendQueue.h"
+#include "../src/common/core/network/FragmentAssembler.h"
+#include "../src/common/core/config/NetworkConstants.h"
+#include "../src/common/core/cache/ContentHash.h"
+#include "../src/common/core/cache/LruCache.h"
+#include <QtCore/QBuffer>
+#include <algorithm>
+
+/**
+ * @brief 协议编解码与网络辅助组件测试
+ *
+ * 验证内容：
+ * 1. 心跳时间戳消息的编解码及与旧版空载荷的兼容
+ * 2. 时钟偏移/RTT估计
+ * 3. ScreenData 可选尾部字段的前后兼容
+ * 4. 延迟分位数统计
+ * 5. 握手能力协商及与旧版本握手的兼容
+ * 6. 接收缓冲区的游标解析与压缩
+ * 7. 零拷贝解析路径
+ * 8. 校验算法实现一致性与协商
+ * 9. 分段编码（scatter-gather）发送路径
+ * 10. 字段描述符编解码与原 QDataStream 格式的一致性
+ */
+class TestProtocol : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // 心跳与时钟同步
+    void test_heartbeatRoundTrip();
+    void test_heartbeatLegacyPayload();
+    void test_clockSyncOffsetAndRtt();
+    void test_clockSyncMinRttFilter();
+    void test_clockSyncExchange();
+    void test_clockSyncIgnoresMismatchedOrigin();
+
+    // ScreenData 兼容性
+    void test_screenDataCaptureTimestamp();
+    void test_screenDataWithoutCaptureTimestamp();
+
+    // 延迟统计
+    void test_latencyStatsPercentiles();
+    void test_latencyStatsWindow();
+
+    // 能力协商
+    void test_capabilityHandshakeRoundTrip();
+    void test_capabilityLegacyHandshake();
+    void test_capabilityIntersection();
+
+    // 接收缓冲区
+    void test_receiveBufferStreamParsing();
+    void test_receiveBufferCompaction();
+
+    // 零拷贝解析
+    void test_zeroCopyParse();
+
+    // 校验算法
+    void test_checksumKnownVectors();
+    void test_checksumImplementationsAgree();
+    void test_checksumNegotiation();
+    void test_checksumAlgorithmParse();
+    void test_checksumIncremental();
+
+    // 分段编码
+    void test_messageSegments();
+
+    // 字段描述符编解码
+    void test_wireFormatMatchesDataStream();
+    void test_wireFormatRejectsTruncated();
+
+    // 优先级发送与分片
+    void test_sendQueueInteractiveFirst();
+    void test_sendQueueLowWatermark();
+    void test_fragmentRoundTrip();
+    void test_fragmentRejectsOutOfOrder();
+
+    // 输入事件批量发送
+    void test_inputBatchRoundTrip();
+    void test_cursorStateRoundTrip();
+    void test_cursorShapeRoundTrip();
+    void test_lruCacheMirrorsEviction();
+
+    // 图块缓存
+    void test_tileUpdateRoundTrip();
+
+    // 多显示器
+    void test_monitorLayoutRoundTrip();
+};
+
+void TestProtocol::initTestCase() {
+    qCDebug(lcTest) << "初始化协议测试";
+}
+
+void TestProtocol::cleanupTestCase() {
+    qCDebug(lcTest) << "清理协议测试";
+}
+
+void TestProtocol::init() {
+}
+
+void TestProtocol::cleanup() {
+}
+
+void TestProtocol::test_heartbeatRoundTrip() {
+    HeartbeatMessage sent;
+    sent.originTimestamp = 1700000000001ULL;
+    sent.receiveTimestamp = 1700000000002ULL;
+    sent.transmitTimestamp = 1700000000003ULL;
+
+    QByteArray encoded = sent.encode();
+    QCOMPARE(encoded.size(), 24);
+
+    HeartbeatMessage received;
+    QVERIFY(received.decode(encoded));
+    QCOMPARE(received.originTimestamp, sent.originTimestamp);
+    QCOMPARE(received.receiveTimestamp, sent.receiveTimestamp);
+    QCOMPARE(received.transmitTimestamp, sent.transmitTimestamp);
+}
+
+void TestProtocol::test_heartbeatLegacyPayload() {
+    // 旧版本对端发送空载荷（BaseMessage），解码应失败以便调用方退回普通心跳
+    HeartbeatMessage message;
+    QVERIFY(!message.decode(QByteArray()));
+    QVERIFY(!message.decode(BaseMessage().encode()));
+}
+
+void TestProtocol::test_clockSyncOffsetAndRtt() {
+    ClockSynchronizer sync;
+    QVERIFY(!sync.estimate().valid);
+
+    // 对端时钟快 100ms，单程 10ms，对端处理 5ms
+    // T1=1000 -> T2=1110 (对端) -> T3=1115 (对端) -> T4=1025
+    QVERIFY(sync.addSample(1000, 1110, 1115, 1025));
+
+    ClockSyncEstimate estimate = sync.estimate();
+    QVERIFY(estimate.valid);
+    QCOMPARE(estimate.sampleCount, 1);
+    QCOMPARE(estimate.offsetMs, 100.0);
+    QCOMPARE(estimate.rttMs, 20.0);
+    QCOMPARE(sync.toLocalTime(2100), qint64(2000));
+}
+
+void TestProtocol::test_clockSyncMinRttFilter() {
+    ClockSynchronizer sync;
+
+    // 非对称排队延迟导致偏移估计失真（RTT大）
+    QVERIFY(sync.addSample(100, 280, 280, 300));
+    // 低延迟样本给出真实偏移 100ms
+    QVERIFY(sync.addSample(1000, 1105, 1105, 1010));
+    QVERIFY(sync.addSample(2000, 2160, 2160, 2120));
+
+    ClockSyncEstimate estimate = sync.estimate();
+    QCOMPARE(estimate.sampleCount, 3);
+    QCOMPARE(estimate.rttMs, 10.0);
+    QCOMPARE(estimate.offsetMs, 100.0);
+
+    sync.reset();
+    QVERIFY(!sync.estimate().valid);
+}
+
+void TestProtocol::test_clockSyncExchange() {
+    ClockSynchronizer server;
+    ClockSynchronizer client;
+
+    // 服务端时钟 = 客户端时钟 + 50ms，单程 5ms
+    const quint64 serverSend = 10000;
+    HeartbeatMessage request = server.prepareOutgoing(serverSend);
+    QCOMPARE(request.transmitTimestamp, serverSend);
+
+    // 首条心跳无回显，客户端无法形成样本
+    QVERIFY(!client.processIncoming(request, 9955));
+    HeartbeatMessage response = client.prepareOutgoing(9957);
+    QCOMPARE(response.originTimestamp, serverSend);
+
+    // 服务端收到回显后得到第一个样本
+    QVERIFY(server.processIncoming(response, 10012));
+    ClockSyncEstimate serverEstimate = server.estimate();
+    QVERIFY(serverEstimate.valid);
+    QCOMPARE(serverEstimate.offsetMs, -50.0);
+    QCOMPARE(serverEstimate.rttMs, 10.0);
+
+    // 服务端再次发送，客户端得到样本
+    HeartbeatMessage second = server.prepareOutgoing(10020);
+    QVERIFY(client.processIncoming(second, 9975));
+    ClockSyncEstimate clientEstimate = client.estimate();
+    QVERIFY(clientEstimate.valid);
+    QCOMPARE(clientEstimate.offsetMs, 50.0);
+    QCOMPARE(clientEstimate.rttMs, 10.0);
+}
+
+void TestProtocol::test_clockSyncIgnoresMismatchedOrigin() {
+    ClockSynchronizer sync;
+    sync.prepareOutgoing(5000);
+
+    // 回显的 origin 与本端最近发送时间不一致（重复或过期响应）
+    HeartbeatMessage stale;
+    stale.originTimestamp = 4000;
+    stale.receiveTimestamp = 4100;
+    stale.transmitTimestamp = 4101;
+    QVERIFY(!sync.processIncoming(stale, 5020));
+    QVERIFY(!sync.estimate().valid);
+}
+
+void TestProtocol::test_screenDataCaptureTimestamp() {
+    ScreenData sent;
+    sent.width = 4;
+    sent.height = 2;
+    sent.originalWidth = 4;
+    sent.originalHeight = 2;
+    sent.imageData = QByteArray(16, 'x');
+    sent.dataSize = sent.imageData.size();
+    sent.captureTimestamp = 1700000000123ULL;
+
+    ScreenData received;
+    QVERIFY(received.decode(sent.encode()));
+    QCOMPARE(received.imageData, sent.imageData);
+    QCOMPARE(received.captureTimestamp, sent.captureTimestamp);
+}
+
+void TestProtocol::test_screenDataWithoutCaptureTimestamp() {
+    ScreenData sent;
+    sent.width = 4;
+    sent.height = 2;
+    sent.imageData = QByteArray(16, 'y');
+    sent.dataSize = sent.imageData.size();
+
+    // 未设置捕获时间时编码结果与旧版本一致（无尾部字段）
+    QByteArray encoded = sent.encode();
+    sent.captureTimestamp = 42;
+    QCOMPARE(sent.encode().size(), encoded.size() + 8);
+
+    ScreenData received;
+    received.captureTimestamp = 99;
+    QVERIFY(received.decode(encoded));
+    QCOMPARE(received.imageData, sent.imageData);
+    QCOMPARE(received.captureTimestamp, quint64(0));
+}
+
+void TestProtocol::test_latencyStatsPercentiles() {
+    LatencyStats stats;
+    QCOMPARE(stats.summary().count, 0);
+
+    for ( int i = 1; i <= 100; ++i ) {
+        stats.record(i);
+    }
+
+    LatencyStats::Summary summary = stats.summary();
+    QCOMPARE(summary.count, 100);
+    QCOMPARE(summary.p50, 50.0);
+    QCOMPARE(summary.p95, 95.0);
+    QCOMPARE(summary.p99, 99.0);
+    QCOMPARE(summary.max, 100.0);
+    QCOMPARE(summary.toString(), QString("50.0/95.0/99.0ms"));
+}
+
+void TestProtocol::test_latencyStatsWindow() {
+    LatencyStats stats(4);
+    for ( int i = 1; i <= 10; ++i ) {
+        stats.record(i);
+    }
+
+    // 仅保留最近4个样本：7,8,9,10
+    LatencyStats::Summary summary = stats.summary();
+    QCOMPARE(summary.count, 4);
+    QCOMPARE(summary.p50, 8.0);
+    QCOMPARE(summary.max, 10.0);
+
+    stats.reset();
+    QCOMPARE(stats.summary().count, 0);
+}
+
+void TestProtocol::test_capabilityHandshakeRoundTrip() {
+    HandshakeRequest sent{};
+    sent.clientVersion = PROTOCOL_VERSION;
+    sent.screenWidth = 1920;
+    sent.screenHeight = 1080;
+    sent.colorDepth = 32;
+    sent.clientName = QStringLiteral("client");
+    sent.clientOS = QStringLiteral("Linux");
+    sent.capabilities = CapabilitySet::local();
+    sent.capabilities.entries.insert(0x7FFF, QByteArray("future"));
+
+    HandshakeRequest received{};
+    QVERIFY(received.decode(sent.encode()));
+    QCOMPARE(received.clientName, sent.clientName);
+    QCOMPARE(received.capabilities.version, CAPABILITY_SET_VERSION);
+    QCOMPARE(received.capabilities.entries, sent.capabilities.entries);
+    QVERIFY(received.capabilities.has(Capability::CLOCK_SYNC));
+    QCOMPARE(received.capabilities.uint32Param(Capability::MAX_MESSAGE_SIZE),
+        sent.capabilities.uint32Param(Capability::MAX_MESSAGE_SIZE));
+}
+
+void TestProtocol::test_capabilityLegacyHandshake() {
+    HandshakeResponse sent{};
+    sent.serverVersion = PROTOCOL_VERSION;
+    sent.screenWidth = 1280;
+    sent.screenHeight = 720;
+    sent.colorDepth = 32;
+    sent.supportedFeatures = 0;
+    sent.serverName = QStringLiteral("server");
+    sent.serverOS = QStringLiteral("Linux");
+
+    // 空能力集只占 version + count 4字节，去掉后即为旧版本的握手载荷
+    QByteArray encoded = sent.encode();
+    QByteArray legacy = encoded.left(encoded.size() - 4);
+
+    HandshakeResponse received{};
+    received.capabilities = CapabilitySet::local();
+    QVERIFY(received.decode(legacy));
+    QCOMPARE(received.serverName, sent.serverName);
+    QCOMPARE(received.screenWidth, sent.screenWidth);
+    QVERIFY(received.capabilities.isEmpty());
+
+    // 截断的能力集应解析失败
+    sent.capabilities = CapabilitySet::local();
+    QByteArray truncated = sent.encode();
+    truncated.chop(2);
+    QVERIFY(!received.decode(truncated));
+}
+
+void TestProtocol::test_capabilityIntersection() {
+    CapabilitySet client;
+    client.set(Capability::CLOCK_SYNC);
+    client.setUInt32(Capability::MAX_MESSAGE_SIZE, 1024);
+    client.entries.insert(0x7FFF, QByteArray());
+
+    CapabilitySet server;
+    server.set(Capability::CLOCK_SYNC);
+    server.set(Capability::ZSTD_SCREEN);
+    server.setUInt32(Capability::MAX_MESSAGE_SIZE, 4096);
+
+    CapabilitySet common = server.intersected(client);
+    QCOMPARE(common.entries.size(), 2);
+    QVERIFY(common.has(Capability::CLOCK_SYNC));
+    QVERIFY(!common.has(Capability::ZSTD_SCREEN));
+    QCOMPARE(common.uint32Param(Capability::MAX_MESSAGE_SIZE), quint32(4096));
+    QCOMPARE(client.intersected(server).uint32Param(Capability::MAX_MESSAGE_SIZE), quint32(1024));
+
+    // 旧版本对端没有能力集
+    QVERIFY(server.intersected(CapabilitySet()).isEmpty());
+    QCOMPARE(server.uint32Param(Capability::CAPTURE_TIMESTAMP, 7u), quint32(7));
+}
+
+void TestProtocol::test_receiveBufferStreamParsing() {
+    // 一个大帧后面跟随多条小输入消息，按任意分片到达
+    ScreenData frame;
+    frame.width = 64;
+    frame.height = 64;
+    frame.imageData = QByteArray(300 * 1024, 'f');
+    frame.dataSize = frame.imageData.size();
+    QByteArray stream = Protocol::createMessage(MessageType::SCREEN_DATA, frame);
+    for ( int i = 0; i < 50; ++i ) {
+        MouseEvent move{};
+        move.eventType = MouseEventType::MOVE;
+        move.x = static_cast<qint16>(i);
+        move.y = static_cast<qint16>(i * 2);
+        move.wheelDelta = 0;
+        stream += Protocol::createMessage(MessageType::MOUSE_EVENT, move);
+    }
+
+    ReceiveBuffer buffer(4096);
+    int screenMessages = 0;
+    int mouseMessages = 0;
+    for ( qsizetype offset = 0; offset < stream.size(); offset += 7777 ) {
+        QByteArray chunk = stream.mid(offset, 7777);
+        QBuffer device(&chunk);
+        QVERIFY(device.open(QIODevice::ReadOnly));
+        QCOMPARE(buffer.readFrom(&device), qint64(chunk.size()));
+
+        while ( !buffer.isEmpty() ) {
+            MessageHeader header;
+            QByteArrayView payload;
+            qsizetype result = Protocol::parseMessage(buffer.view(), header, payload);
+            QVERIFY(result != 0);
+            if ( result < 0 ) {
+                break;
+            }
+            buffer.consume(result);
+            if ( header.type == MessageType::SCREEN_DATA ) {
+                ScreenData decoded;
+                QVERIFY(decoded.decodeView(payload));
+                QCOMPARE(decoded.imageView.size(), frame.imageData.size());
+                ++screenMessages;
+            } else if ( header.type == MessageType::MOUSE_EVENT ) {
+                MouseEvent decoded{};
+                QVERIFY(decoded.decode(payload.toByteArray()));
+                QCOMPARE(decoded.x, static_cast<qint16>(mouseMessages));
+                ++mouseMessages;
+            }
+        }
+    }
+
+    QCOMPARE(screenMessages, 1);
+    QCOMPARE(mouseMessages, 50);
+    QVERIFY(buffer.isEmpty());
+}
+
+void TestProtocol::test_receiveBufferCompaction() {
+    ReceiveBuffer buffer(16);
+    buffer.append("0123456789", 10);
+    buffer.consume(8);
+    QCOMPARE(buffer.size(), qsizetype(2));
+
+    // 尾部空间不足时先压缩，容量不变
+    buffer.append("abcdefghij", 10);
+    QCOMPARE(buffer.capacity(), qsizetype(16));
+    QCOMPARE(buffer.view().toByteArray(), QByteArray("89abcdefghij"));
+
+    // 压缩后仍不足则扩容
+    buffer.append("KLMNOPQRST", 10);
+    QVERIFY(buffer.capacity() >= 22);
+    QCOMPARE(buffer.view().toByteArray(), QByteArray("89abcdefghijKLMNOPQRST"));
+
+    // 读空后游标归零
+    buffer.consume(buffer.size());
+    QVERIFY(buffer.isEmpty());
+    buffer.append("xy", 2);
+    QCOMPARE(buffer.view().toByteArray(), QByteArray("xy"));
+
+    buffer.clear();
+    QCOMPARE(buffer.size(), qsizetype(0));
+}
+
+void TestProtocol::test_zeroCopyParse() {
+    ScreenData frame;
+    frame.width = 8;
+    frame.height = 8;
+    frame.imageData = QByteArray(1024, 'z');
+    frame.dataSize = frame.imageData.size();
+    frame.captureTimestamp = 123;
+    const QByteArray message = Protocol::createMessage(MessageType::SCREEN_DATA, frame);
+
+    // 载荷与图像字节都应直接指向原始消息缓冲区
+    MessageHeader header;
+    QByteArrayView payload;
+    QCOMPARE(Protocol::parseMessage(message, header, payload), message.size());
+    QCOMPARE(header.type, MessageType::SCREEN_DATA);
+    QVERIFY(payload.constData() == message.constData() + SERIALIZED_HEADER_SIZE);
+
+    ScreenData decoded;
+    QVERIFY(decoded.decodeView(payload));
+    QVERIFY(decoded.imageView.constData() == payload.constData() + 17);
+    QCOMPARE(decoded.imageView.toByteArray(), frame.imageData);
+    QVERIFY(decoded.imageData.isEmpty());
+    QCOMPARE(decoded.captureTimestamp, quint64(123));
+
+    // 拷贝版本结果一致
+    QByteArray payloadCopy;
+    QCOMPARE(Protocol::parseMessage(message, header, payloadCopy), message.size());
+    QCOMPARE(payloadCopy, payload.toByteArray());
+
+    // 校验和错误被拒绝
+    QByteArray corrupted = message;
+    corrupted[corrupted.size() - 1] = 'X';
+    QCOMPARE(Protocol::parseMessage(corrupted, header, payload), qsizetype(0));
+
+    // 不完整的消息等待更多数据
+    QCOMPARE(Protocol::parseMessage(QByteArrayView(message).first(message.size() - 1), header, payload), qsizetype(-1));
+}
+
+void TestProtocol::test_checksumKnownVectors() {
+    const QByteArray check("123456789");
+    QCOMPARE(Checksum::crc32(check), quint32(0xCBF43926));
+    QCOMPARE(Checksum::crc32Bytewise(check), quint32(0xCBF43926));
+    QCOMPARE(Checksum::crc32SliceBy8(check), quint32(0xCBF43926));
+    QCOMPARE(Checksum::crc32c(check), quint32(0xE3069283));
+    QCOMPARE(Checksum::crc32cSliceBy8(check), quint32(0xE3069283));
+    QCOMPARE(Checksum::crc32(QByteArrayView()), quint32(0));
+    QCOMPARE(Checksum::compute(ChecksumAlgorithm::NONE, check), quint32(0));
+}
+
+void TestProtocol::test_checksumImplementationsAgree() {
+    QByteArray data(1024, Qt::Uninitialized);
+    quint32 seed = 0x12345678u;
+    for ( char& c : data ) {
+        seed = seed * 1103515245u + 12345u;
+        c = static_cast<char>(seed >> 24);
+    }
+
+    // 覆盖非对齐起始地址及硬件路径的分块边界（16/64字节）
+    for ( qsizetype offset = 0; offset < 8; ++offset ) {
+        for ( qsizetype length = 0; length <= 300; ++length ) {
+            const QByteArrayView view = QByteArrayView(data).sliced(offset, length);
+            const quint32 reference = Checksum::crc32Bytewise(view);
+            QCOMPARE(Checksum::crc32SliceBy8(view), reference);
+            QCOMPARE(Checksum::crc32(view), reference);
+            QCOMPARE(Checksum::crc32c(view), Checksum::crc32cSliceBy8(view));
+        }
+    }
+    const QByteArrayView whole(data);
+    QCOMPARE(Checksum::crc32(whole), Checksum::crc32Bytewise(whole));
+}
+
+void TestProtocol::test_checksumNegotiation() {
+    const quint32 plain = Checksum::supportedMask(false);
+    const quint32 tls = Checksum::supportedMask(true);
+    QVERIFY(!(plain & Checksum::maskOf(ChecksumAlgorithm::NONE)));
+    QVERIFY(tls & Checksum::maskOf(ChecksumAlgorithm::NONE));
+
+    // 双方都在 TLS 下才跳过校验
+    QCOMPARE(Checksum::choose(tls, tls), ChecksumAlgorithm::NONE);
+    QVERIFY(Checksum::choose(tls, plain) != ChecksumAlgorithm::NONE);
+
+    // 旧版本对端（无掩码）或只支持 CRC32 时回退到 CRC32
+    QCOMPARE(Checksum::choose(plain, 0), ChecksumAlgorithm::CRC32);
+    QCOMPARE(Checksum::choose(plain, Checksum::maskOf(ChecksumAlgorithm::CRC32)), ChecksumAlgorithm::CRC32);
+
+    // 能力集中携带掩码，交集后参数保持不变
+    CapabilitySet client = CapabilitySet::local();
+    client.setUInt32(Capability::CHECKSUM, tls);
+    const CapabilitySet common = client.intersected(CapabilitySet::local());
+    QVERIFY(common.has(Capability::CHECKSUM));
+    QCOMPARE(common.uint32Param(Capability::CHECKSUM), tls);
+}
+
+void TestProtocol::test_checksumAlgorithmParse() {
+    MouseEvent move{};
+    move.eventType = MouseEventType::MOVE;
+    move.x = 10;
+    move.y = 20;
+
+    MessageHeader header;
+    QByteArrayView payload;
+    for ( ChecksumAlgorithm algorithm : { ChecksumAlgorithm::CRC32, ChecksumAlgorithm::CRC32C } ) {
+        const QByteArray message = Protocol::createMessage(MessageType::MOUSE_EVENT, move, algorithm);
+        QCOMPARE(Protocol::parseMessage(message, header, payload, algorithm), message.size());
+        QCOMPARE(header.checksum, Checksum::compute(algorithm, payload));
+    }
+
+    // 算法不一致时视为无效消息
+    const QByteArray crc32c = Protocol::createMessage(MessageType::MOUSE_EVENT, move, ChecksumAlgorithm::CRC32C);
+    QCOMPARE(Protocol::parseMessage(crc32c, header, payload, ChecksumAlgorithm::CRC32), qsizetype(0));
+
+    // NONE：校验和字段为0，接收端不再验证
+    QByteArray unchecked = Protocol::createMessage(MessageType::MOUSE_EVENT, move, ChecksumAlgorithm::NONE);
+    QVERIFY(Protocol::parseMessage(unchecked, header, payload, ChecksumAlgorithm::NONE) > 0);
+    QCOMPARE(header.checksum, quint32(0));
+    unchecked[unchecked.size() - 1] = static_cast<char>(unchecked.at(unchecked.size() - 1) ^ 0x01);
+    QCOMPARE(Protocol::parseMessage(unchecked, header, payload, ChecksumAlgorithm::NONE), unchecked.size());
+}
+
+void TestProtocol::test_checksumIncremental() {
+    const QByteArray data = QByteArray("scatter-gather ").repeated(40);
+    for ( ChecksumAlgorithm algorithm : { ChecksumAlgorithm::CRC32, ChecksumAlgorithm::CRC32C } ) {
+        const quint32 whole = Checksum::compute(algorithm, data);
+        for ( qsizetype split : { qsizetype(0), qsizetype(7), qsizetype(64), qsizetype(333), data.size() } ) {
+            const QByteArrayView view(data);
+            const quint32 first = Checksum::compute(algorithm, view.first(split));
+            QCOMPARE(Checksum::compute(algorithm, view.sliced(split), first), whole);
+        }
+    }
+}
+
+void TestProtocol::test_messageSegments() {
+    ScreenData frame;
+    frame.width = 16;
+    frame.height = 9;
+    frame.originalWidth = 32;
+    frame.originalHeight = 18;
+    frame.imageData = QByteArray(4096, 'p');
+    frame.dataSize = frame.imageData.size();
+    frame.flags = static_cast<quint8>(ScreenDataFlags::SCALED);
+    frame.captureTimestamp = 987654321;
+
+    // 图像字节与消息对象共享，不拷贝
+    const MessageSegments segments = Protocol::createMessageSegments(MessageType::SCREEN_DATA, frame, ChecksumAlgorithm::CRC32C);
+    QVERIFY(!segments.isEmpty());
+    QVERIFY(segments.body.constData() == frame.imageData.constData());
+    QCOMPARE(segments.head.size(), qsizetype(SERIALIZED_HEADER_SIZE) + ScreenData::FIXED_FIELDS_SIZE);
+    QCOMPARE(segments.tail.size(), qsizetype(sizeof(quint64)));
+
+    // 拼接后的载荷与 ScreenData::encode() 逐字节一致
+    const QByteArray joined = segments.toByteArray();
+    QCOMPARE(joined.size(), segments.size());
+    QCOMPARE(joined.mid(SERIALIZED_HEADER_SIZE), frame.encode());
+
+    MessageHeader header;
+    QByteArrayView payload;
+    QCOMPARE(Protocol::parseMessage(joined, header, payload, ChecksumAlgorithm::CRC32C), joined.size());
+    QCOMPARE(header.length, quint32(joined.size() - SERIALIZED_HEADER_SIZE));
+
+    ScreenData decoded;
+    QVERIFY(decoded.decodeView(payload));
+    QCOMPARE(decoded.originalWidth, quint16(32));
+    QCOMPARE(decoded.flags, frame.flags);
+    QCOMPARE(decoded.imageView.toByteArray(), frame.imageData);
+    QCOMPARE(decoded.captureTimestamp, quint64(987654321));
+
+    // 小消息只有一段，createMessage 直接返回该段
+    HeartbeatMessage heartbeat{};
+    const MessageSegments small = Protocol::createMessageSegments(MessageType::HEARTBEAT, heartbeat);
+    QVERIFY(small.body.isEmpty() && small.tail.isEmpty());
+    QVERIFY(Protocol::parseMessage(small.toByteArray(), header, payload) > 0);
+    QCOMPARE(header.type, MessageType::HEARTBEAT);
+}
+
+void TestProtocol::test_wireFormatMatchesDataStream() {
+    MouseEvent mouse{};
+    mouse.eventType = MouseEventType::WHEEL_DOWN;
+    mouse.x = -12;
+    mouse.y = 1080;
+    mouse.wheelDelta = -120;
+
+    // 与原 QDataStream(LittleEndian) 实现的字节流逐字节一致
+    QByteArray expected;
+    {
+        QDataStream ds(&expected, QIODevice::WriteOnly);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        ds << static_cast<quint8>(mouse.eventType) << mouse.x << mouse.y << mouse.wheelDelta;
+    }
+    QCOMPARE(mouse.encode(), expected);
+
+    MouseEvent decodedMouse{};
+    QVERIFY(decodedMouse.decode(expected));
+    QCOMPARE(decodedMouse.eventType, mouse.eventType);
+    QCOMPARE(decodedMouse.x, mouse.x);
+    QCOMPARE(decodedMouse.y, mouse.y);
+    QCOMPARE(decodedMouse.wheelDelta, mouse.wheelDelta);
+
+    KeyboardEvent key{};
+    key.eventType = KeyboardEventType::KEY_PRESS;
+    key.keyCode = Qt::Key_A;
+    key.modifiers = Qt::ShiftModifier;
+    key.text = QStringLiteral("Aé");
+    expected.clear();
+    {
+        QDataStream ds(&expected, QIODevice::WriteOnly);
+        ds.setByteOrder(QDataStream::LittleEndian);
+        const QByteArray utf8 = key.text.toUtf8();
+        ds << static_cast<quint8>(key.eventType) << key.keyCode << key.modifiers << static_cast<quint32>(utf8.size());
+        ds.writeRawData(utf8.constData(), utf8.size());
+    }
+    QCOMPARE(key.encode(), expected);
+
+    // appendTo 保留已有内容
+    QByteArray appended("prefix");
+    key.appendTo(appended);
+    QCOMPARE(appended, QByteArray("prefix") + expected);
+
+    KeyboardEvent decodedKey{};
+    QVERIFY(decodedKey.decode(expected));
+    QCOMPARE(decodedKey.keyCode, key.keyCode);
+    QCOMPARE(decodedKey.modifiers, key.modifiers);
+    QCOMPARE(decodedKey.text, key.text);
+}
+
+void TestProtocol::test_wireFormatRejectsTruncated() {
+    MouseEvent mouse{};
+    mouse.eventType = MouseEventType::MOVE;
+    const QByteArray mouseBytes = mouse.encode();
+    QCOMPARE(mouseBytes.size(), qsizetype(7));
+    QVERIFY(!mouse.decode(mouseBytes.first(6)));
+
+    KeyboardEvent key{};
+    key.eventType = KeyboardEventType::KEY_RELEASE;
+    key.text = QStringLiteral("xyz");
+    const QByteArray keyBytes = key.encode();
+    QVERIFY(!key.decode(keyBytes.first(keyBytes.size() - 1)));
+
+    // 超过字段上限的长度前缀被拒绝，不分配内存
+    QByteArray hostile = keyBytes.first(9);
+    hostile.append("\xff\xff\xff\x7f", 4);
+    QVERIFY(!key.decode(hostile));
+
+    // 多余的尾部字节被忽略（向前兼容）
+    QVERIFY(key.decode(keyBytes + QByteArray(8, '\0')));
+    QCOMPARE(key.text, QStringLiteral("xyz"));
+}
+
+namespace {
+
+// 把写出的字节流按消息切分，返回消息类型序列
+QList<MessageType> splitMessageTypes(const QByteArray& stream, QList<QByteArray>* payloads = nullptr,
+                                     ChecksumAlgorithm algorithm = ChecksumAlgorithm::CRC32) {
+    QList<MessageType> types;
+    qsizetype pos = 0;
+    while ( pos < stream.size() ) {
+        MessageHeader header;
+        QByteArrayView payload;
+        const qsizetype consumed = Protocol::parseMessage(QByteArrayView(stream).sliced(pos), header, payload, algorithm);
+        if ( consumed <= 0 ) {
+            break;
+        }
+        types.append(header.type);
+        if ( payloads ) {
+            payloads->append(payload.toByteArray());
+        }
+        pos += consumed;
+    }
+    return types;
+}
+
+ScreenData makeFrame(qsizetype imageBytes) {
+    ScreenData frame{};
+    frame.width = 64;
+    frame.height = 64;
+    frame.imageData = QByteArray(imageBytes, '\0');
+    for ( qsizetype i = 0; i < imageBytes; ++i ) {
+        frame.imageData[i] = static_cast<char>(i * 31);
+    }
+    frame.dataSize = static_cast<quint32>(imageBytes);
+    return frame;
+}
+
+} // namespace
+
+void TestProtocol::test_sendQueueInteractiveFirst() {
+    QByteArray wire;
+    PrioritySendQueue queue([&wire](const char* data, qint64 length) {
+        wire.append(data, length);
+        return length;
+    });
+
+    // 批量消息先入队，随后的交互消息应在同一次 flush 中先写出
+    queue.enqueue(Protocol::createMessageSegments(MessageType::SCREEN_DATA, makeFrame(1000)));
+    MouseEvent mouse{};
+    mouse.eventType = MouseEventType::MOVE;
+    queue.enqueue(Protocol::createMessageSegments(MessageType::MOUSE_EVENT, mouse));
+    QCOMPARE(queue.pendingBulkMessages(), qsizetype(1));
+
+    QVERIFY(queue.flush(0) > 0);
+    QVERIFY(queue.isEmpty());
+    const QList<MessageType> types = splitMessageTypes(wire);
+    QCOMPARE(types, (QList<MessageType>{ MessageType::MOUSE_EVENT, MessageType::SCREEN_DATA }));
+}
+
+void TestProtocol::test_sendQueueLowWatermark() {
+    QByteArray wire;
+    PrioritySendQueue queue([&wire](const char* data, qint64 length) {
+        wire.append(data, length);
+        return length;
+    });
+    queue.setLowWatermark(4096);
+    queue.setFragmentSize(1024);
+
+    queue.enqueue(Protocol::createMessageSegments(MessageType::SCREEN_DATA, makeFrame(10000)));
+
+    // 套接字积压超过水位：批量通道不写
+    QCOMPARE(queue.flush(8192), qint64(0));
+    QCOMPARE(queue.pendingBulkMessages(), qsizetype(1));
+
+    // 积压清空：写到水位为止，每片不超过分片大小加消息头
+    const qint64 written = queue.flush(0);
+    QVERIFY(written >= 4096);
+    QVERIFY(written < 4096 + 1024 + 2 * SERIALIZED_HEADER_SIZE + MessageFragment::FIXED_FIELDS_SIZE);
+    QCOMPARE(queue.pendingBulkMessages(), qsizetype(1));
+
+    // 两批分片之间插入的交互消息不必等待整帧
+    HeartbeatMessage heartbeat{};
+    queue.enqueue(Protocol::createMessageSegments(MessageType::HEARTBEAT, heartbeat));
+    const qsizetype before = wire.size();
+    queue.flush(1 << 20);
+    QCOMPARE(splitMessageTypes(wire.sliced(before)), (QList<MessageType>{ MessageType::HEARTBEAT }));
+}
+
+void TestProtocol::test_fragmentRoundTrip() {
+    QByteArray wire;
+    PrioritySendQueue queue([&wire](const char* data, qint64 length) {
+        wire.append(data, length);
+        return length;
+    });
+    queue.setFragmentSize(1000);
+    queue.setChecksumAlgorithm(ChecksumAlgorithm::CRC32C);
+
+    const ScreenData frame = makeFrame(5000);
+    const QByteArray original = Protocol::createMessage(MessageType::SCREEN_DATA, frame, ChecksumAlgorithm::CRC32C);
+    queue.enqueue(Protocol::createMessageSegments(MessageType::SCREEN_DATA, frame, ChecksumAlgorithm::CRC32C));
+    while ( !queue.isEmpty() ) {
+        QVERIFY(queue.flush(0) > 0);
+    }
+
+    QList<QByteArray> payloads;
+    const QList<MessageType> types = splitMessageTypes(wire, &payloads, ChecksumAlgorithm::CRC32C);
+    QCOMPARE(types.size(), qsizetype((original.size() + 999) / 1000));
+    QVERIFY(std::all_of(types.begin(), types.end(), [](MessageType t) { return t == MessageType::FRAGMENT; }));
+
+    FragmentAssembler assembler;
+    QByteArray message;
+    for ( qsizetype i = 0; i < payloads.size(); ++i ) {
+        MessageFragment fragment;
+        QVERIFY(fragment.decodeView(payloads[i]));
+        const FragmentAssembler::Result expected = (i + 1 == payloads.size())
+            ? FragmentAssembler::Result::Complete : FragmentAssembler::Result::Incomplete;
+        QCOMPARE(assembler.addFragment(fragment, message), expected);
+    }
+    QCOMPARE(message, original);
+    QCOMPARE(assembler.pendingMessages(), qsizetype(0));
+}
+
+void TestProtocol::test_fragmentRejectsOutOfOrder() {
+    const QByteArray data(100, 'x');
+    MessageFragment first;
+    first.messageId = 7;
+    first.totalSize = 300;
+    first.offset = 0;
+    first.data = data;
+
+    MessageFragment skipped = first;
+    skipped.offset = 200;
+
+    FragmentAssembler assembler;
+    QByteArray message;
+    QCOMPARE(assembler.addFragment(first, message), FragmentAssembler::Result::Incomplete);
+    QCOMPARE(assembler.addFragment(skipped, message), FragmentAssembler::Result::Invalid);
+    QCOMPARE(assembler.pendingMessages(), qsizetype(0));
+
+    // 缺少首个分片的消息直接拒绝
+    QCOMPARE(assembler.addFragment(skipped, message), FragmentAssembler::Result::Invalid);
+
+    // 编解码往返
+    MessageFragment decoded;
+    const QByteArray encoded = first.encode();
+    QVERIFY(decoded.decodeView(encoded));
+    QCOMPARE(decoded.messageId, quint32(7));
+    QCOMPARE(decoded.totalSize, quint32(300));
+    QCOMPARE(decoded.data.toByteArray(), data);
+
+    // 越界分片在解码时即被拒绝
+    MessageFragment overflow = first;
+    overflow.offset = 250;
+    const QByteArray overflowEncoded = overflow.encode();
+    QVERIFY(!decoded.decodeView(overflowEncoded));
+}
+
+void TestProtocol::test_inputBatchRoundTrip() {
+    InputBatch batch;
+    batch.baseTimestamp = 1700000000123ULL;
+
+    InputBatchEvent move;
+    move.kind = InputBatchEvent::Kind::MOUSE;
+    move.mouse.eventType = MouseEventType::MOVE;
+    move.mouse.x = 640;
+    move.mouse.y = -3;
+    batch.events.append(move);
+
+    InputBatchEvent key;
+    key.kind = InputBatchEvent::Kind::KEYBOARD;
+    key.timeOffsetMs = 5;
+    key.keyboard.eventType = KeyboardEventType::KEY_PRESS;
+    key.keyboard.keyCode = Qt::Key_Q;
+    key.keyboard.text = QStringLiteral("q");
+    batch.events.append(key);
+
+    const QByteArray bytes = batch.encode();
+    InputBatch decoded;
+    QVERIFY(decoded.decode(bytes));
+    QCOMPARE(decoded.baseTimestamp, batch.baseTimestamp);
+    QCOMPARE(decoded.events.size(), qsizetype(2));
+    QCOMPARE(decoded.events[0].kind, InputBatchEvent::Kind::MOUSE);
+    QCOMPARE(decoded.events[0].mouse.x, qint16(640));
+    QCOMPARE(decoded.events[0].mouse.y, qint16(-3));
+    QCOMPARE(decoded.events[1].kind, InputBatchEvent::Kind::KEYBOARD);
+    QCOMPARE(decoded.events[1].timeOffsetMs, quint16(5));
+    QCOMPARE(decoded.events[1].keyboard.keyCode, quint32(Qt::Key_Q));
+    QCOMPARE(decoded.events[1].keyboard.text, QStringLiteral("q"));
+
+    // 截断与未知事件类型被拒绝
+    QVERIFY(!decoded.decode(bytes.first(bytes.size() - 1)));
+    QVERIFY(decoded.events.isEmpty());
+    QByteArray unknownKind = bytes;
+    unknownKind[10] = char(7);
+    QVERIFY(!decoded.decode(unknownKind));
+}
+
+void TestProtocol::test_cursorStateRoundTrip() {
+    CursorState state;
+    state.x = 1919;
+    state.y = -1;
+    state.cursorType = Qt::IBeamCursor;
+
+    const QByteArray bytes = state.encode();
+    QCOMPARE(bytes.size(), qsizetype(6));
+
+    CursorState decoded;
+    QVERIFY(decoded.decode(bytes));
+    QCOMPARE(decoded.x, qint16(1919));
+    QCOMPARE(decoded.y, qint16(-1));
+    QCOMPARE(decoded.cursorType, Qt::IBeamCursor);
+    QVERIFY(decoded.isVisible());
+
+    state.flags = static_cast<quint8>(CursorStateFlags::NONE);
+    QVERIFY(decoded.decode(state.encode()));
+    QVERIFY(!decoded.isVisible());
+
+    QVERIFY(!decoded.decode(bytes.first(5)));
+
+    // 握手默认声明光标流能力
+    QVERIFY(CapabilitySet::local().has(Capability::CURSOR_STREAM));
+}
+
+void TestProtocol::test_cursorShapeRoundTrip() {
+    CursorShapeMessage shape;
+    shape.cacheId = 7;
+    shape.flags = static_cast<quint8>(CursorShapeFlags::HAS_BITMAP);
+    shape.width = 2;
+    shape.height = 3;
+    shape.hotspotX = 1;
+    shape.hotspotY = 2;
+    shape.pixels = QByteArray(2 * 3 * 4, char(0x7f));
+
+    const QByteArray bytes = shape.encode();
+    CursorShapeMessage decoded;
+    QVERIFY(decoded.decode(bytes));
+    QCOMPARE(decoded.cacheId, quint32(7));
+    QVERIFY(decoded.hasBitmap());
+    QCOMPARE(decoded.width, quint16(2));
+    QCOMPARE(decoded.hotspotY, qint16(2));
+    QCOMPARE(decoded.pixels, shape.pixels);
+
+    // 位图不完整或尺寸超限被拒绝
+    QVERIFY(!decoded.decode(bytes.first(bytes.size() - 1)));
+    CursorShapeMessage oversized = shape;
+    oversized.width = CursorShapeMessage::MAX_DIMENSION + 1;
+    QVERIFY(!decoded.decode(oversized.encode()));
+
+    // 缓存引用只有定长头部
+    CursorShapeMessage reference;
+    reference.cacheId = 7;
+    QVERIFY(decoded.decode(reference.encode()));
+    QVERIFY(!decoded.hasBitmap());
+    QVERIFY(decoded.pixels.isEmpty());
+
+    // 内容哈希区分不同内容
+    QVERIFY(ContentHash::of(bytes) == ContentHash::of(shape.encode()));
+    QVERIFY(ContentHash::of(bytes) != ContentHash::of(reference.encode()));
+}
+
+void TestProtocol::test_lruCacheMirrorsEviction() {
+    // 服务端镜像（哈希 -> ID）与客户端缓存（ID -> 数据）按相同顺序操作
+    LruCache<ContentHash, quint32> mirror(2);
+    LruCache<quint32, QByteArray> client(2);
+    quint32 nextId = 1;
+
+    auto send = [&](const QByteArray& content) {
+        const ContentHash hash = ContentHash::of(content);
+        if ( const quint32* id = mirror.find(hash) ) {
+            QVERIFY(client.find(*id) != nullptr);
+            QCOMPARE(*client.find(*id), content);
+            return;
+        }
+        const quint32 id = nextId++;
+        mirror.insert(hash, id);
+        client.insert(id, content);
+    };
+
+    send("a");
+    send("b");
+    send("a");       // 命中，a 成为最近使用
+    send("c");       // 淘汰 b
+    QCOMPARE(nextId, quint32(4));
+    QVERIFY(!mirror.contains(ContentHash::of("b")));
+    QVERIFY(!client.contains(2));
+    QVERIFY(client.contains(1) && client.contains(3));
+
+    send("b");       // 重新发送，淘汰 a
+    QCOMPARE(nextId, quint32(5));
+    QVERIFY(!client.contains(1));
+
+    const auto evicted = client.insert(9, "x");
+    QVERIFY(evicted.has_value());
+    QCOMPARE(evicted->first, quint32(3));
+
+    client.setCapacity(1);
+    QCOMPARE(client.size(), qsizetype(1));
+    QVERIFY(client.contains(9));
+}
+
+void TestProtocol::test_tileUpdateRoundTrip() {
+    TileUpdate original;
+    original.width = 200;
+    original.height = 100;
+    original.originalWidth = 400;
+    original.originalHeight = 200;
+    original.flags = static_cast<quint8>(ScreenDataFlags::SCALED);
+    original.captureTimestamp = 1234567890123ULL;
+
+    TileRecord cached;
+    cached.kind = TileRecordKind::CACHED;
+    cached.cacheId = 7;
+    cached.x = 64;
+    cached.width = 64;
+    cached.height = 64;
+    TileRecord encoded;
+    encoded.kind = TileRecordKind::ENCODED;
+    encoded.cacheId = 8;
+    encoded.x = 192;
+    encoded.y = 64;
+    encoded.width = 8;
+    encoded.height = 36;
+    encoded.data = QByteArray("\xFF\xD8jpeg", 6);
+    original.records = { cached, encoded };
+
+    // 没有复制时不带尾部，旧格式不变
+    const QByteArray withoutCopies = original.encode();
+    CopyRect copy;
+    copy.srcY = 20;
+    copy.width = 200;
+    copy.height = 80;
+    original.copies = { copy };
+
+    const QByteArray bytes = original.encode();
+    QCOMPARE(bytes.size(), withoutCopies.size() + 2 + 12);
+    TileUpdate decoded;
+    QVERIFY(decoded.decode(bytes));
+    QCOMPARE(decoded.width, original.width);
+    QCOMPARE(decoded.originalHeight, original.originalHeight);
+    QCOMPARE(decoded.flags, original.flags);
+    QCOMPARE(decoded.captureTimestamp, original.captureTimestamp);
+    QCOMPARE(decoded.records.size(), qsizetype(2));
+    QCOMPARE(decoded.records[0].kind, TileRecordKind::CACHED);
+    QCOMPARE(decoded.records[0].cacheId, quint32(7));
+    QCOMPARE(decoded.records[0].rect(), QRect(64, 0, 64, 64));
+    QVERIFY(decoded.records[0].data.isEmpty());
+    QCOMPARE(decoded.records[1].rect(), QRect(192, 64, 8, 36));
+    QCOMPARE(decoded.records[1].data, encoded.data);
+    QCOMPARE(decoded.copies.size(), qsizetype(1));
+    QCOMPARE(decoded.copies[0].sourceRect(), QRect(0, 20, 200, 80));
+    QCOMPARE(decoded.copies[0].targetRect(), QRect(0, 0, 200, 80));
+    QVERIFY(decoded.decode(withoutCopies));
+    QVERIFY(decoded.copies.isEmpty());
+
+    // 截断、越出帧范围的记录与复制均拒绝
+    QVERIFY(!decoded.decode(bytes.left(bytes.size() - 1)));
+    original.copies[0].srcY = 21;
+    QVERIFY(!decoded.decode(original.encode()));
+    original.copies.clear();
+    original.records[1].width = 9;
+    QVERIFY(!decoded.decode(original.encode()));
+}
+
+void TestProtocol::test_monitorLayoutRoundTrip() {
+    MonitorLayout layout;
+    MonitorInfo primary;
+    primary.id = 0;
+    primary.flags = static_cast<quint8>(MonitorFlags::PRIMARY) | static_cast<quint8>(MonitorFlags::VIEWED);
+    primary.width = 3840;
+    primary.height = 2160;
+    MonitorInfo left;
+    left.id = 1;
+    left.flags = static_cast<quint8>(MonitorFlags::VIEWED);
+    left.x = -1920;
+    left.y = 120;
+    left.width = 1920;
+    left.height = 1080;
+    MonitorInfo idle;
+    idle.id = 2;
+    idle.x = 3840;
+    idle.width = 1920;
+    idle.height = 1200;
+    layout.monitors = {primary, left, idle};
+
+    const QByteArray bytes = layout.encode();
+    QCOMPARE(bytes.size(), qsizetype(1 + 3 * 10));
+
+    MonitorLayout decoded;
+    QVERIFY(decoded.decode(bytes));
+    QCOMPARE(decoded.monitors.size(), qsizetype(3));
+    QVERIFY(decoded.monitors.at(0).isPrimary());
+    QCOMPARE(decoded.monitors.at(1).geometry(), QRect(-1920, 120, 1920, 1080));
+    QVERIFY(!decoded.monitors.at(2).isViewed());
+    // 外接矩形只包含查看中的显示器
+    QCOMPARE(decoded.viewedBounds(), QRect(-1920, 0, 5760, 2160));
+
+    // 截断、重复ID和空尺寸都应拒绝
+    QVERIFY(!decoded.decode(bytes.first(bytes.size() - 1)));
+    layout.monitors[2].id = 1;
+    QVERIFY(!decoded.decode(layout.encode()));
+    layout.monitors[2].id = 2;
+    layout.monitors[2].width = 0;
+    QVERIFY(!decoded.decode(layout.encode()));
+
+    MonitorSelect select;
+    select.monitorIds = {2, 0, 2};
+    MonitorSelect decodedSelect;
+    QVERIFY(decodedSelect.decode(select.encode()));
+    QCOMPARE(decodedSelect.monitorIds, QList<quint8>({2, 0}));
+    select.monitorIds.clear();
+    QVERIFY(!decodedSelect.decode(select.encode()));
+
+    QVERIFY(CapabilitySet::local().has(Capability::MULTI_MONITOR));
+}
+
+QTEST_MAIN(TestProtocol)
+#include "test_protocol.moc"
@@ -84,6 +84,128 @@ private slots:
         QCOMPARE(received.originalFrameId, quint64(42));
     }
 
+    // --- ProcessedQueue broadcast readers ---
+
+    void testProcessedReadersFanOut() {
+        QVERIFY(m_qm->initialize(5, 5));
+
+        const quint32 first = m_qm->addProcessedReader();
+        const quint32 second = m_qm->addProcessedReader();
+        QVERIFY(first != 0 && second != 0 && first != second);
+        QCOMPARE(m_qm->processedReaderCount(), 2);
+
+        QVERIFY(m_qm->enqueueProcessedData(makeProcessed(1)));
+        QVERIFY(m_qm->enqueueProcessedData(makeProcessed(2)));
+
+        // 每个读者都能读到每一帧，读取不影响其他读者
+        for ( quint32 reader : { first, second } ) {
+            ProcessedData data;
+            QVERIFY(m_qm->readProcessedData(reader, data));
+            QCOMPARE(data.originalFrameId, quint64(1));
+            QVERIFY(m_qm->readProcessedData(reader, data));
+            QCOMPARE(data.originalFrameId, quint64(2));
+            QVERIFY(!m_qm->readProcessedData(reader, data));
+        }
+
+        m_qm->removeProcessedReader(first);
+        QCOMPARE(m_qm->processedReaderCount(), 1);
+        ProcessedData data;
+        QVERIFY(!m_qm->readProcessedData(first, data));
+    }
+
+    void testProcessedLayersAreSeparate() {
+        QVERIFY(m_qm->initialize(5, 5));
+        QVERIFY(m_qm->processedLayerCount() > 1);
+
+        const quint32 primary = m_qm->addProcessedReader(0);
+        const quint32 reduced = m_qm->addProcessedReader(1);
+        QCOMPARE(m_qm->processedReaderCount(1), 1);
+
+        ProcessedData layer0 = makeProcessed(1);
+        ProcessedData layer1 = makeProcessed(1);
+        layer1.layer = 1;
+        QVERIFY(m_qm->enqueueProcessedData(layer0));
+        QVERIFY(m_qm->enqueueProcessedData(layer1));
+
+        // 每个读者只读到所订阅层的帧
+        ProcessedData data;
+        QVERIFY(m_qm->readProcessedData(reduced, data, 1));
+        QCOMPARE(data.layer, 1);
+        QVERIFY(!m_qm->readProcessedData(reduced, data, 1));
+        QVERIFY(m_qm->readProcessedData(primary, data, 0));
+        QCOMPARE(data.layer, 0);
+        QVERIFY(!m_qm->readProcessedData(primary, data, 0));
+
+        ProcessedData invalidLayer = makeProcessed(2);
+        invalidLayer.layer = m_qm->processedLayerCount();
+        QVERIFY(!m_qm->enqueueProcessedData(invalidLayer));
+    }
+
+    void testSlowProcessedReaderSkipsToLatest() {
+        QVERIFY(m_qm->initialize(5, 5));
+
+        const quint32 reader = m_qm->addProcessedReader();
+        for ( quint64 i = 1; i <= 6; ++i ) {
+            QVERIFY(m_qm->enqueueProcessedData(makeProcessed(i)));
+        }
+
+        // 积压按读者游标计算，不受保留帧数限制（上限为 maxSize）
+        m_qm->forceUpdateStats();
+        QCOMPARE(m_qm->getQueueStats(QueueManager::ProcessedQueue).currentSize, 5);
+
+        ProcessedData data;
+        QVERIFY(m_qm->readProcessedData(reader, data));
+        QCOMPARE(data.originalFrameId, quint64(6));
+        QVERIFY(!m_qm->readProcessedData(reader, data));
+
+        m_qm->forceUpdateStats();
+        const QueueStats stats = m_qm->getQueueStats(QueueManager::ProcessedQueue);
+        QCOMPARE(stats.currentSize, 0);
+        QCOMPARE(stats.totalDropped, quint64(5));
+    }
+
+    void testDefaultReaderRelease() {
+        QVERIFY(m_qm->initialize(5, 5));
+
+        // 首次出队注册默认读者
+        ProcessedData data;
+        QVERIFY(!m_qm->dequeueProcessedData(data));
+        QCOMPARE(m_qm->processedReaderCount(), 1);
+
+        QVERIFY(m_qm->enqueueProcessedData(makeProcessed(1)));
+        m_qm->releaseDefaultReader();
+        QCOMPARE(m_qm->processedReaderCount(), 0);
+
+        // 注销后再次出队重新注册，从保留的最旧一帧开始
+        QVERIFY(m_qm->dequeueProcessedData(data));
+        QCOMPARE(data.originalFrameId, quint64(1));
+        QCOMPARE(m_qm->processedReaderCount(), 1);
+
+        // 注销前已读过的帧不再重复出队
+        m_qm->releaseDefaultReader();
+        QVERIFY(m_qm->enqueueProcessedData(makeProcessed(2)));
+        QVERIFY(m_qm->dequeueProcessedData(data));
+        QCOMPARE(data.originalFrameId, quint64(2));
+        QVERIFY(!m_qm->dequeueProcessedData(data));
+    }
+
+    void testTileHashConsumers() {
+        QVERIFY(m_qm->initialize(5, 5));
+        QVERIFY(!m_qm->tileHashesWanted());
+
+        // 登记即请求整帧：新会话的第一帧带图块哈希
+        m_qm->takeFullFrameRequest();
+        m_qm->addTileHashConsumer();
+        m_qm->addTileHashConsumer();
+        QVERIFY(m_qm->tileHashesWanted());
+        QVERIFY(m_qm->takeFullFrameRequest());
+
+        m_qm->removeTileHashConsumer();
+        QVERIFY(m_qm->tileHashesWanted());
+        m_qm->removeTileHashConsumer();
+        QVERIFY(!m_qm->tileHashesWanted());
+    }
+
     // --- Queue stats ---
 
     void testQueueStats() {
@@ -99,6 +221,34 @@ private slots:
         QCOMPARE(stats.currentSize, 3);
     }
 
+    // --- Multiple pipelines ---
+
+    void testPipelinesAreIndependentAndAggregated() {
+        QueueManager second(QStringLiteral("screen1"));
+        QVERIFY(m_qm->initialize(10, 10));
+        QVERIFY(second.initialize(10, 10));
+        QVERIFY(QueueManager::pipelines().contains(&second));
+        QCOMPARE(m_qm->threadName(QStringLiteral("DataProcessingWorker")), QStringLiteral("DataProcessingWorker"));
+        QCOMPARE(second.threadName(QStringLiteral("DataProcessingWorker")), QStringLiteral("DataProcessingWorker_screen1"));
+
+        QVERIFY(m_qm->enqueueCapturedFrame(makeFrame(1)));
+        QVERIFY(second.enqueueCapturedFrame(makeFrame(1)));
+        QVERIFY(second.enqueueCapturedFrame(makeFrame(2)));
+
+        // 每条流水线只看到自己的帧
+        m_qm->forceUpdateStats();
+        second.forceUpdateStats();
+        QCOMPARE(m_qm->getQueueStats(QueueManager::CaptureQueue).currentSize, 1);
+        QCOMPARE(second.getQueueStats(QueueManager::CaptureQueue).currentSize, 2);
+
+        // 汇总包含本测试的两条流水线（单例若已创建，其队列为空）
+        const QueueStats total = QueueManager::aggregatedStats(QueueManager::CaptureQueue);
+        QVERIFY(total.currentSize >= 3);
+        QVERIFY(total.totalEnqueued >= 3);
+
+        second.cleanup();
+    }
+
     // --- Clear queue ---
 
     void testClearQueue() {
@@ -4,12 +4,16 @@
 #include <QtGui/QPixmap>
 #include <QtGui/QScreen>
 #include <QtGui/QGuiApplication>
+#include <QtGui/QColor>
 #include <memory>
 
 #include "../src/server/capture/ScreenCaptureWorker.h"
+#include "../src/server/capture/CaptureBackend.h"
+#include "../src/server/capture/XShmCaptureBackend.h"
 #include "../src/common/core/threading/ThreadManager.h"
 #include "../src/server/dataflow/QueueManager.h"
 #include "../src/server/dataflow/DataFlowStructures.h"
+#include "../src/common/core/memory/FrameBufferPool.h"
 
 /**
  * @brief ScreenCaptureWorker单元测试类
@@ -102,8 +106,52 @@ private slots:
      * @brief 测试信号发射
      */
     void test_signalEmission();
+
+    /**
+     * @brief 测试抓取后端工厂与回退
+     */
+    void test_captureBackendFactory();
+
+    /**
+     * @brief 测试XShm后端把抓取结果拷贝到缓冲池、下游持有多帧时不占住共享内存段（需要X服务器，例如 xvfb-run）
+     */
+    void test_xshmBackend();
+
+    /**
+     * @brief 测试XShm后端的Damage变化跟踪（需要X服务器，例如 xvfb-run）
+     */
+    void test_xshmDamageTracking();
+
+    /**
+     * @brief 测试画面静止时不重复发布、帧间隔逐步加倍到空闲帧率，输入与整帧请求立即恢复全帧率
+     */
+    void test_idleFrameRate();
+
+    /**
+     * @brief 测试只抓取配置的区域，区域变化时无需重启即生效
+     */
+    void test_captureRectRegion();
+
+    /**
+     * @brief 测试XShm后端查询窗口位置以跟随单个窗口（需要X服务器，例如 xvfb-run）
+     */
+    void test_xshmWindowGeometry();
 };
 
+#ifdef Q_OS_LINUX
+/**
+ * @brief 通过独立的X连接在根窗口上填充纯色矩形（定义在文件末尾，避免X11宏与Qt头文件冲突）
+ */
+static bool fillRootRect(const QRect& rect, QRgb color);
+
+/**
+ * @brief 创建、移动和销毁一个不受窗口管理器控制的测试窗口（定义在文件末尾）
+ */
+static quintptr createTestWindow(const QRect& rect);
+static void moveTestWindow(quintptr window, const QRect& rect);
+static void destroyTestWindow(quintptr window);
+#endif
+
 void TestScreenCaptureWorker::initTestCase()
 {
     qDebug() << "开始ScreenCaptureWorker测试";
@@ -438,6 +486,320 @@ void TestScreenCaptureWorker::test_signalEmission()
     QVERIFY(tempFrame.frameId > 0);
 }
 
+void TestScreenCaptureWorker::test_captureBackendFactory()
+{
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        QSKIP("没有可用的屏幕");
+    }
+
+    // 工厂总是返回已打开的后端；offscreen 平台没有X连接，使用QScreen回退
+    std::unique_ptr<CaptureBackend> backend = CaptureBackend::create(screen);
+    QVERIFY(backend != nullptr);
+    if (QGuiApplication::platformName() != QLatin1String("xcb")) {
+        QCOMPARE(backend->name(), QStringLiteral("QScreen"));
+    }
+
+    const QRect rect(screen->geometry().topLeft(), QSize(64, 32));
+    QImage image = backend->grab(rect);
+    QVERIFY(!image.isNull());
+    QVERIFY(backend->grab(QRect()).isNull());
+    backend->close();
+}
+
+void TestScreenCaptureWorker::test_xshmBackend()
+{
+#ifdef Q_OS_LINUX
+    QScreen* screen = QGuiApplication::primaryScreen();
+    XShmCaptureBackend backend;
+    if (!screen || !backend.open(screen)) {
+        QSKIP("XShm不可用（需要支持MIT-SHM的本地X服务器，例如 xvfb-run）");
+    }
+
+    const QRect rect(screen->geometry().topLeft(), QSize(64, 32));
+    const qreal ratio = screen->devicePixelRatio();
+    QImage first = backend.grab(rect);
+    QVERIFY(!first.isNull());
+    QCOMPARE(first.format(), QImage::Format_RGB32);
+    QCOMPARE(first.size(), QSize(qRound(64 * ratio), qRound(32 * ratio)));
+
+    // 下游持有的帧数远超过去的段数上限：每次抓取都拷贝到缓冲池的新内存块，不占住共享内存段
+    FrameBufferPool& pool = FrameBufferPool::instance();
+    const FrameBufferPool::Stats before = pool.stats();
+    QList<QImage> held{ first };
+    QSet<const uchar*> bits{ first.constBits() };
+    const int grabs = 8;
+    for (int i = 0; i < grabs; ++i) {
+        held.append(backend.grab(rect));
+        QVERIFY(!held.last().isNull());
+        QCOMPARE(held.last().size(), first.size());
+        bits.insert(held.last().constBits());
+    }
+    QCOMPARE(bits.size(), held.size());
+    const FrameBufferPool::Stats during = pool.stats();
+    QCOMPARE(during.imageHits + during.imageMisses, before.imageHits + before.imageMisses + grabs);
+
+    // 释放后内存块回到池中，下一次抓取复用而不新分配
+    held.clear();
+    first = QImage();
+    QImage reused = backend.grab(rect);
+    QVERIFY(!reused.isNull());
+    QCOMPARE(pool.stats().imageHits, during.imageHits + 1);
+
+    // 关闭后已返回的图像仍可读取
+    const QRgb pixel = reused.pixel(0, 0);
+    backend.close();
+    QCOMPARE(reused.pixel(0, 0), pixel);
+#else
+    QSKIP("XShm后端仅在Linux上可用");
+#endif
+}
+
+void TestScreenCaptureWorker::test_xshmDamageTracking()
+{
+#ifdef Q_OS_LINUX
+    QScreen* screen = QGuiApplication::primaryScreen();
+    XShmCaptureBackend backend;
+    if (!screen || !backend.open(screen) || !backend.hasDamageTracking()) {
+        QSKIP("XShm/Damage不可用（需要支持MIT-SHM与Damage的本地X服务器，例如 xvfb-run）");
+    }
+    if (!qFuzzyCompare(screen->devicePixelRatio(), 1.0)) {
+        QSKIP("该测试假定屏幕没有缩放");
+    }
+
+    const QRect rect(screen->geometry().topLeft(), QSize(64, 32));
+    QVERIFY(!backend.grab(rect).isNull());
+
+    // 丢弃打开前后的残余变化，静止画面之后不再报告变化
+    QRegion changed;
+    QVERIFY(backend.takeDamage(rect, changed));
+    QTRY_VERIFY(backend.takeDamage(rect, changed) && changed.isEmpty());
+
+    // 在抓取区域内画一块：变化以图像坐标报告，段只重读变化的条带
+    const QRect painted(rect.topLeft() + QPoint(10, 8), QSize(12, 6));
+    QVERIFY(fillRootRect(painted, qRgb(0, 255, 0)));
+    QRegion accumulated;
+    auto damageCovers = [&]() {
+        QRegion part;
+        backend.takeDamage(rect, part);
+        accumulated += part;
+        return QRegion(QRect(QPoint(10, 8), QSize(12, 6))).subtracted(accumulated).isEmpty();
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(damageCovers(), 2000);
+    QVERIFY(QRect(QPoint(0, 0), rect.size()).contains(accumulated.boundingRect()));
+
+    QImage after = backend.grab(rect);
+    QVERIFY(!after.isNull());
+    QCOMPARE(QColor(after.pixel(15, 10)), QColor(0, 255, 0));
+
+    // 区域外的变化不报告给该区域
+    QTest::qWait(100);
+    backend.takeDamage(rect, changed);
+    QVERIFY(fillRootRect(QRect(rect.bottomRight() + QPoint(20, 20), QSize(4, 4)), qRgb(255, 0, 0)));
+    QTest::qWait(100);
+    QVERIFY(backend.takeDamage(rect, changed));
+    QVERIFY(changed.isEmpty());
+#else
+    QSKIP("XShm后端仅在Linux上可用");
+#endif
+}
+
+void TestScreenCaptureWorker::test_idleFrameRate()
+{
+    // 独立流水线，worker 在队列管理器之前析构
+    QueueManager queueManager(QStringLiteral("idle_test"));
+    queueManager.initialize(120, 120);
+    ScreenCaptureWorker worker(&queueManager);
+
+    auto config = worker.getCurrentConfig();
+    config.frameRate = 30;
+    config.idleFrameRate = 2;
+    worker.updateConfig(config);
+    worker.startCapturing();
+
+    // 首帧总是发布
+    CapturedFrame frame;
+    QTRY_VERIFY_WITH_TIMEOUT(queueManager.dequeueCapturedFrame(frame), 2000);
+    QVERIFY(!frame.image.isNull());
+
+    // offscreen 屏幕画面静止：帧间隔每次加倍，直到空闲帧率
+    const qint64 fullDelay = 1000 / config.frameRate;
+    const qint64 idleDelay = 1000 / config.idleFrameRate;
+    auto currentDelay = [&worker]() { return worker.getCaptureStats().currentFrameDelay.count(); };
+    QList<qint64> delays;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (elapsed.elapsed() < 3000 && (delays.isEmpty() || delays.last() != idleDelay)) {
+        const qint64 delay = currentDelay();
+        if (delay > 0 && (delays.isEmpty() || delays.last() != delay)) {
+            delays.append(delay);
+        }
+        QTest::qWait(2);
+    }
+    QVERIFY2(delays.size() >= 2, qPrintable(QStringLiteral("%1").arg(delays.size())));
+    QCOMPARE(delays.last(), idleDelay);
+    for (qsizetype i = 1; i < delays.size(); ++i) {
+        QCOMPARE(delays.at(i), std::min(delays.at(i - 1) * 2, idleDelay));
+    }
+
+    // 静止画面不再入队，抓取被判定为未变化
+    QVERIFY(!queueManager.dequeueCapturedFrame(frame));
+    QVERIFY(worker.getCaptureStats().unchangedFrames > 0);
+
+    // 客户端输入立即恢复全帧率（之后画面仍静止会再次降频，因此快速轮询），但不会凭空发布帧
+    queueManager.noteInputActivity();
+    bool restored = false;
+    elapsed.restart();
+    while (!restored && elapsed.elapsed() < 500) {
+        restored = currentDelay() == fullDelay;
+        QTest::qWait(1);
+    }
+    QVERIFY(restored);
+    QVERIFY(!queueManager.dequeueCapturedFrame(frame));
+
+    // 新读者请求整帧时立即发布一帧
+    queueManager.requestFullFrame();
+    QTRY_VERIFY_WITH_TIMEOUT(queueManager.dequeueCapturedFrame(frame), 500);
+    QVERIFY(!frame.image.isNull());
+
+    worker.stopCapturing();
+}
+
+void TestScreenCaptureWorker::test_captureRectRegion()
+{
+    QScreen* screen = QGuiApplication::primaryScreen();
+    if (!screen) {
+        QSKIP("没有可用的屏幕");
+    }
+    const qreal ratio = screen->devicePixelRatio();
+    const QRect first(screen->geometry().topLeft() + QPoint(10, 20), QSize(64, 48));
+    const QRect second(screen->geometry().topLeft() + QPoint(30, 40), QSize(96, 32));
+
+    QueueManager queueManager(QStringLiteral("region_test"));
+    queueManager.initialize(120, 120);
+    ScreenCaptureWorker worker(&queueManager);
+
+    auto config = worker.getCurrentConfig();
+    config.frameRate = 30;
+    config.captureRect = first;
+    worker.updateConfig(config);
+    worker.startCapturing();
+
+    // 只抓取配置的区域，并记录它在屏幕上的位置
+    CapturedFrame frame;
+    QTRY_VERIFY_WITH_TIMEOUT(queueManager.dequeueCapturedFrame(frame), 2000);
+    QCOMPARE(frame.image.size(), first.size() * ratio);
+    QCOMPARE(frame.sourceRect, first);
+
+    // 运行中改变区域：下一帧即为新区域的完整画面
+    config.captureRect = second;
+    worker.updateConfig(config);
+    QTRY_VERIFY_WITH_TIMEOUT(queueManager.dequeueCapturedFrame(frame) && frame.sourceRect == second, 2000);
+    QCOMPARE(frame.image.size(), second.size() * ratio);
+
+    // 超出屏幕的部分被裁掉
+    config.captureRect = QRect(screen->geometry().bottomRight() - QPoint(15, 15), QSize(64, 64));
+    worker.updateConfig(config);
+    QTRY_VERIFY_WITH_TIMEOUT(queueManager.dequeueCapturedFrame(frame) && frame.sourceRect != second, 2000);
+    QCOMPARE(frame.sourceRect.size(), QSize(16, 16));
+
+    worker.stopCapturing();
+}
+
+void TestScreenCaptureWorker::test_xshmWindowGeometry()
+{
+#ifdef Q_OS_LINUX
+    QScreen* screen = QGuiApplication::primaryScreen();
+    XShmCaptureBackend backend;
+    if (!screen || !backend.open(screen)) {
+        QSKIP("XShm不可用（需要支持MIT-SHM的本地X服务器，例如 xvfb-run）");
+    }
+    if (!qFuzzyCompare(screen->devicePixelRatio(), 1.0)) {
+        QSKIP("该测试假定屏幕没有缩放");
+    }
+
+    const QPoint origin = screen->geometry().topLeft();
+    const QRect placed(origin + QPoint(40, 30), QSize(120, 80));
+    const quintptr window = createTestWindow(placed);
+    QVERIFY(window != 0);
+
+    QTRY_COMPARE(backend.windowGeometry(window), placed);
+
+    // 移动并改变大小后立即反映新位置
+    const QRect moved(origin + QPoint(70, 50), QSize(100, 60));
+    moveTestWindow(window, moved);
+    QTRY_COMPARE(backend.windowGeometry(window), moved);
+
+    // 销毁的窗口返回空区域而不是触发X错误
+    destroyTestWindow(window);
+    QTRY_VERIFY(backend.windowGeometry(window).isEmpty());
+    QVERIFY(backend.windowGeometry(0).isEmpty());
+#else
+    QSKIP("XShm后端仅在Linux上可用");
+#endif
+}
+
 // 包含moc生成的代码
 QTEST_MAIN(TestScreenCaptureWorker)
-#include "test_screencaptureworker.moc"
\ No newline at end of file
+#include "test_screencaptureworker.moc"
+
+#ifdef Q_OS_LINUX
+#include <X11/Xlib.h>
+
+static bool fillRootRect(const QRect& rect, QRgb color)
+{
+    Display* display = XOpenDisplay(nullptr);
+    if (!display) {
+        return false;
+    }
+    const Window root = DefaultRootWindow(display);
+    GC gc = XCreateGC(display, root, 0, nullptr);
+    XSetForeground(display, gc, color & 0xffffff);
+    XSetSubwindowMode(display, gc, IncludeInferiors);
+    XFillRectangle(display, root, gc, rect.x(), rect.y(),
+                   static_cast<unsigned int>(rect.width()), static_cast<unsigned int>(rect.height()));
+    XFreeGC(display, gc);
+    XSync(display, False);
+    XCloseDisplay(display);
+    return true;
+}
+
+static Display* testWindowDisplay()
+{
+    static Display* display = XOpenDisplay(nullptr);
+    return display;
+}
+
+static quintptr createTestWindow(const QRect& rect)
+{
+    Display* display = testWindowDisplay();
+    if (!display) {
+        return 0;
+    }
+    XSetWindowAttributes attributes{};
+    attributes.override_redirect = True;
+    attributes.background_pixel = BlackPixel(display, DefaultScreen(display));
+    const Window window = XCreateWindow(display, DefaultRootWindow(display), rect.x(), rect.y(),
+                                        static_cast<unsigned int>(rect.width()), static_cast<unsigned int>(rect.height()),
+                                        0, CopyFromParent, InputOutput, CopyFromParent,
+                                        CWOverrideRedirect | CWBackPixel, &attributes);
+    XMapRaised(display, window);
+    XSync(display, False);
+    return static_cast<quintptr>(window);
+}
+
+static void moveTestWindow(quintptr window, const QRect& rect)
+{
+    Display* display = testWindowDisplay();
+    XMoveResizeWindow(display, static_cast<Window>(window), rect.x(), rect.y(),
+                      static_cast<unsigned int>(rect.width()), static_cast<unsigned int>(rect.height()));
+    XSync(display, False);
+}
+
+static void destroyTestWindow(quintptr window)
+{
+    Display* display = testWindowDisplay();
+    XDestroyWindow(display, static_cast<Window>(window));
+    XSync(display, False);
+}
+#endif
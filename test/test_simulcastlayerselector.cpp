@@ -0,0 +1,58 @@
+#include <QtTest/QtTest>
+#include "../src/server/clienthandler/SimulcastLayerSelector.h"
+#include "../src/common/core/config/NetworkConstants.h"
+
+/**
+ * @brief 同播层选择（SimulcastLayerSelector）测试
+ */
+class TestSimulcastLayerSelector : public QObject {
+    Q_OBJECT
+
+private slots:
+    void test_simulcastLayerSelection();
+};
+
+void TestSimulcastLayerSelector::test_simulcastLayerSelection() {
+    SimulcastLayerSelector selector(3);
+    QCOMPARE(selector.layer(), 0);
+
+    // 偶发跳帧不降层
+    for ( int i = 0; i < 16; ++i ) {
+        QCOMPARE(selector.update(i == 0 ? 2 : 0), 0);
+    }
+
+    // 近期频繁跳帧：降一层，统计清零后需要再次拥塞才继续降
+    for ( int i = 0; i < NetworkConstants::SIMULCAST_DOWN_SKIPS; ++i ) {
+        selector.update(3);
+    }
+    QCOMPARE(selector.layer(), 1);
+    for ( int i = 0; i < NetworkConstants::SIMULCAST_DOWN_SKIPS * 2; ++i ) {
+        selector.update(3);
+    }
+    QCOMPARE(selector.layer(), 2);
+    for ( int i = 0; i < NetworkConstants::SIMULCAST_DOWN_SKIPS; ++i ) {
+        selector.update(3);
+    }
+    QCOMPARE(selector.layer(), 2);   // 已是最低层
+
+    // 长时间顺畅后逐层回升
+    for ( int i = 0; i < NetworkConstants::SIMULCAST_UP_CLEAN_FRAMES - 1; ++i ) {
+        selector.update(0);
+    }
+    QCOMPARE(selector.layer(), 2);
+    QCOMPARE(selector.update(0), 1);
+
+    // 可用层数减少时降到范围内；reset 回到层 0
+    selector.setLayerCount(1);
+    QCOMPARE(selector.layer(), 0);
+    selector.setLayerCount(3);
+    selector.update(1);
+    selector.update(1);
+    selector.update(1);
+    QCOMPARE(selector.layer(), 1);
+    selector.reset();
+    QCOMPARE(selector.layer(), 0);
+}
+
+QTEST_MAIN(TestSimulcastLayerSelector)
+#include "test_simulcastlayerselector.moc"
@@ -7,6 +7,8 @@
 
 #include "../src/common/core/threading/ThreadManager.h"
 #include "../src/common/core/threading/Worker.h"
+#include "../src/common/core/threading/TimerWheel.h"
+#include "../src/common/core/threading/IoThreadPool.h"
 
 /**
  * @brief ThreadManager单元测试类
@@ -93,6 +95,16 @@ private slots:
      * @brief 测试并发安全性
      */
     void test_threadSafety();
+
+    /**
+     * @brief 测试定时轮的调度、周期触发与取消
+     */
+    void test_timerWheel();
+
+    /**
+     * @brief 测试I/O线程池按负载分配对象
+     */
+    void test_ioThreadPool();
 };
 
 /**
@@ -630,5 +642,83 @@ void TestThreadManager::test_threadSafety()
     QTest::qWait(50);
 }
 
+void TestThreadManager::test_timerWheel()
+{
+    TimerWheel wheel(10, 4);
+    int oneShot = 0;
+    int periodic = 0;
+    int longTimer = 0;
+
+    wheel.schedule(25, [&oneShot]() { ++oneShot; }, false);         // 向上取整为3个刻度
+    const TimerWheel::TimerId periodicId = wheel.schedule(10, [&periodic]() { ++periodic; });
+    wheel.schedule(70, [&longTimer]() { ++longTimer; }, false);     // 超过一圈（4个刻度）
+    QCOMPARE(wheel.pendingCount(), 3);
+
+    // 不足一个刻度的时间累积到下次
+    QCOMPARE(wheel.advance(5), 0);
+    QCOMPARE(wheel.advance(5), 1);
+    QCOMPARE(periodic, 1);
+
+    wheel.advance(10);
+    wheel.advance(10);
+    QCOMPARE(oneShot, 1);
+    QCOMPARE(periodic, 3);
+    QCOMPARE(longTimer, 0);
+
+    // 落后多个刻度时周期定时器只补触发一次
+    wheel.advance(40);
+    QCOMPARE(periodic, 4);
+    QCOMPARE(longTimer, 1);
+    QCOMPARE(wheel.pendingCount(), 1);
+
+    QVERIFY(wheel.cancel(periodicId));
+    QVERIFY(!wheel.cancel(periodicId));
+    wheel.advance(100);
+    QCOMPARE(periodic, 4);
+    QCOMPARE(wheel.pendingCount(), 0);
+    QCOMPARE(wheel.driverIntervalMs(), -1);
+
+    // 驱动只在最近的到期时间唤醒，最后一个定时器取消后停止
+    const TimerWheel::TimerId slowId = wheel.schedule(1000, []() {});
+    QVERIFY(wheel.driverIntervalMs() > 900);
+    const TimerWheel::TimerId fastId = wheel.schedule(30, []() {}, false);
+    QVERIFY(wheel.driverIntervalMs() <= 30);
+    QVERIFY(wheel.cancel(fastId));
+    QVERIFY(wheel.driverIntervalMs() > 900);
+    QVERIFY(wheel.cancel(slowId));
+    QCOMPARE(wheel.driverIntervalMs(), -1);
+}
+
+void TestThreadManager::test_ioThreadPool()
+{
+    IoThreadPool pool(2, QStringLiteral("TestIo"));
+    QCOMPARE(pool.threadCount(), 2);
+
+    QObject* first = new QObject();
+    QObject* second = new QObject();
+    QObject* third = new QObject();
+    QThread* firstThread = pool.attach(first);
+    QThread* secondThread = pool.attach(second);
+    QVERIFY(firstThread && secondThread);
+    QVERIFY(firstThread != secondThread);
+    QCOMPARE(first->thread(), firstThread);
+
+    // 归还后负载最小的线程被优先分配
+    pool.detach(firstThread);
+    QCOMPARE(pool.attach(third), firstThread);
+    QCOMPARE(pool.loads(), QList<int>({ 1, 1 }));
+
+    // 对象在其所在线程的事件循环中执行
+    QThread* ranOn = nullptr;
+    QMetaObject::invokeMethod(third, [&ranOn]() { ranOn = QThread::currentThread(); }, Qt::BlockingQueuedConnection);
+    QCOMPARE(ranOn, firstThread);
+
+    for (QObject* object : { first, second, third }) {
+        object->deleteLater();
+    }
+    pool.shutdown();
+    QCOMPARE(pool.threadCount(), 0);
+}
+
 QTEST_MAIN(TestThreadManager)
 #include "test_threadmanager.moc"
\ No newline at end of file
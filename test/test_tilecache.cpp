@@ -0,0 +1,255 @@
+#include <QtTest/QtTest>
+#include "../src/common/core/network/Protocol.h"
+#include "../src/common/core/config/NetworkConstants.h"
+#include "../src/common/core/cache/TileHasher.h"
+#include "../src/server/clienthandler/ScrollDetector.h"
+#include "../src/server/clienthandler/TileCacheMirror.h"
+#include "../src/client/managers/TileCache.h"
+#include <algorithm>
+
+/**
+ * @brief 图块缓存测试：服务端镜像（TileCacheMirror）与客户端缓存（TileCache）经编解码后保持一致
+ */
+class TestTileCache : public QObject {
+    Q_OBJECT
+
+private slots:
+    void test_tileCacheFollowsMirror();
+    void test_diskSpillDisabledByDefault();
+    void test_scrollSendsCopyRect();
+    void test_videoRegionSentSeparately();
+};
+
+void TestTileCache::test_tileCacheFollowsMirror() {
+    // 4x2 个图块，每个图块为不同的纯色；seed 不同的帧之间没有相同图块
+    const int tile = NetworkConstants::TILE_SIZE;
+    const auto makeFrame = [tile](int seed) {
+        QImage frame(4 * tile, 2 * tile, QImage::Format_RGB32);
+        for ( int i = 0; i < 8; ++i ) {
+            const QRect rect((i % 4) * tile, (i / 4) * tile, tile, tile);
+            for ( int y = rect.top(); y <= rect.bottom(); ++y ) {
+                std::fill_n(reinterpret_cast<QRgb*>(frame.scanLine(y)) + rect.x(), tile, qRgb(seed * 60, i * 30, 255 - seed * 60));
+            }
+        }
+        return frame;
+    };
+    const QImage frameA = makeFrame(1);
+    const QImage frameB = makeFrame(2);
+
+    // 容量 12：放不下两帧的全部图块；客户端内存层 3 条，其余 9 条写入磁盘
+    TileCacheMirror mirror;
+    mirror.setCapacity(12);
+    TileCache cache(3, 9 * TileCache::SPILL_FILE_BYTES);
+    QCOMPARE(cache.maxCapacity(), qsizetype(12));
+    cache.setCapacity(12);
+    QImage canvas;
+
+    // 经过编解码后应用到客户端；整帧时先以原图代替 SCREEN_DATA 解码结果
+    const auto deliver = [&](const QImage& frame, TileCacheMirror::Plan expected) {
+        TileUpdate update;
+        const TileCacheMirror::Plan plan = mirror.plan(frame, TileHasher::hashTiles(frame), 80, update);
+        if ( plan != expected ) {
+            return false;
+        }
+        if ( plan == TileCacheMirror::Plan::FullFrame ) {
+            canvas = frame;
+        }
+        TileUpdate received;
+        if ( plan != TileCacheMirror::Plan::Unchanged && received.decode(update.encode()) ) {
+            cache.apply(received, canvas);
+        }
+        return true;
+    };
+
+    QVERIFY(deliver(frameA, TileCacheMirror::Plan::FullFrame));
+    QCOMPARE(cache.size(), qsizetype(8));
+    QCOMPARE(cache.spilledCount(), qsizetype(5));
+    QVERIFY(deliver(frameA, TileCacheMirror::Plan::Unchanged));
+
+    QVERIFY(deliver(frameB, TileCacheMirror::Plan::FullFrame));
+    QCOMPARE(cache.size(), qsizetype(12));
+
+    // 切回 A：A 的后 4 块仍在缓存中，未命中不超过一半，按图块发送（命中的先发送，不被新图块淘汰）
+    QVERIFY(deliver(frameA, TileCacheMirror::Plan::Tiles));
+    QCOMPARE(cache.misses(), quint64(0));
+    QCOMPARE(cache.size(), qsizetype(12));
+    // 命中的图块无损：与原帧逐像素一致
+    QCOMPARE(canvas.copy(3 * tile, tile, tile, tile), frameA.copy(3 * tile, tile, tile, tile));
+
+    // 再切回 B：上一步淘汰了 B 的前 4 块，后 4 块仍可命中
+    TileUpdate update;
+    const TileCacheMirror::Plan plan = mirror.plan(frameB, TileHasher::hashTiles(frameB), 80, update);
+    QCOMPARE(plan, TileCacheMirror::Plan::Tiles);
+    QCOMPARE(std::count_if(update.records.cbegin(), update.records.cend(),
+        [](const TileRecord& record) { return record.kind == TileRecordKind::CACHED; }), qsizetype(4));
+    TileUpdate received;
+    QVERIFY(received.decode(update.encode()));
+    QVERIFY(cache.apply(received, canvas));
+    QCOMPARE(cache.misses(), quint64(0));
+
+    // 容量变化时双方都清空
+    mirror.setCapacity(4);
+    cache.setCapacity(4);
+    QCOMPARE(cache.size(), qsizetype(0));
+    QVERIFY(deliver(frameA, TileCacheMirror::Plan::FullFrame));
+}
+
+void TestTileCache::test_diskSpillDisabledByDefault() {
+    // 未启用磁盘溢出：容量不超过内存层，淘汰的图块直接丢弃，不创建临时文件
+    TileCache cache(3);
+    QCOMPARE(cache.maxCapacity(), qsizetype(3));
+    cache.setCapacity(12);
+    QCOMPARE(cache.capacity(), qsizetype(3));
+
+    QImage tile(NetworkConstants::TILE_SIZE, NetworkConstants::TILE_SIZE, QImage::Format_RGB32);
+    for ( quint32 id = 1; id <= 5; ++id ) {
+        tile.fill(qRgb(int(id) * 40, 0, 0));
+        cache.insert(id, tile);
+    }
+    QCOMPARE(cache.size(), qsizetype(3));
+    QCOMPARE(cache.spilledCount(), qsizetype(0));
+    QVERIFY(cache.find(1).isNull());
+    QCOMPARE(cache.find(5).pixel(0, 0), qRgb(200, 0, 0));
+
+    // 溢出上限不足一个文件时同样不落盘
+    TileCache tiny(3, TileCache::SPILL_FILE_BYTES - 1);
+    QCOMPARE(tiny.maxCapacity(), qsizetype(3));
+}
+
+void TestTileCache::test_scrollSendsCopyRect() {
+    // 每行、每列内容都不同的画面；(dx, dy) 为内容的偏移，模拟滚动
+    const auto makeFrame = [](int dx, int dy) {
+        QImage frame(256, 512, QImage::Format_RGB32);
+        for ( int y = 0; y < frame.height(); ++y ) {
+            QRgb* line = reinterpret_cast<QRgb*>(frame.scanLine(y));
+            for ( int x = 0; x < frame.width(); ++x ) {
+                line[x] = qRgb((x + dx) & 0xFF, (y + dy) & 0xFF, ((x + dx) >> 8) * 16 + ((y + dy) >> 8));
+            }
+        }
+        return frame;
+    };
+    const QImage frameA = makeFrame(0, 0);
+    const QImage scrolled = makeFrame(0, 40);
+
+    TileCacheMirror mirror;
+    mirror.setCapacity(256);
+    mirror.setCopyRectEnabled(true);
+    TileCache cache(256);
+    cache.setCapacity(256);
+
+    TileUpdate update;
+    QCOMPARE(mirror.plan(frameA, TileHasher::hashTiles(frameA), 80, update), TileCacheMirror::Plan::FullFrame);
+    QImage canvas = frameA;
+    cache.apply(update, canvas);
+
+    // 向上滚动 40 行：全部图块都变了，但只有底部一行图块需要编码
+    QCOMPARE(mirror.plan(scrolled, TileHasher::hashTiles(scrolled), 80, update), TileCacheMirror::Plan::Tiles);
+    QCOMPARE(update.copies.size(), qsizetype(1));
+    QCOMPARE(update.copies[0].sourceRect(), QRect(0, 40, 256, 472));
+    QCOMPARE(update.copies[0].targetRect(), QRect(0, 0, 256, 472));
+    QCOMPARE(update.records.size(), qsizetype(4));
+
+    TileUpdate received;
+    QVERIFY(received.decode(update.encode()));
+    QVERIFY(cache.apply(received, canvas));
+    QCOMPARE(cache.misses(), quint64(0));
+    // 复制得到的部分无损
+    QCOMPARE(canvas.copy(0, 0, 256, 472), scrolled.copy(0, 0, 256, 472));
+
+    // 水平位移同样检测
+    const std::optional<CopyRect> horizontal = ScrollDetector::detect(frameA, makeFrame(24, 0), frameA.rect());
+    QVERIFY(horizontal.has_value());
+    QCOMPARE(horizontal->sourceRect(), QRect(24, 0, 232, 512));
+    QCOMPARE(horizontal->targetRect(), QRect(0, 0, 232, 512));
+
+    // 对端不支持区域复制时退回整帧
+    TileCacheMirror plain;
+    plain.setCapacity(256);
+    QCOMPARE(plain.plan(frameA, TileHasher::hashTiles(frameA), 80, update), TileCacheMirror::Plan::FullFrame);
+    QCOMPARE(plain.plan(scrolled, TileHasher::hashTiles(scrolled), 80, update), TileCacheMirror::Plan::FullFrame);
+    QVERIFY(update.copies.isEmpty());
+}
+
+void TestTileCache::test_videoRegionSentSeparately() {
+    // 8x4 个图块的静态桌面，其中 3x2 个图块的矩形每帧变化（模拟视频播放）
+    const QRect video(128, 64, 192, 128);
+    const auto makeFrame = [video](int k) {
+        QImage frame(512, 256, QImage::Format_RGB32);
+        for ( int y = 0; y < frame.height(); ++y ) {
+            QRgb* line = reinterpret_cast<QRgb*>(frame.scanLine(y));
+            for ( int x = 0; x < frame.width(); ++x ) {
+                line[x] = video.contains(x, y) ? qRgb((k * 7 + x) & 0xFF, (k * 13 + y) & 0xFF, (k * 29) & 0xFF)
+                                               : qRgb(x / 2, y, 200);
+            }
+        }
+        return frame;
+    };
+
+    TileCacheMirror mirror;
+    mirror.setCapacity(1024);
+    TileCache cache(1024);
+    cache.setCapacity(1024);
+    QImage canvas;
+    const auto hasVideoRecord = [](const TileUpdate& update) {
+        return std::any_of(update.records.cbegin(), update.records.cend(),
+            [](const TileRecord& record) { return record.kind == TileRecordKind::VIDEO; });
+    };
+
+    TileUpdate update;
+    qint64 timestamp = 1000;
+    QImage frame = makeFrame(0);
+    QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::FullFrame);
+    canvas = frame;
+    cache.apply(update, canvas);
+
+    // 变化频率尚未达到阈值：按普通图块发送
+    for ( int k = 1; k < NetworkConstants::VIDEO_HOT_CHANGES; ++k ) {
+        timestamp += 33;
+        frame = makeFrame(k);
+        QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::Tiles);
+        QVERIFY(!hasVideoRecord(update));
+        cache.apply(update, canvas);
+    }
+
+    // 持续变化后识别为视频区域：整块缩小编码为一条记录，客户端放大绘制且不入缓存
+    timestamp += 33;
+    frame = makeFrame(NetworkConstants::VIDEO_HOT_CHANGES);
+    QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::Tiles);
+    QCOMPARE(update.records.size(), qsizetype(1));
+    QCOMPARE(update.records[0].kind, TileRecordKind::VIDEO);
+    QCOMPARE(update.records[0].rect(), video);
+    QImage encoded;
+    QVERIFY(encoded.loadFromData(update.records[0].data, "JPEG"));
+    QCOMPARE(encoded.size(), video.size() * NetworkConstants::VIDEO_SCALE_PERCENT / 100);
+
+    TileUpdate received;
+    QVERIFY(received.decode(update.encode()));
+    const qsizetype cached = cache.size();
+    QVERIFY(cache.apply(received, canvas));
+    QCOMPARE(cache.size(), cached);
+    QCOMPARE(canvas.size(), frame.size());
+
+    // 帧率上限内的下一帧延后，间隔足够后发送最新内容
+    timestamp += 33;
+    frame = makeFrame(NetworkConstants::VIDEO_HOT_CHANGES + 1);
+    QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::Unchanged);
+    timestamp += 33;
+    frame = makeFrame(NetworkConstants::VIDEO_HOT_CHANGES + 2);
+    QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::Tiles);
+    QVERIFY(hasVideoRecord(update));
+
+    // 停止播放：区域冷却后，其中的图块按普通图块重发一次（替换低质量画面），之后不再发送
+    TileCacheMirror::Plan plan = TileCacheMirror::Plan::Unchanged;
+    for ( int i = 0; i < 16 && plan == TileCacheMirror::Plan::Unchanged; ++i ) {
+        timestamp += 33;
+        plan = mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp);
+    }
+    QCOMPARE(plan, TileCacheMirror::Plan::Tiles);
+    QVERIFY(!hasVideoRecord(update));
+    QCOMPARE(update.records.size(), qsizetype(6));
+    timestamp += 33;
+    QCOMPARE(mirror.plan(frame, TileHasher::hashTiles(frame), 80, update, timestamp), TileCacheMirror::Plan::Unchanged);
+}
+
+QTEST_MAIN(TestTileCache)
+#include "test_tilecache.moc"